@@ -0,0 +1,101 @@
+#ifndef CHAIN_BIN_H
+#define CHAIN_BIN_H
+
+// chain log binary 형식 (column 방식)
+// DASM logging thread가 쓰고(chain_log.h), Bare_metal_tools/chain_analyze.c가 mmap으로 읽는다.
+//
+// 파일 구조: [file header] [block] [block] ...
+//  - file header: chain 번호, chain 길이(level 수), column 개수와 이름
+//  - block: [block header(rows)] [column 0: rows개 int64] [column 1: rows개 int64] ...
+//    record를 최대 CHAIN_BIN_BLOCK_ROWS개씩 모아 column 단위로 저장 (마지막 block은 더 작을 수 있음)
+//
+// column 순서 (levels = L):
+//  id, lL_wake, lL_recv, lL_send, ..., l2_wake, l2_recv, l2_send, l1_wake, l1_recv, l1_end,
+//  l1_last_end, prev_wake, l1_reads, clock_err
+//  id는 chain 시작 task의 seq (chain_msg.h), lL_recv는 text log의 chain_lL_start, 시각은 모두 CLOCK_MONOTONIC ns
+//  l1_*은 이 sample을 처음 읽은 DASM job, l1_last_end는 마지막으로 읽은 DASM job의 end,
+//  prev_wake는 직전 sample의 lL_wake (첫 sample은 0), l1_reads는 이 sample을 읽은 DASM job 수
+//  clock_err는 node 사이 clock 보정의 E2E 오차 상한 ns (TCP 변형, rt_clock.h / shm은 0)
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define CHAIN_BIN_MAGIC 0x57434842       // "WCHB"
+#define CHAIN_BIN_BLOCK_MAGIC 0x57424c4b // "WBLK"
+#define CHAIN_BIN_VERSION 3
+#define CHAIN_BIN_BLOCK_ROWS 4096
+#define CHAIN_BIN_MAX_COLS 24
+#define CHAIN_BIN_COL_NAME 16
+
+enum
+{
+    CHAIN_BIN_WAKE = 0,
+    CHAIN_BIN_RECV,
+    CHAIN_BIN_SEND // level 1(DASM)에서는 end
+};
+
+// level column 뒤에 붙는 column
+enum
+{
+    CHAIN_BIN_LAST_END = 0,
+    CHAIN_BIN_PREV_WAKE,
+    CHAIN_BIN_READS,
+    CHAIN_BIN_CLOCK_ERR,
+    CHAIN_BIN_NUM_EXTRA
+};
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    int32_t chain;
+    int32_t levels;
+    int32_t num_cols;
+    int32_t block_rows; // block당 최대 record 수
+    char col_names[CHAIN_BIN_MAX_COLS][CHAIN_BIN_COL_NAME];
+} chain_bin_header_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t rows;
+} chain_bin_block_t;
+
+static inline int chain_bin_num_cols(int levels)
+{
+    return 1 + levels * 3 + CHAIN_BIN_NUM_EXTRA;
+}
+
+// level lvl의 wake/recv/send column 위치
+static inline int chain_bin_col(int levels, int lvl, int kind)
+{
+    return 1 + (levels - lvl) * 3 + kind;
+}
+
+// level column 뒤의 CHAIN_BIN_LAST_END / PREV_WAKE / READS / CLOCK_ERR 위치
+static inline int chain_bin_extra_col(int levels, int kind)
+{
+    return 1 + levels * 3 + kind;
+}
+
+static inline void chain_bin_init_header(chain_bin_header_t *h, int chain, int levels)
+{
+    static const char *kinds[3] = {"wake", "recv", "send"};
+    static const char *extras[CHAIN_BIN_NUM_EXTRA] = {"l1_last_end", "prev_wake", "l1_reads", "clock_err"};
+    *h = (chain_bin_header_t){0};
+    h->magic = CHAIN_BIN_MAGIC;
+    h->version = CHAIN_BIN_VERSION;
+    h->chain = chain;
+    h->levels = levels;
+    h->num_cols = chain_bin_num_cols(levels);
+    h->block_rows = CHAIN_BIN_BLOCK_ROWS;
+    snprintf(h->col_names[0], CHAIN_BIN_COL_NAME, "id");
+    for (int lvl = levels; lvl >= 1; lvl--)
+        for (int k = 0; k < 3; k++)
+            snprintf(h->col_names[chain_bin_col(levels, lvl, k)], CHAIN_BIN_COL_NAME, "l%d_%s", lvl,
+                     (lvl == 1 && k == CHAIN_BIN_SEND) ? "end" : kinds[k]);
+    for (int k = 0; k < CHAIN_BIN_NUM_EXTRA; k++)
+        snprintf(h->col_names[chain_bin_extra_col(levels, k)], CHAIN_BIN_COL_NAME, "%s", extras[k]);
+}
+
+#endif
@@ -0,0 +1,434 @@
+#ifndef CHAIN_LOG_H
+#define CHAIN_LOG_H
+
+// DASM chain log 비동기 writer
+// DASM의 runnable thread(5ms 주기)는 완성된 chain record를 queue에 넣기만 하고,
+// 별도의 logging thread가 queue를 모아서(batch) log_Chain N_<변형>.txt 파일에 기록한다.
+// 파일 I/O(fopen, fprintf, fclose)가 end task의 critical path에서 빠짐.
+//  - queue: 단일 producer(DASM) / 단일 consumer(logging thread) lock-free ring
+//  - queue가 가득 차면 DASM은 기다리지 않고 record를 버리고 dropped만 증가
+//  - WATERS_LOG_CORE: logging thread를 둘 core (없으면 DASM과 같은 core에서 SCHED_OTHER로 동작)
+//  - WATERS_LOG_FSYNC: none(기본) | batch(매 batch마다 fsync) | close(종료 시에만 fsync)
+//  - WATERS_LOG_FORMAT: text(기본) | binary | both
+//    text는 기존과 같은 형식(analysis2.py 사용), binary는 log_Chain N_<변형>.bin (chain_bin.h, chain_analyze 사용)
+// 기록과 함께 chain별 latency histogram(chain_stats.h, shm /waters_dasm_stats)도 갱신해 실행 중에 볼 수 있음
+//
+// sample 추적 (chain_track_*): DASM은 같은 sample(chain 시작 task의 seq)을 여러 job에서 읽을 수 있으므로
+// 처음 읽은 job(first)과 마지막으로 읽은 job(last)을 모두 기록한다. record는 다음 sample이 도착해
+// 마지막 job이 확정될 때 queue에 들어감 (실행 종료 시점의 마지막 sample은 기록되지 않음)
+//  - Reaction time = first job end - 직전 sample의 시작 wake
+//    (직전 sample을 읽은 직후 발생한 event가 처음 반영되기까지, first-to-first)
+//  - Data age      = last job end - 시작 wake (sample이 출력에 마지막으로 쓰일 때의 나이, last-to-last)
+
+// pthread_setaffinity_np 사용: include하는 파일 맨 위에 _GNU_SOURCE가 정의되어 있어야 함
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "chain_bin.h"
+#include "chain_stats.h"
+
+#define CHAIN_LOG_CAPACITY 1024    // queue record 개수 (2의 거듭제곱)
+#define CHAIN_LOG_NUM_CHAINS 5
+#define CHAIN_LOG_MAX_LEVEL 5
+#define CHAIN_LOG_FLUSH_MS 100     // logging thread가 queue를 비우는 간격
+#define CHAIN_LOG_FILE_BUF (64 * 1024)
+
+// WATERS_LOG_FORMAT
+#define CHAIN_LOG_TEXT 0x1
+#define CHAIN_LOG_BINARY 0x2
+
+enum
+{
+    CHAIN_LOG_FSYNC_NONE = 0,
+    CHAIN_LOG_FSYNC_BATCH,
+    CHAIN_LOG_FSYNC_CLOSE
+};
+
+// chain 하나의 완성된 기록 (시각은 CLOCK_MONOTONIC ns)
+// level L의 wake/recv/send, level 1(DASM)은 처음 읽은 job의 recv와 end(send 자리)만 사용
+typedef struct
+{
+    int32_t chain;   // 1 ~ 5
+    int32_t levels;  // chain 길이 (3 또는 5)
+    int64_t seq;     // chain 시작 task가 만든 data의 seq (chain_msg.h)
+    int32_t reads;   // 이 sample을 읽은 DASM job 수
+    int32_t reserved;
+    int64_t wake_ns[CHAIN_LOG_MAX_LEVEL + 1];
+    int64_t recv_ns[CHAIN_LOG_MAX_LEVEL + 1];
+    int64_t send_ns[CHAIN_LOG_MAX_LEVEL + 1];
+    int64_t last_end_ns;  // 마지막으로 읽은 DASM job의 end
+    int64_t prev_wake_ns; // 직전 sample의 시작 wake (첫 sample은 0)
+    int64_t clock_err_ns; // node 사이 clock 보정의 E2E 오차 상한 (TCP 변형, rt_clock.h / -1: 추정 전이라 기록하지 않음)
+} chain_log_rec_t;
+
+// chain별 sample 추적 상태 (DASM runnable thread만 사용)
+typedef struct
+{
+    uint64_t last_seq;
+    int pending;          // rec이 아직 queue에 들어가지 않음 (마지막 job이 확정되지 않음)
+    int64_t prev_wake_ns; // 직전 sample의 시작 wake
+    chain_log_rec_t rec;
+} chain_track_t;
+
+typedef struct
+{
+    _Alignas(64) uint64_t head;  // DASM만 씀
+    _Alignas(64) uint64_t tail;  // logging thread만 씀
+    _Alignas(64) uint64_t dropped;
+    uint64_t written;
+    chain_log_rec_t recs[CHAIN_LOG_CAPACITY];
+    FILE *fp[CHAIN_LOG_NUM_CHAINS + 1];
+    // binary 출력: chain별로 block 하나 분량의 column buffer를 모았다가 한 번에 기록
+    FILE *bin_fp[CHAIN_LOG_NUM_CHAINS + 1];
+    int64_t *bin_cols[CHAIN_LOG_NUM_CHAINS + 1];
+    int bin_levels[CHAIN_LOG_NUM_CHAINS + 1];
+    int bin_rows[CHAIN_LOG_NUM_CHAINS + 1];
+    // clock 보정 오차 상한 (chain별, logging thread만 사용)
+    int64_t clock_err_max[CHAIN_LOG_NUM_CHAINS + 1];
+    double clock_err_sum[CHAIN_LOG_NUM_CHAINS + 1];
+    uint64_t clock_err_n[CHAIN_LOG_NUM_CHAINS + 1];
+    uint64_t clock_unknown[CHAIN_LOG_NUM_CHAINS + 1];
+    int format;
+    char suffix[16];
+    int fsync_policy;
+    int log_core;
+    pthread_t tid;
+} chain_log_t;
+
+static chain_log_t chain_log;
+static volatile sig_atomic_t chain_log_stop = 0;
+
+static inline int64_t chain_log_ns(int64_t sec, int64_t nsec)
+{
+    return sec * 1000000000LL + nsec;
+}
+
+// record 한 개를 queue에 넣음 (DASM runnable thread에서 호출, hot path)
+static inline void chain_log_push(const chain_log_rec_t *rec)
+{
+    uint64_t head = chain_log.head;
+    if (head - __atomic_load_n(&chain_log.tail, __ATOMIC_ACQUIRE) >= CHAIN_LOG_CAPACITY)
+    {
+        __atomic_store_n(&chain_log.dropped, chain_log.dropped + 1, __ATOMIC_RELAXED);
+        return;
+    }
+    chain_log.recs[head & (CHAIN_LOG_CAPACITY - 1)] = *rec;
+    __atomic_store_n(&chain_log.head, head + 1, __ATOMIC_RELEASE);
+}
+
+static inline void chain_track_init(chain_track_t *t)
+{
+    memset(t, 0, sizeof(*t));
+}
+
+// 이번 DASM job이 읽은 chain 시작 seq가 이전 job과 같으면 마지막 소비 job만 갱신하고 0을 반환
+// 다르면(새 sample) 1을 반환: 호출한 쪽이 record를 채워 chain_track_begin()으로 넘김
+// seq 0은 chain 시작 task가 아직 쓰지 않은 buffer라 기록하지 않음
+static inline int chain_track_read(chain_track_t *t, uint64_t seq, const struct timespec *end)
+{
+    if (seq == 0)
+        return 0;
+    if (seq == t->last_seq)
+    {
+        t->rec.last_end_ns = chain_log_ns(end->tv_sec, end->tv_nsec);
+        t->rec.reads++;
+        return 0;
+    }
+    t->last_seq = seq;
+    return 1;
+}
+
+// 새 sample 시작: 직전 sample은 마지막 소비 job이 확정되었으므로 queue에 넣고, rec을 새 pending으로 둠
+static inline void chain_track_begin(chain_track_t *t, const chain_log_rec_t *rec)
+{
+    if (t->pending)
+        chain_log_push(&t->rec);
+    t->rec = *rec;
+    t->rec.reads = 1;
+    t->rec.last_end_ns = rec->send_ns[1];
+    t->rec.prev_wake_ns = t->prev_wake_ns;
+    t->prev_wake_ns = (rec->clock_err_ns < 0) ? 0 : rec->wake_ns[rec->levels]; // 보정 전 시각은 다음 sample에 넘기지 않음
+    t->pending = 1;
+}
+
+static FILE *chain_log_file(int chain)
+{
+    if (chain < 1 || chain > CHAIN_LOG_NUM_CHAINS)
+        return NULL;
+    if (chain_log.fp[chain] == NULL)
+    {
+        char filename[64];
+        snprintf(filename, sizeof(filename), "log_Chain %d_%s.txt", chain, chain_log.suffix);
+        chain_log.fp[chain] = fopen(filename, "a");
+        if (chain_log.fp[chain] == NULL)
+        {
+            perror("[DASM] Failed to open chain log");
+            return NULL;
+        }
+        setvbuf(chain_log.fp[chain], NULL, _IOFBF, CHAIN_LOG_FILE_BUF);
+    }
+    return chain_log.fp[chain];
+}
+
+// 기존 print_log_if_new와 같은 형식으로 출력 (us 단위), 마지막 두 줄은 Reaction time / Data age 계산용
+static void chain_log_format(FILE *fp, const chain_log_rec_t *r)
+{
+    int top = r->levels;
+    fprintf(fp, "ID = %lld, chain_l%d_wake_us = %.2f us\n", (long long)r->seq, top, r->wake_ns[top] / 1.0e3);
+    fprintf(fp, "ID = %lld, chain_l%d_start_us = %.2f us\n", (long long)r->seq, top, r->recv_ns[top] / 1.0e3);
+    fprintf(fp, "ID = %lld, chain_l%d_send_us = %.2f us\n", (long long)r->seq, top, r->send_ns[top] / 1.0e3);
+    for (int lvl = top - 1; lvl >= 2; lvl--)
+    {
+        fprintf(fp, "ID = %lld, chain_l%d_recv_us = %.2f us\n", (long long)r->seq, lvl, r->recv_ns[lvl] / 1.0e3);
+        fprintf(fp, "ID = %lld, chain_l%d_send_us = %.2f us\n", (long long)r->seq, lvl, r->send_ns[lvl] / 1.0e3);
+    }
+    fprintf(fp, "ID = %lld, chain_l1_recv_us = %.2f us\n", (long long)r->seq, r->recv_ns[1] / 1.0e3);
+    fprintf(fp, "ID = %lld, chain_l1_end_us = %.2f us\n", (long long)r->seq, r->send_ns[1] / 1.0e3);
+    fprintf(fp, "ID = %lld, chain_l1_last_end_us = %.2f us\n", (long long)r->seq, r->last_end_ns / 1.0e3);
+    fprintf(fp, "ID = %lld, chain_prev_wake_us = %.2f us\n\n", (long long)r->seq, r->prev_wake_ns / 1.0e3);
+}
+
+// clock 보정 오차 상한 집계 (shm 변형은 항상 0이라 집계하지 않음)
+// 첫 offset 추정 전의 sample은 node마다 clock이 달라 latency가 의미 없으므로 세기만 하고 0을 반환 (기록하지 않음)
+static int chain_log_clock_add(const chain_log_rec_t *r)
+{
+    if (r->chain < 1 || r->chain > CHAIN_LOG_NUM_CHAINS || r->clock_err_ns == 0)
+        return 1;
+    if (r->clock_err_ns < 0)
+    {
+        chain_log.clock_unknown[r->chain]++;
+        return 0;
+    }
+    if (r->clock_err_ns > chain_log.clock_err_max[r->chain])
+        chain_log.clock_err_max[r->chain] = r->clock_err_ns;
+    chain_log.clock_err_sum[r->chain] += r->clock_err_ns;
+    chain_log.clock_err_n[r->chain]++;
+    return 1;
+}
+
+static void chain_log_clock_print(FILE *fp)
+{
+    for (int c = 1; c <= CHAIN_LOG_NUM_CHAINS; c++)
+    {
+        if (chain_log.clock_err_n[c] == 0 && chain_log.clock_unknown[c] == 0)
+            continue;
+        fprintf(fp, "[DASM] chain %d clock sync: E2E error bound mean %.1f us, max %.1f us (%llu samples, %llu before first estimate not logged)\n",
+                c, chain_log.clock_err_n[c] ? chain_log.clock_err_sum[c] / chain_log.clock_err_n[c] / 1.0e3 : 0.0,
+                chain_log.clock_err_max[c] / 1.0e3, (unsigned long long)chain_log.clock_err_n[c],
+                (unsigned long long)chain_log.clock_unknown[c]);
+    }
+}
+
+// 모아 둔 column buffer를 block 하나로 기록
+static void chain_log_bin_flush(int chain)
+{
+    int rows = chain_log.bin_rows[chain];
+    if (chain_log.bin_fp[chain] == NULL || rows == 0)
+        return;
+    int num_cols = chain_bin_num_cols(chain_log.bin_levels[chain]);
+    chain_bin_block_t b = {CHAIN_BIN_BLOCK_MAGIC, (uint32_t)rows};
+    fwrite(&b, sizeof(b), 1, chain_log.bin_fp[chain]);
+    for (int c = 0; c < num_cols; c++)
+        fwrite(chain_log.bin_cols[chain] + (size_t)c * CHAIN_BIN_BLOCK_ROWS, sizeof(int64_t), rows, chain_log.bin_fp[chain]);
+    chain_log.bin_rows[chain] = 0;
+}
+
+// record 한 개를 column buffer에 추가, block이 가득 차면 기록
+static void chain_log_bin_append(const chain_log_rec_t *r)
+{
+    int chain = r->chain;
+    if (chain < 1 || chain > CHAIN_LOG_NUM_CHAINS)
+        return;
+    if (chain_log.bin_fp[chain] == NULL)
+    {
+        char filename[64];
+        snprintf(filename, sizeof(filename), "log_Chain %d_%s.bin", chain, chain_log.suffix);
+        chain_log.bin_fp[chain] = fopen(filename, "wb");
+        chain_log.bin_cols[chain] = malloc(sizeof(int64_t) * CHAIN_BIN_MAX_COLS * CHAIN_BIN_BLOCK_ROWS);
+        if (chain_log.bin_fp[chain] == NULL || chain_log.bin_cols[chain] == NULL)
+        {
+            perror("[DASM] Failed to open binary chain log");
+            exit(EXIT_FAILURE);
+        }
+        chain_bin_header_t h;
+        chain_bin_init_header(&h, chain, r->levels);
+        fwrite(&h, sizeof(h), 1, chain_log.bin_fp[chain]);
+        chain_log.bin_levels[chain] = r->levels;
+    }
+
+    int levels = chain_log.bin_levels[chain];
+    int row = chain_log.bin_rows[chain];
+    int64_t *cols = chain_log.bin_cols[chain];
+    cols[row] = r->seq;
+    for (int lvl = levels; lvl >= 1; lvl--)
+    {
+        cols[(size_t)chain_bin_col(levels, lvl, CHAIN_BIN_WAKE) * CHAIN_BIN_BLOCK_ROWS + row] = r->wake_ns[lvl];
+        cols[(size_t)chain_bin_col(levels, lvl, CHAIN_BIN_RECV) * CHAIN_BIN_BLOCK_ROWS + row] = r->recv_ns[lvl];
+        cols[(size_t)chain_bin_col(levels, lvl, CHAIN_BIN_SEND) * CHAIN_BIN_BLOCK_ROWS + row] = r->send_ns[lvl];
+    }
+    cols[(size_t)chain_bin_extra_col(levels, CHAIN_BIN_LAST_END) * CHAIN_BIN_BLOCK_ROWS + row] = r->last_end_ns;
+    cols[(size_t)chain_bin_extra_col(levels, CHAIN_BIN_PREV_WAKE) * CHAIN_BIN_BLOCK_ROWS + row] = r->prev_wake_ns;
+    cols[(size_t)chain_bin_extra_col(levels, CHAIN_BIN_READS) * CHAIN_BIN_BLOCK_ROWS + row] = r->reads;
+    cols[(size_t)chain_bin_extra_col(levels, CHAIN_BIN_CLOCK_ERR) * CHAIN_BIN_BLOCK_ROWS + row] = r->clock_err_ns;
+    if (++chain_log.bin_rows[chain] == CHAIN_BIN_BLOCK_ROWS)
+        chain_log_bin_flush(chain);
+}
+
+// queue에 쌓인 record를 모두 파일 buffer로 옮긴 뒤 한 번에 flush
+static void chain_log_drain(void)
+{
+    uint64_t head = __atomic_load_n(&chain_log.head, __ATOMIC_ACQUIRE);
+    uint64_t tail = chain_log.tail;
+    if (tail == head)
+        return;
+    chain_stats_write_begin();
+    for (; tail < head; tail++)
+    {
+        const chain_log_rec_t *r = &chain_log.recs[tail & (CHAIN_LOG_CAPACITY - 1)];
+        if (!chain_log_clock_add(r))
+            continue; // 시각을 DASM clock으로 바꾸지 못한 sample (TCP 연결 직후)
+        chain_stats_add(r->chain, r->levels, r->wake_ns, r->recv_ns, r->send_ns, r->last_end_ns, r->prev_wake_ns);
+        if (chain_log.format & CHAIN_LOG_TEXT)
+        {
+            FILE *fp = chain_log_file(r->chain);
+            if (fp != NULL)
+                chain_log_format(fp, r);
+        }
+        if (chain_log.format & CHAIN_LOG_BINARY)
+            chain_log_bin_append(r);
+        chain_log.written++;
+    }
+    __atomic_store_n(&chain_log.tail, tail, __ATOMIC_RELEASE);
+    chain_stats_write_end(__atomic_load_n(&chain_log.dropped, __ATOMIC_RELAXED));
+
+    for (int c = 1; c <= CHAIN_LOG_NUM_CHAINS; c++)
+    {
+        if (chain_log.fp[c] == NULL)
+            continue;
+        fflush(chain_log.fp[c]);
+        if (chain_log.fsync_policy == CHAIN_LOG_FSYNC_BATCH)
+            fsync(fileno(chain_log.fp[c]));
+    }
+}
+
+static void chain_log_close(void)
+{
+    chain_log_drain();
+    for (int c = 1; c <= CHAIN_LOG_NUM_CHAINS; c++)
+    {
+        if (chain_log.bin_fp[c] != NULL)
+        {
+            chain_log_bin_flush(c); // 마지막 (덜 찬) block
+            fflush(chain_log.bin_fp[c]);
+            if (chain_log.fsync_policy != CHAIN_LOG_FSYNC_NONE)
+                fsync(fileno(chain_log.bin_fp[c]));
+            fclose(chain_log.bin_fp[c]);
+            chain_log.bin_fp[c] = NULL;
+        }
+        if (chain_log.fp[c] == NULL)
+            continue;
+        fflush(chain_log.fp[c]);
+        if (chain_log.fsync_policy != CHAIN_LOG_FSYNC_NONE)
+            fsync(fileno(chain_log.fp[c]));
+        fclose(chain_log.fp[c]);
+        chain_log.fp[c] = NULL;
+    }
+    printf("[DASM] chain log: %llu records written, %llu dropped\n",
+           (unsigned long long)chain_log.written,
+           (unsigned long long)__atomic_load_n(&chain_log.dropped, __ATOMIC_RELAXED));
+    chain_stats_print(stdout, chain_stats); // 최종 통계 (us)
+    chain_log_clock_print(stdout);
+    fflush(stdout);
+}
+
+static void chain_log_on_signal(int sig)
+{
+    (void)sig;
+    chain_log_stop = 1;
+}
+
+// logging thread: 실시간 우선순위를 물려받지 않도록 SCHED_OTHER로 낮춘 뒤 주기적으로 queue를 비움
+// 종료 신호(SIGTERM/SIGINT)를 받으면 남은 record를 모두 기록하고 process를 종료
+static void *chain_log_thread(void *arg)
+{
+    (void)arg;
+    struct sched_param param = {.sched_priority = 0};
+    pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    if (chain_log.log_core >= 0)
+    {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(chain_log.log_core, &cpuset);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0)
+            fprintf(stderr, "[DASM] chain log: cannot bind to core %d\n", chain_log.log_core);
+    }
+
+    struct timespec interval = {0, CHAIN_LOG_FLUSH_MS * 1000000L};
+    while (!chain_log_stop)
+    {
+        chain_log_drain();
+        nanosleep(&interval, NULL);
+    }
+    chain_log_close();
+    exit(EXIT_SUCCESS);
+    return NULL;
+}
+
+// logging thread 시작, suffix는 log 파일 이름의 변형 표시 ("shm" / "tcp")
+static inline void chain_log_start(const char *suffix)
+{
+    memset(&chain_log, 0, sizeof(chain_log));
+    snprintf(chain_log.suffix, sizeof(chain_log.suffix), "%s", suffix);
+
+    const char *env = getenv("WATERS_LOG_CORE");
+    chain_log.log_core = (env != NULL && *env != '\0') ? atoi(env) : -1;
+
+    env = getenv("WATERS_LOG_FSYNC");
+    if (env == NULL || *env == '\0' || strcmp(env, "none") == 0)
+        chain_log.fsync_policy = CHAIN_LOG_FSYNC_NONE;
+    else if (strcmp(env, "batch") == 0)
+        chain_log.fsync_policy = CHAIN_LOG_FSYNC_BATCH;
+    else if (strcmp(env, "close") == 0)
+        chain_log.fsync_policy = CHAIN_LOG_FSYNC_CLOSE;
+    else
+    {
+        fprintf(stderr, "[DASM] unknown WATERS_LOG_FSYNC '%s' (none|batch|close)\n", env);
+        exit(EXIT_FAILURE);
+    }
+
+    env = getenv("WATERS_LOG_FORMAT");
+    if (env == NULL || *env == '\0' || strcmp(env, "text") == 0)
+        chain_log.format = CHAIN_LOG_TEXT;
+    else if (strcmp(env, "binary") == 0)
+        chain_log.format = CHAIN_LOG_BINARY;
+    else if (strcmp(env, "both") == 0)
+        chain_log.format = CHAIN_LOG_TEXT | CHAIN_LOG_BINARY;
+    else
+    {
+        fprintf(stderr, "[DASM] unknown WATERS_LOG_FORMAT '%s' (text|binary|both)\n", env);
+        exit(EXIT_FAILURE);
+    }
+
+    chain_stats_create();
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = chain_log_on_signal;
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+
+    if (pthread_create(&chain_log.tid, NULL, chain_log_thread, NULL) != 0)
+    {
+        perror("[DASM] chain log pthread_create");
+        exit(EXIT_FAILURE);
+    }
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef CHAIN_MSG_H
+#define CHAIN_MSG_H
+
+// task 사이에 전달되는 chain message의 고정 layout (channel buffer의 앞 1280bytes, 1KB인 CAN channel은 chain 2 영역까지만)
+// chain_type(1~5)마다 256bytes, 그 안에서 chain_level(2~5)마다 64bytes slot 하나 (level 1인 DASM은 읽기만 함)
+//  offset = (chain_type - 1) * 256 + (chain_level - 2) * 64
+// slot (64bytes = cache line 하나, 16bytes 단위):
+//  [0-7]: seq (producer job마다 1씩 증가하는 64-bit 번호, 0은 아직 쓰지 않은 buffer)
+//  [8-15]: clock_ns (TCP 변형의 clock 동기화, rt_clock.h / 같은 host의 shm은 0)
+//  [16-31]: 주기가 깨는 시점 (wake)
+//  [32-47]: Task start 시점 (데이터를 모두 수신완료한 recv_time, edge task는 start)
+//  [48-63]: Task send 시점 (= Data 전송 시점)
+// offset 계산과 memcpy 대신 buffer를 chain_msg_t로 보고 slot을 직접 읽고 쓴다 (zero-copy view).
+// layout은 아래 _Static_assert로 고정되어, 크기나 위치가 바뀌면 compile이 실패한다.
+// buffer는 64bytes 정렬이어야 함: shm mapping / rt_mem_alloc은 page 정렬, 지역 / 전역 배열은 CHAIN_MSG_ALIGNED
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#define CHAIN_MSG_TYPES 5          // chain_type 1~5
+#define CHAIN_MSG_FIRST_LEVEL 2    // slot이 있는 chain_level 2~5
+#define CHAIN_MSG_LAST_LEVEL 5
+#define CHAIN_MSG_LEVELS (CHAIN_MSG_LAST_LEVEL - CHAIN_MSG_FIRST_LEVEL + 1)
+#define CHAIN_MSG_SLOT_SIZE 64
+#define CHAIN_MSG_CHAIN_SIZE (CHAIN_MSG_LEVELS * CHAIN_MSG_SLOT_SIZE)
+#define CHAIN_MSG_SIZE (CHAIN_MSG_TYPES * CHAIN_MSG_CHAIN_SIZE)
+#define CHAIN_MSG_ALIGNED __attribute__((aligned(CHAIN_MSG_SLOT_SIZE)))
+
+// chain을 시작하는 task의 level (chain 1,2: Lidar_grabber / CAN, chain 3~5: SFM / Lane_detection / Detection)
+#define CHAIN_MSG_SOURCE_LEVEL(type) ((type) <= 2 ? 5 : 3)
+
+typedef struct
+{
+    uint64_t seq;
+    int64_t clock_ns;
+
+    int64_t wake_sec;
+    int64_t wake_nsec;
+
+    int64_t recv_sec;
+    int64_t recv_nsec;
+
+    int64_t send_sec;
+    int64_t send_nsec;
+} CHAIN_MSG_ALIGNED chain_slot_t;
+
+typedef struct
+{
+    chain_slot_t slot[CHAIN_MSG_LEVELS]; // slot[chain_level - 2]
+} chain_msg_chain_t;
+
+typedef struct
+{
+    chain_msg_chain_t chain[CHAIN_MSG_TYPES]; // chain[chain_type - 1]
+} chain_msg_t;
+
+_Static_assert(sizeof(chain_slot_t) == CHAIN_MSG_SLOT_SIZE, "chain slot must be one 64-byte cache line");
+_Static_assert(_Alignof(chain_slot_t) == CHAIN_MSG_SLOT_SIZE, "chain slot must be cache-line aligned");
+_Static_assert(offsetof(chain_slot_t, seq) == 0, "seq must start at byte 0");
+_Static_assert(offsetof(chain_slot_t, clock_ns) == 8, "clock_ns must start at byte 8");
+_Static_assert(offsetof(chain_slot_t, wake_sec) == 16, "wake must start at byte 16");
+_Static_assert(offsetof(chain_slot_t, recv_sec) == 32, "recv must start at byte 32");
+_Static_assert(offsetof(chain_slot_t, send_sec) == 48, "send must start at byte 48");
+_Static_assert(sizeof(chain_msg_chain_t) == CHAIN_MSG_CHAIN_SIZE, "chain area must be 256 bytes");
+_Static_assert(sizeof(chain_msg_t) == CHAIN_MSG_SIZE, "chain message must be 5 x 256 bytes");
+
+// channel buffer 크기 검사 (task의 크기 / chain_type 정의 뒤에 사용)
+// 보통의 channel buffer는 chain message 전체(1280bytes)를 담음: CHAIN_MSG_ASSERT_FITS(OUTPUT_SIZE_B)
+#define CHAIN_MSG_ASSERT_FITS(size) \
+    _Static_assert((size) >= CHAIN_MSG_SIZE, #size " must hold a whole chain message")
+// 예외: CAN channel(1KB)은 자기 chain 2 영역(256 ~ 511)까지만 담음. 이런 buffer는 자기 chain의 slot만 읽고 쓰며
+// chain message 전체를 복사하거나 다른 chain 영역에 접근하면 안 됨: CHAIN_MSG_ASSERT_FITS_CHAIN(OUTPUT_SIZE_B, chain_type)
+#define CHAIN_MSG_ASSERT_FITS_CHAIN(size, type) \
+    _Static_assert((size) >= (type) * CHAIN_MSG_CHAIN_SIZE, #size " must hold its chain area")
+
+// 상수 조건 검사: 거짓이면 음수 bit-field로 compile error, 상수가 아니어도 compile error
+#define CHAIN_MSG_CHECK(cond) (0 * sizeof(struct { int chain_msg_check : (cond) ? 1 : -1; }))
+#define CHAIN_MSG_TYPE_INDEX(type) ((type) - 1 + CHAIN_MSG_CHECK((type) >= 1 && (type) <= CHAIN_MSG_TYPES))
+#define CHAIN_MSG_LEVEL_INDEX(level) \
+    ((level) - CHAIN_MSG_FIRST_LEVEL + CHAIN_MSG_CHECK((level) >= CHAIN_MSG_FIRST_LEVEL && (level) <= CHAIN_MSG_LAST_LEVEL))
+
+// 상수 chain_type의 chain 영역 (256bytes), 예: *CHAIN_OF(out, chain_type_1) = *CHAIN_OF(in, chain_type_1)
+#define CHAIN_OF(msg, type) (&(msg)->chain[CHAIN_MSG_TYPE_INDEX(type)])
+// chain 영역 하나 안에서 상수 chain_level의 slot
+#define CHAIN_LEVEL(ch, level) (&(ch)->slot[CHAIN_MSG_LEVEL_INDEX(level)])
+// 상수 chain_type / chain_level의 slot, 예: CHAIN_SLOT(msg, chain_type, chain_level)
+#define CHAIN_SLOT(msg, type, level) CHAIN_LEVEL(CHAIN_OF(msg, type), level)
+
+// channel buffer를 message로 보기 (복사 없음)
+static inline chain_msg_t *chain_msg(void *buf)
+{
+    return (chain_msg_t *)buf;
+}
+
+static inline const chain_msg_t *chain_msg_const(const void *buf)
+{
+    return (const chain_msg_t *)buf;
+}
+
+// 실행 중에 정해지는 level의 slot (2 <= level <= 5)
+static inline const chain_slot_t *chain_msg_level(const chain_msg_chain_t *ch, int level)
+{
+    return &ch->slot[level - CHAIN_MSG_FIRST_LEVEL];
+}
+
+// chain을 시작한 task(Lidar_grabber / CAN / SFM / Lane_detection / Detection)의 slot (1 <= type <= 5)
+static inline const chain_slot_t *chain_msg_source(const chain_msg_t *msg, int type)
+{
+    return chain_msg_level(&msg->chain[type - 1], CHAIN_MSG_SOURCE_LEVEL(type));
+}
+
+// 자기 slot 작성: seq와 wake / recv / send 시각, clock_ns는 0 (TCP producer는 이어서 rt_clock_stamp)
+static inline void chain_slot_set(chain_slot_t *slot, uint64_t seq, const struct timespec *wake,
+                                  const struct timespec *recv, const struct timespec *send)
+{
+    slot->seq = seq;
+    slot->clock_ns = 0;
+    slot->wake_sec = wake->tv_sec;
+    slot->wake_nsec = wake->tv_nsec;
+    slot->recv_sec = recv->tv_sec;
+    slot->recv_nsec = recv->tv_nsec;
+    slot->send_sec = send->tv_sec;
+    slot->send_nsec = send->tv_nsec;
+}
+
+#endif
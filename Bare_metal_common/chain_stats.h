@@ -0,0 +1,199 @@
+#ifndef CHAIN_STATS_H
+#define CHAIN_STATS_H
+
+// DASM 실시간 latency 통계 (shared memory /waters_dasm_stats, instance마다 rt_instance.h 규칙으로 이름이 다름)
+// DASM의 logging thread(chain_log.h)가 record를 파일에 쓰면서 chain별 histogram(rt_hist.h)도 갱신한다.
+//  - E2E latency / Execution time / Waiting time (analysis2.py와 같은 정의)
+//  - Reaction time / Data age (cause-effect chain 정의, chain_log.h의 sample 추적 참고)
+//  - 외부 도구(Bare_metal_tools/stats_view.c)는 read-only로 mmap해서 원하는 때에 읽음
+//  - writer 하나(logging thread)와 여러 reader 사이는 seqlock으로 동기화:
+//    writer는 batch 갱신 전후로 seq를 1씩 증가(홀수 = 갱신 중), reader는 seq가 짝수이고 복사 전후가 같을 때만 사용
+//  실시간 thread(DASM runnable)는 이 segment를 건드리지 않음
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "rt_hist.h"
+#include "rt_instance.h"
+
+#define CHAIN_STATS_SHM_NAME "/waters_dasm_stats"
+#define CHAIN_STATS_MAGIC 0x57535454 // "WSTT"
+#define CHAIN_STATS_NUM_CHAINS 5
+
+enum
+{
+    CHAIN_STATS_E2E = 0,
+    CHAIN_STATS_EXEC,
+    CHAIN_STATS_WAIT,
+    CHAIN_STATS_REACTION,
+    CHAIN_STATS_AGE,
+    CHAIN_STATS_NUM_METRICS
+};
+
+static const char *chain_stats_metric_names[CHAIN_STATS_NUM_METRICS] = {"E2E latency", "Execution time", "Waiting time",
+                                                                        "Reaction time", "Data age"};
+
+typedef struct
+{
+    int32_t levels;
+    int32_t reserved;
+    uint64_t invalid; // 초기화 전 data(시각 0)라 통계에서 제외한 record 수
+    rt_hist_t hist[CHAIN_STATS_NUM_METRICS];
+} chain_stats_chain_t;
+
+typedef struct
+{
+    uint32_t magic;
+    int32_t pid;
+    _Alignas(64) uint64_t seq; // seqlock
+    int64_t start_ns;          // 통계 시작 시각 (CLOCK_MONOTONIC)
+    int64_t updated_ns;        // 마지막 갱신 시각
+    uint64_t dropped;          // DASM queue에서 버려진 record 수 (통계에도 빠짐)
+    chain_stats_chain_t chains[CHAIN_STATS_NUM_CHAINS + 1]; // 1 ~ 5 사용
+} chain_stats_t;
+
+static chain_stats_t *chain_stats;
+
+static inline int64_t chain_stats_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// writer: stats segment 생성 (logging thread 시작 전에 한 번)
+static inline void chain_stats_create(void)
+{
+    shm_unlink(rt_instance_name(CHAIN_STATS_SHM_NAME));
+    int fd = shm_open(rt_instance_name(CHAIN_STATS_SHM_NAME), O_CREAT | O_RDWR, 0644);
+    if (fd == -1)
+    {
+        perror("stats_shm_open");
+        exit(EXIT_FAILURE);
+    }
+    if (ftruncate(fd, sizeof(chain_stats_t)) == -1)
+    {
+        perror("stats_ftruncate");
+        exit(EXIT_FAILURE);
+    }
+    chain_stats = mmap(NULL, sizeof(chain_stats_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (chain_stats == MAP_FAILED)
+    {
+        perror("stats_mmap");
+        exit(EXIT_FAILURE);
+    }
+    memset(chain_stats, 0, sizeof(chain_stats_t));
+    for (int c = 0; c <= CHAIN_STATS_NUM_CHAINS; c++)
+        for (int m = 0; m < CHAIN_STATS_NUM_METRICS; m++)
+            rt_hist_reset(&chain_stats->chains[c].hist[m]);
+    chain_stats->pid = getpid();
+    chain_stats->start_ns = chain_stats_now_ns();
+    __atomic_store_n(&chain_stats->magic, CHAIN_STATS_MAGIC, __ATOMIC_RELEASE);
+}
+
+static inline void chain_stats_write_begin(void)
+{
+    __atomic_store_n(&chain_stats->seq, chain_stats->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void chain_stats_write_end(uint64_t dropped)
+{
+    chain_stats->dropped = dropped;
+    chain_stats->updated_ns = chain_stats_now_ns();
+    __atomic_store_n(&chain_stats->seq, chain_stats->seq + 1, __ATOMIC_RELEASE);
+}
+
+// record 하나 반영 (write_begin ~ write_end 사이에서 호출), 시각은 ns
+// wake/recv/send 배열은 chain_log_rec_t와 같은 level 번호 (1 = DASM, send[1] = end)
+// last_end: sample을 마지막으로 읽은 DASM job의 end, prev_wake: 직전 sample의 시작 wake (없으면 0, reaction은 기록하지 않음)
+static inline void chain_stats_add(int chain, int levels, const int64_t *wake, const int64_t *recv, const int64_t *send,
+                                   int64_t last_end, int64_t prev_wake)
+{
+    if (chain < 1 || chain > CHAIN_STATS_NUM_CHAINS)
+        return;
+    chain_stats_chain_t *cs = &chain_stats->chains[chain];
+    cs->levels = levels;
+    if (wake[levels] == 0 || recv[1] == 0)
+    {
+        cs->invalid++;
+        return;
+    }
+    int64_t e2e = send[1] - wake[levels];
+    int64_t exec = 0;
+    for (int lvl = levels; lvl >= 1; lvl--)
+        exec += send[lvl] - recv[lvl];
+    rt_hist_record(&cs->hist[CHAIN_STATS_E2E], e2e);
+    rt_hist_record(&cs->hist[CHAIN_STATS_EXEC], exec);
+    rt_hist_record(&cs->hist[CHAIN_STATS_WAIT], e2e - exec);
+    // 직전 sample이 없으면(첫 sample, clock 보정 전 sample 다음) reaction time을 알 수 없으므로 세지 않음 (text log는 0)
+    if (prev_wake != 0)
+        rt_hist_record(&cs->hist[CHAIN_STATS_REACTION], send[1] - prev_wake);
+    rt_hist_record(&cs->hist[CHAIN_STATS_AGE], last_end - wake[levels]);
+}
+
+// reader: read-only로 연결, 없으면 NULL
+static inline const chain_stats_t *chain_stats_attach(void)
+{
+    int fd = shm_open(rt_instance_name(CHAIN_STATS_SHM_NAME), O_RDONLY, 0);
+    if (fd == -1)
+        return NULL;
+    const chain_stats_t *s = mmap(NULL, sizeof(chain_stats_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (s == MAP_FAILED)
+        return NULL;
+    if (__atomic_load_n(&s->magic, __ATOMIC_ACQUIRE) != CHAIN_STATS_MAGIC)
+    {
+        munmap((void *)s, sizeof(chain_stats_t));
+        return NULL;
+    }
+    return s;
+}
+
+// reader: 일관된 snapshot 복사 (writer가 갱신 중이면 다시 시도)
+static inline void chain_stats_snapshot(const chain_stats_t *s, chain_stats_t *out)
+{
+    for (;;)
+    {
+        uint64_t seq1 = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+        if (seq1 & 1)
+        {
+            sched_yield();
+            continue;
+        }
+        memcpy(out, (const void *)s, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&s->seq, __ATOMIC_RELAXED) == seq1)
+            return;
+    }
+}
+
+// chain별 통계 표 출력 (us 단위)
+static inline void chain_stats_print(FILE *fp, const chain_stats_t *s)
+{
+    fprintf(fp, "%-6s %-15s %10s %10s %10s %10s %10s %10s\n", "chain", "metric", "count", "mean", "p50", "p99",
+            "p99.9", "max");
+    for (int c = 1; c <= CHAIN_STATS_NUM_CHAINS; c++)
+    {
+        const chain_stats_chain_t *cs = &s->chains[c];
+        if (cs->hist[CHAIN_STATS_E2E].count == 0)
+            continue;
+        for (int m = 0; m < CHAIN_STATS_NUM_METRICS; m++)
+        {
+            const rt_hist_t *h = &cs->hist[m];
+            fprintf(fp, "%-6d %-15s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", c, chain_stats_metric_names[m],
+                    (unsigned long long)h->count, rt_hist_mean(h) / 1.0e3, rt_hist_percentile(h, 50.0) / 1.0e3,
+                    rt_hist_percentile(h, 99.0) / 1.0e3, rt_hist_percentile(h, 99.9) / 1.0e3, h->max / 1.0e3);
+        }
+    }
+}
+
+#endif
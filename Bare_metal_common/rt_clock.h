@@ -0,0 +1,307 @@
+#ifndef RT_CLOCK_H
+#define RT_CLOCK_H
+
+// node 사이 clock offset / drift 추정 (TCP 변형)
+// 모든 시각은 CLOCK_MONOTONIC이라 한 host 안에서만 비교할 수 있다. task가 서로 다른 node(VM, ECU)에 있으면
+// DASM이 계산하는 E2E(chain_l1_end - chain_lL_wake)에 두 clock의 차이가 그대로 더해진다.
+// 기존 TCP link의 양방향을 이용해 NTP와 같은 방식으로 link마다 offset을 추정하고, consumer가 받은 시각을 자기 clock으로 옮긴다.
+//  - 정방향 sample: producer slot의 send(t1) -> consumer copy thread에 frame 첫 byte 도착(t2), fwd = t2 - t1 = 지연 + offset
+//    (frame 전체의 수신 완료를 쓰면 fwd에만 전송 시간이 더해져 offset이 그 절반만큼 치우침, 역방향 ping과 같은 작은 전송으로 맞춤)
+//  - 역방향 sample: consumer가 frame마다 보내는 ping(t3) -> producer clock thread의 수신(t4), rev = t4 - t3 = 지연 - offset
+//    producer는 최근 rev를 다음 frame의 자기 slot(clock_ns)에 실어 보냄 (frame 형식은 그대로, 역방향은 원래 쓰지 않던 방향)
+//  - RT_CLOCK_WINDOW개 frame마다 방향별 최솟값으로 offset = (fwd - rev) / 2, 오차 상한 = (fwd + rev) / 2
+//    (최소 지연 sample만 쓰므로 queueing 지연의 영향이 작고, 상한은 두 방향 지연이 얼마나 비대칭이어도 성립)
+//  - drift: window마다 offset 변화 / 경과 시간의 지수 평균, 변환할 때 마지막 추정 시각부터 선형 외삽
+//  - consumer는 받은 message에서 producer와 그 윗단 slot의 시각에 offset을 더하고, slot의 clock_ns를 누적 오차 상한으로 바꾼다
+//    (hop마다 상한이 더해짐, RT_CLOCK_UNKNOWN은 첫 추정 전). DASM에서는 모든 slot이 DASM clock 기준이고,
+//    chain 시작 slot의 clock_ns가 E2E의 오차 상한이다.
+// 보정은 link가 node를 건널 때만 적용 (peer 주소가 자기 주소와 다름: 다른 network namespace / host).
+// 같은 host의 task는 CLOCK_MONOTONIC을 함께 쓰므로 시각을 그대로 두고 offset / 오차 상한을 0으로 (기존 결과와 비교 가능).
+// WATERS_CLOCK_SYNC=1 / 0으로 강제로 켜고 끌 수 있고, WATERS_CLOCK_SKEW_* 가 있으면 켬.
+// 한 host에서 시험할 때는 WATERS_CLOCK_SKEW_<task 이름>=<offset_us>[,<drift_ppm>]로 task의 clock을 흉내 낸다.
+// (wire로 나가는 시각과 DASM의 시각에만 적용, release / sleep은 실제 clock 그대로)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "chain_msg.h"
+
+#define RT_CLOCK_MAGIC 0x57434c4b // "WCLK"
+#define RT_CLOCK_WINDOW 32        // 추정 한 번에 쓰는 frame 수
+#define RT_CLOCK_DRIFT_WEIGHT 0.25
+#define RT_CLOCK_UNKNOWN (-1)     // slot clock_ns: 아직 offset을 추정하지 못한 hop을 거침
+
+// consumer -> producer (역방향)
+typedef struct
+{
+    uint32_t magic;
+    uint32_t n;
+    int64_t t3_ns;
+} rt_clock_ping_t;
+
+// producer 쪽: link 하나의 역방향 sample
+typedef struct
+{
+    int sock;
+    int64_t rev_ns; // 최근 t4 - t3 (0: 아직 없음), clock thread가 쓰고 runnable이 읽음
+    pthread_t tid;
+} rt_clock_peer_t;
+
+// consumer 쪽: link 하나의 추정 상태 (copy thread만 사용)
+typedef struct
+{
+    int level;           // producer의 chain_level
+    uint32_t chain_mask; // link로 오는 chain (bit c = chain c)
+    int64_t win_fwd;     // 현재 window의 최소 fwd / rev
+    int64_t win_rev;
+    int win_n;
+    int valid;
+    int sock;            // enabled를 판정한 연결 (재연결하면 다시 판정)
+    int enabled;         // 0: 같은 node, 보정하지 않음
+    int64_t offset_ns; // producer clock + offset = consumer clock (est_ns 시점)
+    int64_t err_ns;
+    int64_t est_ns;    // 마지막 추정 시각 (consumer clock)
+    double drift;      // offset 변화율 (ns/ns)
+    uint32_t windows;
+    uint32_t pings;
+} rt_clock_link_t;
+
+typedef struct
+{
+    int64_t offset_ns;
+    double drift;
+} rt_clock_skew_t;
+
+// WATERS_CLOCK_SKEW_<WATERS_TASK>: 흉내 낸 clock (없으면 실제 clock)
+static inline const rt_clock_skew_t *rt_clock_skew(void)
+{
+    static rt_clock_skew_t skew;
+    static int loaded = 0;
+    if (!loaded)
+    {
+        loaded = 1;
+        const char *task = getenv("WATERS_TASK");
+        char name[64];
+        snprintf(name, sizeof(name), "WATERS_CLOCK_SKEW_%s", task != NULL ? task : "");
+        const char *env = getenv(name);
+        if (task != NULL && env != NULL && *env != '\0')
+        {
+            char *end;
+            skew.offset_ns = (int64_t)(strtod(env, &end) * 1000.0);
+            if (*end == ',')
+                skew.drift = strtod(end + 1, NULL) / 1.0e6;
+        }
+    }
+    return &skew;
+}
+
+static inline int64_t rt_clock_local_ns(int64_t mono_ns)
+{
+    const rt_clock_skew_t *s = rt_clock_skew();
+    return mono_ns + s->offset_ns + (int64_t)(mono_ns * s->drift);
+}
+
+static inline int64_t rt_clock_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return rt_clock_local_ns((int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+}
+
+static inline int64_t rt_clock_get(int64_t sec, int64_t nsec)
+{
+    return sec * 1000000000LL + nsec;
+}
+
+static inline void rt_clock_put(int64_t ns, int64_t *sec, int64_t *nsec)
+{
+    *sec = ns / 1000000000LL;
+    *nsec = ns % 1000000000LL;
+}
+
+// producer clock thread: ping을 받을 때마다 rev 갱신
+// 연결마다 thread 하나, socket은 dup한 자기 fd만 씀 (재연결로 원래 fd가 닫히고 번호가 재사용되어도 안전)
+typedef struct
+{
+    rt_clock_peer_t *p;
+    int fd;
+} rt_clock_peer_arg_t;
+
+static inline void *rt_clock_peer_thread(void *arg)
+{
+    rt_clock_peer_arg_t a = *(rt_clock_peer_arg_t *)arg;
+    free(arg);
+    rt_clock_ping_t ping;
+    while (recv(a.fd, &ping, sizeof(ping), MSG_WAITALL) == (ssize_t)sizeof(ping))
+    {
+        int64_t t4 = rt_clock_now_ns();
+        if (ping.magic == RT_CLOCK_MAGIC)
+            __atomic_store_n(&a.p->rev_ns, t4 - ping.t3_ns, __ATOMIC_RELAXED);
+    }
+    close(a.fd);
+    return NULL; // 연결 종료 (끊긴 socket은 shutdown으로 깨움, rt_link.h)
+}
+
+// producer: consumer에 연결한 직후 호출, 재연결하면 새 socket으로 다시 호출
+// (clock thread는 호출한 thread의 우선순위를 물려받음)
+static inline void rt_clock_peer_start(rt_clock_peer_t *p, int sock)
+{
+    rt_clock_peer_arg_t *a = malloc(sizeof(*a));
+    if (a == NULL || (a->fd = dup(sock)) < 0)
+    {
+        perror("rt_clock_peer_start");
+        exit(EXIT_FAILURE);
+    }
+    a->p = p;
+    p->sock = sock;
+    __atomic_store_n(&p->rev_ns, 0, __ATOMIC_RELAXED); // 이전 연결의 sample은 버림
+    if (pthread_create(&p->tid, NULL, rt_clock_peer_thread, a) != 0)
+    {
+        perror("rt_clock_peer_start");
+        exit(EXIT_FAILURE);
+    }
+    pthread_detach(p->tid);
+}
+
+// producer: chain_slot_set 직후 자기 slot을 wire 형식으로 (흉내 낸 clock 적용, 최근 rev 기록)
+static inline void rt_clock_stamp(rt_clock_peer_t *p, chain_slot_t *slot)
+{
+    slot->clock_ns = __atomic_load_n(&p->rev_ns, __ATOMIC_RELAXED);
+    const rt_clock_skew_t *s = rt_clock_skew();
+    if (s->offset_ns == 0 && s->drift == 0)
+        return;
+    rt_clock_put(rt_clock_local_ns(rt_clock_get(slot->wake_sec, slot->wake_nsec)), &slot->wake_sec, &slot->wake_nsec);
+    rt_clock_put(rt_clock_local_ns(rt_clock_get(slot->recv_sec, slot->recv_nsec)), &slot->recv_sec, &slot->recv_nsec);
+    rt_clock_put(rt_clock_local_ns(rt_clock_get(slot->send_sec, slot->send_nsec)), &slot->send_sec, &slot->send_nsec);
+}
+
+static inline void rt_clock_link_init(rt_clock_link_t *l, int producer_level, uint32_t chain_mask)
+{
+    memset(l, 0, sizeof(*l));
+    l->sock = -1;
+    l->level = producer_level;
+    l->chain_mask = chain_mask;
+    l->win_fwd = INT64_MAX;
+    l->win_rev = INT64_MAX;
+}
+
+// link 보정 여부: WATERS_CLOCK_SYNC가 있으면 그 값, WATERS_CLOCK_SKEW_*가 있으면 켬, 아니면 node를 건너는 연결만
+static inline int rt_clock_link_crosses(int sock)
+{
+    extern char **environ;
+    const char *env = getenv("WATERS_CLOCK_SYNC");
+    if (env != NULL && *env != '\0')
+        return atoi(env) != 0;
+    for (char **e = environ; *e != NULL; e++)
+        if (strncmp(*e, "WATERS_CLOCK_SKEW_", 18) == 0)
+            return 1;
+    struct sockaddr_in self, peer;
+    socklen_t self_len = sizeof(self), peer_len = sizeof(peer);
+    if (getsockname(sock, (struct sockaddr *)&self, &self_len) < 0 ||
+        getpeername(sock, (struct sockaddr *)&peer, &peer_len) < 0 || self.sin_family != AF_INET)
+        return 0;
+    return self.sin_addr.s_addr != peer.sin_addr.s_addr;
+}
+
+// producer clock의 시각을 consumer clock으로
+static inline int64_t rt_clock_link_map(const rt_clock_link_t *l, int64_t t)
+{
+    int64_t local = t + l->offset_ns;
+    return local + (int64_t)((local - l->est_ns) * l->drift);
+}
+
+// window의 최솟값으로 추정 (commit이면 drift 갱신 후 window를 비움)
+static inline void rt_clock_link_estimate(rt_clock_link_t *l, int64_t now, int commit)
+{
+    if (l->win_fwd != INT64_MAX && l->win_rev != INT64_MAX)
+    {
+        int64_t offset = (l->win_fwd - l->win_rev) / 2;
+        int64_t err = (l->win_fwd + l->win_rev) / 2;
+        if (commit && l->windows > 0 && now > l->est_ns)
+        {
+            double d = (double)(offset - l->offset_ns) / (double)(now - l->est_ns);
+            l->drift = (l->windows == 1) ? d : l->drift + RT_CLOCK_DRIFT_WEIGHT * (d - l->drift);
+        }
+        l->offset_ns = offset;
+        l->err_ns = err < 0 ? 0 : err;
+        l->est_ns = now;
+        l->valid = 1;
+        if (commit)
+            l->windows++;
+    }
+    if (commit)
+    {
+        l->win_fwd = INT64_MAX;
+        l->win_rev = INT64_MAX;
+        l->win_n = 0;
+    }
+}
+
+// consumer copy thread: frame 하나를 받은 직후 호출 (msg는 받은 local copy, 시각을 이 task의 clock으로 바꿈)
+// t2는 frame 첫 byte의 도착 시각 (rt_clock_now_ns 기준, rt_link_rx_t의 first_ns)
+static inline void rt_clock_link_recv(rt_clock_link_t *l, int sock, chain_msg_t *msg, int64_t t2)
+{
+    int first = __builtin_ctz(l->chain_mask);
+    if (sock != l->sock)
+    {
+        l->sock = sock;
+        l->enabled = rt_clock_link_crosses(sock);
+    }
+    if (!l->enabled)
+    {
+        // 같은 clock: 시각은 그대로, producer slot의 clock_ns(실려 온 rev)는 오차 0으로
+        for (int c = 1; c <= CHAIN_MSG_TYPES; c++)
+            if (l->chain_mask & (1u << c))
+                msg->chain[c - 1].slot[l->level - CHAIN_MSG_FIRST_LEVEL].clock_ns = 0;
+        return;
+    }
+    const chain_slot_t *own = &msg->chain[first - 1].slot[l->level - CHAIN_MSG_FIRST_LEVEL];
+    if (own->seq != 0)
+    {
+        int64_t fwd = t2 - rt_clock_get(own->send_sec, own->send_nsec);
+        if (fwd < l->win_fwd)
+            l->win_fwd = fwd;
+        if (own->clock_ns != 0 && own->clock_ns < l->win_rev)
+            l->win_rev = own->clock_ns;
+        if (++l->win_n == RT_CLOCK_WINDOW)
+            rt_clock_link_estimate(l, t2, 1);
+        else if (!l->valid)
+            rt_clock_link_estimate(l, t2, 0); // 첫 window가 끝나기 전의 임시 추정
+    }
+
+    for (int c = 1; c <= CHAIN_MSG_TYPES; c++)
+    {
+        if (!(l->chain_mask & (1u << c)))
+            continue;
+        for (int level = l->level; level <= CHAIN_MSG_SOURCE_LEVEL(c); level++)
+        {
+            chain_slot_t *s = &msg->chain[c - 1].slot[level - CHAIN_MSG_FIRST_LEVEL];
+            if (s->seq == 0)
+                continue;
+            if (!l->valid)
+            {
+                s->clock_ns = RT_CLOCK_UNKNOWN;
+                continue;
+            }
+            rt_clock_put(rt_clock_link_map(l, rt_clock_get(s->wake_sec, s->wake_nsec)), &s->wake_sec, &s->wake_nsec);
+            rt_clock_put(rt_clock_link_map(l, rt_clock_get(s->recv_sec, s->recv_nsec)), &s->recv_sec, &s->recv_nsec);
+            rt_clock_put(rt_clock_link_map(l, rt_clock_get(s->send_sec, s->send_nsec)), &s->send_sec, &s->send_nsec);
+            if (level == l->level)
+                s->clock_ns = l->err_ns; // producer 자기 slot: 실려 온 값은 rev
+            else if (s->clock_ns != RT_CLOCK_UNKNOWN)
+                s->clock_ns += l->err_ns;
+        }
+    }
+
+    rt_clock_ping_t ping = {RT_CLOCK_MAGIC, ++l->pings, rt_clock_now_ns()};
+    send(sock, &ping, sizeof(ping), MSG_DONTWAIT | MSG_NOSIGNAL); // 실패하면 이번 sample만 빠짐
+}
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef RT_CONTROL_H
+#define RT_CONTROL_H
+
+// launcher <-> task 제어용 공통 헤더
+// launcher(Bare_metal_tools/launcher.c)가 실험 시작 전에 제어용 shared memory를 만들고,
+// 각 task는 ready를 알린 뒤 launcher가 공지하는 공통 epoch까지 대기한다 (start barrier).
+// 이후 k번째 release 시각은 epoch + offset + k * period 로 계산하므로,
+// task 사이의 위상(phase)은 실험마다, transport 변형(shm/tcp)마다 동일하다.
+// launcher 없이 단독 실행하면 (WATERS_CTRL 환경변수 없음) 현재 시각을 epoch으로 사용한다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "rt_mem.h"
+
+#define RT_CTRL_MAGIC 0x57415452      // "WATR"
+#define RT_CTRL_SHM_NAME "/waters_ctrl_shm"
+#define RT_CTRL_POLL_NS 200000        // 시작 시각 공지를 기다리는 polling 간격 (200us)
+
+// 제어용 shared memory 구조체
+// ready, stop, epoch_ns는 여러 process가 동시에 접근하므로 __atomic builtin으로만 읽고 씀
+typedef struct
+{
+    uint32_t magic;
+    int32_t expected; // launcher가 띄운 task 개수
+    int32_t ready;    // ready를 알린 task 개수
+    int32_t stop;     // launcher가 종료를 요청하면 1
+    int64_t epoch_ns; // 공통 release 기준 시각 (CLOCK_MONOTONIC, ns), 0이면 아직 공지 전
+} rt_ctrl_t;
+
+// task별 주기 release 계산용 구조체
+typedef struct
+{
+    int64_t epoch_ns;  // 공통 epoch
+    int64_t offset_ns; // task별 위상 offset (WATERS_OFFSET_US)
+    int64_t period_ns; // 주기
+    int64_t k;         // 현재 job 번호 (epoch 이후 k번째 release)
+} rt_release_t;
+
+static inline int64_t rt_timespec_to_ns(const struct timespec *ts)
+{
+    return (int64_t)ts->tv_sec * 1000000000LL + ts->tv_nsec;
+}
+
+static inline void rt_ns_to_timespec(int64_t ns, struct timespec *ts)
+{
+    ts->tv_sec = ns / 1000000000LL;
+    ts->tv_nsec = ns % 1000000000LL;
+}
+
+static inline int64_t rt_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return rt_timespec_to_ns(&now);
+}
+
+// launcher가 WATERS_CORE로 core를 지정했으면 그 값을, 아니면 source에 적힌 기본 core를 사용
+static inline int rt_core_from_env(int default_core)
+{
+    const char *env = getenv("WATERS_CORE");
+    if (env == NULL || *env == '\0')
+        return default_core;
+    return atoi(env);
+}
+
+// WATERS_CTRL 환경변수에 적힌 제어용 shared memory를 연결, 없으면 NULL
+static inline rt_ctrl_t *rt_ctrl_attach(void)
+{
+    static rt_ctrl_t *ctrl = NULL;
+    if (ctrl != NULL)
+        return ctrl;
+
+    const char *name = getenv("WATERS_CTRL");
+    if (name == NULL || *name == '\0')
+        return NULL;
+
+    int fd = shm_open(name, O_RDWR, 0666);
+    if (fd == -1)
+    {
+        perror("ctrl_shm_open");
+        exit(EXIT_FAILURE);
+    }
+    rt_ctrl_t *p = mmap(NULL, sizeof(rt_ctrl_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+    {
+        perror("ctrl_mmap");
+        exit(EXIT_FAILURE);
+    }
+    if (p->magic != RT_CTRL_MAGIC)
+    {
+        fprintf(stderr, "ctrl shm %s: magic mismatch\n", name);
+        exit(EXIT_FAILURE);
+    }
+    ctrl = p;
+    return ctrl;
+}
+
+// WATERS_OFFSET_US 환경변수로 지정한 task의 위상 offset (us), 없으면 0
+static inline int64_t rt_offset_from_env(void)
+{
+    const char *env = getenv("WATERS_OFFSET_US");
+    if (env == NULL || *env == '\0')
+        return 0;
+    return atoll(env) * 1000LL;
+}
+
+// start barrier: ready를 알리고 launcher가 epoch을 공지할 때까지 대기한 뒤 epoch을 반환
+// launcher 없이 실행한 경우에는 현재 시각을 epoch으로 사용 (기존 동작)
+static inline int64_t rt_ctrl_wait_epoch(void)
+{
+    rt_ctrl_t *ctrl = rt_ctrl_attach();
+    if (ctrl == NULL)
+        return rt_now_ns();
+
+    __atomic_add_fetch(&ctrl->ready, 1, __ATOMIC_ACQ_REL);
+
+    struct timespec poll = {0, RT_CTRL_POLL_NS};
+    int64_t epoch_ns;
+    while ((epoch_ns = __atomic_load_n(&ctrl->epoch_ns, __ATOMIC_ACQUIRE)) == 0)
+    {
+        if (__atomic_load_n(&ctrl->stop, __ATOMIC_ACQUIRE))
+            exit(EXIT_SUCCESS);
+        nanosleep(&poll, NULL);
+    }
+    return epoch_ns;
+}
+
+// release 시각 계산: epoch + offset + k * period
+static inline void rt_release_time(const rt_release_t *rel, struct timespec *next)
+{
+    rt_ns_to_timespec(rel->epoch_ns + rel->offset_ns + rel->k * rel->period_ns, next);
+}
+
+// 첫 release까지 대기하고, next에 첫 주기의 기상 시각을 채움
+// epoch이 이미 지난 뒤에 합류한 task(재시작 등)는 다음 release 지점부터 같은 위상으로 시작
+static inline void rt_release_init(rt_release_t *rel, int64_t period_ns, struct timespec *next)
+{
+    rt_mem_lock(); // channel / buffer mapping이 끝난 뒤, 첫 release 전에 page 고정
+    rel->epoch_ns = rt_ctrl_wait_epoch();
+    rel->offset_ns = rt_offset_from_env();
+    rel->period_ns = period_ns;
+    rel->k = 0;
+
+    int64_t late_ns = rt_now_ns() - (rel->epoch_ns + rel->offset_ns);
+    if (late_ns > 0 && rt_ctrl_attach() != NULL)
+        rel->k = (late_ns + period_ns - 1) / period_ns;
+
+    rt_release_time(rel, next);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, next, NULL);
+}
+
+// 다음 주기의 release 시각 계산 (누적 덧셈 대신 epoch 기준으로 매번 계산)
+static inline void rt_release_next(rt_release_t *rel, struct timespec *next)
+{
+    rel->k++;
+    rt_release_time(rel, next);
+}
+
+// job이 보내는 sample의 seq (chain_msg.h): 공통 epoch 기준 release 번호 + 1 (1부터, wrap 없음)
+// 재시작한 task도 epoch 기준 k로 합류하므로 seq는 재시작 전보다 크고, 실행되지 않은 release 수만큼 건너뜀
+// (consumer / DASM의 seq 간격이 그대로 도달하지 못한 sample 수)
+static inline uint64_t rt_release_seq(const rt_release_t *rel)
+{
+    return (uint64_t)rel->k + 1;
+}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef RT_HIST_H
+#define RT_HIST_H
+
+// log bucket histogram (HDR histogram 방식)
+// 값(ns)을 2의 거듭제곱 구간으로 나누고, 각 구간을 다시 2^RT_HIST_SUB_BITS개의 같은 간격으로 나눔
+//  - 상대 오차 최대 1/2^RT_HIST_SUB_BITS (약 3%), 0 ~ 2^RT_HIST_MAX_BITS ns (약 18분) 범위
+//  - 고정 크기 배열이라 shared memory에 그대로 둘 수 있고, 기록은 bucket 계산 + 덧셈 몇 번
+// percentile은 bucket의 가운데 값으로 돌려줌
+
+#include <stdint.h>
+#include <string.h>
+
+#define RT_HIST_SUB_BITS 5
+#define RT_HIST_MAX_BITS 40
+#define RT_HIST_SUB_COUNT (1 << RT_HIST_SUB_BITS)
+#define RT_HIST_BUCKETS ((RT_HIST_MAX_BITS - RT_HIST_SUB_BITS + 1) * RT_HIST_SUB_COUNT)
+
+typedef struct
+{
+    uint64_t count;
+    int64_t min;
+    int64_t max;
+    double sum;
+    uint64_t buckets[RT_HIST_BUCKETS];
+} rt_hist_t;
+
+static inline void rt_hist_reset(rt_hist_t *h)
+{
+    memset(h, 0, sizeof(*h));
+    h->min = INT64_MAX;
+}
+
+static inline int rt_hist_index(int64_t v)
+{
+    if (v < RT_HIST_SUB_COUNT)
+        return v < 0 ? 0 : (int)v;
+    if (v >= (1LL << RT_HIST_MAX_BITS))
+        return RT_HIST_BUCKETS - 1;
+    int msb = 63 - __builtin_clzll((uint64_t)v);
+    int shift = msb - RT_HIST_SUB_BITS;
+    return (shift + 1) * RT_HIST_SUB_COUNT + (int)((v >> shift) - RT_HIST_SUB_COUNT);
+}
+
+// bucket idx에 들어가는 값의 범위 [low, low + width)
+static inline int64_t rt_hist_bucket_low(int idx, int64_t *width)
+{
+    int shift = idx / RT_HIST_SUB_COUNT - 1;
+    if (shift < 0)
+    {
+        *width = 1;
+        return idx;
+    }
+    *width = 1LL << shift;
+    return (int64_t)(idx % RT_HIST_SUB_COUNT + RT_HIST_SUB_COUNT) << shift;
+}
+
+static inline void rt_hist_record(rt_hist_t *h, int64_t v)
+{
+    h->buckets[rt_hist_index(v)]++;
+    h->count++;
+    h->sum += (double)v;
+    if (v < h->min)
+        h->min = v;
+    if (v > h->max)
+        h->max = v;
+}
+
+// p (0 ~ 100) percentile 값, 기록이 없으면 0
+static inline int64_t rt_hist_percentile(const rt_hist_t *h, double p)
+{
+    if (h->count == 0)
+        return 0;
+    uint64_t target = (uint64_t)(p / 100.0 * h->count + 0.5);
+    if (target < 1)
+        target = 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < RT_HIST_BUCKETS; i++)
+    {
+        seen += h->buckets[i];
+        if (seen >= target)
+        {
+            int64_t width;
+            int64_t v = rt_hist_bucket_low(i, &width) + width / 2;
+            // 정확히 알고 있는 최소/최대 밖으로 나가지 않도록
+            if (v < h->min)
+                v = h->min;
+            if (v > h->max)
+                v = h->max;
+            return v;
+        }
+    }
+    return h->max;
+}
+
+static inline double rt_hist_mean(const rt_hist_t *h)
+{
+    return h->count > 0 ? h->sum / h->count : 0.0;
+}
+
+#endif
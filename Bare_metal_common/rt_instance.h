@@ -0,0 +1,137 @@
+#ifndef RT_INSTANCE_H
+#define RT_INSTANCE_H
+
+// 한 host에서 여러 pipeline을 동시에 실행하기 위한 instance namespace
+// launcher가 WATERS_INSTANCE=<id>를 넘겨주면 shm / semaphore 이름과 TCP port를 id로부터 만든다.
+//  - 이름: id 0은 기존 이름 그대로, id > 0은 "<이름>_i<id>" (예: /sfm_planner_shm -> /sfm_planner_shm_i2)
+//  - port: 기존 port + id * RT_INSTANCE_PORT_STRIDE (예: 5556 -> 5756)
+// 단독 실행이나 instance 0은 기존과 같은 이름 / port를 사용
+// WATERS_PROXY_PORTS(쉼표로 구분한 기존 port 목록)에 있는 link의 producer는 consumer 대신
+// netem_proxy(port + RT_INSTANCE_PROXY_OFFSET)에 연결한다 (rt_instance_peer_port).
+// launcher의 node 구성(network namespace)에서는 WATERS_NODE=<node>와 WATERS_NODE_LINKS(node 사이 link의 shm / sem 기존 이름 목록)를
+// 받는다. 목록에 있는 이름은 node마다 다른 객체 "<이름>_<node>"가 되고, shm_bridge가 두 node의 객체를 TCP로 잇는다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RT_INSTANCE_MAX 64            // instance id 상한 (port 범위: 5555 + 63 * 100)
+#define RT_INSTANCE_PORT_STRIDE 100   // instance마다 port 간격 (한 pipeline은 5555 ~ 5562 사용)
+#define RT_INSTANCE_NAME_MAX 64
+#define RT_INSTANCE_MAX_NAMES 32      // process 하나가 쓰는 이름 개수 상한
+#define RT_INSTANCE_PROXY_OFFSET 50   // netem_proxy가 listen하는 port 간격 (instance port 간격 안)
+
+// WATERS_INSTANCE 환경변수 값, 없으면 0
+static inline int rt_instance_id(void)
+{
+    static int id = -1;
+    if (id < 0)
+    {
+        const char *env = getenv("WATERS_INSTANCE");
+        id = (env != NULL && *env != '\0') ? atoi(env) : 0;
+        if (id < 0 || id >= RT_INSTANCE_MAX)
+        {
+            fprintf(stderr, "WATERS_INSTANCE=%s: out of range (0 ~ %d)\n", env, RT_INSTANCE_MAX - 1);
+            exit(EXIT_FAILURE);
+        }
+    }
+    return id;
+}
+
+// 지정한 instance의 이름 (launcher처럼 여러 instance를 다루는 쪽에서 사용)
+// 잘린 이름은 다른 instance의 객체와 겹칠 수 있으므로 종료
+static inline void rt_instance_name_for(int instance, const char *base, char *name, size_t len)
+{
+    int n = (instance <= 0) ? snprintf(name, len, "%s", base) : snprintf(name, len, "%s_i%d", base, instance);
+    if (n < 0 || (size_t)n >= len)
+    {
+        fprintf(stderr, "%s: instance name too long\n", base);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// node 사이 link 객체의 이름: instance 이름 뒤에 "_<node>" (node가 NULL이면 rt_instance_name_for와 같음)
+static inline void rt_instance_node_name_for(int instance, const char *node, const char *base, char *name, size_t len)
+{
+    rt_instance_name_for(instance, base, name, len);
+    if (node == NULL)
+        return;
+    size_t used = strlen(name);
+    int n = snprintf(name + used, len - used, "_%s", node);
+    if (n < 0 || (size_t)n >= len - used)
+    {
+        fprintf(stderr, "%s: node name too long\n", base);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// 현재 process의 node에서 base가 node 사이 link 객체이면 node 이름, 아니면 NULL
+static inline const char *rt_instance_node_of(const char *base)
+{
+    const char *node = getenv("WATERS_NODE");
+    const char *links = getenv("WATERS_NODE_LINKS");
+    if (node == NULL || *node == '\0' || links == NULL)
+        return NULL;
+    size_t len = strlen(base);
+    for (const char *p = links; (p = strstr(p, base)) != NULL; p += len)
+        if ((p == links || p[-1] == ',') && (p[len] == ',' || p[len] == '\0'))
+            return node;
+    return NULL;
+}
+
+// 현재 instance의 이름, shm_open(rt_instance_name(SHM_NAME), ...)처럼 기존 이름 자리에 그대로 사용
+// 만든 이름은 process 안에서 재사용하므로 반환값을 보관해도 됨
+static inline const char *rt_instance_name(const char *base)
+{
+    static struct
+    {
+        const char *base;
+        char name[RT_INSTANCE_NAME_MAX];
+    } cache[RT_INSTANCE_MAX_NAMES];
+    static int num_cached = 0;
+
+    int id = rt_instance_id();
+    const char *node = rt_instance_node_of(base);
+    if (id == 0 && node == NULL)
+        return base;
+    for (int i = 0; i < num_cached; i++)
+        if (strcmp(cache[i].base, base) == 0)
+            return cache[i].name;
+    if (num_cached == RT_INSTANCE_MAX_NAMES)
+    {
+        fprintf(stderr, "rt_instance_name: too many names\n");
+        exit(EXIT_FAILURE);
+    }
+    cache[num_cached].base = base;
+    rt_instance_node_name_for(id, node, base, cache[num_cached].name, RT_INSTANCE_NAME_MAX);
+    return cache[num_cached++].name;
+}
+
+// 현재 instance의 TCP port
+static inline int rt_instance_port(int base_port)
+{
+    return base_port + rt_instance_id() * RT_INSTANCE_PORT_STRIDE;
+}
+
+// producer가 connect할 port: WATERS_PROXY_PORTS에 있으면 그 link의 netem_proxy port
+static inline int rt_instance_peer_port(int base_port)
+{
+    const char *env = getenv("WATERS_PROXY_PORTS");
+    const char *p = (env != NULL) ? env : "";
+    while (*p != '\0')
+    {
+        char *end;
+        long port = strtol(p, &end, 10);
+        if (end == p)
+        {
+            p++; // 구분자
+            continue;
+        }
+        if (port == base_port)
+            return rt_instance_port(base_port) + RT_INSTANCE_PROXY_OFFSET;
+        p = end;
+    }
+    return rt_instance_port(base_port);
+}
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef RT_LINK_H
+#define RT_LINK_H
+
+// TCP link 재연결 (TCP 변형)
+// send 실패로 runnable loop가 끝나거나 recv 0으로 copy thread가 끝나면, task 하나의 재시작으로 실험 전체가 멈춘다.
+// link 양쪽이 연결 종료를 견디고 스스로 다시 연결한다 (launcher의 task 옵션 restart=<ms>로 종료된 task를 다시 실행).
+//  - producer (rt_link_tx_*): send가 실패하면 socket을 닫고 down 상태로. down인 동안 job마다 non-blocking connect를 시도하되
+//    실패할 때마다 간격을 2배로 (RT_LINK_BACKOFF_MIN_NS ~ RT_LINK_BACKOFF_MAX_NS), 그 job은 전송을 건너뜀 (주기는 그대로)
+//    다시 연결되면 clock thread(rt_clock.h)를 새 socket으로 시작하고, 복구 시간과 건너뛴 주기 수를 출력
+//  - consumer (rt_link_rx_*): copy thread가 연결 종료(recv 0 또는 ECONNRESET 같은 오류)를 보면 client socket을 닫고 다시 accept.
+//    EINTR이나 나뉘어 도착한 frame은 연결 종료가 아니므로 이어서 받음 (rt_link_rx_recv)
+//    그동안 runnable은 마지막으로 받은 buffer를 그대로 읽음 (stale data, chain message의 seq가 바뀌지 않음)
+//    다시 받은 첫 frame에서 복구 시간과, frame 간격의 지수 평균으로 추정한 놓친 주기 수를 출력
+// 출력은 stdout(<task>.out)에 한 줄씩 바로 flush (copy thread도 쓰므로 단일 writer인 trace ring에는 기록하지 않음)
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "rt_control.h"
+#include "rt_clock.h"
+
+#define RT_LINK_BACKOFF_MIN_NS 1000000LL     // 첫 재시도 간격 (1ms)
+#define RT_LINK_BACKOFF_MAX_NS 100000000LL   // 재시도 간격 상한 (100ms)
+#define RT_LINK_CONNECT_TIMEOUT_NS 1000000000LL // 응답 없는 connect를 포기하는 시간 (1s)
+#define RT_LINK_INTERVAL_WEIGHT 0.125        // consumer frame 간격 지수 평균의 가중치
+
+// producer 쪽 link
+typedef struct
+{
+    const char *name; // 출력용, 예: "[lidar] Localization"
+    struct sockaddr_in addr;
+    int sock;         // -1: down
+    int pending;      // 진행 중인 non-blocking connect (-1: 없음)
+    int64_t down_ns;  // 끊긴 시각
+    int64_t retry_ns; // 다음 connect 시도 시각 (pending이면 시작 시각)
+    int64_t backoff_ns;
+    uint64_t missed;  // 이번 outage에서 전송을 건너뛴 job 수
+    uint64_t missed_total;
+    uint32_t outages;
+    rt_clock_peer_t *clock;
+} rt_link_tx_t;
+
+// consumer 쪽 link (copy thread만 사용)
+typedef struct
+{
+    const char *name;
+    int64_t last_ns;     // 마지막 frame 수신 시각
+    int64_t down_ns;     // 연결 종료를 본 시각 (0: 연결됨)
+    int64_t interval_ns; // frame 간격의 지수 평균
+    int64_t first_ns;    // 마지막 frame의 첫 byte 도착 시각 (rt_clock_now_ns 기준, clock offset 추정의 정방향 sample)
+    uint64_t missed_total;
+    uint32_t outages;
+} rt_link_rx_t;
+
+// producer: 처음 연결(기존 blocking connect)이 끝난 뒤 호출, clock thread도 시작
+static inline void rt_link_tx_init(rt_link_tx_t *l, const char *name, int sock, const struct sockaddr_in *addr,
+                                   rt_clock_peer_t *clock)
+{
+    memset(l, 0, sizeof(*l));
+    l->name = name;
+    l->addr = *addr;
+    l->sock = sock;
+    l->pending = -1;
+    l->clock = clock;
+    rt_clock_peer_start(clock, sock);
+}
+
+static inline void rt_link_tx_down(rt_link_tx_t *l, int64_t now)
+{
+    fprintf(stdout, "%s link down (%s), reconnecting\n", l->name, strerror(errno));
+    fflush(stdout);
+    shutdown(l->sock, SHUT_RDWR); // clock thread의 recv를 깨움
+    close(l->sock);
+    l->sock = -1;
+    l->down_ns = now;
+    l->retry_ns = now;
+    l->backoff_ns = RT_LINK_BACKOFF_MIN_NS;
+    l->missed = 0;
+    l->outages++;
+}
+
+static inline void rt_link_tx_retry_later(rt_link_tx_t *l, int64_t now)
+{
+    if (l->pending >= 0)
+    {
+        close(l->pending);
+        l->pending = -1;
+    }
+    l->retry_ns = now + l->backoff_ns;
+    l->backoff_ns *= 2;
+    if (l->backoff_ns > RT_LINK_BACKOFF_MAX_NS)
+        l->backoff_ns = RT_LINK_BACKOFF_MAX_NS;
+}
+
+// down인 link의 재연결 시도 (기다리지 않음), 연결되면 1
+static inline int rt_link_tx_reconnect(rt_link_tx_t *l, int64_t now)
+{
+    if (l->pending < 0)
+    {
+        if (now < l->retry_ns)
+            return 0;
+        l->pending = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (l->pending < 0)
+        {
+            rt_link_tx_retry_later(l, now);
+            return 0;
+        }
+        l->retry_ns = now;
+        if (connect(l->pending, (struct sockaddr *)&l->addr, sizeof(l->addr)) < 0)
+        {
+            if (errno != EINPROGRESS)
+                rt_link_tx_retry_later(l, now); // 보통 ECONNREFUSED: consumer가 아직 listen 전
+            return 0;
+        }
+    }
+    else
+    {
+        struct pollfd pfd = {l->pending, POLLOUT, 0};
+        if (poll(&pfd, 1, 0) == 0)
+        {
+            if (now - l->retry_ns > RT_LINK_CONNECT_TIMEOUT_NS)
+                rt_link_tx_retry_later(l, now);
+            return 0;
+        }
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(l->pending, SOL_SOCKET, SO_ERROR, &err, &len) < 0 || err != 0)
+        {
+            rt_link_tx_retry_later(l, now);
+            return 0;
+        }
+    }
+
+    // 연결됨: 이후 전송은 기존처럼 blocking
+    fcntl(l->pending, F_SETFL, fcntl(l->pending, F_GETFL) & ~O_NONBLOCK);
+    l->sock = l->pending;
+    l->pending = -1;
+    rt_clock_peer_start(l->clock, l->sock);
+    l->missed_total += l->missed;
+    fprintf(stdout, "%s link recovered after %.3f ms, %llu missed periods (outage %u, total missed %llu)\n", l->name,
+            (now - l->down_ns) / 1.0e6, (unsigned long long)l->missed, l->outages,
+            (unsigned long long)l->missed_total);
+    fflush(stdout);
+    return 1;
+}
+
+// producer: job 하나의 결과 전송, 보낸 bytes (link가 down이면 0, 이번 job은 missed)
+static inline ssize_t rt_link_tx_send(rt_link_tx_t *l, const void *buf, size_t len)
+{
+    int64_t now = rt_now_ns();
+    if (l->sock < 0 && !rt_link_tx_reconnect(l, now))
+    {
+        l->missed++;
+        return 0;
+    }
+    size_t off = 0;
+    while (off < len)
+    {
+        ssize_t n = send(l->sock, (const char *)buf + off, len - off, MSG_NOSIGNAL); // SIGPIPE로 죽지 않음
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            rt_link_tx_down(l, now);
+            l->missed++;
+            return 0;
+        }
+        off += (size_t)n;
+    }
+    return (ssize_t)off;
+}
+
+static inline void rt_link_rx_init(rt_link_rx_t *l, const char *name)
+{
+    memset(l, 0, sizeof(*l));
+    l->name = name;
+}
+
+// consumer copy thread: frame 하나를 모두 받은 직후 호출
+static inline void rt_link_rx_frame(rt_link_rx_t *l)
+{
+    int64_t now = rt_now_ns();
+    if (l->down_ns != 0)
+    {
+        // 놓친 주기: 마지막 frame부터의 간격 / 평균 간격 - 1 (간격을 모르면 0)
+        uint64_t missed = 0;
+        if (l->interval_ns > 0 && l->last_ns > 0)
+        {
+            int64_t periods = (now - l->last_ns + l->interval_ns / 2) / l->interval_ns;
+            missed = periods > 1 ? (uint64_t)(periods - 1) : 0;
+        }
+        l->missed_total += missed;
+        fprintf(stdout, "%s link recovered after %.3f ms, ~%llu missed periods (outage %u, total missed %llu)\n",
+                l->name, (now - l->down_ns) / 1.0e6, (unsigned long long)missed, l->outages,
+                (unsigned long long)l->missed_total);
+        fflush(stdout);
+        l->down_ns = 0;
+    }
+    else if (l->last_ns > 0)
+    {
+        int64_t gap = now - l->last_ns;
+        l->interval_ns = (l->interval_ns == 0) ? gap
+                                               : l->interval_ns + (int64_t)(RT_LINK_INTERVAL_WEIGHT * (gap - l->interval_ns));
+    }
+    l->last_ns = now;
+}
+
+// consumer copy thread: 연결 종료(recv 0 또는 EINTR이 아닌 오류)를 보면 호출, 새 연결의 socket을 돌려줌
+static inline int rt_link_rx_reaccept(rt_link_rx_t *l, int server_sock, int client_sock)
+{
+    close(client_sock);
+    if (l->down_ns == 0)
+    {
+        l->down_ns = rt_now_ns();
+        l->outages++;
+    }
+    fprintf(stdout, "%s link down, serving last data until reconnect\n", l->name);
+    fflush(stdout);
+    int sock;
+    while ((sock = accept(server_sock, NULL, NULL)) < 0)
+    {
+        if (errno != EINTR && errno != ECONNABORTED)
+        {
+            perror("rt_link_rx_reaccept");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return sock;
+}
+
+// consumer copy thread: frame 하나를 모두 받을 때까지 (EINTR은 다시, 나뉘어 온 frame은 이어서 받음)
+// 연결이 끊기면 받던 frame은 버리고 다시 accept한 연결의 처음부터 받음 (*sock은 새 socket), 반환하면 frame 하나가 완성됨
+// frame의 첫 recv는 MSG_WAITALL 없이 받아 첫 byte 도착 시각을 first_ns에 기록
+static inline void rt_link_rx_recv(rt_link_rx_t *l, int server_sock, int *sock, void *buf, size_t len)
+{
+    size_t off = 0;
+    while (off < len)
+    {
+        ssize_t n = recv(*sock, (char *)buf + off, len - off, off == 0 ? 0 : MSG_WAITALL);
+        if (n > 0)
+        {
+            if (off == 0)
+                l->first_ns = rt_clock_now_ns();
+            off += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+            continue;
+        *sock = rt_link_rx_reaccept(l, server_sock, *sock);
+        off = 0;
+    }
+    rt_link_rx_frame(l);
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef RT_MEM_H
+#define RT_MEM_H
+
+// channel / task buffer 메모리 계층
+// 첫 주기에 page fault가 몰리지 않도록 모든 buffer를 미리 할당(prefault)하고, release 전에 mlockall로 고정한다.
+//  - channel (shared): rt_mem_shm_open / truncate / map / unmap / unlink
+//    WATERS_HUGEPAGES=1이고 hugetlbfs(WATERS_HUGETLBFS, 기본 /dev/hugepages)가 mount되어 있으면
+//    POSIX shm 대신 hugetlbfs file을 channel로 사용 (크기는 huge page 단위로 올림)
+//    그 외에는 POSIX shm + MADV_HUGEPAGE (shmem THP가 advise/within_size일 때 효과)
+//  - task buffer (private): rt_mem_alloc
+//    WATERS_HUGEPAGES=1이면 MAP_HUGETLB, 실패하면 일반 page + MADV_HUGEPAGE
+//  - 모두 MAP_POPULATE로 mapping 시점에 page table까지 채움
+//  - rt_mem_lock: mlockall(MCL_CURRENT | MCL_FUTURE), WATERS_MLOCK=0이면 생략
+//    (rt_release_init이 첫 release 전에 호출, 이후 만든 thread stack도 고정됨)
+// launcher와 task가 같은 환경변수를 보므로 channel 방식(hugetlbfs / POSIX shm)은 모든 process에서 같다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+
+#define RT_MEM_HUGETLBFS_MAGIC 0x958458f6
+#define RT_MEM_DEFAULT_HUGETLBFS "/dev/hugepages"
+#define RT_MEM_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+
+static inline int rt_mem_huge_requested(void)
+{
+    const char *env = getenv("WATERS_HUGEPAGES");
+    return env != NULL && strcmp(env, "1") == 0;
+}
+
+// hugetlbfs channel을 쓸 때 mount 디렉터리, 아니면 NULL (*page_size에 huge page 크기)
+static inline const char *rt_mem_hugetlbfs(size_t *page_size)
+{
+    static int checked = 0;
+    static const char *dir = NULL;
+    static size_t huge_size = 0;
+    if (!checked)
+    {
+        checked = 1;
+        if (rt_mem_huge_requested())
+        {
+            const char *env = getenv("WATERS_HUGETLBFS");
+            const char *d = (env != NULL && *env != '\0') ? env : RT_MEM_DEFAULT_HUGETLBFS;
+            struct statfs st;
+            if (statfs(d, &st) == 0 && (unsigned long)st.f_type == RT_MEM_HUGETLBFS_MAGIC)
+            {
+                dir = d;
+                huge_size = (size_t)st.f_bsize;
+            }
+        }
+    }
+    if (page_size != NULL)
+        *page_size = huge_size;
+    return dir;
+}
+
+// channel의 실제 크기 (hugetlbfs는 huge page 단위)
+static inline size_t rt_mem_shm_size(size_t size)
+{
+    size_t page;
+    if (rt_mem_hugetlbfs(&page) == NULL)
+        return size;
+    return (size + page - 1) / page * page;
+}
+
+// hugetlbfs의 channel file 경로: <mount>/<이름에서 '/' 제외>
+static inline int rt_mem_shm_path(const char *name, char *path, size_t len)
+{
+    const char *dir = rt_mem_hugetlbfs(NULL);
+    while (*name == '/')
+        name++;
+    int n = snprintf(path, len, "%s/%s", dir, name);
+    return (n < 0 || (size_t)n >= len) ? -1 : 0;
+}
+
+// shm_open과 같은 인자, 반환값
+static inline int rt_mem_shm_open(const char *name, int oflag, mode_t mode)
+{
+    if (rt_mem_hugetlbfs(NULL) == NULL)
+        return shm_open(name, oflag, mode);
+    char path[PATH_MAX];
+    if (rt_mem_shm_path(name, path, sizeof(path)) != 0)
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    return open(path, oflag, mode);
+}
+
+static inline int rt_mem_shm_truncate(int fd, size_t size)
+{
+    return ftruncate(fd, (off_t)rt_mem_shm_size(size));
+}
+
+// channel mapping: 전체 page table을 미리 채움, 실패하면 MAP_FAILED
+static inline void *rt_mem_shm_map(int fd, size_t size, int prot)
+{
+    void *p = mmap(NULL, rt_mem_shm_size(size), prot, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (p != MAP_FAILED && rt_mem_hugetlbfs(NULL) == NULL && rt_mem_huge_requested())
+        madvise(p, size, MADV_HUGEPAGE); // shmem THP가 꺼져 있으면 무시됨
+    return p;
+}
+
+static inline int rt_mem_shm_unmap(void *p, size_t size)
+{
+    return munmap(p, rt_mem_shm_size(size));
+}
+
+static inline int rt_mem_shm_unlink(const char *name)
+{
+    if (rt_mem_hugetlbfs(NULL) == NULL)
+        return shm_unlink(name);
+    char path[PATH_MAX];
+    if (rt_mem_shm_path(name, path, sizeof(path)) != 0)
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    return unlink(path);
+}
+
+// task 내부 buffer (stack 대신), prefault된 상태로 반환, 실패하면 종료
+// process가 끝날 때까지 쓰는 buffer용이라 해제 함수는 없음
+static inline void *rt_mem_alloc(size_t size)
+{
+    void *p = MAP_FAILED;
+    if (rt_mem_huge_requested())
+    {
+        size_t huge = (size + RT_MEM_HUGE_PAGE_SIZE - 1) / RT_MEM_HUGE_PAGE_SIZE * RT_MEM_HUGE_PAGE_SIZE;
+        p = mmap(NULL, huge, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+    }
+    if (p == MAP_FAILED)
+    {
+        p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (p == MAP_FAILED)
+        {
+            perror("rt_mem_alloc");
+            exit(EXIT_FAILURE);
+        }
+        if (rt_mem_huge_requested())
+            madvise(p, size, MADV_HUGEPAGE);
+    }
+    return p;
+}
+
+// 현재와 이후의 mapping을 모두 memory에 고정 (process마다 한 번), 실패해도 경고만 출력
+static inline void rt_mem_lock(void)
+{
+    static int locked = 0;
+    const char *env = getenv("WATERS_MLOCK");
+    if (locked || (env != NULL && strcmp(env, "0") == 0))
+        return;
+    locked = 1;
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+        perror("mlockall (RLIMIT_MEMLOCK 또는 CAP_IPC_LOCK 확인)");
+}
+
+#endif
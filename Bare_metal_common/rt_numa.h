@@ -0,0 +1,181 @@
+#ifndef RT_NUMA_H
+#define RT_NUMA_H
+
+// shared memory channel의 NUMA 배치
+// launcher가 channel을 만들 때 policy에 따라 node를 정해 mbind하고, 전체를 0으로 써서 page를 미리 할당(prefault)한 뒤
+// page별 실제 node를 조회해 기록한다. shm object의 policy는 object에 남으므로 이후 어느 process가 page를 만들어도 같은 node.
+// libnuma 없이 system call(mbind, move_pages)을 직접 사용. node가 하나뿐인 host에서는 모두 node 0.
+//  - producer: producer task core의 node
+//  - consumer: consumer task core의 node (읽는 쪽의 복사가 local)
+//  - interleave: online node 전체에 page 단위로 분산
+//  - <숫자>: 지정한 node
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/syscall.h>
+
+#define RT_MPOL_BIND 2
+#define RT_MPOL_INTERLEAVE 3
+#define RT_MPOL_MF_MOVE (1 << 1)
+#define RT_NUMA_MAX_NODES 64       // node mask는 unsigned long 하나
+#define RT_NUMA_QUERY_PAGES 256    // move_pages 한 번에 조회할 page 수
+
+enum
+{
+    RT_NUMA_NONE = 0,   // first touch (launcher가 0으로 채우는 core의 node)
+    RT_NUMA_PRODUCER,
+    RT_NUMA_CONSUMER,
+    RT_NUMA_INTERLEAVE,
+    RT_NUMA_NODE,
+};
+
+// "none|producer|consumer|interleave|<node>" -> policy, 알 수 없으면 -1
+static inline int rt_numa_parse(const char *s, int *node)
+{
+    *node = -1;
+    if (strcmp(s, "none") == 0)
+        return RT_NUMA_NONE;
+    if (strcmp(s, "producer") == 0)
+        return RT_NUMA_PRODUCER;
+    if (strcmp(s, "consumer") == 0)
+        return RT_NUMA_CONSUMER;
+    if (strcmp(s, "interleave") == 0)
+        return RT_NUMA_INTERLEAVE;
+    char *end;
+    long n = strtol(s, &end, 10);
+    if (*s != '\0' && *end == '\0' && n >= 0 && n < RT_NUMA_MAX_NODES)
+    {
+        *node = (int)n;
+        return RT_NUMA_NODE;
+    }
+    return -1;
+}
+
+static inline const char *rt_numa_policy_name(int policy)
+{
+    static const char *names[] = {"none", "producer", "consumer", "interleave", "node"};
+    return (policy >= RT_NUMA_NONE && policy <= RT_NUMA_NODE) ? names[policy] : "?";
+}
+
+// online node 수 (/sys/devices/system/node/online의 최대 번호 + 1), 정보가 없으면 1
+static inline int rt_numa_num_nodes(void)
+{
+    FILE *fp = fopen("/sys/devices/system/node/online", "r");
+    if (fp == NULL)
+        return 1;
+    char buf[128];
+    int max_node = 0;
+    if (fgets(buf, sizeof(buf), fp) != NULL)
+    {
+        // 형식: "0", "0-1", "0-1,3"
+        for (char *p = buf; *p != '\0';)
+        {
+            char *end;
+            long n = strtol(p, &end, 10);
+            if (end == p)
+            {
+                p++;
+                continue;
+            }
+            if (n > max_node)
+                max_node = (int)n;
+            p = end;
+        }
+    }
+    fclose(fp);
+    return (max_node + 1 < RT_NUMA_MAX_NODES) ? max_node + 1 : RT_NUMA_MAX_NODES;
+}
+
+// cpu가 속한 node (/sys/devices/system/cpu/cpu<N>/node<M>), 정보가 없으면 0
+static inline int rt_numa_node_of_cpu(int cpu)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    DIR *dir = opendir(path);
+    if (dir == NULL)
+        return 0;
+    int node = 0;
+    struct dirent *e;
+    while ((e = readdir(dir)) != NULL)
+    {
+        if (strncmp(e->d_name, "node", 4) == 0 && e->d_name[4] >= '0' && e->d_name[4] <= '9')
+        {
+            node = atoi(e->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+// [addr, addr + len)에 policy 적용 (addr는 page 정렬), 이미 할당된 page는 옮김
+// node: RT_NUMA_NODE / PRODUCER / CONSUMER일 때 대상 node
+static inline int rt_numa_bind(void *addr, size_t len, int policy, int node)
+{
+    unsigned long mask = 0;
+    int mode = RT_MPOL_BIND;
+    if (policy == RT_NUMA_NONE)
+        return 0;
+    if (policy == RT_NUMA_INTERLEAVE)
+    {
+        int nodes = rt_numa_num_nodes();
+        for (int n = 0; n < nodes; n++)
+            mask |= 1UL << n;
+        mode = RT_MPOL_INTERLEAVE;
+    }
+    else
+    {
+        if (node < 0 || node >= RT_NUMA_MAX_NODES)
+        {
+            errno = EINVAL;
+            return -1;
+        }
+        mask = 1UL << node;
+    }
+    return (int)syscall(SYS_mbind, addr, len, mode, &mask, (unsigned long)RT_NUMA_MAX_NODES + 1, RT_MPOL_MF_MOVE);
+}
+
+// page별 node 개수 집계, count[RT_NUMA_MAX_NODES], 조회할 수 없는 page는 *unknown
+static inline int rt_numa_page_nodes(void *addr, size_t len, int *count, int *unknown)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    size_t pages = (len + page - 1) / page;
+    void *ptrs[RT_NUMA_QUERY_PAGES];
+    int status[RT_NUMA_QUERY_PAGES];
+    memset(count, 0, sizeof(int) * RT_NUMA_MAX_NODES);
+    *unknown = 0;
+    for (size_t first = 0; first < pages; first += RT_NUMA_QUERY_PAGES)
+    {
+        size_t n = (pages - first < RT_NUMA_QUERY_PAGES) ? pages - first : RT_NUMA_QUERY_PAGES;
+        for (size_t i = 0; i < n; i++)
+            ptrs[i] = (char *)addr + (first + i) * page;
+        // nodes == NULL이면 옮기지 않고 현재 node만 status에 돌려줌
+        if (syscall(SYS_move_pages, 0, n, ptrs, NULL, status, 0) != 0)
+            return -1;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (status[i] >= 0 && status[i] < RT_NUMA_MAX_NODES)
+                count[status[i]]++;
+            else
+                (*unknown)++;
+        }
+    }
+    return 0;
+}
+
+// page가 가장 많이 있는 node, 없으면 -1
+static inline int rt_numa_major_node(const int *count)
+{
+    int best = -1;
+    for (int n = 0; n < RT_NUMA_MAX_NODES; n++)
+        if (count[n] > 0 && (best < 0 || count[n] > count[best]))
+            best = n;
+    return best;
+}
+
+#endif
@@ -0,0 +1,175 @@
+#ifndef RT_PERF_H
+#define RT_PERF_H
+
+// job phase별 hardware/software performance counter (perf_event_open)
+// WATERS_PERF=1 일 때만 runnable thread에 counter group을 열고, phase 경계마다 group을 한 번에 읽어(read 1회)
+// 직전 경계와의 차이를 phase별로 모아 둔다. trace 기록 구간에서 RT_TR_PERF record로 trace ring에 남김.
+//  - cycles, instructions, LLC miss: cache 간섭 / 실행 속도 변화
+//  - context switch, page fault: 선점(preemption), 메모리 할당 영향
+//  - dTLB load miss: huge page(WATERS_HUGEPAGES) 적용 효과
+// 열 수 없는 counter(가상 머신, perf_event_paranoid 등)는 건너뛰고, 하나도 못 열면 기능을 끈다.
+// 사용 순서 (job마다): rt_perf_begin() -> rt_perf_mark(RT_SPAN_*) ... -> rt_perf_flush(job)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "rt_trace.h"
+
+#define RT_PERF_MAX 6
+
+// RT_TR_PERF record의 flags = span | (counter << 8), arg = phase 동안의 증가량
+enum
+{
+    RT_PERF_CYCLES = 0,
+    RT_PERF_INSTRUCTIONS,
+    RT_PERF_LLC_MISSES,
+    RT_PERF_CTX_SWITCHES,
+    RT_PERF_PAGE_FAULTS,
+    RT_PERF_DTLB_MISSES
+};
+
+typedef struct
+{
+    int enabled;
+    int leader_fd;
+    int num;                            // 열린 counter 수 (group 읽기 순서)
+    int fds[RT_PERF_MAX];
+    uint8_t kinds[RT_PERF_MAX];         // 열린 순서대로 counter 종류
+    uint64_t prev[RT_PERF_MAX];
+    int64_t delta[RT_SPAN_MAX][RT_PERF_MAX];
+    uint32_t marked;                    // 이번 job에서 기록한 span (bit)
+} rt_perf_t;
+
+static rt_perf_t rt_pf = {.leader_fd = -1};
+
+static inline int rt_perf_event_open(struct perf_event_attr *attr, int group_fd)
+{
+    // pid 0, cpu -1: 호출한 thread만, 어느 core에서 실행되든 측정
+    return (int)syscall(SYS_perf_event_open, attr, 0, -1, group_fd, 0);
+}
+
+// runnable thread에서 rt_trace_open 다음에 한 번 호출
+static inline void rt_perf_open(void)
+{
+    const char *env = getenv("WATERS_PERF");
+    if (env == NULL || strcmp(env, "1") != 0)
+        return;
+
+    static const struct
+    {
+        uint32_t type;
+        uint64_t config;
+        const char *name;
+    } events[RT_PERF_MAX] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, "cycles"},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, "instructions"},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, "LLC-misses"},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, "context-switches"},
+        {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, "page-faults"},
+        {PERF_TYPE_HW_CACHE,
+         PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+         "dTLB-load-misses"},
+    };
+
+    for (int i = 0; i < RT_PERF_MAX; i++)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = events[i].type;
+        attr.config = events[i].config;
+        attr.disabled = (rt_pf.leader_fd == -1); // group은 leader로 한꺼번에 시작
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        int fd = rt_perf_event_open(&attr, rt_pf.leader_fd);
+        if (fd == -1 && (errno == EACCES || errno == EPERM))
+        {
+            attr.exclude_kernel = 1; // perf_event_paranoid 때문에 kernel 측정이 막힌 경우
+            fd = rt_perf_event_open(&attr, rt_pf.leader_fd);
+        }
+        if (fd == -1)
+        {
+            fprintf(stderr, "[perf] %s: %s (skip)\n", events[i].name, strerror(errno));
+            continue;
+        }
+        if (rt_pf.leader_fd == -1)
+            rt_pf.leader_fd = fd;
+        rt_pf.fds[rt_pf.num] = fd;
+        rt_pf.kinds[rt_pf.num] = (uint8_t)i;
+        rt_pf.num++;
+    }
+    if (rt_pf.num == 0)
+    {
+        fprintf(stderr, "[perf] no counters available, WATERS_PERF ignored\n");
+        return;
+    }
+    ioctl(rt_pf.leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(rt_pf.leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    rt_pf.enabled = 1;
+}
+
+// group 전체를 한 번의 read로 읽음
+static inline int rt_perf_read(uint64_t *values)
+{
+    struct
+    {
+        uint64_t nr;
+        uint64_t values[RT_PERF_MAX];
+    } buf;
+    if (read(rt_pf.leader_fd, &buf, sizeof(buf)) <= 0)
+        return -1;
+    for (int i = 0; i < rt_pf.num && i < (int)buf.nr; i++)
+        values[i] = buf.values[i];
+    return 0;
+}
+
+// job 시작 (기준 값)
+static inline void rt_perf_begin(void)
+{
+    if (!rt_pf.enabled)
+        return;
+    rt_pf.marked = 0;
+    rt_perf_read(rt_pf.prev);
+}
+
+// span 종료 경계: 직전 경계 이후의 증가량을 span에 기록
+static inline void rt_perf_mark(uint16_t span)
+{
+    if (!rt_pf.enabled)
+        return;
+    uint64_t cur[RT_PERF_MAX];
+    if (rt_perf_read(cur) != 0)
+        return;
+    for (int i = 0; i < rt_pf.num; i++)
+    {
+        rt_pf.delta[span][i] = (int64_t)(cur[i] - rt_pf.prev[i]);
+        rt_pf.prev[i] = cur[i];
+    }
+    rt_pf.marked |= 1u << span;
+}
+
+// trace 기록 구간에서 호출: 이번 job에서 모은 증가량을 trace ring으로
+static inline void rt_perf_flush(uint32_t job)
+{
+    if (!rt_pf.enabled || rt_pf.marked == 0)
+        return;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    for (int span = 1; span < RT_SPAN_MAX; span++)
+    {
+        if (!(rt_pf.marked & (1u << span)))
+            continue;
+        for (int i = 0; i < rt_pf.num; i++)
+            rt_trace_ts(&now, RT_TR_PERF, job, (uint16_t)(span | (rt_pf.kinds[i] << 8)), rt_pf.delta[span][i]);
+    }
+    rt_pf.marked = 0;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef RT_SAMPLE_H
+#define RT_SAMPLE_H
+
+// link별 sample 손실 / 중복 집계 (Planner, DASM의 입력 link)
+// producer는 job마다 64-bit seq(rt_release_seq: 공통 epoch 기준 release 번호 + 1)를 자기 slot에 쓴다 (chain_msg.h, 0은 아직 쓰지 않은 buffer).
+// consumer는 job마다 읽은 buffer의 producer seq를 rt_sample_read()에 넘긴다.
+//  - undersampling: 읽기 전에 덮어써진 sample (seq가 2 이상 증가하면 그 사이의 sample 수)
+//  - oversampling: 같은 sample을 다시 읽은 job (seq가 그대로)
+// seq는 wrap되지 않으므로 wrap과 손실을 구분할 필요가 없다. 재시작한 producer(launcher restart=)도 epoch 기준 번호로 이어 쓰므로
+// 재시작 동안 실행되지 않은 release는 undersampling으로 세어진다. seq가 줄어드는 것은 epoch 없이 단독 실행한 producer를
+// 다시 띄운 경우뿐이며, 이때는 restarts에 세고 새로 센다.
+// 손실 / 중복이 생긴 job에서만 trace record를 남긴다 (RT_TR_SKIP / RT_TR_REPEAT, flags = link 번호),
+// trace_export.py가 task / link별 합계를 출력한다.
+
+#include <stdint.h>
+#include <time.h>
+
+#include "rt_trace.h"
+
+typedef struct
+{
+    uint64_t last_seq; // 마지막으로 읽은 seq (0: 아직 읽은 sample 없음)
+    uint64_t fresh;    // 새 sample을 읽은 job 수
+    uint64_t repeated; // oversampling: 같은 sample을 다시 읽은 job 수
+    uint64_t skipped;  // undersampling: 읽지 못하고 덮어써진 sample 수
+    uint64_t restarts; // seq가 줄어든 횟수 (epoch 없이 단독 실행한 producer의 재시작)
+} rt_sample_link_t;
+
+// job 하나가 link에서 읽은 seq 반영, 새 sample이면 1
+static inline int rt_sample_read(rt_sample_link_t *l, int link, uint64_t seq, const struct timespec *ts, uint32_t job)
+{
+    if (seq == 0)
+        return 0; // producer가 아직 쓰지 않음
+    if (seq == l->last_seq)
+    {
+        l->repeated++;
+        rt_trace_ts(ts, RT_TR_REPEAT, job, (uint16_t)link, (int64_t)seq);
+        return 0;
+    }
+    if (seq < l->last_seq)
+        l->restarts++;
+    else if (l->last_seq != 0 && seq - l->last_seq > 1)
+    {
+        l->skipped += seq - l->last_seq - 1;
+        rt_trace_ts(ts, RT_TR_SKIP, job, (uint16_t)link, (int64_t)(seq - l->last_seq - 1));
+    }
+    l->last_seq = seq;
+    l->fresh++;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef RT_TRACE_H
+#define RT_TRACE_H
+
+// task별 lock-free trace ring (shared memory)
+// 실시간 thread(hot loop)는 printf 대신 고정 크기 binary record(시각, phase, job 번호)만 ring에 쓰고,
+// 낮은 우선순위의 drainer(Bare_metal_tools/trace_drain.c)가 ring을 비워 파일로 저장한다.
+// 단일 writer(task의 runnable thread) / 단일 reader(drainer) 구조라 lock 없이 head/tail만으로 동기화.
+// ring이 가득 차면 기다리지 않고 record를 버리고 dropped만 증가시킨다 (실시간 thread가 drainer를 기다리지 않도록)
+
+// sched_getcpu 사용: include하는 파일 맨 위에 _GNU_SOURCE가 정의되어 있어야 함
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "rt_instance.h"
+
+#define RT_TRACE_MAGIC 0x57545243      // "WTRC"
+#define RT_TRACE_SHM_PREFIX "/waters_trace_"
+#define RT_TRACE_CAPACITY 8192         // ring당 record 개수 (2의 거듭제곱), 8192 * 32B = 256KB
+
+// record 종류
+enum
+{
+    RT_TR_WAKE = 1,  // 주기 release 시각 (next)
+    RT_TR_START,     // 실제로 scheduling되어 실행 시작한 시각
+    RT_TR_READ,      // 입력 데이터 읽기 완료, arg = 읽은 seq, flags = chain 번호
+    RT_TR_SEND,      // 결과 전송(쓰기) 시작, arg = 보낸 seq
+    RT_TR_END,       // job 종료
+    RT_TR_PRE,       // preprocessing 시간, arg = ns
+    RT_TR_FUNC,      // function(GPU) 시간, arg = ns
+    RT_TR_POST,      // postprocessing 시간, arg = ns
+    RT_TR_BEGIN,     // phase 구간 시작, flags = RT_SPAN_*
+    RT_TR_FINISH,    // phase 구간 끝, flags = RT_SPAN_*
+    RT_TR_PERF,      // phase 동안의 performance counter 증가량 (rt_perf.h), flags = span | counter << 8
+    RT_TR_SKIP,      // undersampling: 읽기 전에 덮어써진 sample 수, flags = link 번호 (rt_sample.h)
+    RT_TR_REPEAT,    // oversampling: 다시 읽은 sample의 seq, flags = link 번호
+    RT_TR_PHASE_MAX
+};
+
+// phase 구간 종류 (RT_TR_BEGIN / RT_TR_FINISH의 flags)
+// sleep 구간은 BEGIN만 기록하고, 다음 job의 WAKE(release 시각)에서 끝난 것으로 본다
+enum
+{
+    RT_SPAN_SETUP = 1, // 기상 ~ 입력 데이터 읽기 완료
+    RT_SPAN_EXEC,      // execution (perception task는 아래 pre/func/post로 나뉨)
+    RT_SPAN_PRE,
+    RT_SPAN_FUNC,
+    RT_SPAN_POST,
+    RT_SPAN_SEND,      // 결과 쓰기/전송
+    RT_SPAN_LOG,       // trace 기록, DASM chain log queue 넣기
+    RT_SPAN_SLEEP,     // 다음 release까지 대기
+    RT_SPAN_MAX
+};
+
+// 32 bytes 고정 크기 record
+typedef struct
+{
+    int64_t ts_ns;  // CLOCK_MONOTONIC (ns)
+    int64_t arg;    // phase별 부가 값
+    uint32_t job;   // epoch 이후 release 번호 (k)
+    uint16_t phase; // RT_TR_*
+    uint16_t flags; // phase별 부가 값 (chain 번호 등)
+    int32_t cpu;    // record를 쓴 core
+    uint32_t reserved;
+} rt_trace_rec_t;
+
+// shared memory ring 구조체
+// head는 writer만, tail은 reader만 쓰므로 서로 다른 cache line에 둠 (false sharing 방지)
+typedef struct
+{
+    uint32_t magic;
+    uint32_t capacity;
+    int32_t pid;        // ring을 만든 task의 pid
+    char task[32];
+    _Alignas(64) uint64_t head;    // 다음에 쓸 위치 (writer)
+    uint64_t dropped;              // ring이 가득 차서 버린 record 수 (writer)
+    _Alignas(64) uint64_t tail;    // 다음에 읽을 위치 (reader)
+    _Alignas(64) rt_trace_rec_t recs[];
+} rt_trace_ring_t;
+
+// writer 쪽 상태: tail은 ring이 가득 찼다고 보일 때만 다시 읽음
+typedef struct
+{
+    rt_trace_ring_t *ring;
+    uint64_t head;
+    uint64_t tail_cache;
+} rt_trace_t;
+
+static rt_trace_t rt_tr;
+
+static inline size_t rt_trace_ring_size(uint32_t capacity)
+{
+    return sizeof(rt_trace_ring_t) + (size_t)capacity * sizeof(rt_trace_rec_t);
+}
+
+// /waters_trace_<task>[_i<instance>] 이름 생성, launcher가 WATERS_TASK를 넘겨주면 그 이름을 사용
+static inline void rt_trace_shm_name_for(int instance, const char *task, char *name, size_t len)
+{
+    char base[RT_INSTANCE_NAME_MAX];
+    snprintf(base, sizeof(base), "%s%.40s", RT_TRACE_SHM_PREFIX, task);
+    rt_instance_name_for(instance, base, name, len);
+}
+
+static inline void rt_trace_shm_name(const char *task, char *name, size_t len)
+{
+    rt_trace_shm_name_for(rt_instance_id(), task, name, len);
+}
+
+// trace ring 생성 (runnable thread 시작 전에 한 번 호출)
+// 이전 실행의 ring이 남아 있으면 unlink 후 새로 만든다 (drainer는 inode 변경을 보고 다시 연결)
+static inline void rt_trace_open(const char *default_task)
+{
+    const char *task = getenv("WATERS_TASK");
+    if (task == NULL || *task == '\0')
+        task = default_task;
+
+    char name[64];
+    rt_trace_shm_name(task, name, sizeof(name));
+    shm_unlink(name);
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0666);
+    if (fd == -1)
+    {
+        perror("trace_shm_open");
+        exit(EXIT_FAILURE);
+    }
+    size_t size = rt_trace_ring_size(RT_TRACE_CAPACITY);
+    if (ftruncate(fd, size) == -1)
+    {
+        perror("trace_ftruncate");
+        exit(EXIT_FAILURE);
+    }
+    rt_trace_ring_t *ring = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ring == MAP_FAILED)
+    {
+        perror("trace_mmap");
+        exit(EXIT_FAILURE);
+    }
+    memset(ring, 0, size); // 미리 page를 할당해 hot loop에서 page fault가 나지 않도록
+    ring->capacity = RT_TRACE_CAPACITY;
+    ring->pid = getpid();
+    snprintf(ring->task, sizeof(ring->task), "%s", task);
+    __atomic_store_n(&ring->magic, RT_TRACE_MAGIC, __ATOMIC_RELEASE);
+
+    rt_tr.ring = ring;
+    rt_tr.head = 0;
+    rt_tr.tail_cache = 0;
+}
+
+// record 한 개 기록 (hot path)
+static inline void rt_trace_ns(int64_t ts_ns, uint16_t phase, uint32_t job, uint16_t flags, int64_t arg)
+{
+    rt_trace_ring_t *ring = rt_tr.ring;
+    if (ring == NULL)
+        return;
+
+    if (rt_tr.head - rt_tr.tail_cache >= RT_TRACE_CAPACITY)
+    {
+        rt_tr.tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (rt_tr.head - rt_tr.tail_cache >= RT_TRACE_CAPACITY)
+        {
+            __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+
+    rt_trace_rec_t *r = &ring->recs[rt_tr.head & (RT_TRACE_CAPACITY - 1)];
+    r->ts_ns = ts_ns;
+    r->arg = arg;
+    r->job = job;
+    r->phase = phase;
+    r->flags = flags;
+    r->cpu = sched_getcpu();
+    r->reserved = 0;
+    rt_tr.head++;
+    __atomic_store_n(&ring->head, rt_tr.head, __ATOMIC_RELEASE);
+}
+
+// 이미 측정해 둔 timespec으로 기록 (clock_gettime을 추가로 부르지 않음)
+static inline void rt_trace_ts(const struct timespec *ts, uint16_t phase, uint32_t job, uint16_t flags, int64_t arg)
+{
+    rt_trace_ns((int64_t)ts->tv_sec * 1000000000LL + ts->tv_nsec, phase, job, flags, arg);
+}
+
+// 이미 측정해 둔 두 시각으로 phase 구간 기록 (begin/finish 한 쌍)
+static inline void rt_trace_span(const struct timespec *begin, const struct timespec *finish, uint16_t span, uint32_t job)
+{
+    rt_trace_ts(begin, RT_TR_BEGIN, job, span, 0);
+    rt_trace_ts(finish, RT_TR_FINISH, job, span, 0);
+}
+
+// job 마지막에 호출: log_begin ~ 지금을 log 구간으로 기록하고 sleep 구간 시작
+static inline void rt_trace_sleep(const struct timespec *log_begin, uint32_t job)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    rt_trace_span(log_begin, &now, RT_SPAN_LOG, job);
+    rt_trace_ts(&now, RT_TR_BEGIN, job, RT_SPAN_SLEEP, 0);
+}
+
+#endif
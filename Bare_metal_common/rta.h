@@ -0,0 +1,313 @@
+#ifndef RTA_H
+#define RTA_H
+
+// Partitioned fixed-priority 응답 시간 분석 (response-time analysis)
+// task_model.h의 model에서 mapping과 무관한 값(주기, 실행 시간, 복사 비용)을 rta_build로 한 번 계산해 두고,
+// task -> (core, priority) mapping마다 rta_analyze로 task별 WCRT를 구한다. (mapping 탐색에서 수천 번 호출)
+//
+// task i의 응답 시간 (deadline = 주기)
+//   R_i = C_i + S_i + B_i + Σ_{k: 같은 core, prio_k >= prio_i} ceil((R_i + J_k) / T_k) C_k
+//                         + Σ_{copy thread q: 같은 core, prio_q >= prio_i} ceil((R_i + J_q) / T_q) C_q
+//  - C: EXEC(또는 PRE + POST)의 WCET(task_model_wcet: UB + overrun) + 자기 data 복사 (shm critical section, TCP send, copy buffer 읽기)
+//  - S: GPU 구간(FUNCTION, usleep) self-suspension (C와 같은 WCET)
+//  - B: shm channel semaphore blocking. channel마다 사용자는 producer / consumer 둘뿐이고 job당 한 번씩 잡으므로
+//       channel당 상대의 critical section 한 번. POSIX semaphore에는 priority inheritance가 없어서
+//       상대가 critical section 안에서 자기 core의 더 높은 우선순위 task에게 선점될 수 있음:
+//         W = cs + Σ_{상대 core에서 상대보다 높은 우선순위} ceil((W + J) / T) C
+//       상대가 같은 core에서 우선순위가 같거나 높으면 critical section 도중에 i가 실행될 수 없으므로 0
+//  - copy thread (TCP 변형): consumer process의 thread라 consumer와 같은 core, 같은 우선순위(SCHED_FIFO 상속)로
+//       producer 주기마다 recv + buffer 복사. runnable과는 같은 우선순위 FIFO라 mutex 구간에서 서로 선점하지 않음
+//  - J: self-suspension(S 또는 B)이 있는 task는 R - C, copy thread는 producer의 R (data 도착 시각의 흔들림),
+//       그 밖에는 0. J가 R에 의존하므로 모든 R이 변하지 않을 때까지 반복 (holistic analysis)
+//       suspension이 있는 간섭 task는 jitter 대신 suspension을 실행으로 보는 방법(ceil(R / T) (C + S + B))도 안전하므로
+//       task마다 둘 중 작은 값을 사용 (짧은 remote blocking 때문에 jitter가 R - C로 커지는 경우)
+//  - SCHED_OTHER task는 priority 0 (모든 실시간 task보다 낮고, 서로 같은 우선순위로 취급)
+
+#include <stdint.h>
+#include <string.h>
+
+#include "task_model.h"
+
+#define RTA_MAX_TASKS TASK_MODEL_MAX_TASKS
+#define RTA_MAX_RES TASK_MODEL_MAX_EDGES
+#define RTA_MAX_HOLISTIC_ITER 32
+#define RTA_UNSCHEDULABLE INT64_MAX
+
+// 복사 비용 (host마다 다르므로 rta_cost_default 값을 필요하면 바꿔서 rta_build에 전달)
+typedef struct
+{
+    double memcpy_ns_per_byte; // 사용자 공간 memcpy
+    double net_ns_per_byte;    // loopback TCP send / recv 한쪽의 kernel 복사
+    int64_t sem_ns;            // sem_wait + sem_post
+    int64_t syscall_ns;        // send / recv 한 번의 고정 비용
+} rta_cost_t;
+
+typedef struct
+{
+    int num_tasks;
+    int64_t period[RTA_MAX_TASKS];
+    int64_t exec[RTA_MAX_TASKS];
+    int64_t suspend[RTA_MAX_TASKS];
+    // shm channel semaphore: 사용자 0 = producer, 1 = consumer
+    int num_res;
+    int res_user[RTA_MAX_RES][2];
+    int64_t res_cs[RTA_MAX_RES][2];
+    // TCP copy thread: owner(consumer) task의 core / 우선순위로 producer 주기마다 실행
+    int num_copy;
+    int copy_owner[RTA_MAX_RES];
+    int copy_producer[RTA_MAX_RES];
+    int64_t copy_cost[RTA_MAX_RES];
+} rta_model_t;
+
+typedef struct
+{
+    int core[RTA_MAX_TASKS];
+    int prio[RTA_MAX_TASKS]; // 클수록 높음, SCHED_OTHER는 0
+} rta_mapping_t;
+
+typedef struct
+{
+    int schedulable;                 // 모든 task의 R <= T
+    int64_t wcrt[RTA_MAX_TASKS];     // RTA_UNSCHEDULABLE: R > T
+    int64_t blocking[RTA_MAX_TASKS]; // semaphore blocking B
+} rta_result_t;
+
+static inline rta_cost_t rta_cost_default(void)
+{
+    // 약 8GB/s memcpy, 2GB/s loopback 복사
+    return (rta_cost_t){0.125, 0.5, 1000, 5000};
+}
+
+static inline void rta_build(rta_model_t *r, const task_model_t *m, const rta_cost_t *cost)
+{
+    memset(r, 0, sizeof(*r));
+    r->num_tasks = m->num_tasks;
+    for (int i = 0; i < m->num_tasks; i++)
+    {
+        r->period[i] = m->tasks[i].period_ns;
+        r->exec[i] = task_model_wcet(m->tasks[i].exec_ns);
+        r->suspend[i] = task_model_wcet(m->tasks[i].suspend_ns);
+    }
+    for (int e = 0; e < m->num_edges; e++)
+    {
+        const task_model_edge_t *edge = &m->edges[e];
+        int64_t copy = (int64_t)(edge->bytes * cost->memcpy_ns_per_byte);
+        if (edge->tcp)
+        {
+            int64_t net = cost->syscall_ns + (int64_t)(edge->bytes * cost->net_ns_per_byte);
+            r->exec[edge->producer] += net;  // send
+            r->exec[edge->consumer] += copy; // mutex buffer -> local copy
+            int q = r->num_copy++;
+            r->copy_owner[q] = edge->consumer;
+            r->copy_producer[q] = edge->producer;
+            r->copy_cost[q] = net + copy; // recv + local -> mutex buffer
+        }
+        else
+        {
+            int k = r->num_res++;
+            int64_t cs = cost->sem_ns + copy;
+            r->res_user[k][0] = edge->producer;
+            r->res_user[k][1] = edge->consumer;
+            r->res_cs[k][0] = cs;
+            r->res_cs[k][1] = cs;
+            r->exec[edge->producer] += cs;
+            r->exec[edge->consumer] += cs;
+        }
+    }
+}
+
+// 설명 파일의 mapping 그대로 (fifo / rr은 priority, 그 밖에는 0)
+static inline void rta_mapping_from_model(rta_mapping_t *map, const task_model_t *m)
+{
+    for (int i = 0; i < m->num_tasks; i++)
+    {
+        const task_model_task_t *t = &m->tasks[i];
+        map->core[i] = t->core;
+        map->prio[i] = (strcmp(t->policy, "fifo") == 0 || strcmp(t->policy, "rr") == 0) ? t->priority : 0;
+    }
+}
+
+static inline int64_t rta_ceil_div(int64_t a, int64_t b)
+{
+    return (a + b - 1) / b;
+}
+
+// core에서 prio보다 높은(strict = 1) 또는 같거나 높은(strict = 0) task와 copy thread의 간섭
+// skip_a, skip_b: 간섭에서 뺄 task (-1이면 없음)
+// jitter[k] > 0인 task는 suspended[k](S + B)를 실행으로 본 값과 비교해 작은 쪽
+static inline int64_t rta_interference(const rta_model_t *r, const rta_mapping_t *map, const int64_t *jitter,
+                                       const int64_t *suspended, const int64_t *copy_jitter, int core, int prio,
+                                       int strict, int skip_a, int skip_b, int64_t window)
+{
+    int64_t sum = 0;
+    for (int k = 0; k < r->num_tasks; k++)
+    {
+        if (k == skip_a || k == skip_b || map->core[k] != core)
+            continue;
+        if (map->prio[k] > prio || (!strict && map->prio[k] == prio))
+        {
+            int64_t by_jitter = rta_ceil_div(window + jitter[k], r->period[k]) * r->exec[k];
+            if (jitter[k] > 0)
+            {
+                int64_t oblivious = rta_ceil_div(window, r->period[k]) * (r->exec[k] + suspended[k]);
+                if (oblivious < by_jitter)
+                    by_jitter = oblivious;
+            }
+            sum += by_jitter;
+        }
+    }
+    for (int q = 0; q < r->num_copy; q++)
+    {
+        int owner = r->copy_owner[q];
+        if (map->core[owner] != core)
+            continue;
+        if (map->prio[owner] > prio || (!strict && map->prio[owner] == prio))
+            sum += rta_ceil_div(window + copy_jitter[q], r->period[r->copy_producer[q]]) * r->copy_cost[q];
+    }
+    return sum;
+}
+
+// 상대 holder가 semaphore를 잡은 뒤 놓을 때까지 (waiter는 간섭에서 제외), limit를 넘으면 RTA_UNSCHEDULABLE
+static inline int64_t rta_holder_time(const rta_model_t *r, const rta_mapping_t *map, const int64_t *jitter,
+                                      const int64_t *suspended, const int64_t *copy_jitter, int holder, int waiter,
+                                      int64_t cs, int64_t limit)
+{
+    if (map->core[holder] == map->core[waiter] && map->prio[holder] >= map->prio[waiter])
+        return 0;
+    int64_t w = cs, prev = -1;
+    while (w != prev)
+    {
+        if (w > limit)
+            return RTA_UNSCHEDULABLE;
+        prev = w;
+        w = cs + rta_interference(r, map, jitter, suspended, copy_jitter, map->core[holder], map->prio[holder], 1,
+                                  holder, waiter, prev);
+    }
+    return w;
+}
+
+// chain 하나의 end-to-end 상한 (rta_chain_bounds)
+enum
+{
+    RTA_BOUND_E2E = 0,      // 시작 task wake -> 처음 읽은 DASM job end
+    RTA_BOUND_REACTION,
+    RTA_BOUND_AGE,
+    RTA_BOUND_REACTION_LET,
+    RTA_BOUND_AGE_LET,
+    RTA_NUM_BOUNDS
+};
+
+// chain τ_L(시작 task) -> ... -> τ_1(DASM), task 사이의 위상(offset)은 임의로 가정
+// implicit communication (job 시작에 읽고 끝에 씀, 현재 구현):
+//   Reaction time <= Σ_{i=L..1} (T_i + R_i)       (직전 sample 직후의 event가 처음 출력에 반영되기까지)
+//   Data age      <= Σ_{i=L..2} (T_i + R_i) + R_1 (sample이 마지막으로 출력에 쓰일 때의 나이)
+//   E2E           <= Reaction - T_L              (시작 task wake부터 처음 읽은 DASM job end까지)
+// LET (release에 읽고 release + T에 씀):
+//   Reaction time <= Σ_{i=L..1} 2 T_i,  Data age <= Σ_{i=L..2} 2 T_i + T_1
+// R > T인 task가 있으면 implicit 값은 RTA_UNSCHEDULABLE (ch->len >= 1)
+static inline void rta_chain_bounds(const rta_model_t *r, const task_model_chain_t *ch, const int64_t *wcrt,
+                                    int64_t *out)
+{
+    int64_t sum = 0, let = 0;
+    int unschedulable = 0;
+    for (int k = 0; k + 1 < ch->len; k++)
+    {
+        int i = ch->task[k];
+        if (wcrt[i] == RTA_UNSCHEDULABLE)
+            unschedulable = 1;
+        else
+            sum += r->period[i] + wcrt[i];
+        let += 2 * r->period[i];
+    }
+    int last = ch->task[ch->len - 1];
+    if (wcrt[last] == RTA_UNSCHEDULABLE)
+        unschedulable = 1;
+    int64_t t1 = r->period[last], r1 = wcrt[last];
+    out[RTA_BOUND_REACTION] = unschedulable ? RTA_UNSCHEDULABLE : sum + t1 + r1;
+    out[RTA_BOUND_AGE] = unschedulable ? RTA_UNSCHEDULABLE : sum + r1;
+    out[RTA_BOUND_E2E] = unschedulable ? RTA_UNSCHEDULABLE : sum + t1 + r1 - r->period[ch->task[0]];
+    out[RTA_BOUND_REACTION_LET] = let + 2 * t1;
+    out[RTA_BOUND_AGE_LET] = let + t1;
+}
+
+// mapping 하나 분석. 모든 task가 R <= T이면 1 (R > T인 task의 wcrt는 RTA_UNSCHEDULABLE)
+static inline int rta_analyze(const rta_model_t *r, const rta_mapping_t *map, rta_result_t *out)
+{
+    int64_t jitter[RTA_MAX_TASKS] = {0};
+    int64_t suspended[RTA_MAX_TASKS] = {0};
+    int64_t copy_jitter[RTA_MAX_RES] = {0};
+    int64_t *resp = out->wcrt;
+    for (int i = 0; i < r->num_tasks; i++)
+        resp[i] = 0;
+    out->schedulable = 1;
+
+    for (int iter = 0; iter < RTA_MAX_HOLISTIC_ITER; iter++)
+    {
+        int changed = 0;
+        for (int i = 0; i < r->num_tasks; i++)
+        {
+            // semaphore blocking: 자기가 쓰는 channel마다 상대의 critical section 한 번
+            int64_t b = 0;
+            for (int k = 0; k < r->num_res && b != RTA_UNSCHEDULABLE; k++)
+                for (int u = 0; u < 2; u++)
+                {
+                    if (r->res_user[k][u] != i)
+                        continue;
+                    int64_t w = rta_holder_time(r, map, jitter, suspended, copy_jitter, r->res_user[k][1 - u], i,
+                                                r->res_cs[k][1 - u], r->period[i]);
+                    b = (w == RTA_UNSCHEDULABLE) ? RTA_UNSCHEDULABLE : b + w;
+                    break;
+                }
+            out->blocking[i] = b;
+
+            int64_t base = r->exec[i] + r->suspend[i];
+            int64_t R = RTA_UNSCHEDULABLE;
+            if (b != RTA_UNSCHEDULABLE)
+            {
+                base += b;
+                int64_t w = base, prev = -1;
+                while (w != prev && w <= r->period[i])
+                {
+                    prev = w;
+                    w = base + rta_interference(r, map, jitter, suspended, copy_jitter, map->core[i], map->prio[i],
+                                                0, i, -1, prev);
+                }
+                if (w == prev && w <= r->period[i])
+                    R = w;
+            }
+            if (R == RTA_UNSCHEDULABLE)
+                out->schedulable = 0;
+            if (R != resp[i])
+            {
+                resp[i] = R;
+                changed = 1;
+            }
+        }
+        if (!changed)
+            return out->schedulable;
+        // 다음 반복의 jitter (R > T인 task는 주기만큼으로 두고 계속 계산해서 나머지 task의 값도 남김)
+        for (int i = 0; i < r->num_tasks; i++)
+        {
+            if (resp[i] == RTA_UNSCHEDULABLE || out->blocking[i] == RTA_UNSCHEDULABLE)
+            {
+                jitter[i] = r->period[i];
+                suspended[i] = r->period[i];
+            }
+            else
+            {
+                suspended[i] = r->suspend[i] + out->blocking[i];
+                jitter[i] = (suspended[i] > 0) ? resp[i] - r->exec[i] : 0;
+            }
+        }
+        for (int q = 0; q < r->num_copy; q++)
+        {
+            int p = r->copy_producer[q];
+            copy_jitter[q] = (resp[p] == RTA_UNSCHEDULABLE) ? r->period[p] : resp[p];
+        }
+    }
+    // 반복 안에 수렴하지 않으면 안전하게 탈락으로 처리
+    out->schedulable = 0;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,488 @@
+#ifndef TASK_MODEL_H
+#define TASK_MODEL_H
+
+// pipeline task model
+// pipeline 설명 파일(launcher와 같은 형식)에서 task별 core / policy / priority / offset을 읽고,
+// 각 task 실행 파일의 source(<설명 파일 디렉터리>/<실행 파일 이름>.c)에 있는 #define에서
+//  - PERIOD_MS
+//  - EXEC_TICKS_LB/AVG/UB 또는 PREPROCESS / FUNCTION / POSTPROCESS_EXEC_TICKS_LB/AVG/UB
+//  - PERFORMANCE_Frequency (CPU_ / GPU_)
+//  - chain_type, chain_type_N, chain_level
+//  - INPUT_SIZE_B_by<producer> (식은 다른 #define과 + - * / 로 계산), copy_thread 유무
+// 을 읽어 분석 도구(Bare_metal_tools/e2e_bound.c 등)가 쓰는 model을 만든다.
+// FUNCTION 구간은 GPU 실행을 usleep으로 흉내내므로 CPU를 쓰지 않는 self-suspension으로 구분해 둠.
+// chain은 chain_type이 같은 task를 chain_level이 큰 것(시작 task)부터 1(DASM)까지 나열한 것이고,
+// chain에서 이웃한 task 사이의 전달(edge)은 크기와 전송 방식(shm + semaphore / TCP + copy thread)을 가진다.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <strings.h>
+
+#define TASK_MODEL_MAX_TASKS 32
+#define TASK_MODEL_MAX_CHAINS 5
+#define TASK_MODEL_MAX_LEVELS 8
+#define TASK_MODEL_MAX_INPUTS 8
+#define TASK_MODEL_MAX_EDGES 32
+#define TASK_MODEL_MAX_DEFINES 256
+
+enum
+{
+    TASK_MODEL_LB = 0,
+    TASK_MODEL_AVG,
+    TASK_MODEL_UB,
+    TASK_MODEL_NUM_BOUNDS
+};
+
+typedef struct
+{
+    char name[32];      // 설명 파일의 task 이름
+    char source[PATH_MAX];
+    int core;
+    char policy[8];     // other | fifo | rr | idle
+    int priority;
+    int64_t offset_ns;
+    int64_t period_ns;
+    int64_t exec_ns[TASK_MODEL_NUM_BOUNDS];    // CPU 실행 시간 (EXEC 또는 PRE + POST)
+    int64_t post_ns[TASK_MODEL_NUM_BOUNDS];    // exec_ns 중 GPU 구간 뒤의 POST, 없으면 0
+    int64_t suspend_ns[TASK_MODEL_NUM_BOUNDS]; // GPU 실행 (FUNCTION, usleep), 없으면 0
+    uint32_t chain_mask; // bit c: chain c에 속함
+    int level;           // chain_level (1 = DASM)
+    int num_inputs;      // INPUT_SIZE_B_by<이름> (입력이 하나뿐인 task는 INPUT_SIZE_B)
+    char input_from[TASK_MODEL_MAX_INPUTS][32]; // <이름> 소문자, INPUT_SIZE_B는 ""
+    int64_t input_bytes[TASK_MODEL_MAX_INPUTS];
+    int copy_threads;    // TCP 변형: 입력마다 copy thread가 받아서 mutex buffer에 복사
+} task_model_task_t;
+
+typedef struct
+{
+    int len;
+    int task[TASK_MODEL_MAX_LEVELS]; // 시작 task(level len)부터 DASM(level 1)까지의 task 번호
+} task_model_chain_t;
+
+// chain에서 이웃한 두 task 사이의 data 전달 (여러 chain이 공유하는 구간은 하나)
+typedef struct
+{
+    int producer;
+    int consumer;
+    int64_t bytes;
+    int tcp; // 1: socket + consumer의 copy thread, 0: shared memory + semaphore
+} task_model_edge_t;
+
+typedef struct
+{
+    int num_tasks;
+    task_model_task_t tasks[TASK_MODEL_MAX_TASKS];
+    task_model_chain_t chains[TASK_MODEL_MAX_CHAINS + 1]; // 1 ~ 5 사용, len 0이면 없음
+    int num_edges;
+    task_model_edge_t edges[TASK_MODEL_MAX_EDGES];
+} task_model_t;
+
+typedef struct
+{
+    char name[64];
+    char text[160]; // 이름 뒤의 정의 (주석 제외)
+} task_model_define_t;
+
+// source의 object-like #define을 모두 모음 (값은 task_model_define에서 계산)
+static inline int task_model_read_defines(const char *path, task_model_define_t *defs, int max_defs)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+        return -1;
+    int n = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), fp) != NULL && n < max_defs)
+    {
+        char name[64];
+        int pos;
+        if (sscanf(line, " #define %63[A-Za-z0-9_]%n", name, &pos) != 1 || line[pos] == '(')
+            continue;
+        char *comment = strstr(line + pos, "//");
+        if (comment != NULL)
+            *comment = '\0';
+        snprintf(defs[n].name, sizeof(defs[n].name), "%s", name);
+        snprintf(defs[n].text, sizeof(defs[n].text), "%s", line + pos);
+        n++;
+    }
+    fclose(fp);
+    return n;
+}
+
+// #define 값 계산: 숫자, 다른 #define 이름, + - * / 와 괄호로 된 식만 (size_B = size_KB * 1024 등)
+typedef struct
+{
+    const task_model_define_t *defs;
+    int n;
+    const char *p;
+    int depth;
+    int ok;
+} task_model_expr_t;
+
+static inline int task_model_define(const task_model_define_t *defs, int n, const char *name, double *out);
+static inline double task_model_expr_sum(task_model_expr_t *e);
+
+static inline double task_model_expr_term(task_model_expr_t *e)
+{
+    while (*e->p == ' ' || *e->p == '\t')
+        e->p++;
+    if (*e->p == '(')
+    {
+        e->p++;
+        double v = task_model_expr_sum(e);
+        while (*e->p == ' ' || *e->p == '\t')
+            e->p++;
+        if (*e->p != ')')
+            e->ok = 0;
+        else
+            e->p++;
+        return v;
+    }
+    if (*e->p == '-')
+    {
+        e->p++;
+        return -task_model_expr_term(e);
+    }
+    if ((*e->p >= '0' && *e->p <= '9') || *e->p == '.')
+    {
+        char *end;
+        double v = strtod(e->p, &end);
+        e->p = end;
+        return v;
+    }
+    char name[64];
+    int len = 0;
+    while (len < 63 && ((*e->p >= 'A' && *e->p <= 'Z') || (*e->p >= 'a' && *e->p <= 'z') ||
+                        (*e->p >= '0' && *e->p <= '9') || *e->p == '_'))
+        name[len++] = *e->p++;
+    name[len] = '\0';
+    double v = 0;
+    if (len == 0 || e->depth > 16)
+        e->ok = 0;
+    else
+    {
+        // 이름이 가리키는 #define을 재귀로 계산 (순환 정의는 depth로 끊음)
+        for (int i = 0; i < e->n; i++)
+            if (strcmp(e->defs[i].name, name) == 0)
+            {
+                task_model_expr_t sub = {e->defs, e->n, e->defs[i].text, e->depth + 1, 1};
+                v = task_model_expr_sum(&sub);
+                e->ok &= sub.ok;
+                return v;
+            }
+        e->ok = 0;
+    }
+    return v;
+}
+
+static inline double task_model_expr_product(task_model_expr_t *e)
+{
+    double v = task_model_expr_term(e);
+    for (;;)
+    {
+        while (*e->p == ' ' || *e->p == '\t')
+            e->p++;
+        if (*e->p == '*')
+        {
+            e->p++;
+            v *= task_model_expr_term(e);
+        }
+        else if (*e->p == '/')
+        {
+            e->p++;
+            double d = task_model_expr_term(e);
+            if (d == 0)
+                e->ok = 0;
+            else
+                v /= d;
+        }
+        else
+            return v;
+    }
+}
+
+static inline double task_model_expr_sum(task_model_expr_t *e)
+{
+    double v = task_model_expr_product(e);
+    for (;;)
+    {
+        while (*e->p == ' ' || *e->p == '\t')
+            e->p++;
+        if (*e->p == '+')
+        {
+            e->p++;
+            v += task_model_expr_product(e);
+        }
+        else if (*e->p == '-')
+        {
+            e->p++;
+            v -= task_model_expr_product(e);
+        }
+        else
+            return v;
+    }
+}
+
+// 이름으로 #define 값 찾기 (없거나 식을 계산할 수 없으면 0 반환)
+static inline int task_model_define(const task_model_define_t *defs, int n, const char *name, double *out)
+{
+    for (int i = 0; i < n; i++)
+        if (strcmp(defs[i].name, name) == 0)
+        {
+            task_model_expr_t e = {defs, n, defs[i].text, 0, 1};
+            double v = task_model_expr_sum(&e);
+            while (*e.p == ' ' || *e.p == '\t' || *e.p == '\r' || *e.p == '\n')
+                e.p++;
+            if (!e.ok || *e.p != '\0')
+                return 0;
+            *out = v;
+            return 1;
+        }
+    return 0;
+}
+
+// prefix + "EXEC_TICKS_LB/AVG/UB" 세 값을 ns로 (GHz = tick/ns)
+static inline int task_model_ticks(const task_model_define_t *defs, int n, const char *prefix, double ghz,
+                                   int64_t *out)
+{
+    static const char *suffix[TASK_MODEL_NUM_BOUNDS] = {"LB", "AVG", "UB"};
+    for (int b = 0; b < TASK_MODEL_NUM_BOUNDS; b++)
+    {
+        char name[64];
+        double ticks;
+        snprintf(name, sizeof(name), "%sEXEC_TICKS_%s", prefix, suffix[b]);
+        if (!task_model_define(defs, n, name, &ticks))
+            return 0;
+        out[b] = (int64_t)(ticks / ghz);
+    }
+    return 1;
+}
+
+// rand_range로 뽑는 실행 시간의 실제 최댓값: UB를 넘는 overrun(확률 0.001)이 UB + AVG/10까지 가능
+// (PRE + POST는 각자 overrun해도 합이 exec_ns[UB] + exec_ns[AVG]/10과 같음)
+static inline int64_t task_model_wcet(const int64_t *bounds)
+{
+    return bounds[TASK_MODEL_UB] + bounds[TASK_MODEL_AVG] / 10;
+}
+
+// source에 word가 나오는지 (TCP 변형의 copy thread 확인용)
+static inline int task_model_source_has(const char *path, const char *word)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+        return 0;
+    char line[512];
+    int found = 0;
+    while (!found && fgets(line, sizeof(line), fp) != NULL)
+        found = strstr(line, word) != NULL;
+    fclose(fp);
+    return found;
+}
+
+// task 하나의 source를 읽어 주기, 실행 시간, chain 정보를 채움 (chain_level이 없으면 0 반환: 보조 task)
+static inline int task_model_parse_source(task_model_task_t *t)
+{
+    task_model_define_t defs[TASK_MODEL_MAX_DEFINES];
+    int n = task_model_read_defines(t->source, defs, TASK_MODEL_MAX_DEFINES);
+    if (n < 0)
+        return 0;
+
+    double level, period_ms;
+    if (!task_model_define(defs, n, "chain_level", &level) || !task_model_define(defs, n, "PERIOD_MS", &period_ms))
+        return 0;
+    t->level = (int)level;
+    t->period_ns = (int64_t)(period_ms * 1.0e6);
+
+    double cpu_ghz, gpu_ghz;
+    if (!task_model_define(defs, n, "PERFORMANCE_Frequency", &cpu_ghz) &&
+        !task_model_define(defs, n, "CPU_PERFORMANCE_Frequency", &cpu_ghz))
+        cpu_ghz = 3.4;
+    if (!task_model_define(defs, n, "GPU_PERFORMANCE_Frequency", &gpu_ghz))
+        gpu_ghz = 1.3;
+
+    memset(t->exec_ns, 0, sizeof(t->exec_ns));
+    memset(t->suspend_ns, 0, sizeof(t->suspend_ns));
+    memset(t->post_ns, 0, sizeof(t->post_ns));
+    int64_t pre[TASK_MODEL_NUM_BOUNDS], post[TASK_MODEL_NUM_BOUNDS];
+    if (!task_model_ticks(defs, n, "", cpu_ghz, t->exec_ns))
+    {
+        if (!task_model_ticks(defs, n, "PREPROCESS_", cpu_ghz, pre) ||
+            !task_model_ticks(defs, n, "POSTPROCESS_", cpu_ghz, post) ||
+            !task_model_ticks(defs, n, "FUNCTION_", gpu_ghz, t->suspend_ns))
+        {
+            fprintf(stderr, "[task_model] %s: no EXEC_TICKS bounds\n", t->source);
+            return 0;
+        }
+        for (int b = 0; b < TASK_MODEL_NUM_BOUNDS; b++)
+        {
+            t->exec_ns[b] = pre[b] + post[b];
+            t->post_ns[b] = post[b];
+        }
+    }
+
+    // chain_type (task 하나가 chain 하나) 또는 chain_type_1 ~ chain_type_N (여러 chain의 공통 task)
+    t->chain_mask = 0;
+    double c;
+    if (task_model_define(defs, n, "chain_type", &c) && c >= 1 && c <= TASK_MODEL_MAX_CHAINS)
+        t->chain_mask |= 1u << (int)c;
+    for (int i = 1; i <= TASK_MODEL_MAX_CHAINS; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "chain_type_%d", i);
+        if (task_model_define(defs, n, name, &c) && c >= 1 && c <= TASK_MODEL_MAX_CHAINS)
+            t->chain_mask |= 1u << (int)c;
+    }
+
+    // 입력 data 크기
+    t->num_inputs = 0;
+    for (int i = 0; i < n && t->num_inputs < TASK_MODEL_MAX_INPUTS; i++)
+    {
+        const char *from;
+        if (strcmp(defs[i].name, "INPUT_SIZE_B") == 0)
+            from = "";
+        else if (strncmp(defs[i].name, "INPUT_SIZE_B_by", 15) == 0)
+            from = defs[i].name + 15;
+        else
+            continue;
+        double bytes;
+        if (!task_model_define(defs, n, defs[i].name, &bytes))
+            continue;
+        int k = t->num_inputs++;
+        snprintf(t->input_from[k], sizeof(t->input_from[k]), "%s", from);
+        for (char *q = t->input_from[k]; *q; q++)
+            if (*q >= 'A' && *q <= 'Z')
+                *q += 'a' - 'A';
+        t->input_bytes[k] = (int64_t)bytes;
+    }
+    t->copy_threads = task_model_source_has(t->source, "copy_thread");
+    return 1;
+}
+
+// consumer가 producer에게서 받는 크기: INPUT_SIZE_B_by<producer 이름>, 입력이 하나면 INPUT_SIZE_B
+static inline int64_t task_model_input_bytes(const task_model_task_t *consumer, const char *producer)
+{
+    for (int k = 0; k < consumer->num_inputs; k++)
+        if (strcasecmp(consumer->input_from[k], producer) == 0 ||
+            (consumer->num_inputs == 1 && consumer->input_from[k][0] == '\0'))
+            return consumer->input_bytes[k];
+    return 0;
+}
+
+// chain c: chain_mask에 c가 있는 task를 level 내림차순으로
+static inline void task_model_build_chains(task_model_t *m)
+{
+    for (int c = 1; c <= TASK_MODEL_MAX_CHAINS; c++)
+    {
+        task_model_chain_t *ch = &m->chains[c];
+        ch->len = 0;
+        for (int i = 0; i < m->num_tasks && ch->len < TASK_MODEL_MAX_LEVELS; i++)
+            if (m->tasks[i].chain_mask & (1u << c))
+                ch->task[ch->len++] = i;
+        for (int a = 1; a < ch->len; a++)
+            for (int b = a; b > 0 && m->tasks[ch->task[b]].level > m->tasks[ch->task[b - 1]].level; b--)
+            {
+                int tmp = ch->task[b];
+                ch->task[b] = ch->task[b - 1];
+                ch->task[b - 1] = tmp;
+            }
+        // level이 len부터 1까지 하나씩 이어지지 않으면 (source 일부만 있는 경우 등) chain으로 쓰지 않음
+        for (int k = 0; k < ch->len; k++)
+            if (m->tasks[ch->task[k]].level != ch->len - k)
+            {
+                fprintf(stderr, "[task_model] chain %d: levels are not contiguous, ignored\n", c);
+                ch->len = 0;
+                break;
+            }
+    }
+
+    // chain의 이웃한 task 쌍마다 edge 하나
+    m->num_edges = 0;
+    for (int c = 1; c <= TASK_MODEL_MAX_CHAINS; c++)
+    {
+        const task_model_chain_t *ch = &m->chains[c];
+        for (int k = 0; k + 1 < ch->len; k++)
+        {
+            int p = ch->task[k], q = ch->task[k + 1], e;
+            for (e = 0; e < m->num_edges; e++)
+                if (m->edges[e].producer == p && m->edges[e].consumer == q)
+                    break;
+            if (e < m->num_edges || m->num_edges >= TASK_MODEL_MAX_EDGES)
+                continue;
+            task_model_edge_t *edge = &m->edges[m->num_edges++];
+            edge->producer = p;
+            edge->consumer = q;
+            edge->bytes = task_model_input_bytes(&m->tasks[q], m->tasks[p].name);
+            edge->tcp = m->tasks[q].copy_threads;
+        }
+    }
+}
+
+// 설명 파일 읽기: task 줄의 실행 명령이 <경로>/<이름> 이면 <src_dir>/<이름>.c 를 source로 사용
+// (src_dir이 NULL이면 설명 파일이 있는 디렉터리)
+// source가 없거나 chain_level이 없는 task(trace drainer 등)는 model에서 제외
+static inline int task_model_load(task_model_t *m, const char *conf_path, const char *src_dir)
+{
+    FILE *fp = fopen(conf_path, "r");
+    if (fp == NULL)
+    {
+        perror("[task_model] description open");
+        return -1;
+    }
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s", src_dir != NULL ? src_dir : conf_path);
+    char *slash = strrchr(dir, '/');
+    if (src_dir == NULL && slash != NULL)
+        *slash = '\0';
+    else if (src_dir == NULL)
+        snprintf(dir, sizeof(dir), ".");
+
+    memset(m, 0, sizeof(*m));
+    char line[512];
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        char *hash = strchr(line, '#');
+        if (hash != NULL)
+            *hash = '\0';
+        char *tok[8];
+        int ntok = 0;
+        for (char *s = strtok(line, " \t\r\n"); s != NULL && ntok < 8; s = strtok(NULL, " \t\r\n"))
+            tok[ntok++] = s;
+        if (ntok < 6 || strcmp(tok[0], "task") != 0 || m->num_tasks >= TASK_MODEL_MAX_TASKS)
+            continue;
+
+        task_model_task_t *t = &m->tasks[m->num_tasks];
+        memset(t, 0, sizeof(*t));
+        snprintf(t->name, sizeof(t->name), "%s", tok[1]);
+        t->core = atoi(tok[2]);
+        snprintf(t->policy, sizeof(t->policy), "%s", tok[3]);
+        t->priority = atoi(tok[4]);
+        int cmd = 5;
+        if (strncmp(tok[cmd], "offset_us=", 10) == 0)
+        {
+            t->offset_ns = atoll(tok[cmd] + 10) * 1000;
+            cmd++;
+        }
+        if (cmd >= ntok)
+            continue;
+        const char *exe = strrchr(tok[cmd], '/');
+        exe = (exe != NULL) ? exe + 1 : tok[cmd];
+        int len = snprintf(t->source, sizeof(t->source), "%s/%s.c", dir, exe);
+        if (len > 0 && (size_t)len < sizeof(t->source) && task_model_parse_source(t))
+            m->num_tasks++;
+    }
+    fclose(fp);
+    task_model_build_chains(m);
+    return 0;
+}
+
+static inline int task_model_find(const task_model_t *m, const char *name)
+{
+    for (int i = 0; i < m->num_tasks; i++)
+        if (strcmp(m->tasks[i].name, name) == 0)
+            return i;
+    return -1;
+}
+
+#endif
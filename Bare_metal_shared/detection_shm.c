@@ -13,6 +13,13 @@
 #include <semaphore.h>
 #include <sched.h>
 
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/rt_perf.h"
+#include "../Bare_metal_common/chain_msg.h"
+
 // 설정 값
 #define CPU_PERFORMANCE_Frequency 3.4      // Intel i7의 clock speed (GHz)
 #define GPU_PERFORMANCE_Frequency 1.3      // NVIDIA GPU의 clock speed (GHz)
@@ -54,14 +61,11 @@
 #define FUNCTION_EXEC_TIME_AVG (FUNCTION_EXEC_TICKS_AVG / GPU_PERFORMANCE_Frequency) // nanoseconds 단위로 변환
 #define FUNCTION_EXEC_TIME_UB (FUNCTION_EXEC_TICKS_UB / GPU_PERFORMANCE_Frequency)   // nanoseconds 단위로 변환
 
-// 메세지 OFFSET 설정
+// 메세지 slot 설정 (layout은 chain_msg.h)
 #define chain_type 5 //detection은 Chain_type 5에 해당함
 #define chain_level 3 //detection은 Chain_level 3에 해당함
-#define message_size_of_chain 256 //하나의 task chain마다 할당되는 message size 크기
-#define message_size_of_task 64 //하나의 task마다 할당되는 message size 크기
-#define message_format_unit 16 //task가 사용하는 Message의 format 단위 16bytes
+CHAIN_MSG_ASSERT_FITS(OUTPUT_SIZE_B);
 
-#define offset (((chain_type-1)*message_size_of_chain) + ((chain_level-2)*message_size_of_task)) //detection의 Message가 저장되는 offset
 
 // Shared memory setting
 #define SHM_NAME "/detection_planner_shm"
@@ -100,67 +104,26 @@ double rand_range(double min, double avg, double max)
     }
 }
 
-// 전송할 메세지의 구조체
-// message_size_of_task 크기는 64bytes - 16bytes 단위로 분할
-//[0-15]: ID //이 중에서 1byte만 사용
-//[16-31]: 주기가 깨는 시점 //16bytes
-//[32-47]: Task start 시점 //16bytes //다른 task 들 때문에, recv_time으로 표기
-//[48-63]: Task Data 전송 시점 //16bytes //전송을 위해 data 준비하는 시점에서부터 시작
-// message_format_unit을 사용 (16bytes)
-// int64_t는 8bytes size
-typedef struct
-{
-    uint8_t id;
-
-    int64_t wake_sec;
-    int64_t wake_nsec;
-
-    int64_t recv_sec;
-    int64_t recv_nsec;
-
-    int64_t send_sec;
-    int64_t send_nsec;
-
-} TaskHeader;
-
-// out의 필드에서 읽어 buffer에 offset 위치부터 채움
-// buffer는 출력 버퍼, offset은 해당 TaskHeader의 시작 위치
-// TaskHeader는 id,wake,start,end 필드를 각 16bytes로 가짐
-// TaskHeader의 각 필드는 8bytes로 분리됨 (id를 제외하고, 8bytes씩 sec, nsec를 담당)
-// 따라서 총 64bytes를 작성
-void write_task_header(TaskHeader *out, char *buffer, int task_offset)
-{
-    // ID 작성
-    memcpy(buffer + task_offset, &out->id, sizeof(uint8_t)); // 1byte 만큼 ID 사용
-    // Wake 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 2), &out->wake_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 3), &out->wake_nsec, sizeof(int64_t));
-    // Start 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 4), &out->recv_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 5), &out->recv_nsec, sizeof(int64_t));
-    // End 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 6), &out->send_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 7), &out->send_nsec, sizeof(int64_t));
-}
-
 // ---------------------- Thread Function ---------------------
 void *detection_runnable_thread(void *arg)
 {
     char *shm_base = (char *)arg; // shm_base: main문에 작성된 shared memory에 접근할 수 있는 포인터
     // char result[OUTPUT_SIZE_B];   // 결과를 저장할 버퍼 // 24KB
     struct timespec next, start, send_time, end;
-    int id = 0;
+    uint64_t seq = 0; // 보낸 data의 seq (rt_release_seq: release 번호 + 1, 재시작해도 증가)
 
-    clock_gettime(CLOCK_MONOTONIC, &next); // 주기를 위한 시간 측정
+    rt_trace_open("detection"); // hot loop의 출력은 trace ring으로 (trace_drain이 파일로 저장)
+    rt_perf_open();  // WATERS_PERF=1: phase별 performance counter
+    rt_release_t release;
+    rt_release_init(&release, PERIOD_NS, &next); // 공통 epoch(+offset)의 첫 release까지 대기
 
     while (1)
     {
         // 1. Setup phase: 기상, 데이터 읽기 완료(detection은 edge task라 데이터 읽기 X)
         clock_gettime(CLOCK_MONOTONIC, &start);
-        double next_ms = next.tv_sec * 1000.0 + next.tv_nsec / 1.0e6;
-        printf("[detection] wake-up at %.3f ms\n", next_ms);
-        double start_ms = start.tv_sec * 1000.0 + start.tv_nsec / 1.0e6;
-        printf("[detection] Started at %.3f ms\n", start_ms);
+        rt_trace_ts(&next, RT_TR_WAKE, release.k, 0, 0);
+        rt_trace_ts(&start, RT_TR_START, release.k, 0, 0);
+        rt_perf_begin();
         // ------------------ setup phase 완료 ----------
 
         // 2.Execution phase: busy-loop, 데이터 생성
@@ -179,6 +142,8 @@ void *detection_runnable_thread(void *arg)
                 break;
         } while (1);
         // detection Function
+        struct timespec pre_end = exec_now; // preprocessing 종료 = function 시작
+        rt_perf_mark(RT_SPAN_PRE);
         double func_exec_ns = rand_range(FUNCTION_EXEC_TIME_LB, FUNCTION_EXEC_TIME_AVG, FUNCTION_EXEC_TIME_UB);
         double func_exec_us = func_exec_ns / 1000.0; // nanoseconds to microseconds
         usleep((useconds_t)func_exec_us);            // detection Function 실행 시간 시뮬레이션
@@ -187,6 +152,7 @@ void *detection_runnable_thread(void *arg)
         double post_exec_us = post_exec_ns / 1000.0; // nanoseconds to microseconds
         struct timespec post_exec_start;
         clock_gettime(CLOCK_MONOTONIC, &post_exec_start);
+        rt_perf_mark(RT_SPAN_FUNC);
         do
         {
             clock_gettime(CLOCK_MONOTONIC, &exec_now);
@@ -197,53 +163,36 @@ void *detection_runnable_thread(void *arg)
         } while (1);
 
         // detection 데이터 생성
-        id++; // detection ID 증가
-        if (id > 255)
-            id = 1; // ID가 255를 초과하면 1으로 초기화
+        seq = rt_release_seq(&release); // detection seq 증가
         // --------------Execution phase 완료-----
 
         // 3.Send phase: data packet 생성 시작
         clock_gettime(CLOCK_MONOTONIC, &send_time);
-        double send_time_ms = send_time.tv_sec * 1000.0 + send_time.tv_nsec / 1.0e6;
-        printf("[detection] send at %.3f ms\n", send_time_ms);
-
-        // message packet 생성 시작
-        TaskHeader detection;
-        detection.id = id;                       // detection ID 설정
-        detection.wake_sec = next.tv_sec;        // 주기에 의해 깬 시점
-        detection.wake_nsec = next.tv_nsec;      // 주기에 의해 깬 시점
-        detection.recv_sec = start.tv_sec;       // Scheduling되어 실행되는 시점
-        detection.recv_nsec = start.tv_nsec;     // Scheduling되어 실행되는 시점
-        detection.send_sec = send_time.tv_sec;   // execution이 끝나는 시점 (=data 전송 시점)
-        detection.send_nsec = send_time.tv_nsec; // execution이 끝나는 시점 (=data 전송 시점)
+        rt_perf_mark(RT_SPAN_POST);
 
         // shared memory에 쓰기
         sem_wait(sem);
-        write_task_header(&detection, shm_base, offset);
+        chain_slot_set(CHAIN_SLOT(chain_msg(shm_base), chain_type, chain_level), seq, &next, &start, &send_time);
         sem_post(sem); 
 
-        // 4.log print phase
+        // 4.trace phase: printf 대신 trace ring에 기록
         clock_gettime(CLOCK_MONOTONIC, &end);
-        double end_ms = end.tv_sec * 1000.0 + end.tv_nsec / 1.0e6;
-        printf("[detection] finished at %.3f ms\n", end_ms); // 끝난 시점 출력
-        double exec_time_ms = (send_time.tv_sec - start.tv_sec) * 1000.0 + (send_time.tv_nsec - start.tv_nsec) / 1.0e6;
-        printf("[detection] Execution time: %.3f ms\n", exec_time_ms); // 실행시간 출력
-        double resp_time_ms = (end.tv_sec - next.tv_sec) * 1000.0 + (end.tv_nsec - next.tv_nsec) / 1.0e6;
-        printf("[detection] Response time: %.3f ms\n", resp_time_ms); // 반응시간 출력
-        printf("[detection] send data value: detection = %d\n", detection.id);    // 생성 data id 출력
-        double post_exec_time_ms = (send_time.tv_sec - post_exec_start.tv_sec) * 1000.0 + (send_time.tv_nsec - post_exec_start.tv_nsec) / 1.0e6;
-        printf("[detection] Preprocessing time: %.3f ms\n", pre_exec_ns / 1e6); // detection preprocessing 시간 출력
-        printf("[detection] Function time: %.3f ms\n", func_exec_ns / 1e6);     // detection Function 시간 출력
-        printf("[detection] Postprocessing: %.3f ms\n", post_exec_time_ms);     // detection postprocessing 시간 출력
-        printf("[detection] Sleeping for %d ms\n\n", PERIOD_MS);                // 다음 주기까지 대기 시간 출력
+        rt_perf_mark(RT_SPAN_SEND);
+        rt_trace_ts(&send_time, RT_TR_SEND, release.k, 0, seq);
+        rt_trace_ts(&end, RT_TR_END, release.k, 0, seq);
+        rt_trace_ts(&end, RT_TR_PRE, release.k, 0, (int64_t)pre_exec_ns);
+        rt_trace_ts(&end, RT_TR_FUNC, release.k, 0, (int64_t)func_exec_ns);
+        rt_trace_ts(&end, RT_TR_POST, release.k, 0, (send_time.tv_sec - post_exec_start.tv_sec) * 1000000000LL + (send_time.tv_nsec - post_exec_start.tv_nsec));
+        rt_trace_span(&start, &send_time, RT_SPAN_EXEC, release.k);
+        rt_trace_span(&start, &pre_end, RT_SPAN_PRE, release.k);
+        rt_trace_span(&pre_end, &post_exec_start, RT_SPAN_FUNC, release.k);
+        rt_trace_span(&post_exec_start, &send_time, RT_SPAN_POST, release.k);
+        rt_trace_span(&send_time, &end, RT_SPAN_SEND, release.k);
+        rt_perf_flush(release.k);
 
         // 5. next period cal phase
-        next.tv_nsec += PERIOD_NS;
-        if (next.tv_nsec >= 1000000000)
-        {
-            next.tv_sec += 1;
-            next.tv_nsec -= 1000000000;
-        }
+        rt_trace_sleep(&end, release.k);   // end 이후 기록 구간 + sleep 시작
+        rt_release_next(&release, &next); // epoch + offset + k * period
         clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
     }
     return NULL;
@@ -263,7 +212,7 @@ void bind_process_to_core(int core_id) {
 // ---------------------- Main -------------------------------
 int main()
 {
-    bind_process_to_core(5);
+    bind_process_to_core(rt_core_from_env(5));
     // 1. shared memory 객체 생성(or 열기)
     /*
     - SHM_NAME: 전역변수로 정의된 공유 메모리의 이름 (/detection_planner_shm)
@@ -271,7 +220,7 @@ int main()
     - 0666: Unix 퍼미션, 모든 사용자에게 읽기/쓰기 허용.
     - 반환값 shm_fd: 공유 메모리 객체의 파일 디스크립터입니다.
     */
-    int shm_fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
+    int shm_fd = rt_mem_shm_open(rt_instance_name(SHM_NAME), O_CREAT | O_RDWR, 0666);
     // 실패 검사
     if (shm_fd == -1)
     {
@@ -283,7 +232,7 @@ int main()
     - shm_fd: shared memory 객체의 파일 디스크립터
     - OUTPUT_SIZE_B: 전역변수로 정의된 process의 output 크기
     */
-    if (ftruncate(shm_fd, OUTPUT_SIZE_B) == -1)
+    if (rt_mem_shm_truncate(shm_fd, OUTPUT_SIZE_B) == -1)
     {
         perror("ftruncate");
         exit(EXIT_FAILURE);
@@ -300,14 +249,14 @@ int main()
     - 0: 오프셋 (0부터 매핑 시작).
     - 반환값 shm_base: 공유 메모리에 접근할 수 있는 포인터입니다.
     */
-    char *shm_base = mmap(NULL, OUTPUT_SIZE_B, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    char *shm_base = rt_mem_shm_map(shm_fd, OUTPUT_SIZE_B, PROT_READ | PROT_WRITE);
     if (shm_base == MAP_FAILED)
     {
         perror("mmap");
         exit(EXIT_FAILURE);
     }
     // 3. Shared memory를 위해 semaphore 생성
-    sem = sem_open(SEM_NAME, O_CREAT, 0666, 1); // 초기값 1
+    sem = sem_open(rt_instance_name(SEM_NAME), O_CREAT, 0666, 1); // 초기값 1
     if (sem == SEM_FAILED)
     {
         perror("sem_open");
@@ -320,9 +269,9 @@ int main()
     pthread_join(tid, NULL);
 
     sem_close(sem);
-    sem_unlink(SEM_NAME); // 실험 후 unlink
+    sem_unlink(rt_instance_name(SEM_NAME)); // 실험 후 unlink
 
-    munmap(shm_base, OUTPUT_SIZE_B); // Shared_memory mapping 해제 (Virtual memory space에서 제거)
-    shm_unlink(SHM_NAME);            // Shared memory object 제거
+    rt_mem_shm_unmap(shm_base, OUTPUT_SIZE_B); // Shared_memory mapping 해제 (Virtual memory space에서 제거)
+    rt_mem_shm_unlink(rt_instance_name(SHM_NAME));            // Shared memory object 제거
     return 0;
 }
@@ -13,11 +13,28 @@
 #include <semaphore.h>
 #include <sched.h>
 
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/rt_perf.h"
+#include "../Bare_metal_common/chain_msg.h"
+
 // 설정 값
 #define PERFORMANCE_Frequency 3.4  // Intel i7의 clock speed (GHz)
 #define WCET_OVERRUN_PROBABILITY 0.001 // 실행시간이 WCET를 초과할 확률
 
 // 환경 값
+// input_data
+// by Localization: Lidar grabber와 CAN으로부터 수신한 Timestamp를 포함
+#define x_car_host_size_KB 1
+#define x_car_host_size_B (x_car_host_size_KB * 1024)
+#define y_car_host_size_KB 1
+#define y_car_host_size_B (y_car_host_size_KB * 1024)
+#define yaw_car_host_size_KB 1
+#define yaw_car_host_size_B (yaw_car_host_size_KB * 1024)
+#define INPUT_SIZE_B_byloc (x_car_host_size_B + y_car_host_size_B + yaw_car_host_size_B)
+
 // Output data
 // by ekf
 #define Matrix_ekf_host_size_KB 24
@@ -36,14 +53,19 @@
 #define EXEC_TIME_AVG (EXEC_TICKS_AVG / PERFORMANCE_Frequency) // nanoseconds 단위로 변환
 #define EXEC_TIME_UB (EXEC_TICKS_UB / PERFORMANCE_Frequency)   // nanoseconds 단위
 
-// 메세지 OFFSET 설정
-#define chain_type 1              // ekf은 Chain_type 3에 해당함
+// 메세지 slot 설정 (layout은 chain_msg.h)
+#define chain_type_1 1            // ekf은 Chain_type 1,2에 해당함
+#define chain_type_2 2
 #define chain_level 3             // ekf은 Chain_level 3에 해당함
-#define message_size_of_chain 256 // 하나의 task chain마다 할당되는 message size 크기
-#define message_size_of_task 64   // 하나의 task마다 할당되는 message size 크기
-#define message_format_unit 16    // task가 사용하는 Message의 format 단위 16bytes
+CHAIN_MSG_ASSERT_FITS(OUTPUT_SIZE_B);
 
-#define offset (((chain_type - 1) * message_size_of_chain) + ((chain_level - 2) * message_size_of_task)) // ekf의 Message가 저장되는 offset
+
+// INPUT(READ) 관련 설정
+#define INPUT_SHM_NAME "/loc_ekf_shm"
+#define INPUT_SEM_NAME "/loc_ekf_sem"
+char *INPUT_shm_ptr;
+sem_t *INPUT_sem;
+int INPUT_fd;
 
 // Shared memory setting
 #define SHM_NAME "/ekf_planner_shm"
@@ -82,70 +104,45 @@ double rand_range(double min, double avg, double max)
     }
 }
 
-// 전송할 메세지의 구조체
-// message_size_of_task 크기는 64bytes - 16bytes 단위로 분할
-//[0-15]: ID //이 중에서 1byte만 사용
-//[16-31]: 주기가 깨는 시점 //16bytes
-//[32-47]: Task start 시점 //16bytes //다른 task 들 때문에, recv_time으로 표기
-//[48-63]: Task Data 전송 시점 //16bytes //전송을 위해 data 준비하는 시점에서부터 시작
-// message_format_unit을 사용 (16bytes)
-// int64_t는 8bytes size
-typedef struct
-{
-    uint8_t id;
-
-    int64_t wake_sec;
-    int64_t wake_nsec;
-
-    int64_t recv_sec;
-    int64_t recv_nsec;
-
-    int64_t send_sec;
-    int64_t send_nsec;
-
-} TaskHeader;
-
-// out의 필드에서 읽어 buffer에 offset 위치부터 채움
-// buffer는 출력 버퍼, offset은 해당 TaskHeader의 시작 위치
-// TaskHeader는 id,wake,start,end 필드를 각 16bytes로 가짐
-// TaskHeader의 각 필드는 8bytes로 분리됨 (id를 제외하고, 8bytes씩 sec, nsec를 담당)
-// 따라서 총 64bytes를 작성
-void write_task_header(TaskHeader *out, char *buffer, int task_offset)
-{
-    // ID 작성
-    memcpy(buffer + task_offset, &out->id, sizeof(uint8_t)); // 1byte 만큼 ID 사용
-    // Wake 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 2), &out->wake_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 3), &out->wake_nsec, sizeof(int64_t));
-    // Start 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 4), &out->recv_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 5), &out->recv_nsec, sizeof(int64_t));
-    // End 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 6), &out->send_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 7), &out->send_nsec, sizeof(int64_t));
-}
-
 // ---------------------- Thread Function ---------------------
 void *ekf_runnable_thread(void *arg)
 {
     char *shm_base = (char *)arg; // shm_base: main문에 작성된 shared memory에 접근할 수 있는 포인터
-    // char result[OUTPUT_SIZE_B];   // 결과를 저장할 버퍼 // 24KB
-    struct timespec next, start, send_time, end;
-    int id = 0;
+    char local_copy_byloc[INPUT_SIZE_B_byloc] CHAIN_MSG_ALIGNED; // 3KB만큼 입력
+    chain_msg_t result;                                          // chain 1,2 영역만 사용
+    struct timespec next, start, recv_time, send_time, end;
+    uint64_t seq = 0; // 보낸 data의 seq (rt_release_seq: release 번호 + 1, 재시작해도 증가)
 
-    clock_gettime(CLOCK_MONOTONIC, &next); // 주기를 위한 시간 측정
+    rt_trace_open("ekf"); // hot loop의 출력은 trace ring으로 (trace_drain이 파일로 저장)
+    rt_perf_open();  // WATERS_PERF=1: phase별 performance counter
+    rt_release_t release;
+    rt_release_init(&release, PERIOD_NS, &next); // 공통 epoch(+offset)의 첫 release까지 대기
 
     while (1)
     {
-        // 1. Setup phase: 기상, 데이터 읽기 완료(ekf은 edge task라 데이터 읽기 X)
+        // 1. Setup phase: 기상, 데이터 읽기 완료
         clock_gettime(CLOCK_MONOTONIC, &start);
-        double next_ms = next.tv_sec * 1000.0 + next.tv_nsec / 1.0e6;
-        printf("[ekf] wake-up at %.3f ms\n", next_ms);
-        double start_ms = start.tv_sec * 1000.0 + start.tv_nsec / 1.0e6;
-        printf("[ekf] Started at %.3f ms\n", start_ms);
+        rt_trace_ts(&next, RT_TR_WAKE, release.k, 0, 0);
+        rt_trace_ts(&start, RT_TR_START, release.k, 0, 0);
+        rt_perf_begin();
+
+        // Localization 데이터 복사 (chain 1,2)
+        sem_wait(INPUT_sem);
+        memcpy(local_copy_byloc, INPUT_shm_ptr, INPUT_SIZE_B_byloc);
+        sem_post(INPUT_sem);
+
+        clock_gettime(CLOCK_MONOTONIC, &recv_time);
+        rt_perf_mark(RT_SPAN_SETUP);
         // ------------------ setup phase 완료 ----------
 
-        // 2.Execution phase: busy-loop, 데이터 생성
+        // 2.Execution phase: Data 읽기 및 설정, busy-loop, 데이터 생성
+        // chain 1,2에 해당하는 부분 추출 및 result 저장
+        *CHAIN_OF(&result, chain_type_1) = *CHAIN_OF(chain_msg_const(local_copy_byloc), chain_type_1);
+        *CHAIN_OF(&result, chain_type_2) = *CHAIN_OF(chain_msg_const(local_copy_byloc), chain_type_2);
+        // chain별로 읽은 chain 시작(level 5) data의 seq 기록, flags = chain 번호
+        rt_trace_ts(&recv_time, RT_TR_READ, release.k, 1, chain_msg_source(&result, chain_type_1)->seq);
+        rt_trace_ts(&recv_time, RT_TR_READ, release.k, 2, chain_msg_source(&result, chain_type_2)->seq);
+
         //  ekf 실행 시간 계산 (busy-loop)
         // busy-loop
         // execution time 계산
@@ -155,56 +152,44 @@ void *ekf_runnable_thread(void *arg)
         do
         {
             clock_gettime(CLOCK_MONOTONIC, &exec_now);
-            double elapsed_us = (exec_now.tv_sec - start.tv_sec) * 1e6 +
-                                (exec_now.tv_nsec - start.tv_nsec) / 1e3;
+            double elapsed_us = (exec_now.tv_sec - recv_time.tv_sec) * 1e6 +
+                                (exec_now.tv_nsec - recv_time.tv_nsec) / 1e3;
             if (elapsed_us >= exec_us)
                 break;
         } while (1);
 
         // ekf 데이터 생성
-        id++; // ekf ID 증가
-        if (id > 255)
-            id = 1; // ID가 255를 초과하면 1으로 초기화
+        seq = rt_release_seq(&release); // ekf seq 증가
         // --------------Execution phase 완료-----
 
         // 3.Send phase: data packet 생성 시작
         clock_gettime(CLOCK_MONOTONIC, &send_time);
-        double send_time_ms = send_time.tv_sec * 1000.0 + send_time.tv_nsec / 1.0e6;
-        printf("[ekf] send at %.3f ms\n", send_time_ms);
-
-        // message packet 생성 시작
-        TaskHeader ekf;
-        ekf.id = id;                       // ekf ID 설정
-        ekf.wake_sec = next.tv_sec;        // 주기에 의해 깬 시점
-        ekf.wake_nsec = next.tv_nsec;      // 주기에 의해 깬 시점
-        ekf.recv_sec = start.tv_sec;       // Scheduling되어 실행되는 시점
-        ekf.recv_nsec = start.tv_nsec;     // Scheduling되어 실행되는 시점
-        ekf.send_sec = send_time.tv_sec;   // execution이 끝나는 시점 (=data 전송 시점)
-        ekf.send_nsec = send_time.tv_nsec; // execution이 끝나는 시점 (=data 전송 시점)
-
-        // shared memory에 쓰기
+        rt_perf_mark(RT_SPAN_EXEC);
+
+        // message packet 생성 시작 (chain 1,2 모두 같은 slot 내용)
+        chain_slot_set(CHAIN_SLOT(&result, chain_type_1, chain_level), seq, &next, &recv_time, &send_time);
+        chain_slot_set(CHAIN_SLOT(&result, chain_type_2, chain_level), seq, &next, &recv_time, &send_time);
+
+        // shared memory에 쓰기 (chain 1,2 영역)
+        chain_msg_t *out = chain_msg(shm_base);
         sem_wait(sem);
-        write_task_header(&ekf, shm_base, offset);
-        sem_post(sem); 
+        *CHAIN_OF(out, chain_type_1) = *CHAIN_OF(&result, chain_type_1);
+        *CHAIN_OF(out, chain_type_2) = *CHAIN_OF(&result, chain_type_2);
+        sem_post(sem);
 
-        // 4.log print phase
+        // 4.trace phase: printf 대신 trace ring에 기록
         clock_gettime(CLOCK_MONOTONIC, &end);
-        double end_ms = end.tv_sec * 1000.0 + end.tv_nsec / 1.0e6;
-        printf("[ekf] finished at %.3f ms\n", end_ms); // 끝난 시점 출력
-        double exec_time_ms = (send_time.tv_sec - start.tv_sec) * 1000.0 + (send_time.tv_nsec - start.tv_nsec) / 1.0e6;
-        printf("[ekf] Execution time: %.3f ms\n", exec_time_ms); // 실행시간 출력
-        double resp_time_ms = (end.tv_sec - next.tv_sec) * 1000.0 + (end.tv_nsec - next.tv_nsec) / 1.0e6;
-        printf("[ekf] Response time: %.3f ms\n", resp_time_ms); // 반응시간 출력
-        printf("[ekf] send data value: ekf = %d\n", ekf.id);    // 생성 data id 출력
-        printf("[ekf] Sleeping for %d ms\n\n", PERIOD_MS);   // 다음 주기까지 대기 시간 출력
+        rt_perf_mark(RT_SPAN_SEND);
+        rt_trace_ts(&send_time, RT_TR_SEND, release.k, 0, seq);
+        rt_trace_ts(&end, RT_TR_END, release.k, 0, seq);
+        rt_trace_span(&start, &recv_time, RT_SPAN_SETUP, release.k);
+        rt_trace_span(&recv_time, &send_time, RT_SPAN_EXEC, release.k);
+        rt_trace_span(&send_time, &end, RT_SPAN_SEND, release.k);
+        rt_perf_flush(release.k);
 
         // 5. next period cal phase
-        next.tv_nsec += PERIOD_NS;
-        if (next.tv_nsec >= 1000000000)
-        {
-            next.tv_sec += 1;
-            next.tv_nsec -= 1000000000;
-        }
+        rt_trace_sleep(&end, release.k);   // end 이후 기록 구간 + sleep 시작
+        rt_release_next(&release, &next); // epoch + offset + k * period
         clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
     }
     return NULL;
@@ -223,7 +208,27 @@ void bind_process_to_core(int core_id) {
 // ---------------------- Main -------------------------------
 int main()
 {
-    bind_process_to_core(2); 
+    bind_process_to_core(rt_core_from_env(2));
+    // 읽기용 shm mmap + sem_open
+    INPUT_fd = rt_mem_shm_open(rt_instance_name(INPUT_SHM_NAME), O_RDONLY, 0666);
+    if (INPUT_fd == -1)
+    {
+        perror("input_shm_open");
+        exit(EXIT_FAILURE);
+    }
+    INPUT_shm_ptr = rt_mem_shm_map(INPUT_fd, INPUT_SIZE_B_byloc, PROT_READ);
+    if (INPUT_shm_ptr == MAP_FAILED)
+    {
+        perror("input_mmap");
+        exit(EXIT_FAILURE);
+    }
+    INPUT_sem = sem_open(rt_instance_name(INPUT_SEM_NAME), 0);
+    if (INPUT_sem == SEM_FAILED)
+    {
+        perror("input_sem_open");
+        exit(EXIT_FAILURE);
+    }
+
     // 1. shared memory 객체 생성(or 열기)
     /*
     - SHM_NAME: 전역변수로 정의된 공유 메모리의 이름 (/ekf_planner_shm)
@@ -231,7 +236,7 @@ int main()
     - 0666: Unix 퍼미션, 모든 사용자에게 읽기/쓰기 허용.
     - 반환값 shm_fd: 공유 메모리 객체의 파일 디스크립터입니다.
     */
-    int shm_fd = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666);
+    int shm_fd = rt_mem_shm_open(rt_instance_name(SHM_NAME), O_CREAT | O_RDWR, 0666);
     // 실패 검사
     if (shm_fd == -1)
     {
@@ -243,7 +248,7 @@ int main()
     - shm_fd: shared memory 객체의 파일 디스크립터
     - OUTPUT_SIZE_B: 전역변수로 정의된 process의 output 크기
     */
-    if (ftruncate(shm_fd, OUTPUT_SIZE_B) == -1)
+    if (rt_mem_shm_truncate(shm_fd, OUTPUT_SIZE_B) == -1)
     {
         perror("ftruncate");
         exit(EXIT_FAILURE);
@@ -260,14 +265,14 @@ int main()
     - 0: 오프셋 (0부터 매핑 시작).
     - 반환값 shm_base: 공유 메모리에 접근할 수 있는 포인터입니다.
     */
-    char *shm_base = mmap(NULL, OUTPUT_SIZE_B, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    char *shm_base = rt_mem_shm_map(shm_fd, OUTPUT_SIZE_B, PROT_READ | PROT_WRITE);
     if (shm_base == MAP_FAILED)
     {
         perror("mmap");
         exit(EXIT_FAILURE);
     }
     // 3. Shared memory를 위해 semaphore 생성
-    sem = sem_open(SEM_NAME, O_CREAT, 0666, 1); // 초기값 1
+    sem = sem_open(rt_instance_name(SEM_NAME), O_CREAT, 0666, 1); // 초기값 1
     if (sem == SEM_FAILED)
     {
         perror("sem_open");
@@ -280,9 +285,13 @@ int main()
     pthread_join(tid, NULL);
 
     sem_close(sem);
-    sem_unlink(SEM_NAME); // 실험 후 unlink
+    sem_unlink(rt_instance_name(SEM_NAME)); // 실험 후 unlink
+
+    rt_mem_shm_unmap(shm_base, OUTPUT_SIZE_B); // Shared_memory mapping 해제 (Virtual memory space에서 제거)
+    rt_mem_shm_unlink(rt_instance_name(SHM_NAME));            // Shared memory object 제거
 
-    munmap(shm_base, OUTPUT_SIZE_B); // Shared_memory mapping 해제 (Virtual memory space에서 제거)
-    shm_unlink(SHM_NAME);            // Shared memory object 제거
+    sem_close(INPUT_sem);
+    rt_mem_shm_unmap(INPUT_shm_ptr, INPUT_SIZE_B_byloc);
+    close(INPUT_fd);
     return 0;
 }
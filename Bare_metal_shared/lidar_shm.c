@@ -0,0 +1,232 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <math.h>
+#include <semaphore.h>
+#include <sched.h>
+
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/rt_perf.h"
+#include "../Bare_metal_common/chain_msg.h"
+
+// 설정 값
+#define PERFORMANCE_Frequency 3.4  // Intel i7의 clock speed (GHz)
+#define WCET_OVERRUN_PROBABILITY 0.001 // 실행시간이 WCET를 초과할 확률
+
+// 환경 값
+// Output data
+// by Lidar_grabber: occupancy grid
+#define Occupancy_grid_host_size_KB 500
+#define Occupancy_grid_host_size_B (Occupancy_grid_host_size_KB * 1024)
+#define OUTPUT_SIZE_B (Occupancy_grid_host_size_B)
+
+// execution
+#define PERIOD_MS 33
+// #define PERIOD_US (PERIOD_MS * 1000)    // microseconds 단위로 변환
+#define PERIOD_NS (PERIOD_MS * 1000000) // nanoseconds 단위로 변환
+
+// WATERS 2019 model의 평균 실행시간을 기준으로 +-5% 범위로 근사
+#define EXEC_TICKS_LB 37150000
+#define EXEC_TICKS_AVG 39100000
+#define EXEC_TICKS_UB 41050000
+#define EXEC_TIME_LB (EXEC_TICKS_LB / PERFORMANCE_Frequency)   // nanoseconds 단위로 변환
+#define EXEC_TIME_AVG (EXEC_TICKS_AVG / PERFORMANCE_Frequency) // nanoseconds 단위로 변환
+#define EXEC_TIME_UB (EXEC_TICKS_UB / PERFORMANCE_Frequency)   // nanoseconds 단위
+
+// 메세지 slot 설정 (layout은 chain_msg.h)
+#define chain_type 1              // Lidar_grabber은 Chain_type 1에 해당함
+#define chain_level 5             // Lidar_grabber은 Chain_level 5에 해당함
+CHAIN_MSG_ASSERT_FITS(OUTPUT_SIZE_B);
+
+
+// Shared memory setting
+#define SHM_NAME "/lidar_loc_shm"
+#define SEM_NAME "/lidar_loc_sem"
+sem_t *sem;
+
+// --------------------------------runnable Thread 설정 -----------------
+// 실행시간 난수 생성 함수
+// C에서 rand()의 결과를 [0, 1) 실수로 변환
+double rand_uniform()
+{
+    return ((double)rand()) / ((double)RAND_MAX + 1);
+}
+// exec_us 값을 생성하는 분포 함수
+double rand_range(double min, double avg, double max)
+{
+    // 확률 비율 계산
+    double p_avg = (max - avg) / (max - min);
+    // uniform 확률 변수 [0,1)
+    double x = rand_uniform();
+    if (x < p_avg)
+    {
+        // [min, avg] 구간 uniform
+        return min + rand_uniform() * (avg - min);
+    }
+    else if (x < 1.0 - WCET_OVERRUN_PROBABILITY)
+    {
+        // [avg, max] 구간 uniform
+        return avg + rand_uniform() * (max - avg);
+    }
+    else
+    {
+        // WCET overrun: max를 초과하는 희박한 경우
+        double u = rand_uniform();
+        return max + (avg * pow(u, 2) / 10.0); // 지수적으로 줄어드는 확률
+    }
+}
+
+// ---------------------- Thread Function ---------------------
+void *lidar_runnable_thread(void *arg)
+{
+    char *shm_base = (char *)arg; // shm_base: main문에 작성된 shared memory에 접근할 수 있는 포인터
+    struct timespec next, start, send_time, end;
+    uint64_t seq = 0; // 보낸 data의 seq (rt_release_seq: release 번호 + 1, 재시작해도 증가)
+
+    rt_trace_open("lidar"); // hot loop의 출력은 trace ring으로 (trace_drain이 파일로 저장)
+    rt_perf_open();  // WATERS_PERF=1: phase별 performance counter
+    rt_release_t release;
+    rt_release_init(&release, PERIOD_NS, &next); // 공통 epoch(+offset)의 첫 release까지 대기
+
+    while (1)
+    {
+        // 1. Setup phase: 기상, 데이터 읽기 완료(Lidar_grabber은 edge task라 데이터 읽기 X)
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        rt_trace_ts(&next, RT_TR_WAKE, release.k, 0, 0);
+        rt_trace_ts(&start, RT_TR_START, release.k, 0, 0);
+        rt_perf_begin();
+        // ------------------ setup phase 완료 ----------
+
+        // 2.Execution phase: busy-loop, 데이터 생성
+        //  Lidar_grabber 실행 시간 계산 (busy-loop)
+        // busy-loop
+        // execution time 계산
+        double exec_ns = rand_range(EXEC_TIME_LB, EXEC_TIME_AVG, EXEC_TIME_UB);
+        double exec_us = exec_ns / 1000.0;
+        struct timespec exec_now;
+        do
+        {
+            clock_gettime(CLOCK_MONOTONIC, &exec_now);
+            double elapsed_us = (exec_now.tv_sec - start.tv_sec) * 1e6 +
+                                (exec_now.tv_nsec - start.tv_nsec) / 1e3;
+            if (elapsed_us >= exec_us)
+                break;
+        } while (1);
+
+        // Lidar_grabber 데이터 생성
+        seq = rt_release_seq(&release); // Lidar_grabber seq 증가
+        // --------------Execution phase 완료-----
+
+        // 3.Send phase: data packet 생성 시작
+        clock_gettime(CLOCK_MONOTONIC, &send_time);
+        rt_perf_mark(RT_SPAN_EXEC);
+
+        // shared memory에 쓰기
+        sem_wait(sem);
+        chain_slot_set(CHAIN_SLOT(chain_msg(shm_base), chain_type, chain_level), seq, &next, &start, &send_time);
+        sem_post(sem); 
+
+        // 4.trace phase: printf 대신 trace ring에 기록
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        rt_perf_mark(RT_SPAN_SEND);
+        rt_trace_ts(&send_time, RT_TR_SEND, release.k, 0, seq);
+        rt_trace_ts(&end, RT_TR_END, release.k, 0, seq);
+        rt_trace_span(&start, &send_time, RT_SPAN_EXEC, release.k);
+        rt_trace_span(&send_time, &end, RT_SPAN_SEND, release.k);
+        rt_perf_flush(release.k);
+
+        // 5. next period cal phase
+        rt_trace_sleep(&end, release.k);   // end 이후 기록 구간 + sleep 시작
+        rt_release_next(&release, &next); // epoch + offset + k * period
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return NULL;
+}
+void bind_process_to_core(int core_id) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core_id, &cpuset);
+
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) != 0) {
+        perror("sched_setaffinity");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// ---------------------- Main -------------------------------
+int main()
+{
+    bind_process_to_core(rt_core_from_env(6));
+    // 1. shared memory 객체 생성(or 열기)
+    /*
+    - SHM_NAME: 전역변수로 정의된 공유 메모리의 이름 (/lidar_loc_shm)
+    - O_CREAT | O_RDWR: 없으면 새로 만들고, 읽기/쓰기 권한으로 엽니다.
+    - 0666: Unix 퍼미션, 모든 사용자에게 읽기/쓰기 허용.
+    - 반환값 shm_fd: 공유 메모리 객체의 파일 디스크립터입니다.
+    */
+    int shm_fd = rt_mem_shm_open(rt_instance_name(SHM_NAME), O_CREAT | O_RDWR, 0666);
+    // 실패 검사
+    if (shm_fd == -1)
+    {
+        perror("shm_open");
+        exit(EXIT_FAILURE);
+    }
+    // Shared memory 객체 크기 설정 및 실패 확인
+    /*
+    - shm_fd: shared memory 객체의 파일 디스크립터
+    - OUTPUT_SIZE_B: 전역변수로 정의된 process의 output 크기
+    */
+    if (rt_mem_shm_truncate(shm_fd, OUTPUT_SIZE_B) == -1)
+    {
+        perror("ftruncate");
+        exit(EXIT_FAILURE);
+    }
+
+    // 2. Shared memory object를 virtual memory space에 mmap을 통해 mapping
+    /*
+    - mmap()을 통해 공유 메모리 객체를 현재 프로세스의 가상 메모리 공간에 매핑합니다.
+    - NULL: 커널이 적절한 주소를 자동 선택.
+    - OUTPUT_SIZE_B: 매핑 크기 (500KB).
+    - PROT_READ | PROT_WRITE: 읽기/쓰기 가능.
+    - MAP_SHARED: 다른 프로세스와 메모리를 공유.
+    - shm_fd: 앞서 연 공유 메모리의 파일 디스크립터.
+    - 0: 오프셋 (0부터 매핑 시작).
+    - 반환값 shm_base: 공유 메모리에 접근할 수 있는 포인터입니다.
+    */
+    char *shm_base = rt_mem_shm_map(shm_fd, OUTPUT_SIZE_B, PROT_READ | PROT_WRITE);
+    if (shm_base == MAP_FAILED)
+    {
+        perror("mmap");
+        exit(EXIT_FAILURE);
+    }
+    // 3. Shared memory를 위해 semaphore 생성
+    sem = sem_open(rt_instance_name(SEM_NAME), O_CREAT, 0666, 1); // 초기값 1
+    if (sem == SEM_FAILED)
+    {
+        perror("sem_open");
+        exit(EXIT_FAILURE);
+    }
+
+    srand(time(NULL)); // 난수 초기화
+    pthread_t tid;
+    pthread_create(&tid, NULL, lidar_runnable_thread, shm_base); // shm_base: 공유 메모리에 접근할 수 있는 포인터
+    pthread_join(tid, NULL);
+
+    sem_close(sem);
+    sem_unlink(rt_instance_name(SEM_NAME)); // 실험 후 unlink
+
+    rt_mem_shm_unmap(shm_base, OUTPUT_SIZE_B); // Shared_memory mapping 해제 (Virtual memory space에서 제거)
+    rt_mem_shm_unlink(rt_instance_name(SHM_NAME));            // Shared memory object 제거
+    return 0;
+}
@@ -0,0 +1,310 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <math.h>
+#include <semaphore.h>
+#include <sched.h>
+
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/rt_perf.h"
+#include "../Bare_metal_common/chain_msg.h"
+
+// 설정 값
+#define PERFORMANCE_Frequency 3.4      // Intel i7의 clock speed (GHz)
+#define WCET_OVERRUN_PROBABILITY 0.001 // 실행시간이 WCET를 초과할 확률
+
+// 환경 값
+// input_data
+// by Lidar_grabber
+#define Occupancy_grid_host_size_KB 500
+#define Occupancy_grid_host_size_B (Occupancy_grid_host_size_KB * 1024)
+#define INPUT_SIZE_B_bylidar (Occupancy_grid_host_size_B)
+// by CAN
+#define Vehicle_status_host_size_KB 1
+#define Vehicle_status_host_size_B (Vehicle_status_host_size_KB * 1024)
+#define INPUT_SIZE_B_bycan (Vehicle_status_host_size_B)
+
+//  output data
+// by Localization
+#define x_car_host_size_KB 1
+#define x_car_host_size_B (x_car_host_size_KB * 1024)
+#define y_car_host_size_KB 1
+#define y_car_host_size_B (y_car_host_size_KB * 1024)
+#define yaw_car_host_size_KB 1
+#define yaw_car_host_size_B (yaw_car_host_size_KB * 1024)
+#define OUTPUT_SIZE_B (x_car_host_size_B + y_car_host_size_B + yaw_car_host_size_B)
+
+// execution
+#define PERIOD_MS 400
+#define PERIOD_US (PERIOD_MS * 1000)    // microseconds 단위로 변환
+#define PERIOD_NS (PERIOD_MS * 1000000) // nanoseconds 단위로 변환
+// WATERS 2019 model의 평균 실행시간을 기준으로 +-5% 범위로 근사
+#define EXEC_TICKS_LB 436050000
+#define EXEC_TICKS_AVG 459000000
+#define EXEC_TICKS_UB 481950000
+#define EXEC_TIME_LB (EXEC_TICKS_LB / PERFORMANCE_Frequency)   // nanoseconds 단위로 변환
+#define EXEC_TIME_AVG (EXEC_TICKS_AVG / PERFORMANCE_Frequency) // nanoseconds 단위로 변환
+#define EXEC_TIME_UB (EXEC_TICKS_UB / PERFORMANCE_Frequency)   // nanoseconds 단위로 변환
+
+// 메세지 slot 설정, layout은 chain_msg.h (Localization은 chain 1,2의 level 5 정보를 읽고 두 chain 영역에 작성해야함.)
+#define chain_type_1 1
+#define chain_type_2 2
+#define chain_level 4
+CHAIN_MSG_ASSERT_FITS(OUTPUT_SIZE_B);
+CHAIN_MSG_ASSERT_FITS_CHAIN(INPUT_SIZE_B_bycan, chain_type_2); // CAN channel은 chain 2 영역까지만 (chain_msg.h)
+
+// INPUT(READ) 관련 설정
+#define INPUT_NUM_PROCESSES 2 // Localization이 읽도록 연결된 Process 갯수
+const int INPUT_SIZE_B[INPUT_NUM_PROCESSES] = {
+    INPUT_SIZE_B_bylidar, INPUT_SIZE_B_bycan};
+const char *INPUT_SHM_NAMES[INPUT_NUM_PROCESSES] = {
+    "/lidar_loc_shm", "/can_loc_shm"};
+const char *INPUT_SEM_NAMES[INPUT_NUM_PROCESSES] = {
+    "/lidar_loc_sem", "/can_loc_sem"};
+char *INPUT_shm_ptrs[INPUT_NUM_PROCESSES]; // shared memory pointer들
+sem_t *INPUT_sems[INPUT_NUM_PROCESSES];    // semaphore pointer들
+int INPUT_fds[INPUT_NUM_PROCESSES];        // file descriptor들, 공유메모리 객체를 위해 존재
+
+// OUTPUT (Write)관련 설정
+#define OUTPUT_SHM_NAME "/loc_ekf_shm"
+#define OUTPUT_SEM_NAME "/loc_ekf_sem"
+char *OUTPUT_shm_ptr;
+sem_t *OUTPUT_sem;
+int OUTPUT_fd;
+
+// 실행시간 난수 생성 함수
+// C에서 rand()의 결과를 [0, 1) 실수로 변환
+double rand_uniform()
+{
+    return ((double)rand()) / ((double)RAND_MAX + 1);
+}
+// exec_us 값을 생성하는 분포 함수
+double rand_range(double min, double avg, double max)
+{
+    // 확률 비율 계산
+    double p_avg = (max - avg) / (max - min);
+    // uniform 확률 변수 [0,1)
+    double x = rand_uniform();
+    if (x < p_avg)
+    {
+        // [min, avg] 구간 uniform
+        return min + rand_uniform() * (avg - min);
+    }
+    else if (x < 1.0 - WCET_OVERRUN_PROBABILITY)
+    {
+        // [avg, max] 구간 uniform
+        return avg + rand_uniform() * (max - avg);
+    }
+    else
+    {
+        // WCET overrun: max를 초과하는 희박한 경우
+        double u = rand_uniform();
+        return max + (avg * pow(u, 2) / 10.0); // 지수적으로 줄어드는 확률
+    }
+}
+
+void *runnable_thread(void *arg)
+{
+    char *local_copy_bylidar = rt_mem_alloc(INPUT_SIZE_B_bylidar); // 500KB만큼 입력
+    char *local_copy_bycan = rt_mem_alloc(INPUT_SIZE_B_bycan);     // 1KB만큼 입력
+    char result[OUTPUT_SIZE_B] CHAIN_MSG_ALIGNED;                  // 3KB만큼 출력
+    chain_msg_t *msg = chain_msg(result);                           // result의 chain message 영역
+    struct timespec next, start, recv_time, send_time, end;
+    uint64_t seq = 0; // 보낸 data의 seq (rt_release_seq: release 번호 + 1, 재시작해도 증가)
+
+    memset(result, 0, sizeof(result));
+
+    rt_trace_open("loc"); // hot loop의 출력은 trace ring으로 (trace_drain이 파일로 저장)
+    rt_perf_open();  // WATERS_PERF=1: phase별 performance counter
+    rt_release_t release;
+    rt_release_init(&release, PERIOD_NS, &next); // 공통 epoch(+offset)의 첫 release까지 대기
+
+    while (1)
+    {
+        // 1.Setup phase: 기상, 데이터 읽기 완료
+        // 기상
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        rt_trace_ts(&next, RT_TR_WAKE, release.k, 0, 0);
+        rt_trace_ts(&start, RT_TR_START, release.k, 0, 0);
+        rt_perf_begin();
+
+        // 데이터 읽기 (shared memory)
+        // Lidar_grabber 데이터 복사 (chain 1)
+        sem_wait(INPUT_sems[0]);
+        memcpy(local_copy_bylidar, INPUT_shm_ptrs[0], INPUT_SIZE_B[0]);
+        sem_post(INPUT_sems[0]);
+        // CAN 데이터 복사 (chain 2)
+        sem_wait(INPUT_sems[1]);
+        memcpy(local_copy_bycan, INPUT_shm_ptrs[1], INPUT_SIZE_B[1]);
+        sem_post(INPUT_sems[1]);
+
+        clock_gettime(CLOCK_MONOTONIC, &recv_time);
+        rt_perf_mark(RT_SPAN_SETUP);
+        // ------------------ setup phase 완료 ----------
+        // 2. Execution phase: Data 읽기 및 설정, busy-loop
+
+        // Data 읽기 및 설정
+        // chain 1은 Lidar_grabber, chain 2는 CAN에서 추출해서 result 저장
+        *CHAIN_OF(msg, chain_type_1) = *CHAIN_OF(chain_msg_const(local_copy_bylidar), chain_type_1);
+        *CHAIN_OF(msg, chain_type_2) = *CHAIN_OF(chain_msg_const(local_copy_bycan), chain_type_2);
+        // chain별로 읽은 producer(level 5) data의 seq 기록, flags = chain 번호
+        rt_trace_ts(&recv_time, RT_TR_READ, release.k, 1, chain_msg_source(msg, chain_type_1)->seq);
+        rt_trace_ts(&recv_time, RT_TR_READ, release.k, 2, chain_msg_source(msg, chain_type_2)->seq);
+
+        // busy-loop
+        // execution time 계산
+        double exec_ns = rand_range(EXEC_TIME_LB, EXEC_TIME_AVG, EXEC_TIME_UB);
+        double exec_us = exec_ns / 1000.0;
+        struct timespec exec_now;
+        do
+        {
+            clock_gettime(CLOCK_MONOTONIC, &exec_now);
+            double elapsed_us = (exec_now.tv_sec - recv_time.tv_sec) * 1e6 +
+                                (exec_now.tv_nsec - recv_time.tv_nsec) / 1e3;
+            if (elapsed_us >= exec_us)
+                break;
+        } while (1);
+
+        // Localization 데이터 생성
+        seq = rt_release_seq(&release); // Localization seq 증가
+
+        // 3. send phase: data packet 생성 시작
+        clock_gettime(CLOCK_MONOTONIC, &send_time);
+        rt_perf_mark(RT_SPAN_EXEC);
+
+        //  EKF에 전송할 데이터 준비 (chain 1,2 모두 같은 slot 내용)
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_1, chain_level), seq, &next, &recv_time, &send_time);
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_2, chain_level), seq, &next, &recv_time, &send_time);
+        // result에 준비완료
+
+        // 결과를 EKF에 전송: memcpy
+        sem_wait(OUTPUT_sem);
+        memcpy(OUTPUT_shm_ptr, result, OUTPUT_SIZE_B);
+        sem_post(OUTPUT_sem);
+
+        // 4.trace phase: printf 대신 trace ring에 기록
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        rt_perf_mark(RT_SPAN_SEND);
+        rt_trace_ts(&send_time, RT_TR_SEND, release.k, 0, seq);
+        rt_trace_ts(&end, RT_TR_END, release.k, 0, seq);
+        rt_trace_span(&start, &recv_time, RT_SPAN_SETUP, release.k);
+        rt_trace_span(&recv_time, &send_time, RT_SPAN_EXEC, release.k);
+        rt_trace_span(&send_time, &end, RT_SPAN_SEND, release.k);
+        rt_perf_flush(release.k);
+
+        // 5.next period cal phase
+        //  주기 계산
+        rt_trace_sleep(&end, release.k);   // end 이후 기록 구간 + sleep 시작
+        rt_release_next(&release, &next); // epoch + offset + k * period
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return NULL;
+}
+
+void bind_process_to_core(int core_id) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core_id, &cpuset);
+
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) != 0) {
+        perror("sched_setaffinity");
+        exit(EXIT_FAILURE);
+    }
+}
+
+
+// ------------------------------
+int main()
+{
+    bind_process_to_core(rt_core_from_env(8));
+    // 읽기용 shm mmap + sem_open
+    for (int i = 0; i < INPUT_NUM_PROCESSES; ++i)
+    {
+        INPUT_fds[i] = rt_mem_shm_open(rt_instance_name(INPUT_SHM_NAMES[i]), O_RDONLY, 0666); // shared memory 객체 생성
+        if (INPUT_fds[i] == -1)
+        {
+            perror("input_shm_open");
+            exit(EXIT_FAILURE);
+        }
+        INPUT_shm_ptrs[i] = rt_mem_shm_map(INPUT_fds[i], INPUT_SIZE_B[i], PROT_READ);
+        if (INPUT_shm_ptrs[i] == MAP_FAILED)
+        {
+            perror("input_mmap");
+            exit(EXIT_FAILURE);
+        }
+
+        INPUT_sems[i] = sem_open(rt_instance_name(INPUT_SEM_NAMES[i]), 0);
+        if (INPUT_sems[i] == SEM_FAILED)
+        {
+            perror("input_sem_open");
+            exit(EXIT_FAILURE);
+        }
+    }
+    // 쓰기용 mmap + sem_open
+    // 1. shared memory 객체 생성(or 열기)
+    /*
+    - SHM_NAME: 전역변수로 정의된 공유 메모리의 이름 (/loc_ekf_shm)
+    - O_CREAT | O_RDWR: 없으면 새로 만들고, 읽기/쓰기 권한으로 엽니다.
+    - 0666: Unix 퍼미션, 모든 사용자에게 읽기/쓰기 허용.
+    - 반환값 shm_fd: 공유 메모리 객체의 파일 디스크립터입니다.
+    */
+    OUTPUT_fd = rt_mem_shm_open(rt_instance_name(OUTPUT_SHM_NAME), O_CREAT | O_RDWR, 0666);
+    // 실패 검사
+    if (OUTPUT_fd == -1)
+    {
+        perror("output_shm_open");
+        exit(EXIT_FAILURE);
+    }
+    // Shared memory 객체 크기 설정 및 실패 확인
+    if (rt_mem_shm_truncate(OUTPUT_fd, OUTPUT_SIZE_B) == -1)
+    {
+        perror("ftruncate");
+        exit(EXIT_FAILURE);
+    }
+    // 2. Shared memory object를 virtual memory space에 mmap을 통해 mapping (3KB)
+    OUTPUT_shm_ptr = rt_mem_shm_map(OUTPUT_fd, OUTPUT_SIZE_B, PROT_READ | PROT_WRITE);
+    if (OUTPUT_shm_ptr == MAP_FAILED)
+    {
+        perror("output_mmap");
+        exit(EXIT_FAILURE);
+    }
+    // 3. Shared memory를 위해 semaphore 생성
+    OUTPUT_sem = sem_open(rt_instance_name(OUTPUT_SEM_NAME), O_CREAT, 0666, 1); // 초기값 1
+    if (OUTPUT_sem == SEM_FAILED)
+    {
+        perror("output_sem_open");
+        exit(EXIT_FAILURE);
+    }
+
+    srand(time(NULL)); // random 처리를 위해 있어야함
+    // runnable_thread는 Localization의 실행 로직을 담당
+    pthread_t runnable_tid;
+    pthread_create(&runnable_tid, NULL, runnable_thread, OUTPUT_shm_ptr);
+    pthread_join(runnable_tid, NULL);
+
+    // 정리 (도달하지 않지만 안전하게)
+    // OUTPUT
+    sem_close(OUTPUT_sem);
+    sem_unlink(rt_instance_name(OUTPUT_SEM_NAME));
+    rt_mem_shm_unmap(OUTPUT_shm_ptr, OUTPUT_SIZE_B);
+    rt_mem_shm_unlink(rt_instance_name(OUTPUT_SHM_NAME));
+    // INPUT
+    for (int i = 0; i < INPUT_NUM_PROCESSES; ++i)
+    {
+        sem_close(INPUT_sems[i]);
+        rt_mem_shm_unmap(INPUT_shm_ptrs[i], INPUT_SIZE_B[i]);
+        close(INPUT_fds[i]);
+    }
+    return 0;
+}
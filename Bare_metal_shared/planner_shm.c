@@ -13,6 +13,14 @@
 #include <semaphore.h>
 #include <sched.h>
 
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/rt_perf.h"
+#include "../Bare_metal_common/chain_msg.h"
+#include "../Bare_metal_common/rt_sample.h"
+
 // 설정 값
 #define PERFORMANCE_Frequency 3.4      // Intel i7의 clock speed (GHz)
 #define WCET_OVERRUN_PROBABILITY 0.001 // 실행시간이 WCET를 초과할 확률
@@ -63,22 +71,25 @@
 #define EXEC_TIME_AVG (EXEC_TICKS_AVG / PERFORMANCE_Frequency) // nanoseconds 단위로 변환
 #define EXEC_TIME_UB (EXEC_TICKS_UB / PERFORMANCE_Frequency)   // nanoseconds 단위로 변환
 
-// 메세지 OFFSET 설정 (Planner는 연결된 Task들의 정보를 읽고 모든 영역에 작성해야함.)
+// 메세지 slot 설정, layout은 chain_msg.h (Planner는 연결된 Task들의 정보를 읽고 모든 영역에 작성해야함.)
 #define chain_type_1 1
 #define chain_type_2 2
 #define chain_type_3 3
 #define chain_type_4 4
 #define chain_type_5 5
 #define chain_level 2
-#define message_size_of_chain 256 // 하나의 task chain마다 할당되는 message size 크기
-#define message_size_of_task 64   // 하나의 task마다 할당되는 message size 크기
-#define message_format_unit 16    // task가 사용하는 Message의 format 단위 16bytes
-// 메세지 offset
-#define chain1_offset ((chain_type_1 - 1) * message_size_of_chain)
-#define chain2_offset ((chain_type_2 - 1) * message_size_of_chain)
-#define chain3_offset ((chain_type_3 - 1) * message_size_of_chain)
-#define chain4_offset ((chain_type_4 - 1) * message_size_of_chain)
-#define chain5_offset ((chain_type_5 - 1) * message_size_of_chain)
+#define ekf_level 3 // chain 1,2에서 EKF slot의 chain_level
+CHAIN_MSG_ASSERT_FITS(OUTPUT_SIZE_B);
+
+// 입력 link 번호 (RT_TR_SKIP / RT_TR_REPEAT의 flags, trace_export.py의 SAMPLE_LINKS와 같은 순서)
+enum
+{
+    LINK_EKF = 0,
+    LINK_SFM,
+    LINK_LANE,
+    LINK_DETECTION,
+    NUM_LINKS
+};
 
 // INPUT(READ) 관련 설정
 #define INPUT_NUM_PROCESSES 4 // Planner가 읽도록 연결된 Process 갯수
@@ -130,69 +141,31 @@ double rand_range(double min, double avg, double max)
     }
 }
 
-// 메세지 구조체
-// message_size_of_task 크기는 64bytes - 16bytes 단위로 분할
-//[0-15]: ID //이 중에서 1byte만 사용
-//[16-31]: 주기가 깨는 시점 //16bytes
-//[32-47]: Task start(데이터를 모두 수신완료한 recv_time) 시점 //16bytes (recv_time)
-//[48-63]: Task send 시점(= Data 전송 시점) //16bytes (send_time)
-// message_format_unit을 사용 (16bytes)
-// int64_t는 8bytes size
-typedef struct
-{
-    uint8_t id;
-
-    int64_t wake_sec;
-    int64_t wake_nsec;
-
-    int64_t recv_sec;
-    int64_t recv_nsec;
-
-    int64_t send_sec;
-    int64_t send_nsec;
-
-} TaskHeader;
-
-// out의 필드에서 읽어 buffer에 offset 위치부터 채움
-// buffer는 출력 버퍼, offset은 해당 TaskHeader의 시작 위치
-// TaskHeader는 id,wake,start,end 필드를 각 16bytes로 가짐
-// TaskHeader의 각 필드는 8bytes로 분리됨 (id를 제외하고, 8bytes씩 sec, nsec를 담당)
-// 따라서 총 64bytes를 작성
-void write_task_header(TaskHeader *out, char *buffer, int task_offset)
-{
-    // ID 작성
-    memcpy(buffer + task_offset, &out->id, sizeof(uint8_t)); // 1byte 만큼 ID 사용
-    // Wake 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 2), &out->wake_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 3), &out->wake_nsec, sizeof(int64_t));
-    // Start 작성 (or recv_time 이후부터)
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 4), &out->recv_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 5), &out->recv_nsec, sizeof(int64_t));
-    // End 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 6), &out->send_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 7), &out->send_nsec, sizeof(int64_t));
-}
-
 void *runnable_thread(void *arg)
 {
-    char local_copy_bysfm[INPUT_SIZE_B_bySFM];             // 24KB만큼 입력
-    char local_copy_bylane[INPUT_SIZE_B_bylane];           // 32KB만큼 입력
-    char local_copy_bydetection[INPUT_SIZE_B_bydetection]; // 750KB만큼 입력
-    char local_copy_byekf[INPUT_SIZE_B_byEKF];             // 5KB만큼 입력
-    char result[OUTPUT_SIZE_B];                  // 2048 bytes만큼 출력
+    char *local_copy_bysfm = rt_mem_alloc(INPUT_SIZE_B_bySFM);             // 24KB만큼 입력
+    char *local_copy_bylane = rt_mem_alloc(INPUT_SIZE_B_bylane);           // 32KB만큼 입력
+    char *local_copy_bydetection = rt_mem_alloc(INPUT_SIZE_B_bydetection); // 750KB만큼 입력
+    char *local_copy_byekf = rt_mem_alloc(INPUT_SIZE_B_byEKF);             // 5KB만큼 입력
+    char result[OUTPUT_SIZE_B] CHAIN_MSG_ALIGNED; // 2048 bytes만큼 출력
+    chain_msg_t *msg = chain_msg(result); // result의 chain message 영역
     struct timespec next, start, recv_time, send_time, end;
+    uint64_t seq = 0;                         // DASM에 보낸 data의 seq (rt_release_seq: release 번호 + 1, 재시작해도 증가)
+    rt_sample_link_t links[NUM_LINKS] = {{0}}; // 입력 link별 undersampling / oversampling
 
-    clock_gettime(CLOCK_MONOTONIC, &next); // 주기를 위한 시간 측정
+    rt_trace_open("planner"); // hot loop의 출력은 trace ring으로 (trace_drain이 파일로 저장)
+    rt_perf_open();  // WATERS_PERF=1: phase별 performance counter
+    rt_release_t release;
+    rt_release_init(&release, PERIOD_NS, &next); // 공통 epoch(+offset)의 첫 release까지 대기
 
     while (1)
     {
         // 1.Setup phase: 기상, 데이터 읽기 완료
         // 기상
         clock_gettime(CLOCK_MONOTONIC, &start);
-        double next_ms = next.tv_sec * 1000.0 + next.tv_nsec / 1.0e6;
-        printf("[Planner] wake-up at %.3f ms\n", next_ms);
-        double start_ms = start.tv_sec * 1000.0 + start.tv_nsec / 1.0e6;
-        //printf("[Planner] Started at %.3f ms\n", start_ms);
+        rt_trace_ts(&next, RT_TR_WAKE, release.k, 0, 0);
+        rt_trace_ts(&start, RT_TR_START, release.k, 0, 0);
+        rt_perf_begin();
 
         // 데이터 읽기 (shared memory)
         // 입력버퍼에서 데이터 복사: SFM, Lane_detection, Detection, EKF
@@ -214,34 +187,28 @@ void *runnable_thread(void *arg)
         sem_post(INPUT_sems[3]);
 
         clock_gettime(CLOCK_MONOTONIC, &recv_time);
-        double recv_time_ms = recv_time.tv_sec * 1000.0 + recv_time.tv_nsec / 1.0e6;
-        //double read_time_ms = (recv_time.tv_sec - start.tv_sec) * 1000.0 + (recv_time.tv_nsec - start.tv_nsec) / 1.0e6;
-        //printf("[Planner] read time: %.3f ms\n", read_time_ms); // 실행시간 출력
-
-        //printf("[Planner] received at %.3f ms\n", recv_time_ms);
+        rt_perf_mark(RT_SPAN_SETUP);
         // ------------------ setup phase 완료 ----------
         // 2. Execution phase: Data 읽기 및 설정, busy-loop
 
         // Data 읽기 및 설정
-        // Chain type에 해당하는 local_copy의 해당 부분을 추출해야함
-        // Chain 1,2 (0:511)에 해당하는 부분 추출 및 result 저장
-        memcpy(result + chain1_offset, &local_copy_byekf[chain1_offset], message_size_of_chain * 2);
-        // chain 3 (512:767)
-        memcpy(result + chain3_offset, &local_copy_bysfm[chain3_offset], message_size_of_chain);
-        // chain 4 (768: 1023)
-        memcpy(result + chain4_offset, &local_copy_bylane[chain4_offset], message_size_of_chain);
-        // chain 5 (1024: 1279)
-        memcpy(result + chain5_offset, &local_copy_bydetection[chain5_offset], message_size_of_chain);
-
-        // //debugging chain3(result)
-        // for (int i = chain3_offset + 64; i < chain3_offset + 128; i++) {
-        //     printf("%02X ", (unsigned char)result[i]);
-        //     if ((i - (chain3_offset + 64) + 1) % 16 == 0) printf("\n");  // 16바이트마다 줄바꿈
-        // }
-        // for (int i = chain1_offset + 64; i < chain1_offset + 128; i++) {
-        //     printf("%02X ", (unsigned char)result[i]);
-        //     if ((i - (chain1_offset + 64) + 1) % 16 == 0) printf("\n");  // 16바이트마다 줄바꿈
-        // }
+        // Chain type에 해당하는 local_copy의 chain 영역을 추출해야함
+        // Chain 1,2는 ekf (Lidar_grabber, CAN chain)
+        *CHAIN_OF(msg, chain_type_1) = *CHAIN_OF(chain_msg_const(local_copy_byekf), chain_type_1);
+        *CHAIN_OF(msg, chain_type_2) = *CHAIN_OF(chain_msg_const(local_copy_byekf), chain_type_2);
+        // chain 3은 SFM, chain 4는 Lane_detection, chain 5는 Detection
+        *CHAIN_OF(msg, chain_type_3) = *CHAIN_OF(chain_msg_const(local_copy_bysfm), chain_type_3);
+        *CHAIN_OF(msg, chain_type_4) = *CHAIN_OF(chain_msg_const(local_copy_bylane), chain_type_4);
+        *CHAIN_OF(msg, chain_type_5) = *CHAIN_OF(chain_msg_const(local_copy_bydetection), chain_type_5);
+        // chain별로 읽은 chain 시작 data의 seq 기록, flags = chain 번호
+        // (chain 1,2는 level 5의 Lidar_grabber/CAN, chain 3~5는 level 3의 producer)
+        for (int c = 1; c <= CHAIN_MSG_TYPES; c++)
+            rt_trace_ts(&recv_time, RT_TR_READ, release.k, c, chain_msg_source(msg, c)->seq);
+        // 입력 link별로 buffer를 쓴 task의 seq 확인: 읽기 전에 덮어써진 sample / 다시 읽은 sample
+        rt_sample_read(&links[LINK_EKF], LINK_EKF, CHAIN_SLOT(msg, chain_type_1, ekf_level)->seq, &recv_time, release.k);
+        rt_sample_read(&links[LINK_SFM], LINK_SFM, chain_msg_source(msg, chain_type_3)->seq, &recv_time, release.k);
+        rt_sample_read(&links[LINK_LANE], LINK_LANE, chain_msg_source(msg, chain_type_4)->seq, &recv_time, release.k);
+        rt_sample_read(&links[LINK_DETECTION], LINK_DETECTION, chain_msg_source(msg, chain_type_5)->seq, &recv_time, release.k);
 
         // busy-loop
         // execution time 계산
@@ -259,28 +226,15 @@ void *runnable_thread(void *arg)
 
         // 3. send phase: data packet 생성 시작
         clock_gettime(CLOCK_MONOTONIC, &send_time);
-        double send_time_ms = send_time.tv_sec * 1000.0 + send_time.tv_nsec / 1.0e6;
-        //printf("[Planner] send at %.3f ms\n", send_time_ms);
-
-        //  DASM에 전송할 데이터 준비
-        TaskHeader chains[5]; // chain은 5개
-        for (int i = 0; i < 5; i++){
-            chains[i].id = 0; // 또는 특정 값
-            chains[i].wake_sec = next.tv_sec;
-            chains[i].wake_nsec = next.tv_nsec;
-            chains[i].recv_sec = recv_time.tv_sec;
-            chains[i].recv_nsec = recv_time.tv_nsec;
-            chains[i].send_sec = send_time.tv_sec;
-            chains[i].send_nsec = send_time.tv_nsec;
-        }
-        // 파싱(읽은)한 TaskHeader 구조체를 사용하여 메시지 인덱스와 센싱 시각을 result에 저장
-        // OFFSET에 따라 ID와 센싱 시각을 result에 저장
-        // result는 OUTPUT_SIZE_B_byplanner 크기로 초기화
-        write_task_header(&chains[0], result, chain1_offset); //chain1
-        write_task_header(&chains[1], result, chain2_offset); //chain2
-        write_task_header(&chains[2], result, chain3_offset); //chain3
-        write_task_header(&chains[3], result, chain4_offset); //chain4
-        write_task_header(&chains[4], result, chain5_offset); //chain5
+        rt_perf_mark(RT_SPAN_EXEC);
+
+        //  DASM에 전송할 데이터 준비: chain마다 Planner(level 2) slot 작성 (seq는 DASM의 link 집계용)
+        seq = rt_release_seq(&release);
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_1, chain_level), seq, &next, &recv_time, &send_time);
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_2, chain_level), seq, &next, &recv_time, &send_time);
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_3, chain_level), seq, &next, &recv_time, &send_time);
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_4, chain_level), seq, &next, &recv_time, &send_time);
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_5, chain_level), seq, &next, &recv_time, &send_time);
         // result에 준비완료
 
         // 결과를 DASM에 전송: memcpy
@@ -288,24 +242,20 @@ void *runnable_thread(void *arg)
         memcpy(OUTPUT_shm_ptr, result, OUTPUT_SIZE_B);
         sem_post(OUTPUT_sem);
 
-        // 4.log print phase
+        // 4.trace phase: printf 대신 trace ring에 기록
         clock_gettime(CLOCK_MONOTONIC, &end);
-        double end_ms = end.tv_sec * 1000.0 + end.tv_nsec / 1.0e6;
-        //printf("[Planner] finished at %.3f ms\n", end_ms);           //// 끝난 시점 출력
-        double exec_time_ms = (send_time.tv_sec - recv_time.tv_sec) * 1000.0 + (send_time.tv_nsec - recv_time.tv_nsec) / 1.0e6;
-        //printf("[Planner] Execution time: %.3f ms\n", exec_time_ms); // 실행시간 출력
-        double resp_time_ms = (end.tv_sec - next.tv_sec) * 1000.0 + (end.tv_nsec - next.tv_nsec) / 1.0e6;
-        //printf("[Planner] Response time: %.3f ms\n", resp_time_ms); // 반응시간 출력
-        //printf("[Planner] Sleeping for %d ms\n\n", PERIOD_MS);       // 다음 주기까지 대기 시간 출력
+        rt_perf_mark(RT_SPAN_SEND);
+        rt_trace_ts(&send_time, RT_TR_SEND, release.k, 0, seq);
+        rt_trace_ts(&end, RT_TR_END, release.k, 0, seq);
+        rt_trace_span(&start, &recv_time, RT_SPAN_SETUP, release.k);
+        rt_trace_span(&recv_time, &send_time, RT_SPAN_EXEC, release.k);
+        rt_trace_span(&send_time, &end, RT_SPAN_SEND, release.k);
+        rt_perf_flush(release.k);
 
         // 5.next period cal phase
         //  주기 계산
-        next.tv_nsec += PERIOD_NS;
-        if (next.tv_nsec >= 1000000000)
-        {
-            next.tv_sec += 1;
-            next.tv_nsec -= 1000000000;
-        }
+        rt_trace_sleep(&end, release.k);   // end 이후 기록 구간 + sleep 시작
+        rt_release_next(&release, &next); // epoch + offset + k * period
         clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
     }
     return NULL;
@@ -326,24 +276,24 @@ void bind_process_to_core(int core_id) {
 // ------------------------------
 int main()
 {
-    bind_process_to_core(1); 
+    bind_process_to_core(rt_core_from_env(1));
     // 읽기용 shm mmap + sem_open
     for (int i = 0; i < INPUT_NUM_PROCESSES; ++i)
     {
-        INPUT_fds[i] = shm_open(INPUT_SHM_NAMES[i], O_RDONLY, 0666); // shared memory 객체 생성
+        INPUT_fds[i] = rt_mem_shm_open(rt_instance_name(INPUT_SHM_NAMES[i]), O_RDONLY, 0666); // shared memory 객체 생성
         if (INPUT_fds[i] == -1)
         {
             perror("input_shm_open");
             exit(EXIT_FAILURE);
         }
-        INPUT_shm_ptrs[i] = mmap(NULL, INPUT_SIZE_B[i], PROT_READ, MAP_SHARED, INPUT_fds[i], 0);
+        INPUT_shm_ptrs[i] = rt_mem_shm_map(INPUT_fds[i], INPUT_SIZE_B[i], PROT_READ);
         if (INPUT_shm_ptrs[i] == MAP_FAILED)
         {
             perror("input_mmap");
             exit(EXIT_FAILURE);
         }
 
-        INPUT_sems[i] = sem_open(INPUT_SEM_NAMES[i], 0);
+        INPUT_sems[i] = sem_open(rt_instance_name(INPUT_SEM_NAMES[i]), 0);
         if (INPUT_sems[i] == SEM_FAILED)
         {
             perror("input_sem_open");
@@ -358,7 +308,7 @@ int main()
     - 0666: Unix 퍼미션, 모든 사용자에게 읽기/쓰기 허용.
     - 반환값 shm_fd: 공유 메모리 객체의 파일 디스크립터입니다.
     */
-    OUTPUT_fd = shm_open(OUTPUT_SHM_NAME, O_CREAT | O_RDWR, 0666);
+    OUTPUT_fd = rt_mem_shm_open(rt_instance_name(OUTPUT_SHM_NAME), O_CREAT | O_RDWR, 0666);
     // 실패 검사
     if (OUTPUT_fd == -1)
     {
@@ -370,7 +320,7 @@ int main()
     - shm_fd: shared memory 객체의 파일 디스크립터
     - OUTPUT_SIZE_B: 전역변수로 정의된 process의 output 크기
     */
-    if (ftruncate(OUTPUT_fd, OUTPUT_SIZE_B) == -1)
+    if (rt_mem_shm_truncate(OUTPUT_fd, OUTPUT_SIZE_B) == -1)
     {
         perror("ftruncate");
         exit(EXIT_FAILURE);
@@ -386,14 +336,14 @@ int main()
     - 0: 오프셋 (0부터 매핑 시작).
     - 반환값 OUTPUT_shm_ptr: 공유 메모리에 접근할 수 있는 포인터입니다.
     */
-    OUTPUT_shm_ptr = mmap(NULL, OUTPUT_SIZE_B, PROT_READ | PROT_WRITE, MAP_SHARED, OUTPUT_fd, 0);
+    OUTPUT_shm_ptr = rt_mem_shm_map(OUTPUT_fd, OUTPUT_SIZE_B, PROT_READ | PROT_WRITE);
     if (OUTPUT_shm_ptr == MAP_FAILED)
     {
         perror("output_mmap");
         exit(EXIT_FAILURE);
     }
     // 3. Shared memory를 위해 semaphore 생성
-    OUTPUT_sem = sem_open(OUTPUT_SEM_NAME, O_CREAT, 0666, 1); // 초기값 1
+    OUTPUT_sem = sem_open(rt_instance_name(OUTPUT_SEM_NAME), O_CREAT, 0666, 1); // 초기값 1
     if (OUTPUT_sem == SEM_FAILED)
     {
         perror("output_sem_open");
@@ -409,15 +359,15 @@ int main()
     // 정리 (도달하지 않지만 안전하게)
     // OUTPUT
     sem_close(OUTPUT_sem);
-    sem_unlink(OUTPUT_SEM_NAME);
-    munmap(OUTPUT_shm_ptr, OUTPUT_SIZE_B);
-    shm_unlink(OUTPUT_SHM_NAME);
+    sem_unlink(rt_instance_name(OUTPUT_SEM_NAME));
+    rt_mem_shm_unmap(OUTPUT_shm_ptr, OUTPUT_SIZE_B);
+    rt_mem_shm_unlink(rt_instance_name(OUTPUT_SHM_NAME));
     // INPUT
     for (int i = 0; i < INPUT_NUM_PROCESSES; ++i)
     {
         sem_close(INPUT_sems[i]);
-        sem_unlink(INPUT_SEM_NAMES[i]);
-        munmap(INPUT_shm_ptrs[i], INPUT_SIZE_B[i]);
+        sem_unlink(rt_instance_name(INPUT_SEM_NAMES[i]));
+        rt_mem_shm_unmap(INPUT_shm_ptrs[i], INPUT_SIZE_B[i]);
         //shm_unlink(INPUT_SHM_NAMES[i]);
         close(INPUT_fds[i]);
     }
@@ -3,15 +3,19 @@ import pandas as pd
 import matplotlib.pyplot as plt
 import numpy as np
 import os
+import sys
 
-def analyze_logs_final(file_name,period):
+def analyze_logs_final(file_name,period,log_dir=None,levels=3):
     """
-    ID가 섞여있거나 순환되더라도 모든 로그를 정확하게 분석합니다.
+    ID가 섞여있더라도 모든 로그를 정확하게 분석합니다.
+    ID는 chain 시작 task의 64-bit seq라 순환하지 않으며, DASM이 읽지 못한 sample은 ID 간격으로 셉니다.
 
     Args:
         file_path (str): 분석할 로그 파일의 경로.
+        log_dir (str): 로그가 있는 디렉터리 (launcher의 run 디렉터리), 없으면 스크립트 위치.
+        levels (int): chain 길이 (chain 3~5는 3, Lidar_grabber/CAN에서 시작하는 chain 1,2는 5)
     """
-    file_path = os.path.join(os.path.dirname(__file__), file_name)
+    file_path = os.path.join(log_dir or os.path.dirname(__file__), file_name)
     try:
         with open(file_path, 'r') as f:
             lines = f.readlines()
@@ -23,6 +27,8 @@ def analyze_logs_final(file_name,period):
     results = []
     # ID별로 진행 중인(미완성) 데이터 블록을 저장할 딕셔너리
     incomplete_blocks = {}
+    # 완성된 블록의 ID (DASM까지 도달하지 못한 sample 수 계산용)
+    completed_ids = []
 
     log_pattern = re.compile(r"ID = (\d+), (\w+) = ([\d.]+) us")
 
@@ -41,18 +47,26 @@ def analyze_logs_final(file_name,period):
         # 데이터 추가
         incomplete_blocks[id_val][key] = float(value)
 
-        # 해당 ID의 블록이 7개의 데이터를 모두 모았는지 확인
-        if len(incomplete_blocks[id_val]) == 7:
+        # 해당 ID의 블록이 모든 데이터를 모았는지 확인 (시작 task 3개 + 중간 level마다 2개 + DASM 3개 + 직전 sample 1개)
+        if len(incomplete_blocks[id_val]) == 2 * levels + 3:
             block = incomplete_blocks[id_val]
             
             # 계산 수행
-            e2e_latency = block['chain_l1_end_us'] - block['chain_l3_wake_us']
-            execution_time = (block['chain_l3_send_us'] - block['chain_l3_start_us']) + \
-                             (block['chain_l2_send_us'] - block['chain_l2_recv_us']) + \
+            e2e_latency = block['chain_l1_end_us'] - block[f'chain_l{levels}_wake_us']
+            execution_time = (block[f'chain_l{levels}_send_us'] - block[f'chain_l{levels}_start_us']) + \
+                             sum(block[f'chain_l{lvl}_send_us'] - block[f'chain_l{lvl}_recv_us'] for lvl in range(2, levels)) + \
                              (block['chain_l1_end_us'] - block['chain_l1_recv_us'])
             waiting_time = e2e_latency - execution_time
+            # Reaction time: 직전 sample을 읽은 직후 발생한 event가 처음 출력에 반영되기까지 (first-to-first)
+            #   = 이 sample을 처음 읽은 DASM job의 end - 직전 sample의 시작 wake (직전 sample이 없으면 NaN, 통계에서 제외)
+            # Data age: sample이 마지막으로 출력에 쓰일 때의 나이 (last-to-last)
+            #   = 이 sample을 마지막으로 읽은 DASM job의 end - 시작 wake
+            prev_wake = block['chain_prev_wake_us']
+            reaction_time = block['chain_l1_end_us'] - prev_wake if prev_wake else float('nan')
+            data_age = block['chain_l1_last_end_us'] - block[f'chain_l{levels}_wake_us']
             
-            results.append((e2e_latency, execution_time, waiting_time))
+            results.append((e2e_latency, execution_time, waiting_time, reaction_time, data_age))
+            completed_ids.append(id_val)
             
             # 처리가 완료된 블록은 딕셔너리에서 제거
             del incomplete_blocks[id_val]
@@ -68,10 +82,13 @@ def analyze_logs_final(file_name,period):
 
 
     print("results의 길이: ", len(results))
+    completed_ids.sort()
+    lost = sum(b - a - 1 for a, b in zip(completed_ids, completed_ids[1:]) if b > a + 1)
+    print(f"DASM에 도달하지 못한 sample 수 (ID {completed_ids[0]} ~ {completed_ids[-1]}): {lost}")
     print("걸린 시간(분):", (len(results)*period)*1.66667e-5)
 
     # 결과를 pandas DataFrame으로 변환
-    df = pd.DataFrame(results, columns=['E2E latency', 'Execution time', 'Waiting time'])
+    df = pd.DataFrame(results, columns=['E2E latency', 'Execution time', 'Waiting time', 'Reaction time', 'Data age'])
 
     # df.to_csv('latency_analysis_results.csv', index=False)
     # print(f"\n✅ 총 {len(df)}개의 데이터 분석 완료. 'latency_analysis_results.csv' 파일로 저장되었습니다.")
@@ -116,12 +133,21 @@ def analyze_logs_final(file_name,period):
     plot_statistics(file_name, df['E2E latency'], 'E2E latency', bin_width=10)
     plot_statistics(file_name, df['Execution time'], 'Execution time', bin_width=10)
     plot_statistics(file_name, df['Waiting time'], 'Waiting time', bin_width=10)
+    plot_statistics(file_name, df['Reaction time'].dropna(), 'Reaction time', bin_width=10)
+    plot_statistics(file_name, df['Data age'], 'Data age', bin_width=10)
 
 
 if __name__ == "__main__":
+    # launcher로 실행한 경우 run 디렉터리를 인자로 전달 (예: python3 analysis2.py runs/20250101_120000)
+    LOG_DIR = sys.argv[1] if len(sys.argv) > 1 else None
+    LOG_FILE_PATH1 = 'log_Chain 1_tcp.txt'
+    LOG_FILE_PATH2 = 'log_Chain 2_tcp.txt'
     LOG_FILE_PATH3 = 'log_Chain 3_tcp.txt'
     LOG_FILE_PATH4 = 'log_Chain 4_tcp.txt'
     LOG_FILE_PATH5 = 'log_Chain 5_tcp.txt'
-    analyze_logs_final(LOG_FILE_PATH3,33)
-    analyze_logs_final(LOG_FILE_PATH4,66)
-    analyze_logs_final(LOG_FILE_PATH5,200)
+    # chain 1,2: Localization(400ms)이 새 sample을 읽을 때마다 DASM에 새 id가 도착
+    analyze_logs_final(LOG_FILE_PATH1,400,LOG_DIR,levels=5)
+    analyze_logs_final(LOG_FILE_PATH2,400,LOG_DIR,levels=5)
+    analyze_logs_final(LOG_FILE_PATH3,33,LOG_DIR)
+    analyze_logs_final(LOG_FILE_PATH4,66,LOG_DIR)
+    analyze_logs_final(LOG_FILE_PATH5,200,LOG_DIR)
@@ -13,6 +13,17 @@
 #include <math.h>
 #include <sched.h>
 
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/rt_perf.h"
+#include "../Bare_metal_common/chain_msg.h"
+#include "../Bare_metal_common/rt_clock.h"
+#include "../Bare_metal_common/rt_link.h"
+#include "../Bare_metal_common/rt_sample.h"
+#include "../Bare_metal_common/chain_log.h"
+
 // 설정 값
 #define PERFORMANCE_Frequency 3.4      // Intel i7의 clock speed (GHz)
 #define WCET_OVERRUN_PROBABILITY 0.001 // 실행시간이 WCET를 초과할 확률
@@ -39,22 +50,15 @@
 #define EXEC_TIME_AVG (EXEC_TICKS_AVG / PERFORMANCE_Frequency) // nanoseconds 단위로 변환
 #define EXEC_TIME_UB (EXEC_TICKS_UB / PERFORMANCE_Frequency)   // nanoseconds 단위로 변환
 
-// 메세지 OFFSET 설정
+// 메세지 slot 설정 (layout은 chain_msg.h)
 #define chain_type_1 1
 #define chain_type_2 2
 #define chain_type_3 3
 #define chain_type_4 4
 #define chain_type_5 5
 #define chain_level 1
-#define message_size_of_chain 256 // 하나의 task chain마다 할당되는 message size 크기
-#define message_size_of_task 64   // 하나의 task마다 할당되는 message size 크기
-#define message_format_unit 16    // task가 사용하는 Message의 format 단위 16bytes
-// 메세지 offset
-#define chain1_offset ((chain_type_1 - 1) * message_size_of_chain)
-#define chain2_offset ((chain_type_2 - 1) * message_size_of_chain)
-#define chain3_offset ((chain_type_3 - 1) * message_size_of_chain)
-#define chain4_offset ((chain_type_4 - 1) * message_size_of_chain)
-#define chain5_offset ((chain_type_5 - 1) * message_size_of_chain)
+#define planner_level 2 // Planner slot의 chain_level
+#define LINK_PLANNER 0  // 입력 link 번호 (RT_TR_SKIP / RT_TR_REPEAT의 flags)
 
 // 전역 변수
 char input_buffer_byplanner[INPUT_SIZE_B_byplanner]; // 2048bytes
@@ -69,7 +73,7 @@ void *copy_thread(void *arg)
     int server_sock, client_sock;
     struct sockaddr_in server_addr, client_addr;
     socklen_t client_len = sizeof(client_addr);
-    char local_copy[INPUT_SIZE_B_byplanner];
+    char *local_copy = rt_mem_alloc(INPUT_SIZE_B_byplanner);
 
     // 소켓 생성
     server_sock = socket(AF_INET, SOCK_STREAM, 0);
@@ -79,10 +83,13 @@ void *copy_thread(void *arg)
         exit(EXIT_FAILURE);
     }
 
+    // 이전 실험의 TIME_WAIT 소켓이 남아 있어도 바로 bind 할 수 있도록 설정
+    int reuse = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
     // 서버 주소 설정
     memset(&server_addr, 0, sizeof(server_addr));
     server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(DASM_PORT);
+    server_addr.sin_port = htons(rt_instance_port(DASM_PORT));
     server_addr.sin_addr.s_addr = INADDR_ANY;
 
     // 바인드
@@ -101,7 +108,7 @@ void *copy_thread(void *arg)
         exit(EXIT_FAILURE);
     }
 
-    printf("[DASM] Waiting for connection on port %d...\n", DASM_PORT);
+    printf("[DASM] Waiting for connection on port %d...\n", rt_instance_port(DASM_PORT));
 
     // 클라이언트 연결 수락
     client_sock = accept(server_sock, (struct sockaddr *)&client_addr, &client_len);
@@ -115,15 +122,15 @@ void *copy_thread(void *arg)
     // 통신은 TCP 소켓을 사용하며, 클라이언트가 연결되면 데이터를 수신하여 전역 변수에 저장함
     printf("[DASM] Connected to Planner: %s\n", inet_ntoa(client_addr.sin_addr));
 
+    rt_clock_link_t clock_link; // Planner clock offset 추정 (rt_clock.h)
+    rt_clock_link_init(&clock_link, planner_level, (1u << (CHAIN_MSG_TYPES + 1)) - 2);
+    rt_link_rx_t link; // 연결이 끊기면 다시 accept (rt_link.h)
+    rt_link_rx_init(&link, "[DASM] Planner");
     while (1)
     {
-        ssize_t received = recv(client_sock, local_copy, INPUT_SIZE_B_byplanner, MSG_WAITALL);
-        if (received <= 0)
-        {
-            perror("[DASM] recv error or connection closed\n");
-            break;
-        }
-
+        // 연결이 끊기면 다시 accept: Planner가 다시 연결할 때까지 runnable은 마지막 buffer를 계속 읽음 (같은 seq는 새 sample이 아님)
+        rt_link_rx_recv(&link, server_sock, &client_sock, local_copy, INPUT_SIZE_B_byplanner);
+        rt_clock_link_recv(&clock_link, client_sock, chain_msg(local_copy), link.first_ns); // 이 task의 clock으로 변환
         pthread_mutex_lock(&buffer_lock);
         memcpy(input_buffer_byplanner, local_copy, INPUT_SIZE_B_byplanner);
         pthread_mutex_unlock(&buffer_lock);
@@ -165,214 +172,86 @@ double rand_range(double min, double avg, double max)
     }
 }
 
-// 메세지 구조체
-// message_size_of_task 크기는 64bytes - 16bytes 단위로 분할
-//[0-15]: ID //이 중에서 1byte만 사용
-//[16-31]: 주기가 깨는 시점 //16bytes
-//[32-47]: Task start(데이터를 모두 수신완료한 recv_time) 시점 //16bytes (recv_time)
-//[48-63]: Task send 시점(= Data 전송 시점) //16bytes (send_time)
-// message_format_unit을 사용 (16bytes)
-// int64_t는 8bytes size
-typedef struct __attribute__((packed)) 
-{
-    uint8_t chain_l2_id;
-    int64_t chain_l2_wake_sec;
-    int64_t chain_l2_wake_nsec;
-    int64_t chain_l2_recv_sec;
-    int64_t chain_l2_recv_nsec;
-    int64_t chain_l2_send_sec;
-    int64_t chain_l2_send_nsec;
-
-    uint8_t chain_l3_id;
-    int64_t chain_l3_wake_sec;
-    int64_t chain_l3_wake_nsec;
-    int64_t chain_l3_recv_sec;
-    int64_t chain_l3_recv_nsec;
-    int64_t chain_l3_send_sec;
-    int64_t chain_l3_send_nsec;
-
-    uint8_t chain_l4_id;
-    int64_t chain_l4_wake_sec;
-    int64_t chain_l4_wake_nsec;
-    int64_t chain_l4_recv_sec;
-    int64_t chain_l4_recv_nsec;
-    int64_t chain_l4_send_sec;
-    int64_t chain_l4_send_nsec;
-
-    uint8_t chain_l5_id;
-    int64_t chain_l5_wake_sec;
-    int64_t chain_l5_wake_nsec;
-    int64_t chain_l5_recv_sec;
-    int64_t chain_l5_recv_nsec;
-    int64_t chain_l5_send_sec;
-    int64_t chain_l5_send_nsec;
-
-} TaskHeader;
-
-// out의 필드에 buffer에서 offset 위치부터 읽어와서 채움
-// buffer는 입력 버퍼, offset은 해당 TaskHeader의 시작 위치
-void parse_task_header(TaskHeader *out, const char *buffer, int offset)
-{
-    memcpy(&out->chain_l2_id, buffer + offset, sizeof(uint8_t));
-    memcpy(&out->chain_l2_wake_sec, buffer + offset + (sizeof(int64_t) * 2), sizeof(int64_t));
-    memcpy(&out->chain_l2_wake_nsec, buffer + offset + (sizeof(int64_t) * 3), sizeof(int64_t));
-    memcpy(&out->chain_l2_recv_sec, buffer + offset + (sizeof(int64_t) * 4), sizeof(int64_t));
-    memcpy(&out->chain_l2_recv_nsec, buffer + offset + (sizeof(int64_t) * 5), sizeof(int64_t));
-    memcpy(&out->chain_l2_send_sec, buffer + offset + (sizeof(int64_t) * 6), sizeof(int64_t));
-    memcpy(&out->chain_l2_send_nsec, buffer + offset + (sizeof(int64_t) * 7), sizeof(int64_t));
-
-    memcpy(&out->chain_l3_id, buffer + offset + (sizeof(int64_t) * 8), sizeof(uint8_t));
-    memcpy(&out->chain_l3_wake_sec, buffer + offset + (sizeof(int64_t) * 10), sizeof(int64_t));
-    memcpy(&out->chain_l3_wake_nsec, buffer + offset + (sizeof(int64_t) * 11), sizeof(int64_t));
-    memcpy(&out->chain_l3_recv_sec, buffer + offset + (sizeof(int64_t) * 12), sizeof(int64_t));
-    memcpy(&out->chain_l3_recv_nsec, buffer + offset + (sizeof(int64_t) * 13), sizeof(int64_t));
-    memcpy(&out->chain_l3_send_sec, buffer + offset + (sizeof(int64_t) * 14), sizeof(int64_t));
-    memcpy(&out->chain_l3_send_nsec, buffer + offset + (sizeof(int64_t) * 15), sizeof(int64_t));
-
-    memcpy(&out->chain_l4_id, buffer + offset + (sizeof(int64_t) * 16), sizeof(uint8_t));
-    memcpy(&out->chain_l4_wake_sec, buffer + offset + (sizeof(int64_t) * 18), sizeof(int64_t));
-    memcpy(&out->chain_l4_wake_nsec, buffer + offset + (sizeof(int64_t) * 19), sizeof(int64_t));
-    memcpy(&out->chain_l4_recv_sec, buffer + offset + (sizeof(int64_t) * 20), sizeof(int64_t));
-    memcpy(&out->chain_l4_recv_nsec, buffer + offset + (sizeof(int64_t) * 21), sizeof(int64_t));
-    memcpy(&out->chain_l4_send_sec, buffer + offset + (sizeof(int64_t) * 22), sizeof(int64_t));
-    memcpy(&out->chain_l4_send_nsec, buffer + offset + (sizeof(int64_t) * 23), sizeof(int64_t));
-
-    memcpy(&out->chain_l5_id, buffer + offset + (sizeof(int64_t) * 24), sizeof(uint8_t));
-    memcpy(&out->chain_l5_wake_sec, buffer + offset + (sizeof(int64_t) * 26), sizeof(int64_t));
-    memcpy(&out->chain_l5_wake_nsec, buffer + offset + (sizeof(int64_t) * 27), sizeof(int64_t));
-    memcpy(&out->chain_l5_recv_sec, buffer + offset + (sizeof(int64_t) * 28), sizeof(int64_t));
-    memcpy(&out->chain_l5_recv_nsec, buffer + offset + (sizeof(int64_t) * 29), sizeof(int64_t));
-    memcpy(&out->chain_l5_send_sec, buffer + offset + (sizeof(int64_t) * 30), sizeof(int64_t));
-    memcpy(&out->chain_l5_send_nsec, buffer + offset + (sizeof(int64_t) * 31), sizeof(int64_t));
-}
-
-// 새로운 task의 ID가 이전과 다를 때만 출력
-// print_e2e_if_new 함수는 명확히 End-to-End latency를 출력하는 함수임.
-// task_name은 해당 task의 이름, task는 TaskHeader 구조체 포인터, last_id는 이전 ID를 저장하는 포인터, end는 현재 시각을 저장하는 timespec 구조체 포인터
-// 이 함수는 task의 ID가 이전 ID와 다를 때만 End-to-End latency를 출력함.
-// End-to-End latency는 task가 시작된 시각과 현재 시각의 차이를 계산하여 마이크로초 단위로 출력함.
-// task_name은 "SFM", "Lane", "Detection", "Lidar", "CAN" 등으로 사용됨.
-void print_log_if_new(const char *chain_name, TaskHeader *chain, int *last_id, struct timespec *wake, struct timespec *recv_time, struct timespec *end, int chain_level_size)
+// chain 시작 task의 seq가 이전과 다를 때만 출력 (같은 seq를 다시 읽으면 마지막으로 읽은 job만 갱신)
+// chain은 message 안의 해당 chain 영역 (복사 없이 읽음), chain 시작 task(level 5 또는 3)부터 Planner(level 2)까지의 시각과
+// DASM(level 1)의 wake / recv_time / end를 log record로 만듦
+void print_log_if_new(int chain_type, const chain_msg_chain_t *chain, chain_track_t *track, struct timespec *wake, struct timespec *recv_time, struct timespec *end)
 {
-    // chain_level_size에 해당하는 Task의 ID 읽기 TaskHeader chain의 id를 읽어야함
-    int id;
-    if (chain_level_size == 3)
+    int levels = CHAIN_MSG_SOURCE_LEVEL(chain_type);
+    uint64_t seq = chain_msg_level(chain, levels)->seq; // chain 시작 task의 seq
+    // slot은 copy thread가 이미 DASM clock으로 바꿔 둠 (rt_clock.h), DASM 자기 시각도 같은 clock으로
+    int64_t end_sec, end_nsec;
+    rt_clock_put(rt_clock_local_ns(chain_log_ns(end->tv_sec, end->tv_nsec)), &end_sec, &end_nsec);
+    struct timespec local_end = {end_sec, end_nsec};
+    if (!chain_track_read(track, seq, &local_end))
+        return; // 같은 seq면 마지막으로 읽은 job만 갱신
+
+    // log를 출력해야겠다. (파일 I/O는 logging thread가 담당, 여기서는 queue에 넣기만 함)
+    chain_log_rec_t rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.chain = chain_type;
+    rec.seq = (int64_t)seq;
+    rec.levels = levels;
+    for (int level = levels; level >= CHAIN_MSG_FIRST_LEVEL; level--)
     {
-        id = chain->chain_l3_id; // 새로받은 값들의 id
-        if (id != *last_id)
-        { // 변경됐네.
-            *last_id = id;
-            // log를 출력해야겠다.
-            double chain_l3_wake_us = chain->chain_l3_wake_sec * 1000000.0 + chain->chain_l3_wake_nsec / 1.0e3;
-            double chain_l3_start_us = chain->chain_l3_recv_sec * 1000000.0 + chain->chain_l3_recv_nsec / 1.0e3;
-            double chain_l3_send_us = chain->chain_l3_send_sec * 1000000.0 + chain->chain_l3_send_nsec / 1.0e3;
-            double chain_l2_wake_us = chain->chain_l2_wake_sec * 1000000.0 + chain->chain_l2_wake_nsec / 1.0e3;
-            double chain_l2_recv_us = chain->chain_l2_recv_sec * 1000000.0 + chain->chain_l2_recv_nsec / 1.0e3;
-            double chain_l2_send_us = chain->chain_l2_send_sec * 1000000.0 + chain->chain_l2_send_nsec / 1.0e3;
-            double chain_l1_wake_us = wake->tv_sec * 1000000.0 + wake->tv_nsec / 1.0e3;
-            double chain_l1_recv_us = recv_time->tv_sec * 1000000.0 + recv_time->tv_nsec / 1.0e3;
-            double chain_l1_end_us = end->tv_sec * 1000000.0 + end->tv_nsec / 1.0e3;
-            // 파일 출력
-            char filename[64];
-            snprintf(filename, sizeof(filename), "log_%s_tcp.txt", chain_name);
-            FILE *fp = fopen(filename, "a");
-            if (fp != NULL)
-            {
-                fprintf(fp, "ID = %d, chain_l3_wake_us = %.2f us\n", id, chain_l3_wake_us);
-                fprintf(fp, "ID = %d, chain_l3_start_us = %.2f us\n", id, chain_l3_start_us);
-                fprintf(fp, "ID = %d, chain_l3_send_us = %.2f us\n", id, chain_l3_send_us);
-                //fprintf(fp, "ID = %d, chain_l2_wake_us = %.2f us\n", id, chain_l2_wake_us);
-                fprintf(fp, "ID = %d, chain_l2_recv_us = %.2f us\n", id, chain_l2_recv_us);
-                fprintf(fp, "ID = %d, chain_l2_send_us = %.2f us\n", id, chain_l2_send_us);
-                //fprintf(fp, "ID = %d, chain_l1_wake_us = %.2f us\n", id, chain_l1_wake_us);
-                fprintf(fp, "ID = %d, chain_l1_recv_us = %.2f us\n", id, chain_l1_recv_us);
-                fprintf(fp, "ID = %d, chain_l1_end_us = %.2f us\n\n", id, chain_l1_end_us);
-                fclose(fp);
-            }
-            else
-            {
-                perror("[DASM] Failed to open dasm_log.txt");
-            }
-        }
-    }
-    else if (chain_level_size == 5)
-    {
-        id = chain->chain_l5_id;
-        if (id != *last_id)
-        {
-            // 차후 작성
-            *last_id = id;
-            printf("id 비교에서 문제 발생1");
-        }
-    }
-    else
-    {
-        printf("id 비교에서 문제 발생2");
+        const chain_slot_t *slot = chain_msg_level(chain, level);
+        rec.wake_ns[level] = chain_log_ns(slot->wake_sec, slot->wake_nsec);
+        rec.recv_ns[level] = chain_log_ns(slot->recv_sec, slot->recv_nsec);
+        rec.send_ns[level] = chain_log_ns(slot->send_sec, slot->send_nsec);
     }
+    rec.wake_ns[1] = rt_clock_local_ns(chain_log_ns(wake->tv_sec, wake->tv_nsec));
+    rec.recv_ns[1] = rt_clock_local_ns(chain_log_ns(recv_time->tv_sec, recv_time->tv_nsec));
+    rec.send_ns[1] = chain_log_ns(local_end.tv_sec, local_end.tv_nsec);
+    rec.clock_err_ns = chain_msg_level(chain, levels)->clock_ns; // hop마다 누적된 오차 상한 = E2E 오차 상한
+    chain_track_begin(track, &rec); // 직전 sample의 record를 queue에 넣음
 }
 
 void *runnable_thread(void *arg)
 {
-    char local_copy[INPUT_SIZE_B_byplanner];
+    char local_copy[INPUT_SIZE_B_byplanner] CHAIN_MSG_ALIGNED;
     struct timespec next, start, recv_time, send_time, end; // dasm의 send_time은 output time
 
-    int last_Lidar_grabber_id = -1;
-    int last_CAN_id = -1;
-    int last_SFM_id = -1;
-    int last_Lane_detection_id = -1;
-    int last_Detection_id = -1;
+    // chain별 sample 추적 (처음 / 마지막으로 읽은 DASM job)
+    chain_track_t Lidar_grabber_track, CAN_track, SFM_track, Lane_detection_track, Detection_track;
+    chain_track_init(&Lidar_grabber_track);
+    chain_track_init(&CAN_track);
+    chain_track_init(&SFM_track);
+    chain_track_init(&Lane_detection_track);
+    chain_track_init(&Detection_track);
+    rt_sample_link_t planner_link = {0}; // Planner link의 undersampling / oversampling
 
-    clock_gettime(CLOCK_MONOTONIC, &next);
+    rt_trace_open("dasm"); // hot loop의 출력은 trace ring으로 (trace_drain이 파일로 저장)
+    rt_perf_open();  // WATERS_PERF=1: phase별 performance counter
+    rt_release_t release;
+    rt_release_init(&release, PERIOD_NS, &next); // 공통 epoch(+offset)의 첫 release까지 대기
 
     while (1)
     {
         // 1. Setup phase: 기상, 데이터 읽기 완료
         // 기상
         clock_gettime(CLOCK_MONOTONIC, &start);
-        double next_ms = next.tv_sec * 1000.0 + next.tv_nsec / 1.0e6;
-        printf("[DASM] wake-up at %.3f ms\n", next_ms);
-        double start_ms = start.tv_sec * 1000.0 + start.tv_nsec / 1.0e6;
-        printf("[DASM] Started at %.3f ms\n", start_ms);
+        rt_trace_ts(&next, RT_TR_WAKE, release.k, 0, 0);
+        rt_trace_ts(&start, RT_TR_START, release.k, 0, 0);
+        rt_perf_begin();
 
         pthread_mutex_lock(&buffer_lock);
         memcpy(local_copy, input_buffer_byplanner, INPUT_SIZE_B_byplanner);
         pthread_mutex_unlock(&buffer_lock);
 
-        // for (int i = chain1_offset + 64; i < chain1_offset + 128; i++) {
-        //     printf("%02X ", (unsigned char)local_copy[i]);
-        //     if ((i - (chain1_offset + 64) + 1) % 16 == 0) printf("\n");  // 16바이트마다 줄바꿈
-        // }
-        // for (int i = chain3_offset + 64; i < chain3_offset + 128; i++) {
-        //     printf("%02X ", (unsigned char)local_copy[i]);
-        //     if ((i - (chain3_offset + 64) + 1) % 16 == 0) printf("\n");  // 16바이트마다 줄바꿈
-        // }
 
         clock_gettime(CLOCK_MONOTONIC, &recv_time);
-        double recv_time_ms = recv_time.tv_sec * 1000.0 + recv_time.tv_nsec / 1.0e6;
-        printf("[DASM] received at %.3f ms\n", recv_time_ms);
+        rt_perf_mark(RT_SPAN_SETUP);
         // ------------------ setup phase 완료 ----------
         // 2. Execution phase: Data 읽기 및 설정, busy-loop
 
         // Data 읽기 및 설정
-        // TaskHeader 구조체를 사용하여 각 task의 헤더를 파싱: 읽기
-        // local_copy는 input_buffer의 복사본으로, 각 task의 헤더를 읽어오기 위해 사용됨
-        TaskHeader chain1_r, chain2_r, chain3_r, chain4_r, chain5_r;
-        parse_task_header(&chain1_r, local_copy, chain1_offset);
-        parse_task_header(&chain2_r, local_copy, chain2_offset);
-        parse_task_header(&chain3_r, local_copy, chain3_offset);
-        parse_task_header(&chain4_r, local_copy, chain4_offset);
-        parse_task_header(&chain5_r, local_copy, chain5_offset);
-
-        //chain1 debugging 용
-        printf("%d\n", chain1_r.chain_l3_id);
-        //chain2 debugging 용
-        printf("%d\n", chain2_r.chain_l5_id);
-        //chain3 debugging 용
-        printf("%d\n", chain3_r.chain_l3_id);
-        //chain4 debugging 용
-        printf("%d\n", chain4_r.chain_l3_id);
-        //chain5 debugging 용
-        printf("%d\n", chain5_r.chain_l3_id);
+        // local_copy를 chain message로 보고 각 chain 영역을 그대로 읽음 (파싱 복사 없음)
+        const chain_msg_t *msg = chain_msg_const(local_copy);
+        // chain별로 읽은 seq 기록, flags = chain 번호 (chain 1,2는 level 5 task의 seq)
+        for (int c = 1; c <= CHAIN_MSG_TYPES; c++)
+            rt_trace_ts(&recv_time, RT_TR_READ, release.k, c, chain_msg_source(msg, c)->seq);
+        // Planner link: 읽기 전에 덮어써진 sample / 다시 읽은 sample (Planner seq는 모든 chain의 level 2 slot에 같음)
+        rt_sample_read(&planner_link, LINK_PLANNER, CHAIN_SLOT(msg, chain_type_1, planner_level)->seq, &recv_time, release.k);
 
         // busy-loop
         double exec_ns = rand_range(EXEC_TIME_LB, EXEC_TIME_AVG, EXEC_TIME_UB);
@@ -388,32 +267,26 @@ void *runnable_thread(void *arg)
         } while (1);
 
         // 3. Send phase: DASM은 End task이므로 해당 phase 없음
-        // 4. log print phase
+        // 4.trace phase: printf 대신 trace ring에 기록
         clock_gettime(CLOCK_MONOTONIC, &end);
-        double end_ms = end.tv_sec * 1000.0 + end.tv_nsec / 1.0e6;
-        printf("[DASM] Finished at %.3f ms\n", end_ms); // 끝난 시점 출력
-        double exec_time_ms = (end.tv_sec - recv_time.tv_sec) * 1000.0 + (end.tv_nsec - recv_time.tv_nsec) / 1.0e6;
-        printf("[DASM] Execution time: %.3f ms\n", exec_time_ms); // 실행시간 출력
-        double resp_time_ms = (end.tv_sec - next.tv_sec) * 1000.0 + (end.tv_nsec - next.tv_nsec) / 1.0e6;
-        printf("[DASM] Response time: %.3f ms\n", resp_time_ms); // 반응시간 출력
-        printf("[DASM] Sleeping for %d ms\n\n", PERIOD_MS);      // 다음 주기까지 대기 시간 출력
+        rt_perf_mark(RT_SPAN_EXEC);
+        rt_trace_ts(&end, RT_TR_END, release.k, 0, 0);
+        rt_trace_span(&start, &recv_time, RT_SPAN_SETUP, release.k);
+        rt_trace_span(&recv_time, &end, RT_SPAN_EXEC, release.k);
 
         // ID 변경 시(새 Data인 경우), log 출력
         // log출력: Chain_type의 level에 따라,micorsecond 단위로, Chain에서의 시점들 전부 출력.
-        print_log_if_new("Chain 1", &chain1_r, &last_Lidar_grabber_id, &next, &recv_time, &end, 5);
-        print_log_if_new("Chain 2", &chain2_r, &last_CAN_id, &next, &recv_time, &end, 5);
-        print_log_if_new("Chain 3", &chain3_r, &last_SFM_id, &next, &recv_time, &end, 3);
-        print_log_if_new("Chain 4", &chain4_r, &last_Lane_detection_id, &next, &recv_time, &end, 3);
-        print_log_if_new("Chain 5", &chain5_r, &last_Detection_id, &next, &recv_time, &end, 3);
+        print_log_if_new(chain_type_1, CHAIN_OF(msg, chain_type_1), &Lidar_grabber_track, &next, &recv_time, &end);
+        print_log_if_new(chain_type_2, CHAIN_OF(msg, chain_type_2), &CAN_track, &next, &recv_time, &end);
+        print_log_if_new(chain_type_3, CHAIN_OF(msg, chain_type_3), &SFM_track, &next, &recv_time, &end);
+        print_log_if_new(chain_type_4, CHAIN_OF(msg, chain_type_4), &Lane_detection_track, &next, &recv_time, &end);
+        print_log_if_new(chain_type_5, CHAIN_OF(msg, chain_type_5), &Detection_track, &next, &recv_time, &end);
+        rt_perf_flush(release.k);
 
         // 5.next period cal phase
         //  주기 계산
-        next.tv_nsec += PERIOD_NS;
-        if (next.tv_nsec >= 1000000000)
-        {
-            next.tv_sec += 1;
-            next.tv_nsec -= 1000000000;
-        }
+        rt_trace_sleep(&end, release.k);   // end 이후 기록 구간 + sleep 시작
+        rt_release_next(&release, &next); // epoch + offset + k * period
         clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
     }
     return NULL;
@@ -436,12 +309,13 @@ void bind_process_to_core(int core_id) {
 int main()
 {
     //process를 core에 배치
-    bind_process_to_core(0); 
+    bind_process_to_core(rt_core_from_env(0));
 
     pthread_t copy_tid, runnable_tid;
     srand(time(NULL));
     memset(input_buffer_byplanner, 0, INPUT_SIZE_B_byplanner);
 
+    chain_log_start("tcp"); // chain log는 별도 logging thread가 파일에 기록
     pthread_create(&copy_tid, NULL, copy_thread, NULL);
     pthread_create(&runnable_tid, NULL, runnable_thread, NULL);
 
@@ -13,11 +13,27 @@
 #include <math.h>
 #include <sched.h>
 
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/rt_perf.h"
+#include "../Bare_metal_common/chain_msg.h"
+#include "../Bare_metal_common/rt_clock.h"
+#include "../Bare_metal_common/rt_link.h"
+
 // 설정 값
 #define PERFORMANCE_Frequency 3.4      // Intel i7의 clock speed (GHz)
 #define WCET_OVERRUN_PROBABILITY 0.001 // 실행시간이 WCET를 초과할 확률
 
 // 환경 값
+// input_data
+// by Localization: Lidar grabber와 CAN으로부터 수신한 Timestamp를 포함
+#define loc_x_car_host_size_KB 1
+#define loc_y_car_host_size_KB 1
+#define loc_yaw_car_host_size_KB 1
+#define INPUT_SIZE_B_byloc ((loc_x_car_host_size_KB + loc_y_car_host_size_KB + loc_yaw_car_host_size_KB) * 1024)
+
 // Output data
 // by ekf
 #define x_car_host_size_KB 1
@@ -44,17 +60,87 @@
 #define EXEC_TIME_AVG (EXEC_TICKS_AVG / PERFORMANCE_Frequency) // nanoseconds 단위로 변환
 #define EXEC_TIME_UB (EXEC_TICKS_UB / PERFORMANCE_Frequency)   // nanoseconds 단위
 
-// 메세지 OFFSET 설정
-#define chain_type 1              // ekf은 Chain_type 3에 해당함
+// 메세지 slot 설정 (layout은 chain_msg.h)
+#define chain_type_1 1            // ekf은 Chain_type 1,2에 해당함
+#define chain_type_2 2
 #define chain_level 3             // ekf은 Chain_level 3에 해당함
-#define message_size_of_chain 256 // 하나의 task chain마다 할당되는 message size 크기
-#define message_size_of_task 64   // 하나의 task마다 할당되는 message size 크기
-#define message_format_unit 16    // task가 사용하는 Message의 format 단위 16bytes
+CHAIN_MSG_ASSERT_FITS(OUTPUT_SIZE_B);
 
-#define offset (((chain_type - 1) * message_size_of_chain) + ((chain_level - 2) * message_size_of_task)) // ekf의 Message가 저장되는 offset
 
 // Planner 서버 포트 (수신단)
 #define Planner_ekf_PORT 5559
+// ekf 서버 포트 (Localization 수신)
+#define EKF_loc_PORT 5562
+
+// 전역 변수
+char input_buffer_byloc[INPUT_SIZE_B_byloc];
+pthread_mutex_t buffer_lock_byloc = PTHREAD_MUTEX_INITIALIZER;
+
+// Copy Thread: Localization으로부터 데이터 수신
+void *copy_thread_byloc(void *arg)
+{
+    int server_sock, client_sock;
+    struct sockaddr_in server_addr, client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    char *local_copy = rt_mem_alloc(INPUT_SIZE_B_byloc);
+    // 소켓 생성
+    server_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_sock < 0)
+    {
+        perror("[ekf] Localization socket error");
+        exit(EXIT_FAILURE);
+    }
+    // 이전 실험의 TIME_WAIT 소켓이 남아 있어도 바로 bind 할 수 있도록 설정
+    int reuse = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    // 서버 주소 설정
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(rt_instance_port(EKF_loc_PORT));
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    // 바인드
+    if (bind(server_sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+    {
+        perror("[ekf] Localization bind error");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+    // 리슨
+    if (listen(server_sock, 5) < 0)
+    {
+        perror("[ekf] Localization listen error");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+    printf("[ekf] Waiting for Localization connection on port %d...\n", rt_instance_port(EKF_loc_PORT));
+    // Localization에서 연결을 기다림
+    client_sock = accept(server_sock, (struct sockaddr *)&client_addr, &client_len);
+    if (client_sock < 0)
+    {
+        perror("[ekf] Localization accept error");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+    printf("[ekf] Connected to Localization: %s\n", inet_ntoa(client_addr.sin_addr));
+    // Localization으로부터 데이터를 수신하여 input_buffer_byloc에 저장
+    rt_clock_link_t clock_link; // Localization clock offset 추정 (rt_clock.h)
+    rt_clock_link_init(&clock_link, chain_level + 1, (1u << chain_type_1) | (1u << chain_type_2));
+    rt_link_rx_t link; // 연결이 끊기면 다시 accept (rt_link.h)
+    rt_link_rx_init(&link, "[ekf] Localization");
+    while (1)
+    {
+        // 연결이 끊기면 다시 accept: producer가 다시 연결할 때까지 runnable은 마지막 buffer(stale)를 계속 사용
+        rt_link_rx_recv(&link, server_sock, &client_sock, local_copy, INPUT_SIZE_B_byloc);
+        rt_clock_link_recv(&clock_link, client_sock, chain_msg(local_copy), link.first_ns); // 이 task의 clock으로 변환
+        pthread_mutex_lock(&buffer_lock_byloc);
+        memcpy(input_buffer_byloc, local_copy, INPUT_SIZE_B_byloc);
+        pthread_mutex_unlock(&buffer_lock_byloc);
+    }
+    close(client_sock);
+    close(server_sock);
+    return NULL;
+}
+
 
 // --------------------------------runnable Thread 설정 -----------------
 // 실행시간 난수 생성 함수
@@ -88,143 +174,106 @@ double rand_range(double min, double avg, double max)
     }
 }
 
-//전송할 메세지의 구조체
-//message_size_of_task 크기는 64bytes - 16bytes 단위로 분할
-//[0-15]: ID //이 중에서 1byte만 사용
-//[16-31]: 주기가 깨는 시점 //16bytes
-//[32-47]: Task start 시점 //16bytes //다른 task 들 때문에, recv_time으로 표기
-//[48-63]: Task Data 전송 시점 //16bytes //전송을 위해 data 준비하는 시점에서부터 시작
-//message_format_unit을 사용 (16bytes)
-//int64_t는 8bytes size
-typedef struct {
-    uint8_t id;
-    
-    int64_t wake_sec; 
-    int64_t wake_nsec;
-
-    int64_t recv_sec; 
-    int64_t recv_nsec;
-
-    int64_t send_sec; 
-    int64_t send_nsec;
-
-} TaskHeader;
-
-// out의 필드에서 읽어 buffer에 offset 위치부터 채움
-// buffer는 출력 버퍼, offset은 해당 TaskHeader의 시작 위치
-// TaskHeader는 id,wake,start,end 필드를 각 16bytes로 가짐
-// TaskHeader의 각 필드는 8bytes로 분리됨 (id를 제외하고, 8bytes씩 sec, nsec를 담당)
-// 따라서 총 64bytes를 작성
-void write_task_header(TaskHeader *out, char *buffer, int task_offset)
-{
-    //ID 작성
-    memcpy(buffer + task_offset, &out->id, sizeof(uint8_t)); //1byte 만큼 ID 사용
-    //Wake 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t)*2), &out->wake_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t)*3), &out->wake_nsec, sizeof(int64_t));
-    //Start 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t)*4), &out->recv_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t)*5), &out->recv_nsec, sizeof(int64_t));
-    //End 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t)*6), &out->send_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t)*7), &out->send_nsec, sizeof(int64_t));
-}
-
 void *runnable_thread(void *arg)
 {
-    char result[OUTPUT_SIZE_B]; // 결과를 저장할 버퍼 // 24KB
-    struct timespec next, start, send_time, end; //ekf은 Edge task: start = recv_time
-    int last_ekf_id = 0; // 마지막 ekf ID를 저장할 변수
+    char local_copy_byloc[INPUT_SIZE_B_byloc] CHAIN_MSG_ALIGNED; // 3KB만큼 입력
+    char result[OUTPUT_SIZE_B] CHAIN_MSG_ALIGNED; // 결과를 저장할 버퍼 // 5KB
+    chain_msg_t *msg = chain_msg(result);        // result의 chain message 영역
+    struct timespec next, start, recv_time, send_time, end;
+    uint64_t last_ekf_seq = 0; // 마지막으로 보낸 ekf seq (rt_release_seq: release 번호 + 1, 재시작해도 증가)
+
+    memset(result, 0, sizeof(result));
 
     // while문을 통해 running 이전에 Planner에 Client로써 연결시도
     int Planner_sock_ekf = socket(AF_INET, SOCK_STREAM, 0);
     struct sockaddr_in Planner_addr_ekf;
     Planner_addr_ekf.sin_family = AF_INET;
-    Planner_addr_ekf.sin_port = htons(Planner_ekf_PORT);
+    Planner_addr_ekf.sin_port = htons(rt_instance_peer_port(Planner_ekf_PORT));
     inet_pton(AF_INET, "127.0.0.1", &Planner_addr_ekf.sin_addr); // localhost IP 주소로 설정
-    // 반복 하여 Planner에 연결 시도
+    // 반복 하여 Planner에 연결 시도 (1ms 간격, 대기 메세지는 한 번만 출력)
+    printf("[ekf] Waiting for Planner...\n");
     while (connect(Planner_sock_ekf, (struct sockaddr *)&Planner_addr_ekf, sizeof(Planner_addr_ekf)) < 0)
     {
-        printf("[ekf] Waiting for Planner...\n");
-        sleep(1); // 1초 대기 후 재시도
+        usleep(1000); // 1ms 대기 후 재시도
     }
     printf("[ekf] Connected to Planner\n");
+    static rt_clock_peer_t clock_peer; // 역방향 ping 수신 (clock offset 추정, rt_clock.h)
+    static rt_link_tx_t link; // 연결이 끊기면 재연결, 그동안의 job은 전송을 건너뜀 (rt_link.h)
+    rt_link_tx_init(&link, "[ekf] Planner", Planner_sock_ekf, &Planner_addr_ekf, &clock_peer);
 
-    clock_gettime(CLOCK_MONOTONIC, &next); // 주기를 위한 시간 측정
+    rt_trace_open("ekf"); // hot loop의 출력은 trace ring으로 (trace_drain이 파일로 저장)
+    rt_perf_open();  // WATERS_PERF=1: phase별 performance counter
+    rt_release_t release;
+    rt_release_init(&release, PERIOD_NS, &next); // 공통 epoch(+offset)의 첫 release까지 대기
 
     while(1){
-        //실제: 기상 |- 실행 ㅣ- 데이터 생성 ㅣ- 전송  
-        //코드 구현: 기상 |- 실행(busy loop) - 데이터 생성(id++) |- 메세지 패킷 생성 완료 - 전송 | - debuging용 출력 | - 주기 계산
-        //ekf은 edge task이므로 데이터 읽기가 없음
+        //실제: 기상 |- 데이터 읽기 |- 실행 ㅣ- 데이터 생성 ㅣ- 전송  
+        //코드 구현: 기상 |- Localization 데이터 복사 |- 실행(busy loop) - 데이터 생성(seq++) |- 메세지 패킷 생성 완료 - 전송 | - debuging용 출력 | - 주기 계산
 
-        //1.Setup phase: 기상, 데이터 읽기 완료(ekf은 edge task라 데이터 읽기 X) 
+        //1.Setup phase: 기상, 데이터 읽기 완료
         clock_gettime(CLOCK_MONOTONIC, &start);
-        double next_ms = next.tv_sec * 1000.0 + next.tv_nsec / 1.0e6;
-        printf("[ekf] wake-up at %.3f ms\n", next_ms);
-        double start_ms = start.tv_sec * 1000.0 + start.tv_nsec / 1.0e6;
-        printf("[ekf] Started at %.3f ms\n", start_ms);
+        rt_trace_ts(&next, RT_TR_WAKE, release.k, 0, 0);
+        rt_trace_ts(&start, RT_TR_START, release.k, 0, 0);
+        rt_perf_begin();
+
+        // Localization 데이터 복사 (chain 1,2)
+        pthread_mutex_lock(&buffer_lock_byloc);
+        memcpy(local_copy_byloc, input_buffer_byloc, INPUT_SIZE_B_byloc);
+        pthread_mutex_unlock(&buffer_lock_byloc);
+
+        clock_gettime(CLOCK_MONOTONIC, &recv_time);
+        rt_perf_mark(RT_SPAN_SETUP);
         // ------------------ setup phase 완료 ----------
 
+        // chain 1,2에 해당하는 부분 추출 및 result 저장
+        *CHAIN_OF(msg, chain_type_1) = *CHAIN_OF(chain_msg_const(local_copy_byloc), chain_type_1);
+        *CHAIN_OF(msg, chain_type_2) = *CHAIN_OF(chain_msg_const(local_copy_byloc), chain_type_2);
+        // chain별로 읽은 chain 시작(level 5) data의 seq 기록, flags = chain 번호
+        rt_trace_ts(&recv_time, RT_TR_READ, release.k, 1, chain_msg_source(msg, chain_type_1)->seq);
+        rt_trace_ts(&recv_time, RT_TR_READ, release.k, 2, chain_msg_source(msg, chain_type_2)->seq);
+
         double exec_ns = rand_range(EXEC_TIME_LB, EXEC_TIME_AVG, EXEC_TIME_UB);
         double exec_us = exec_ns / 1000.0;
         struct timespec exec_now;
         do
         {
             clock_gettime(CLOCK_MONOTONIC, &exec_now);
-            double elapsed_us = (exec_now.tv_sec - start.tv_sec) * 1e6 +
-                                (exec_now.tv_nsec - start.tv_nsec) / 1e3;
+            double elapsed_us = (exec_now.tv_sec - recv_time.tv_sec) * 1e6 +
+                                (exec_now.tv_nsec - recv_time.tv_nsec) / 1e3;
             if (elapsed_us >= exec_us)
                 break;
         } while (1);
 
 
         // ekf 데이터 생성
-        last_ekf_id++; // ekf ID 증가
-        if (last_ekf_id > 255) last_ekf_id = 1; // ID가 255를 초과하면 1으로 초기화
+        last_ekf_seq = rt_release_seq(&release); // ekf seq 증가
          // --------------Execution phase 완료--
 
          //3.Send phase: data packet 생성 시작
          clock_gettime(CLOCK_MONOTONIC, &send_time);
-         double send_time_ms = send_time.tv_sec * 1000.0 + send_time.tv_nsec / 1.0e6;
-         printf("[ekf] send at %.3f ms\n", send_time_ms);
-        //message packet 생성 시작
-        TaskHeader ekf;
-        ekf.id = last_ekf_id; // ekf ID 설정
-        ekf.wake_sec = next.tv_sec; // 주기에 의해 깬 시점
-        ekf.wake_nsec = next.tv_nsec; // 주기에 의해 깬 시점
-        ekf.recv_sec = start.tv_sec; //Scheduling되어 실행되는 시점
-        ekf.recv_nsec = start.tv_nsec; //Scheduling되어 실행되는 시점
-        ekf.send_sec = send_time.tv_sec; // execution이 끝나는 시점 (=data 전송 시점)
-        ekf.send_nsec = send_time.tv_nsec; // execution이 끝나는 시점 (=data 전송 시점)
-
-        // ekf 결과를 result 버퍼에 작성
-        write_task_header(&ekf, result, offset);
+         rt_perf_mark(RT_SPAN_EXEC);
+        // ekf 결과를 result 버퍼에 작성 (chain 1,2 모두 같은 slot 내용)
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_1, chain_level), last_ekf_seq, &next, &recv_time, &send_time);
+        rt_clock_stamp(&clock_peer, CHAIN_SLOT(msg, chain_type_1, chain_level));
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_2, chain_level), last_ekf_seq, &next, &recv_time, &send_time);
+        rt_clock_stamp(&clock_peer, CHAIN_SLOT(msg, chain_type_2, chain_level));
 
         // ekf 결과 전송
-        ssize_t sent_bytes = send(Planner_sock_ekf, result, OUTPUT_SIZE_B, 0);
-        if (sent_bytes < 0) {
-            perror("[ekf] send() failed");
-            break; // 전송 실패 시 루프 종료
-        }
+        rt_link_tx_send(&link, result, OUTPUT_SIZE_B); // 실패하면 재연결, 이번 job은 missed
 
-        //4.log print phase
+        //4.trace phase: printf 대신 trace ring에 기록
         clock_gettime(CLOCK_MONOTONIC, &end);
-        double end_ms = end.tv_sec * 1000.0 + end.tv_nsec / 1.0e6;
-        printf("[ekf] finished at %.3f ms\n", end_ms); // 끝난 시점 출력
-        double exec_time_ms = (send_time.tv_sec - start.tv_sec) * 1000.0 + (send_time.tv_nsec - start.tv_nsec) / 1.0e6;
-        printf("[ekf] Execution time: %.3f ms\n", exec_time_ms); // 실행시간 출력
-        double resp_time_ms = (end.tv_sec - next.tv_sec) * 1000.0 + (end.tv_nsec - next.tv_nsec) / 1.0e6;
-        printf("[ekf] Response time: %.3f ms\n", resp_time_ms); // 반응시간 출력
-        printf("[ekf] send data value: ekf = %d\n", ekf.id); //생성 data id 출력
-        printf("[ekf] Sleeping for %d ms\n\n", PERIOD_MS); // 다음 주기까지 대기 시간 출력
+        rt_perf_mark(RT_SPAN_SEND);
+        rt_trace_ts(&send_time, RT_TR_SEND, release.k, 0, last_ekf_seq);
+        rt_trace_ts(&end, RT_TR_END, release.k, 0, last_ekf_seq);
+        rt_trace_span(&start, &recv_time, RT_SPAN_SETUP, release.k);
+        rt_trace_span(&recv_time, &send_time, RT_SPAN_EXEC, release.k);
+        rt_trace_span(&send_time, &end, RT_SPAN_SEND, release.k);
+        rt_perf_flush(release.k);
         
         //5.next period cal phase
-        next.tv_nsec += PERIOD_NS;
-        if (next.tv_nsec >= 1000000000)
-        {
-            next.tv_sec += 1;
-            next.tv_nsec -= 1000000000;
-        }
+        rt_trace_sleep(&end, release.k);   // end 이후 기록 구간 + sleep 시작
+        rt_release_next(&release, &next); // epoch + offset + k * period
         clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL); 
     }
     return NULL;
@@ -245,14 +294,20 @@ void bind_process_to_core(int core_id) {
 // ------------------------------
 int main()
 {
-    bind_process_to_core(2);
+    bind_process_to_core(rt_core_from_env(2));
     srand(time(NULL)); // 난수 초기화
+    memset(input_buffer_byloc, 0, INPUT_SIZE_B_byloc);
+
+    pthread_t tid_loc;
+    pthread_create(&tid_loc, NULL, copy_thread_byloc, NULL);
+
     pthread_t runnable_tid;
 
     // runnable_thread 생성
     pthread_create(&runnable_tid, NULL, runnable_thread, NULL);
 
     // runnable_thread 종료 대기
+    pthread_join(tid_loc, NULL);
     pthread_join(runnable_tid, NULL);
 
     return 0;
@@ -0,0 +1,201 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <math.h>
+#include <sched.h>
+
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/rt_perf.h"
+#include "../Bare_metal_common/chain_msg.h"
+#include "../Bare_metal_common/rt_clock.h"
+#include "../Bare_metal_common/rt_link.h"
+
+// 설정 값
+#define PERFORMANCE_Frequency 3.4      // Intel i7의 clock speed (GHz)
+#define WCET_OVERRUN_PROBABILITY 0.001 // 실행시간이 WCET를 초과할 확률
+
+// 환경 값
+// Output data
+// by Lidar_grabber: occupancy grid
+#define Occupancy_grid_host_size_KB 500
+#define Occupancy_grid_host_size_B (Occupancy_grid_host_size_KB * 1024)
+#define OUTPUT_SIZE_B (Occupancy_grid_host_size_B)
+
+// execution
+#define PERIOD_MS 33
+// #define PERIOD_US (PERIOD_MS * 1000)    // microseconds 단위로 변환
+#define PERIOD_NS (PERIOD_MS * 1000000) // nanoseconds 단위로 변환
+
+// WATERS 2019 model의 평균 실행시간을 기준으로 +-5% 범위로 근사
+#define EXEC_TICKS_LB 37150000
+#define EXEC_TICKS_AVG 39100000
+#define EXEC_TICKS_UB 41050000
+#define EXEC_TIME_LB (EXEC_TICKS_LB / PERFORMANCE_Frequency)   // nanoseconds 단위로 변환
+#define EXEC_TIME_AVG (EXEC_TICKS_AVG / PERFORMANCE_Frequency) // nanoseconds 단위로 변환
+#define EXEC_TIME_UB (EXEC_TICKS_UB / PERFORMANCE_Frequency)   // nanoseconds 단위
+
+// 메세지 slot 설정 (layout은 chain_msg.h)
+#define chain_type 1              // Lidar_grabber은 Chain_type 1에 해당함
+#define chain_level 5             // Lidar_grabber은 Chain_level 5에 해당함
+CHAIN_MSG_ASSERT_FITS(OUTPUT_SIZE_B);
+
+
+// Localization 서버 포트 (수신단)
+#define Loc_lidar_PORT 5560
+
+// --------------------------------runnable Thread 설정 -----------------
+// 실행시간 난수 생성 함수
+// C에서 rand()의 결과를 [0, 1) 실수로 변환
+double rand_uniform()
+{
+    return ((double)rand()) / ((double)RAND_MAX + 1);
+}
+// exec_us 값을 생성하는 분포 함수
+double rand_range(double min, double avg, double max)
+{
+    // 확률 비율 계산
+    double p_avg = (max - avg) / (max - min);
+    // uniform 확률 변수 [0,1)
+    double x = rand_uniform();
+    if (x < p_avg)
+    {
+        // [min, avg] 구간 uniform
+        return min + rand_uniform() * (avg - min);
+    }
+    else if (x < 1.0 - WCET_OVERRUN_PROBABILITY)
+    {
+        // [avg, max] 구간 uniform
+        return avg + rand_uniform() * (max - avg);
+    }
+    else
+    {
+        // WCET overrun: max를 초과하는 희박한 경우
+        double u = rand_uniform();
+        return max + (avg * pow(u, 2) / 10.0); // 지수적으로 줄어드는 확률
+    }
+}
+
+void *runnable_thread(void *arg)
+{
+    char result[OUTPUT_SIZE_B] CHAIN_MSG_ALIGNED; // 결과를 저장할 버퍼 // 500KB
+    struct timespec next, start, send_time, end; //Lidar_grabber은 Edge task: start = recv_time
+    uint64_t last_lidar_seq = 0; // 마지막으로 보낸 Lidar_grabber seq (rt_release_seq: release 번호 + 1, 재시작해도 증가)
+
+    memset(result, 0, sizeof(result));
+
+    // while문을 통해 running 이전에 Localization에 Client로써 연결시도
+    int Loc_sock_lidar = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in Loc_addr_lidar;
+    Loc_addr_lidar.sin_family = AF_INET;
+    Loc_addr_lidar.sin_port = htons(rt_instance_peer_port(Loc_lidar_PORT));
+    inet_pton(AF_INET, "127.0.0.1", &Loc_addr_lidar.sin_addr); // localhost IP 주소로 설정
+    // 반복 하여 Localization에 연결 시도 (1ms 간격, 대기 메세지는 한 번만 출력)
+    printf("[lidar] Waiting for Localization...\n");
+    while (connect(Loc_sock_lidar, (struct sockaddr *)&Loc_addr_lidar, sizeof(Loc_addr_lidar)) < 0)
+    {
+        usleep(1000); // 1ms 대기 후 재시도
+    }
+    printf("[lidar] Connected to Localization\n");
+    static rt_clock_peer_t clock_peer; // 역방향 ping 수신 (clock offset 추정, rt_clock.h)
+    static rt_link_tx_t link; // 연결이 끊기면 재연결, 그동안의 job은 전송을 건너뜀 (rt_link.h)
+    rt_link_tx_init(&link, "[lidar] Localization", Loc_sock_lidar, &Loc_addr_lidar, &clock_peer);
+
+    rt_trace_open("lidar"); // hot loop의 출력은 trace ring으로 (trace_drain이 파일로 저장)
+    rt_perf_open();  // WATERS_PERF=1: phase별 performance counter
+    rt_release_t release;
+    rt_release_init(&release, PERIOD_NS, &next); // 공통 epoch(+offset)의 첫 release까지 대기
+
+    while(1){
+        //실제: 기상 |- 실행 ㅣ- 데이터 생성 ㅣ- 전송  
+        //코드 구현: 기상 |- 실행(busy loop) - 데이터 생성(seq++) |- 메세지 패킷 생성 완료 - 전송 | - debuging용 출력 | - 주기 계산
+        //Lidar_grabber은 edge task이므로 데이터 읽기가 없음
+
+        //1.Setup phase: 기상, 데이터 읽기 완료(Lidar_grabber은 edge task라 데이터 읽기 X) 
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        rt_trace_ts(&next, RT_TR_WAKE, release.k, 0, 0);
+        rt_trace_ts(&start, RT_TR_START, release.k, 0, 0);
+        rt_perf_begin();
+        // ------------------ setup phase 완료 ----------
+
+        double exec_ns = rand_range(EXEC_TIME_LB, EXEC_TIME_AVG, EXEC_TIME_UB);
+        double exec_us = exec_ns / 1000.0;
+        struct timespec exec_now;
+        do
+        {
+            clock_gettime(CLOCK_MONOTONIC, &exec_now);
+            double elapsed_us = (exec_now.tv_sec - start.tv_sec) * 1e6 +
+                                (exec_now.tv_nsec - start.tv_nsec) / 1e3;
+            if (elapsed_us >= exec_us)
+                break;
+        } while (1);
+
+
+        // Lidar_grabber 데이터 생성
+        last_lidar_seq = rt_release_seq(&release); // Lidar_grabber seq 증가
+         // --------------Execution phase 완료--
+
+         //3.Send phase: data packet 생성 시작
+         clock_gettime(CLOCK_MONOTONIC, &send_time);
+         rt_perf_mark(RT_SPAN_EXEC);
+        // Lidar_grabber 결과를 result 버퍼에 작성
+        chain_slot_set(CHAIN_SLOT(chain_msg(result), chain_type, chain_level), last_lidar_seq, &next, &start, &send_time);
+        rt_clock_stamp(&clock_peer, CHAIN_SLOT(chain_msg(result), chain_type, chain_level));
+
+        // Lidar_grabber 결과 전송
+        rt_link_tx_send(&link, result, OUTPUT_SIZE_B); // 실패하면 재연결, 이번 job은 missed
+
+        //4.trace phase: printf 대신 trace ring에 기록
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        rt_perf_mark(RT_SPAN_SEND);
+        rt_trace_ts(&send_time, RT_TR_SEND, release.k, 0, last_lidar_seq);
+        rt_trace_ts(&end, RT_TR_END, release.k, 0, last_lidar_seq);
+        rt_trace_span(&start, &send_time, RT_SPAN_EXEC, release.k);
+        rt_trace_span(&send_time, &end, RT_SPAN_SEND, release.k);
+        rt_perf_flush(release.k);
+        
+        //5.next period cal phase
+        rt_trace_sleep(&end, release.k);   // end 이후 기록 구간 + sleep 시작
+        rt_release_next(&release, &next); // epoch + offset + k * period
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL); 
+    }
+    return NULL;
+}
+void bind_process_to_core(int core_id) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core_id, &cpuset);
+
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) != 0) {
+        perror("sched_setaffinity");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// ------------------------------
+// 메인 함수
+// ------------------------------
+int main()
+{
+    bind_process_to_core(rt_core_from_env(6));
+    srand(time(NULL)); // 난수 초기화
+    pthread_t runnable_tid;
+
+    // runnable_thread 생성
+    pthread_create(&runnable_tid, NULL, runnable_thread, NULL);
+
+    // runnable_thread 종료 대기
+    pthread_join(runnable_tid, NULL);
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,391 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <math.h>
+#include <sched.h>
+
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/rt_perf.h"
+#include "../Bare_metal_common/chain_msg.h"
+#include "../Bare_metal_common/rt_clock.h"
+#include "../Bare_metal_common/rt_link.h"
+
+// 설정 값
+#define PERFORMANCE_Frequency 3.4      // Intel i7의 clock speed (GHz)
+#define WCET_OVERRUN_PROBABILITY 0.001 // 실행시간이 WCET를 초과할 확률
+
+// 환경 값
+// input_data
+// by Lidar_grabber
+#define Occupancy_grid_host_size_KB 500
+#define Occupancy_grid_host_size_B (Occupancy_grid_host_size_KB * 1024)
+#define INPUT_SIZE_B_bylidar (Occupancy_grid_host_size_B)
+// by CAN
+#define Vehicle_status_host_size_KB 1
+#define Vehicle_status_host_size_B (Vehicle_status_host_size_KB * 1024)
+#define INPUT_SIZE_B_bycan (Vehicle_status_host_size_B)
+
+//  output data
+// by Localization
+#define x_car_host_size_KB 1
+#define x_car_host_size_B (x_car_host_size_KB * 1024)
+#define y_car_host_size_KB 1
+#define y_car_host_size_B (y_car_host_size_KB * 1024)
+#define yaw_car_host_size_KB 1
+#define yaw_car_host_size_B (yaw_car_host_size_KB * 1024)
+#define OUTPUT_SIZE_B (x_car_host_size_B + y_car_host_size_B + yaw_car_host_size_B)
+
+// execution
+#define PERIOD_MS 400
+#define PERIOD_US (PERIOD_MS * 1000)    // microseconds 단위로 변환
+#define PERIOD_NS (PERIOD_MS * 1000000) // nanoseconds 단위로 변환
+// WATERS 2019 model의 평균 실행시간을 기준으로 +-5% 범위로 근사
+#define EXEC_TICKS_LB 436050000
+#define EXEC_TICKS_AVG 459000000
+#define EXEC_TICKS_UB 481950000
+#define EXEC_TIME_LB (EXEC_TICKS_LB / PERFORMANCE_Frequency)   // nanoseconds 단위로 변환
+#define EXEC_TIME_AVG (EXEC_TICKS_AVG / PERFORMANCE_Frequency) // nanoseconds 단위로 변환
+#define EXEC_TIME_UB (EXEC_TICKS_UB / PERFORMANCE_Frequency)   // nanoseconds 단위로 변환
+
+// 메세지 slot 설정, layout은 chain_msg.h (Localization은 chain 1,2의 level 5 정보를 읽고 두 chain 영역에 작성해야함.)
+#define chain_type_1 1
+#define chain_type_2 2
+#define chain_level 4
+CHAIN_MSG_ASSERT_FITS(OUTPUT_SIZE_B);
+CHAIN_MSG_ASSERT_FITS_CHAIN(INPUT_SIZE_B_bycan, chain_type_2); // CAN channel은 chain 2 영역까지만 (chain_msg.h)
+
+// 전역 변수
+char input_buffer_bylidar[INPUT_SIZE_B_bylidar];
+char input_buffer_bycan[INPUT_SIZE_B_bycan];
+
+pthread_mutex_t buffer_lock_bylidar = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t buffer_lock_bycan = PTHREAD_MUTEX_INITIALIZER;
+
+#define EKF_loc_PORT 5562 // EKF 서버 포트
+// Localization 서버 포트
+#define Loc_lidar_PORT 5560
+#define Loc_can_PORT 5561
+
+// Copy Thread: Lidar_grabber로부터 데이터 수신
+void *copy_thread_bylidar(void *arg)
+{
+    int server_sock, client_sock;
+    struct sockaddr_in server_addr, client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    char *local_copy = rt_mem_alloc(INPUT_SIZE_B_bylidar);
+    // 소켓 생성
+    server_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_sock < 0)
+    {
+        perror("[Loc] Lidar_grabber socket error");
+        exit(EXIT_FAILURE);
+    }
+    // 이전 실험의 TIME_WAIT 소켓이 남아 있어도 바로 bind 할 수 있도록 설정
+    int reuse = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    // 서버 주소 설정
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(rt_instance_port(Loc_lidar_PORT));
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    // 바인드
+    if (bind(server_sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+    {
+        perror("[Loc] Lidar_grabber bind error");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+    // 리슨
+    if (listen(server_sock, 5) < 0)
+    {
+        perror("[Loc] Lidar_grabber listen error");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+    printf("[Loc] Waiting for Lidar_grabber connection on port %d...\n", rt_instance_port(Loc_lidar_PORT));
+    // Lidar_grabber에서 연결을 기다림
+    client_sock = accept(server_sock, (struct sockaddr *)&client_addr, &client_len);
+    if (client_sock < 0)
+    {
+        perror("[Loc] Lidar_grabber accept error");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+    printf("[Loc] Connected to Lidar_grabber: %s\n", inet_ntoa(client_addr.sin_addr));
+    // Lidar_grabber로부터 데이터를 수신하여 input_buffer_bylidar에 저장
+    rt_clock_link_t clock_link; // Lidar_grabber clock offset 추정 (rt_clock.h)
+    rt_clock_link_init(&clock_link, CHAIN_MSG_SOURCE_LEVEL(chain_type_1), 1u << chain_type_1);
+    rt_link_rx_t link; // 연결이 끊기면 다시 accept (rt_link.h)
+    rt_link_rx_init(&link, "[Loc] Lidar_grabber");
+    while (1)
+    {
+        // 연결이 끊기면 다시 accept: producer가 다시 연결할 때까지 runnable은 마지막 buffer(stale)를 계속 사용
+        rt_link_rx_recv(&link, server_sock, &client_sock, local_copy, INPUT_SIZE_B_bylidar);
+        rt_clock_link_recv(&clock_link, client_sock, chain_msg(local_copy), link.first_ns); // 이 task의 clock으로 변환
+        pthread_mutex_lock(&buffer_lock_bylidar);
+        memcpy(input_buffer_bylidar, local_copy, INPUT_SIZE_B_bylidar);
+        pthread_mutex_unlock(&buffer_lock_bylidar);
+    }
+    close(client_sock);
+    close(server_sock);
+    return NULL;
+}
+
+// Copy Thread: CAN으로부터 데이터 수신
+void *copy_thread_bycan(void *arg)
+{
+    int server_sock, client_sock;
+    struct sockaddr_in server_addr, client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    char *local_copy = rt_mem_alloc(INPUT_SIZE_B_bycan);
+    // 소켓 생성
+    server_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_sock < 0)
+    {
+        perror("[Loc] CAN socket error");
+        exit(EXIT_FAILURE);
+    }
+    // 이전 실험의 TIME_WAIT 소켓이 남아 있어도 바로 bind 할 수 있도록 설정
+    int reuse = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    // 서버 주소 설정
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(rt_instance_port(Loc_can_PORT));
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+    // 바인드
+    if (bind(server_sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
+    {
+        perror("[Loc] CAN bind error");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+    // 리슨
+    if (listen(server_sock, 5) < 0)
+    {
+        perror("[Loc] CAN listen error");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+    printf("[Loc] Waiting for CAN connection on port %d...\n", rt_instance_port(Loc_can_PORT));
+    // CAN에서 연결을 기다림
+    client_sock = accept(server_sock, (struct sockaddr *)&client_addr, &client_len);
+    if (client_sock < 0)
+    {
+        perror("[Loc] CAN accept error");
+        close(server_sock);
+        exit(EXIT_FAILURE);
+    }
+    printf("[Loc] Connected to CAN: %s\n", inet_ntoa(client_addr.sin_addr));
+    // CAN로부터 데이터를 수신하여 input_buffer_bycan에 저장
+    rt_clock_link_t clock_link; // CAN clock offset 추정 (rt_clock.h)
+    rt_clock_link_init(&clock_link, CHAIN_MSG_SOURCE_LEVEL(chain_type_2), 1u << chain_type_2);
+    rt_link_rx_t link; // 연결이 끊기면 다시 accept (rt_link.h)
+    rt_link_rx_init(&link, "[Loc] CAN");
+    while (1)
+    {
+        // 연결이 끊기면 다시 accept: producer가 다시 연결할 때까지 runnable은 마지막 buffer(stale)를 계속 사용
+        rt_link_rx_recv(&link, server_sock, &client_sock, local_copy, INPUT_SIZE_B_bycan);
+        rt_clock_link_recv(&clock_link, client_sock, chain_msg(local_copy), link.first_ns); // 이 task의 clock으로 변환
+        pthread_mutex_lock(&buffer_lock_bycan);
+        memcpy(input_buffer_bycan, local_copy, INPUT_SIZE_B_bycan);
+        pthread_mutex_unlock(&buffer_lock_bycan);
+    }
+    close(client_sock);
+    close(server_sock);
+    return NULL;
+}
+
+// Runnable Thread
+
+// 실행시간 난수 생성 함수
+// C에서 rand()의 결과를 [0, 1) 실수로 변환
+double rand_uniform()
+{
+    return ((double)rand()) / ((double)RAND_MAX + 1);
+}
+// exec_us 값을 생성하는 분포 함수
+double rand_range(double min, double avg, double max)
+{
+    // 확률 비율 계산
+    double p_avg = (max - avg) / (max - min);
+    // uniform 확률 변수 [0,1)
+    double x = rand_uniform();
+    if (x < p_avg)
+    {
+        // [min, avg] 구간 uniform
+        return min + rand_uniform() * (avg - min);
+    }
+    else if (x < 1.0 - WCET_OVERRUN_PROBABILITY)
+    {
+        // [avg, max] 구간 uniform
+        return avg + rand_uniform() * (max - avg);
+    }
+    else
+    {
+        // WCET overrun: max를 초과하는 희박한 경우
+        double u = rand_uniform();
+        return max + (avg * pow(u, 2) / 10.0); // 지수적으로 줄어드는 확률
+    }
+}
+
+void *runnable_thread(void *arg)
+{
+    char *local_copy_bylidar = rt_mem_alloc(INPUT_SIZE_B_bylidar); // 500KB만큼 입력
+    char *local_copy_bycan = rt_mem_alloc(INPUT_SIZE_B_bycan);     // 1KB만큼 입력
+    char result[OUTPUT_SIZE_B] CHAIN_MSG_ALIGNED;                  // 3KB만큼 출력
+    chain_msg_t *msg = chain_msg(result);                           // result의 chain message 영역
+    struct timespec next, start, recv_time, send_time, end;
+    uint64_t seq = 0; // 보낸 data의 seq (rt_release_seq: release 번호 + 1, 재시작해도 증가)
+
+    memset(result, 0, sizeof(result));
+
+    // while문을 통해 running 이전에 EKF에 Client로써 연결시도
+    int ekf_sock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in ekf_addr;
+    ekf_addr.sin_family = AF_INET;
+    ekf_addr.sin_port = htons(rt_instance_peer_port(EKF_loc_PORT));
+    inet_pton(AF_INET, "127.0.0.1", &ekf_addr.sin_addr); // localhost IP 주소로 설정
+    // 반복 연결 시도 (1ms 간격, 대기 메세지는 한 번만 출력)
+    printf("[Loc] Waiting for EKF...\n");
+    while (connect(ekf_sock, (struct sockaddr *)&ekf_addr, sizeof(ekf_addr)) < 0)
+    {
+        usleep(1000);
+    }
+    printf("[Loc] Connected to EKF\n");
+    static rt_clock_peer_t clock_peer; // 역방향 ping 수신 (clock offset 추정, rt_clock.h)
+    static rt_link_tx_t link; // 연결이 끊기면 재연결, 그동안의 job은 전송을 건너뜀 (rt_link.h)
+    rt_link_tx_init(&link, "[Loc] EKF", ekf_sock, &ekf_addr, &clock_peer);
+
+    rt_trace_open("loc"); // hot loop의 출력은 trace ring으로 (trace_drain이 파일로 저장)
+    rt_perf_open();  // WATERS_PERF=1: phase별 performance counter
+    rt_release_t release;
+    rt_release_init(&release, PERIOD_NS, &next); // 공통 epoch(+offset)의 첫 release까지 대기
+
+    while (1)
+    {
+        // 1.Setup phase: 기상, 데이터 읽기 완료
+        // 기상
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        rt_trace_ts(&next, RT_TR_WAKE, release.k, 0, 0);
+        rt_trace_ts(&start, RT_TR_START, release.k, 0, 0);
+        rt_perf_begin();
+
+        // 데이터 읽기
+        // Lidar_grabber 데이터 복사 (chain 1)
+        pthread_mutex_lock(&buffer_lock_bylidar);
+        memcpy(local_copy_bylidar, input_buffer_bylidar, INPUT_SIZE_B_bylidar);
+        pthread_mutex_unlock(&buffer_lock_bylidar);
+        // CAN 데이터 복사 (chain 2)
+        pthread_mutex_lock(&buffer_lock_bycan);
+        memcpy(local_copy_bycan, input_buffer_bycan, INPUT_SIZE_B_bycan);
+        pthread_mutex_unlock(&buffer_lock_bycan);
+
+        clock_gettime(CLOCK_MONOTONIC, &recv_time);
+        rt_perf_mark(RT_SPAN_SETUP);
+        // ------------------ setup phase 완료 ----------
+        // 2. Execution phase: Data 읽기 및 설정, busy-loop
+
+        // Data 읽기 및 설정
+        // chain 1은 Lidar_grabber, chain 2는 CAN에서 추출해서 result 저장
+        *CHAIN_OF(msg, chain_type_1) = *CHAIN_OF(chain_msg_const(local_copy_bylidar), chain_type_1);
+        *CHAIN_OF(msg, chain_type_2) = *CHAIN_OF(chain_msg_const(local_copy_bycan), chain_type_2);
+        // chain별로 읽은 producer(level 5) data의 seq 기록, flags = chain 번호
+        rt_trace_ts(&recv_time, RT_TR_READ, release.k, 1, chain_msg_source(msg, chain_type_1)->seq);
+        rt_trace_ts(&recv_time, RT_TR_READ, release.k, 2, chain_msg_source(msg, chain_type_2)->seq);
+
+        // busy-loop
+        // execution time 계산
+        double exec_ns = rand_range(EXEC_TIME_LB, EXEC_TIME_AVG, EXEC_TIME_UB);
+        double exec_us = exec_ns / 1000.0;
+        struct timespec exec_now;
+        do
+        {
+            clock_gettime(CLOCK_MONOTONIC, &exec_now);
+            double elapsed_us = (exec_now.tv_sec - recv_time.tv_sec) * 1e6 +
+                                (exec_now.tv_nsec - recv_time.tv_nsec) / 1e3;
+            if (elapsed_us >= exec_us)
+                break;
+        } while (1);
+
+        // Localization 데이터 생성
+        seq = rt_release_seq(&release); // Localization seq 증가
+
+        // 3. send phase: data packet 생성 시작
+        clock_gettime(CLOCK_MONOTONIC, &send_time);
+        rt_perf_mark(RT_SPAN_EXEC);
+
+        //  EKF에 전송할 데이터 준비 (chain 1,2 모두 같은 slot 내용)
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_1, chain_level), seq, &next, &recv_time, &send_time);
+        rt_clock_stamp(&clock_peer, CHAIN_SLOT(msg, chain_type_1, chain_level));
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_2, chain_level), seq, &next, &recv_time, &send_time);
+        rt_clock_stamp(&clock_peer, CHAIN_SLOT(msg, chain_type_2, chain_level));
+        // result에 준비완료
+
+        // 결과를 EKF에 전송
+        rt_link_tx_send(&link, result, OUTPUT_SIZE_B); // 실패하면 재연결, 이번 job은 missed
+
+        // 4.trace phase: printf 대신 trace ring에 기록
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        rt_perf_mark(RT_SPAN_SEND);
+        rt_trace_ts(&send_time, RT_TR_SEND, release.k, 0, seq);
+        rt_trace_ts(&end, RT_TR_END, release.k, 0, seq);
+        rt_trace_span(&start, &recv_time, RT_SPAN_SETUP, release.k);
+        rt_trace_span(&recv_time, &send_time, RT_SPAN_EXEC, release.k);
+        rt_trace_span(&send_time, &end, RT_SPAN_SEND, release.k);
+        rt_perf_flush(release.k);
+
+        // 5.next period cal phase
+        //  주기 계산
+        rt_trace_sleep(&end, release.k);   // end 이후 기록 구간 + sleep 시작
+        rt_release_next(&release, &next); // epoch + offset + k * period
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+    return NULL;
+}
+
+void bind_process_to_core(int core_id) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core_id, &cpuset);
+
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) != 0) {
+        perror("sched_setaffinity");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// ------------------------------
+int main()
+{
+    bind_process_to_core(rt_core_from_env(8));
+    srand(time(NULL));
+    memset(input_buffer_bylidar, 0, INPUT_SIZE_B_bylidar);
+    memset(input_buffer_bycan, 0, INPUT_SIZE_B_bycan);
+
+    pthread_t tid_lidar, tid_can;
+    pthread_create(&tid_lidar, NULL, copy_thread_bylidar, NULL);
+    pthread_create(&tid_can, NULL, copy_thread_bycan, NULL);
+
+    // runnable_thread는 Localization의 실행 로직을 담당
+    pthread_t runnable_tid;
+    pthread_create(&runnable_tid, NULL, runnable_thread, NULL);
+
+    pthread_join(tid_lidar, NULL);
+    pthread_join(tid_can, NULL);
+    pthread_join(runnable_tid, NULL);
+
+    return 0;
+}
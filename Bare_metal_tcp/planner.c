@@ -13,6 +13,16 @@
 #include <math.h>
 #include <sched.h>
 
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/rt_perf.h"
+#include "../Bare_metal_common/chain_msg.h"
+#include "../Bare_metal_common/rt_clock.h"
+#include "../Bare_metal_common/rt_link.h"
+#include "../Bare_metal_common/rt_sample.h"
+
 // 설정 값
 #define PERFORMANCE_Frequency 3.4      // Intel i7의 clock speed (GHz)
 #define WCET_OVERRUN_PROBABILITY 0.001 // 실행시간이 WCET를 초과할 확률
@@ -43,12 +53,8 @@
 #define yaw_rate_size_KB 1
 #define yaw_rate_size_B (yaw_rate_size_KB * 1024)
 #define INPUT_SIZE_B_byekf (x_car_host_size_B + y_car_host_size_B + yaw_car_host_size_B + vel_car_size_B + yaw_rate_size_B)
-// by Localization: 나중에 구현, e2e의 직접연결 X
-// #define Vehicle_status_host_size_KB 1
-// #define Vehicle_status_host_size_B (Vehicle_status_host_size_KB * 1024)
-// by Lidar_grabber: 나중에 구현, e2e의 직접연결 X
-// #define Occupancy_grid_host_size_KB 500
-// #define Occupancy_grid_host_size_B (Occupancy_grid_host_size_KB * 1024)
+// Lidar_grabber의 Occupancy_grid(500KB)와 CAN의 Vehicle_status(1KB)는 Localization(loc.c)이 읽고,
+// chain 1,2의 Timestamp는 Localization -> EKF를 거쳐 위의 EKF 입력에 포함됨
 // 추가적으로 다른 Task들로부터 수신되어야하는 데이터도 존재(차후 연구 구현)
 //  output data
 // by Planner
@@ -69,29 +75,25 @@
 #define EXEC_TIME_AVG (EXEC_TICKS_AVG / PERFORMANCE_Frequency) // nanoseconds 단위로 변환
 #define EXEC_TIME_UB (EXEC_TICKS_UB / PERFORMANCE_Frequency)   // nanoseconds 단위로 변환
 
-// 메세지 OFFSET 설정 (Planner는 연결된 Task들의 정보를 읽고 모든 영역에 작성해야함.)
+// 메세지 slot 설정, layout은 chain_msg.h (Planner는 연결된 Task들의 정보를 읽고 모든 영역에 작성해야함.)
 #define chain_type_1 1
 #define chain_type_2 2
 #define chain_type_3 3
 #define chain_type_4 4
 #define chain_type_5 5
 #define chain_level 2
-#define message_size_of_chain 256 // 하나의 task chain마다 할당되는 message size 크기
-#define message_size_of_task 64   // 하나의 task마다 할당되는 message size 크기
-#define message_format_unit 16    // task가 사용하는 Message의 format 단위 16bytes
-// 메세지 offset
-#define chain1_offset ((chain_type_1 - 1) * message_size_of_chain)
-#define chain2_offset ((chain_type_2 - 1) * message_size_of_chain)
-#define chain3_offset ((chain_type_3 - 1) * message_size_of_chain)
-#define chain4_offset ((chain_type_4 - 1) * message_size_of_chain)
-#define chain5_offset ((chain_type_5 - 1) * message_size_of_chain)
-
-// //메세지 read offset (chain_level이 3인 task들의 data 위치) (2,3,4,5가 담겨서 256bytes)
-// #define chain1_read_offset (((chain_type_1-1)*message_size_of_chain) + ((chain_level-1)*message_size_of_task)) //chain1의 read offset
-// #define chain2_read_offset (((chain_type_2-1)*message_size_of_chain) + ((chain_level-1)*message_size_of_task)) //chain2의 read offset
-// #define chain3_read_offset (((chain_type_3-1)*message_size_of_chain) + ((chain_level-1)*message_size_of_task)) //chain3의 read offset
-// #define chain4_read_offset (((chain_type_4-1)*message_size_of_chain) + ((chain_level-1)*message_size_of_task)) //chain4의 read offset
-// #define chain5_read_offset (((chain_type_5-1)*message_size_of_chain) + ((chain_level-1)*message_size_of_task)) //chain5의 read offset
+#define ekf_level 3 // chain 1,2에서 EKF slot의 chain_level
+CHAIN_MSG_ASSERT_FITS(OUTPUT_SIZE_B_byplanner);
+
+// 입력 link 번호 (RT_TR_SKIP / RT_TR_REPEAT의 flags, trace_export.py의 SAMPLE_LINKS와 같은 순서)
+enum
+{
+    LINK_EKF = 0,
+    LINK_SFM,
+    LINK_LANE,
+    LINK_DETECTION,
+    NUM_LINKS
+};
 
 // 전역 변수
 char input_buffer_bySFM[INPUT_SIZE_B_bySFM];
@@ -117,7 +119,7 @@ void *copy_thread_bySFM(void *arg)
     int server_sock, client_sock;
     struct sockaddr_in server_addr, client_addr;
     socklen_t client_len = sizeof(client_addr);
-    char local_copy[INPUT_SIZE_B_bySFM];
+    char *local_copy = rt_mem_alloc(INPUT_SIZE_B_bySFM);
     // 소켓 생성
     server_sock = socket(AF_INET, SOCK_STREAM, 0);
     if (server_sock < 0)
@@ -125,10 +127,13 @@ void *copy_thread_bySFM(void *arg)
         perror("[Planner] SFM socket error");
         exit(EXIT_FAILURE);
     }
+    // 이전 실험의 TIME_WAIT 소켓이 남아 있어도 바로 bind 할 수 있도록 설정
+    int reuse = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
     // 서버 주소 설정
     memset(&server_addr, 0, sizeof(server_addr));
     server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(Planner_SFM_PORT);
+    server_addr.sin_port = htons(rt_instance_port(Planner_SFM_PORT));
     server_addr.sin_addr.s_addr = INADDR_ANY;
     // 바인드
     if (bind(server_sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
@@ -144,7 +149,7 @@ void *copy_thread_bySFM(void *arg)
         close(server_sock);
         exit(EXIT_FAILURE);
     }
-    printf("[Planner] Waiting for SFM connection on port %d...\n", Planner_SFM_PORT);
+    printf("[Planner] Waiting for SFM connection on port %d...\n", rt_instance_port(Planner_SFM_PORT));
     // SFM에서 연결을 기다림
     client_sock = accept(server_sock, (struct sockaddr *)&client_addr, &client_len);
     if (client_sock < 0)
@@ -155,20 +160,18 @@ void *copy_thread_bySFM(void *arg)
     }
     printf("[Planner] Connected to SFM: %s\n", inet_ntoa(client_addr.sin_addr));
     // SFM으로부터 데이터를 수신하여 input_buffer_bySFM에 저장
+    rt_clock_link_t clock_link; // SFM clock offset 추정 (rt_clock.h)
+    rt_clock_link_init(&clock_link, chain_level + 1, 1u << chain_type_3);
+    rt_link_rx_t link; // 연결이 끊기면 다시 accept (rt_link.h)
+    rt_link_rx_init(&link, "[Planner] SFM");
     while (1)
     {
-        ssize_t n = recv(client_sock, local_copy, INPUT_SIZE_B_bySFM, MSG_WAITALL);
-        if (n > 0)
-        {
-            pthread_mutex_lock(&buffer_lock_bySFM);
-            memcpy(input_buffer_bySFM, local_copy, INPUT_SIZE_B_bySFM);
-            pthread_mutex_unlock(&buffer_lock_bySFM);
-        }
-        else
-        {
-            printf("[Planner] recv error or connection closed\n");
-            break;
-        }
+        // 연결이 끊기면 다시 accept: producer가 다시 연결할 때까지 runnable은 마지막 buffer(stale)를 계속 사용
+        rt_link_rx_recv(&link, server_sock, &client_sock, local_copy, INPUT_SIZE_B_bySFM);
+        rt_clock_link_recv(&clock_link, client_sock, chain_msg(local_copy), link.first_ns); // 이 task의 clock으로 변환
+        pthread_mutex_lock(&buffer_lock_bySFM);
+        memcpy(input_buffer_bySFM, local_copy, INPUT_SIZE_B_bySFM);
+        pthread_mutex_unlock(&buffer_lock_bySFM);
     }
     close(client_sock);
     close(server_sock);
@@ -181,7 +184,7 @@ void *copy_thread_bylane(void *arg)
     int server_sock, client_sock;
     struct sockaddr_in server_addr, client_addr;
     socklen_t client_len = sizeof(client_addr);
-    char local_copy[INPUT_SIZE_B_bylane];
+    char *local_copy = rt_mem_alloc(INPUT_SIZE_B_bylane);
     // 소켓 생성
     server_sock = socket(AF_INET, SOCK_STREAM, 0);
     if (server_sock < 0)
@@ -189,10 +192,13 @@ void *copy_thread_bylane(void *arg)
         perror("[Planner] Lane socket error");
         exit(EXIT_FAILURE);
     }
+    // 이전 실험의 TIME_WAIT 소켓이 남아 있어도 바로 bind 할 수 있도록 설정
+    int reuse = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
     // 서버 주소 설정
     memset(&server_addr, 0, sizeof(server_addr));
     server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(Planner_LANE_PORT);
+    server_addr.sin_port = htons(rt_instance_port(Planner_LANE_PORT));
     server_addr.sin_addr.s_addr = INADDR_ANY;
     // 바인드
     if (bind(server_sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
@@ -208,7 +214,7 @@ void *copy_thread_bylane(void *arg)
         close(server_sock);
         exit(EXIT_FAILURE);
     }
-    printf("[Planner] Waiting for Lane connection on port %d...\n", Planner_LANE_PORT);
+    printf("[Planner] Waiting for Lane connection on port %d...\n", rt_instance_port(Planner_LANE_PORT));
     // Lane_detection에서 연결을 기다림
     client_sock = accept(server_sock, (struct sockaddr *)&client_addr, &client_len);
     if (client_sock < 0)
@@ -219,20 +225,18 @@ void *copy_thread_bylane(void *arg)
     }
     printf("[Planner] Connected to Lane_detection: %s\n", inet_ntoa(client_addr.sin_addr));
     // Lane_detection으로부터 데이터를 수신하여 input_buffer_bylane에 저장
+    rt_clock_link_t clock_link; // Lane clock offset 추정 (rt_clock.h)
+    rt_clock_link_init(&clock_link, chain_level + 1, 1u << chain_type_4);
+    rt_link_rx_t link; // 연결이 끊기면 다시 accept (rt_link.h)
+    rt_link_rx_init(&link, "[Planner] Lane_detection");
     while (1)
     {
-        ssize_t n = recv(client_sock, local_copy, INPUT_SIZE_B_bylane, MSG_WAITALL);
-        if (n > 0)
-        {
-            pthread_mutex_lock(&buffer_lock_bylane);
-            memcpy(input_buffer_bylane, local_copy, INPUT_SIZE_B_bylane);
-            pthread_mutex_unlock(&buffer_lock_bylane);
-        }
-        else
-        {
-            printf("[Planner] recv error or connection closed\n");
-            break;
-        }
+        // 연결이 끊기면 다시 accept: producer가 다시 연결할 때까지 runnable은 마지막 buffer(stale)를 계속 사용
+        rt_link_rx_recv(&link, server_sock, &client_sock, local_copy, INPUT_SIZE_B_bylane);
+        rt_clock_link_recv(&clock_link, client_sock, chain_msg(local_copy), link.first_ns); // 이 task의 clock으로 변환
+        pthread_mutex_lock(&buffer_lock_bylane);
+        memcpy(input_buffer_bylane, local_copy, INPUT_SIZE_B_bylane);
+        pthread_mutex_unlock(&buffer_lock_bylane);
     }
     close(client_sock);
     close(server_sock);
@@ -245,7 +249,7 @@ void *copy_thread_bydetection(void *arg)
     int server_sock, client_sock;
     struct sockaddr_in server_addr, client_addr;
     socklen_t client_len = sizeof(client_addr);
-    char local_copy[INPUT_SIZE_B_bydetection];
+    char *local_copy = rt_mem_alloc(INPUT_SIZE_B_bydetection);
     // 소켓 생성
     server_sock = socket(AF_INET, SOCK_STREAM, 0);
     if (server_sock < 0)
@@ -253,10 +257,13 @@ void *copy_thread_bydetection(void *arg)
         perror("[Planner] Detection socket error");
         exit(EXIT_FAILURE);
     }
+    // 이전 실험의 TIME_WAIT 소켓이 남아 있어도 바로 bind 할 수 있도록 설정
+    int reuse = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
     // 서버 주소 설정
     memset(&server_addr, 0, sizeof(server_addr));
     server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(Planner_DETECTION_PORT);
+    server_addr.sin_port = htons(rt_instance_port(Planner_DETECTION_PORT));
     server_addr.sin_addr.s_addr = INADDR_ANY;
     // 바인드
     if (bind(server_sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
@@ -272,7 +279,7 @@ void *copy_thread_bydetection(void *arg)
         close(server_sock);
         exit(EXIT_FAILURE);
     }
-    printf("[Planner] Waiting for Detection connection on port %d...\n", Planner_DETECTION_PORT);
+    printf("[Planner] Waiting for Detection connection on port %d...\n", rt_instance_port(Planner_DETECTION_PORT));
     // Detection에서 연결을 기다림
     client_sock = accept(server_sock, (struct sockaddr *)&client_addr, &client_len);
     if (client_sock < 0)
@@ -283,20 +290,18 @@ void *copy_thread_bydetection(void *arg)
     }
     printf("[Planner] Connected to Detection: %s\n", inet_ntoa(client_addr.sin_addr));
     // Detection으로부터 데이터를 수신하여 input_buffer_bydetection에 저장
+    rt_clock_link_t clock_link; // Detection clock offset 추정 (rt_clock.h)
+    rt_clock_link_init(&clock_link, chain_level + 1, 1u << chain_type_5);
+    rt_link_rx_t link; // 연결이 끊기면 다시 accept (rt_link.h)
+    rt_link_rx_init(&link, "[Planner] Detection");
     while (1)
     {
-        ssize_t n = recv(client_sock, local_copy, INPUT_SIZE_B_bydetection, MSG_WAITALL);
-        if (n > 0)
-        {
-            pthread_mutex_lock(&buffer_lock_bydetection);
-            memcpy(input_buffer_bydetection, local_copy, INPUT_SIZE_B_bydetection);
-            pthread_mutex_unlock(&buffer_lock_bydetection);
-        }
-        else
-        {
-            printf("[Planner] recv error or connection closed\n");
-            break;
-        }
+        // 연결이 끊기면 다시 accept: producer가 다시 연결할 때까지 runnable은 마지막 buffer(stale)를 계속 사용
+        rt_link_rx_recv(&link, server_sock, &client_sock, local_copy, INPUT_SIZE_B_bydetection);
+        rt_clock_link_recv(&clock_link, client_sock, chain_msg(local_copy), link.first_ns); // 이 task의 clock으로 변환
+        pthread_mutex_lock(&buffer_lock_bydetection);
+        memcpy(input_buffer_bydetection, local_copy, INPUT_SIZE_B_bydetection);
+        pthread_mutex_unlock(&buffer_lock_bydetection);
     }
     close(client_sock);
     close(server_sock);
@@ -309,7 +314,7 @@ void *copy_thread_byekf(void *arg)
     int server_sock, client_sock;
     struct sockaddr_in server_addr, client_addr;
     socklen_t client_len = sizeof(client_addr);
-    char local_copy[INPUT_SIZE_B_byekf];
+    char *local_copy = rt_mem_alloc(INPUT_SIZE_B_byekf);
     // 소켓 생성
     server_sock = socket(AF_INET, SOCK_STREAM, 0);
     if (server_sock < 0)
@@ -317,10 +322,13 @@ void *copy_thread_byekf(void *arg)
         perror("[Planner] ekf socket error");
         exit(EXIT_FAILURE);
     }
+    // 이전 실험의 TIME_WAIT 소켓이 남아 있어도 바로 bind 할 수 있도록 설정
+    int reuse = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
     // 서버 주소 설정
     memset(&server_addr, 0, sizeof(server_addr));
     server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(Planner_ekf_PORT);
+    server_addr.sin_port = htons(rt_instance_port(Planner_ekf_PORT));
     server_addr.sin_addr.s_addr = INADDR_ANY;
     // 바인드
     if (bind(server_sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0)
@@ -336,7 +344,7 @@ void *copy_thread_byekf(void *arg)
         close(server_sock);
         exit(EXIT_FAILURE);
     }
-    printf("[Planner] Waiting for ekf connection on port %d...\n", Planner_ekf_PORT);
+    printf("[Planner] Waiting for ekf connection on port %d...\n", rt_instance_port(Planner_ekf_PORT));
     // ekf에서 연결을 기다림
     client_sock = accept(server_sock, (struct sockaddr *)&client_addr, &client_len);
     if (client_sock < 0)
@@ -347,21 +355,18 @@ void *copy_thread_byekf(void *arg)
     }
     printf("[Planner] Connected to ekf: %s\n", inet_ntoa(client_addr.sin_addr));
     // ekf로부터 데이터를 수신하여 input_buffer_byekf에 저장
+    rt_clock_link_t clock_link; // ekf clock offset 추정 (rt_clock.h)
+    rt_clock_link_init(&clock_link, ekf_level, (1u << chain_type_1) | (1u << chain_type_2));
+    rt_link_rx_t link; // 연결이 끊기면 다시 accept (rt_link.h)
+    rt_link_rx_init(&link, "[Planner] ekf");
     while (1)
     {
-        ssize_t n = recv(client_sock, local_copy, INPUT_SIZE_B_byekf, MSG_WAITALL);
-        if (n > 0)
-        {
-            pthread_mutex_lock(&buffer_lock_byekf);
-            memcpy(input_buffer_byekf, local_copy, INPUT_SIZE_B_byekf);
-            printf("복사함");
-            pthread_mutex_unlock(&buffer_lock_byekf);
-        }
-        else
-        {
-            printf("[Planner] recv error or connection closed\n");
-            break;
-        }
+        // 연결이 끊기면 다시 accept: producer가 다시 연결할 때까지 runnable은 마지막 buffer(stale)를 계속 사용
+        rt_link_rx_recv(&link, server_sock, &client_sock, local_copy, INPUT_SIZE_B_byekf);
+        rt_clock_link_recv(&clock_link, client_sock, chain_msg(local_copy), link.first_ns); // 이 task의 clock으로 변환
+        pthread_mutex_lock(&buffer_lock_byekf);
+        memcpy(input_buffer_byekf, local_copy, INPUT_SIZE_B_byekf);
+        pthread_mutex_unlock(&buffer_lock_byekf);
     }
     close(client_sock);
     close(server_sock);
@@ -401,102 +406,49 @@ double rand_range(double min, double avg, double max)
     }
 }
 
-// 메세지 구조체
-// message_size_of_task 크기는 64bytes - 16bytes 단위로 분할
-//[0-15]: ID //이 중에서 1byte만 사용
-//[16-31]: 주기가 깨는 시점 //16bytes
-//[32-47]: Task start(데이터를 모두 수신완료한 recv_time) 시점 //16bytes (recv_time)
-//[48-63]: Task send 시점(= Data 전송 시점) //16bytes (send_time)
-// message_format_unit을 사용 (16bytes)
-// int64_t는 8bytes size
-typedef struct
-{
-    uint8_t id;
-
-    int64_t wake_sec;
-    int64_t wake_nsec;
-
-    int64_t recv_sec;
-    int64_t recv_nsec;
-
-    int64_t send_sec;
-    int64_t send_nsec;
-
-} TaskHeader;
-
-// // out의 필드에 buffer에서 offset 위치부터 읽어와서 채움
-// // buffer는 입력 버퍼, offset은 해당 TaskHeader의 읽는 시작 위치
-// // TaskHeader는 id,wake,start,end 필드를 각 16bytes로 가짐
-// // id는 1바이트, sec와 nsec은 각각 8바이트로 구성됨
-// void parse_task_header(TaskHeader *out, const char *buffer, int offset)
-// {
-//     memcpy(&out->id, buffer + offset, sizeof(uint8_t));
-
-//     memcpy(&out->wake_sec, buffer + offset + (sizeof(int64_t) * 2), sizeof(int64_t));
-//     memcpy(&out->wake_nsec, buffer + offset + (sizeof(int64_t) * 3), sizeof(int64_t));
-
-//     memcpy(&out->start_sec, buffer + offset + (sizeof(int64_t) * 4), sizeof(int64_t));
-//     memcpy(&out->start_nsec, buffer + offset + (sizeof(int64_t) * 5), sizeof(int64_t));
-
-//     memcpy(&out->end_sec, buffer + offset + (sizeof(int64_t) * 6), sizeof(int64_t));
-//     memcpy(&out->end_nsec, buffer + offset + (sizeof(int64_t) * 7), sizeof(int64_t));
-// }
-
-// out의 필드에서 읽어 buffer에 offset 위치부터 채움
-// buffer는 출력 버퍼, offset은 해당 TaskHeader의 시작 위치
-// TaskHeader는 id,wake,start,end 필드를 각 16bytes로 가짐
-// TaskHeader의 각 필드는 8bytes로 분리됨 (id를 제외하고, 8bytes씩 sec, nsec를 담당)
-// 따라서 총 64bytes를 작성
-void write_task_header(TaskHeader *out, char *buffer, int task_offset)
-{
-    // ID 작성
-    memcpy(buffer + task_offset, &out->id, sizeof(uint8_t)); // 1byte 만큼 ID 사용
-    // Wake 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 2), &out->wake_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 3), &out->wake_nsec, sizeof(int64_t));
-    // Start 작성 (or recv_time 이후부터)
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 4), &out->recv_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 5), &out->recv_nsec, sizeof(int64_t));
-    // End 작성
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 6), &out->send_sec, sizeof(int64_t));
-    memcpy(buffer + task_offset + (sizeof(int64_t) * 7), &out->send_nsec, sizeof(int64_t));
-}
-
 void *runnable_thread(void *arg)
 {
-    char local_copy_bySFM[INPUT_SIZE_B_bySFM];             // 24KB만큼 입력
-    char local_copy_bylane[INPUT_SIZE_B_bylane];           // 32KB만큼 입력
-    char local_copy_bydetection[INPUT_SIZE_B_bydetection]; // 750KB만큼 입력
-    char local_copy_byekf[INPUT_SIZE_B_byekf];             // 5KB만큼 입력
-    char result[OUTPUT_SIZE_B_byplanner];                  // 2048 bytes만큼 출력
+    char *local_copy_bySFM = rt_mem_alloc(INPUT_SIZE_B_bySFM);             // 24KB만큼 입력
+    char *local_copy_bylane = rt_mem_alloc(INPUT_SIZE_B_bylane);           // 32KB만큼 입력
+    char *local_copy_bydetection = rt_mem_alloc(INPUT_SIZE_B_bydetection); // 750KB만큼 입력
+    char *local_copy_byekf = rt_mem_alloc(INPUT_SIZE_B_byekf);             // 5KB만큼 입력
+    char result[OUTPUT_SIZE_B_byplanner] CHAIN_MSG_ALIGNED; // 2048 bytes만큼 출력
+    chain_msg_t *msg = chain_msg(result); // result의 chain message 영역
     struct timespec next, start, recv_time, send_time, end;
+    uint64_t seq = 0;                         // DASM에 보낸 data의 seq (rt_release_seq: release 번호 + 1, 재시작해도 증가)
+    rt_sample_link_t links[NUM_LINKS] = {{0}}; // 입력 link별 undersampling / oversampling
 
     // 해당 위치에 DASM에 연결 시도 로직구현 필요
     // while문을 통해 running 이전에 DASM에 Client로써 연결시도
     int dasm_sock = socket(AF_INET, SOCK_STREAM, 0);
     struct sockaddr_in dasm_addr;
     dasm_addr.sin_family = AF_INET;
-    dasm_addr.sin_port = htons(DASM_PORT);
+    dasm_addr.sin_port = htons(rt_instance_peer_port(DASM_PORT));
     inet_pton(AF_INET, "127.0.0.1", &dasm_addr.sin_addr); // localhost IP 주소로 설정
-    // 반복 연결 시도
+    // 반복 연결 시도 (1ms 간격, 대기 메세지는 한 번만 출력)
+    printf("[Planner] Waiting for DASM...\n");
     while (connect(dasm_sock, (struct sockaddr *)&dasm_addr, sizeof(dasm_addr)) < 0)
     {
-        perror("[Planner] Waiting for DASM...");
-        sleep(1);
+        usleep(1000);
     }
     printf("[Planner] Connected to DASM\n");
+    static rt_clock_peer_t clock_peer; // 역방향 ping 수신 (clock offset 추정, rt_clock.h)
+    static rt_link_tx_t link; // 연결이 끊기면 재연결, 그동안의 job은 전송을 건너뜀 (rt_link.h)
+    rt_link_tx_init(&link, "[Planner] DASM", dasm_sock, &dasm_addr, &clock_peer);
 
-    clock_gettime(CLOCK_MONOTONIC, &next); // 주기를 위한 시간 측정
+    rt_trace_open("planner"); // hot loop의 출력은 trace ring으로 (trace_drain이 파일로 저장)
+    rt_perf_open();  // WATERS_PERF=1: phase별 performance counter
+    rt_release_t release;
+    rt_release_init(&release, PERIOD_NS, &next); // 공통 epoch(+offset)의 첫 release까지 대기
 
     while (1)
     {
         // 1.Setup phase: 기상, 데이터 읽기 완료
         // 기상
         clock_gettime(CLOCK_MONOTONIC, &start);
-        double next_ms = next.tv_sec * 1000.0 + next.tv_nsec / 1.0e6;
-        printf("[Planner] wake-up at %.3f ms\n", next_ms);
-        double start_ms = start.tv_sec * 1000.0 + start.tv_nsec / 1.0e6;
-        printf("[Planner] Started at %.3f ms\n", start_ms);
+        rt_trace_ts(&next, RT_TR_WAKE, release.k, 0, 0);
+        rt_trace_ts(&start, RT_TR_START, release.k, 0, 0);
+        rt_perf_begin();
 
         // 데이터 읽기
         // 입력버퍼에서 데이터 복사: SFM, Lane_detection, Detection, ekf
@@ -518,28 +470,28 @@ void *runnable_thread(void *arg)
         pthread_mutex_unlock(&buffer_lock_bydetection);
 
         clock_gettime(CLOCK_MONOTONIC, &recv_time);
-        double recv_time_ms = recv_time.tv_sec * 1000.0 + recv_time.tv_nsec / 1.0e6;
-        printf("[Planner] received at %.3f ms\n", recv_time_ms);
+        rt_perf_mark(RT_SPAN_SETUP);
         // ------------------ setup phase 완료 ----------
         // 2. Execution phase: Data 읽기 및 설정, busy-loop
 
         // Data 읽기 및 설정
-        // Chain type에 해당하는 local_copy의 해당 부분을 추출해야함
-        // Chain 1,2 (0:511)에 해당하는 부분 추출 및 result 저장
-        memcpy(result + chain1_offset, &local_copy_byekf[chain1_offset], message_size_of_chain * 2);
-        // chain 3 (512:767)
-        memcpy(result + chain3_offset, &local_copy_bySFM[chain3_offset], message_size_of_chain);
-        // chain 4 (768: 1023)
-        memcpy(result + chain4_offset, &local_copy_bylane[chain4_offset], message_size_of_chain);
-        // chain 5 (1024: 1279)
-        memcpy(result + chain5_offset, &local_copy_bydetection[chain5_offset], message_size_of_chain);
-
-        // //debugging(result)
-        // for (int i = chain1_offset + 64; i < chain1_offset + 128; i++) {
-        //     printf("%02X ", (unsigned char)result[i]);
-        //     if ((i - (chain1_offset + 64) + 1) % 16 == 0) printf("\n");  // 16바이트마다 줄바꿈
-        // }
-        
+        // Chain type에 해당하는 local_copy의 chain 영역을 추출해야함
+        // Chain 1,2는 ekf (Lidar_grabber, CAN chain)
+        *CHAIN_OF(msg, chain_type_1) = *CHAIN_OF(chain_msg_const(local_copy_byekf), chain_type_1);
+        *CHAIN_OF(msg, chain_type_2) = *CHAIN_OF(chain_msg_const(local_copy_byekf), chain_type_2);
+        // chain 3은 SFM, chain 4는 Lane_detection, chain 5는 Detection
+        *CHAIN_OF(msg, chain_type_3) = *CHAIN_OF(chain_msg_const(local_copy_bySFM), chain_type_3);
+        *CHAIN_OF(msg, chain_type_4) = *CHAIN_OF(chain_msg_const(local_copy_bylane), chain_type_4);
+        *CHAIN_OF(msg, chain_type_5) = *CHAIN_OF(chain_msg_const(local_copy_bydetection), chain_type_5);
+        // chain별로 읽은 chain 시작 data의 seq 기록, flags = chain 번호
+        // (chain 1,2는 level 5의 Lidar_grabber/CAN, chain 3~5는 level 3의 producer)
+        for (int c = 1; c <= CHAIN_MSG_TYPES; c++)
+            rt_trace_ts(&recv_time, RT_TR_READ, release.k, c, chain_msg_source(msg, c)->seq);
+        // 입력 link별로 buffer를 쓴 task의 seq 확인: 읽기 전에 덮어써진 sample / 다시 읽은 sample
+        rt_sample_read(&links[LINK_EKF], LINK_EKF, CHAIN_SLOT(msg, chain_type_1, ekf_level)->seq, &recv_time, release.k);
+        rt_sample_read(&links[LINK_SFM], LINK_SFM, chain_msg_source(msg, chain_type_3)->seq, &recv_time, release.k);
+        rt_sample_read(&links[LINK_LANE], LINK_LANE, chain_msg_source(msg, chain_type_4)->seq, &recv_time, release.k);
+        rt_sample_read(&links[LINK_DETECTION], LINK_DETECTION, chain_msg_source(msg, chain_type_5)->seq, &recv_time, release.k);
 
         // busy-loop
         // execution time 계산
@@ -557,63 +509,39 @@ void *runnable_thread(void *arg)
 
         // 3. send phase: data packet 생성 시작
         clock_gettime(CLOCK_MONOTONIC, &send_time);
-        double send_time_ms = send_time.tv_sec * 1000.0 + send_time.tv_nsec / 1.0e6;
-        printf("[Planner] send at %.3f ms\n", send_time_ms);
-        //  DASM에 전송할 데이터 준비
-        TaskHeader chains[5]; // chain은 5개
-        for (int i = 0; i < 5; i++){
-            chains[i].id = 0; // 또는 특정 값
-            chains[i].wake_sec = next.tv_sec;
-            chains[i].wake_nsec = next.tv_nsec;
-            chains[i].recv_sec = recv_time.tv_sec;
-            chains[i].recv_nsec = recv_time.tv_nsec;
-            chains[i].send_sec = send_time.tv_sec;
-            chains[i].send_nsec = send_time.tv_nsec;
-        }
-        
-        // 파싱(읽은)한 TaskHeader 구조체를 사용하여 메시지 인덱스와 센싱 시각을 result에 저장
-        // OFFSET에 따라 ID와 센싱 시각을 result에 저장
-        // result는 OUTPUT_SIZE_B_byplanner 크기로 초기화
-        write_task_header(&chains[0], result, chain1_offset); //chain1
-        write_task_header(&chains[1], result, chain2_offset); //chain2
-        write_task_header(&chains[2], result, chain3_offset); //chain3
-        write_task_header(&chains[3], result, chain4_offset); //chain4
-        write_task_header(&chains[4], result, chain5_offset); //chain5
+        rt_perf_mark(RT_SPAN_EXEC);
+        //  DASM에 전송할 데이터 준비: chain마다 Planner(level 2) slot 작성 (seq는 DASM의 link 집계용)
+        seq = rt_release_seq(&release);
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_1, chain_level), seq, &next, &recv_time, &send_time);
+        rt_clock_stamp(&clock_peer, CHAIN_SLOT(msg, chain_type_1, chain_level));
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_2, chain_level), seq, &next, &recv_time, &send_time);
+        rt_clock_stamp(&clock_peer, CHAIN_SLOT(msg, chain_type_2, chain_level));
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_3, chain_level), seq, &next, &recv_time, &send_time);
+        rt_clock_stamp(&clock_peer, CHAIN_SLOT(msg, chain_type_3, chain_level));
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_4, chain_level), seq, &next, &recv_time, &send_time);
+        rt_clock_stamp(&clock_peer, CHAIN_SLOT(msg, chain_type_4, chain_level));
+        chain_slot_set(CHAIN_SLOT(msg, chain_type_5, chain_level), seq, &next, &recv_time, &send_time);
+        rt_clock_stamp(&clock_peer, CHAIN_SLOT(msg, chain_type_5, chain_level));
         // result에 준비완료
-        //debugging
-        // for (int i = chain1_offset + 64; i < chain1_offset + 128; i++) {
-        //     printf("%02X ", (unsigned char)result[i]);
-        //     if ((i - (chain1_offset + 64) + 1) % 16 == 0) printf("\n");  // 16바이트마다 줄바꿈
-        // }
-
 
         // 결과를 DASM에 전송
         // 여기 위치에 DASM에 전송하는 로직 구현 필요.
-        ssize_t sent = send(dasm_sock, result, OUTPUT_SIZE_B_byplanner, 0);
-        if (sent <= 0)
-        {
-            perror("[Planner] send() failed");
-            break; // 또는 재연결 루프 설계
-        }
+        rt_link_tx_send(&link, result, OUTPUT_SIZE_B_byplanner); // 실패하면 재연결, 이번 job은 missed
         
-        // 4.log print phase
+        // 4.trace phase: printf 대신 trace ring에 기록
         clock_gettime(CLOCK_MONOTONIC, &end);
-        double end_ms = end.tv_sec * 1000.0 + end.tv_nsec / 1.0e6;
-        printf("[Planner] finished at %.3f ms\n", end_ms);           //// 끝난 시점 출력
-        double exec_time_ms = (send_time.tv_sec - recv_time.tv_sec) * 1000.0 + (send_time.tv_nsec - recv_time.tv_nsec) / 1.0e6;
-        printf("[Planner] Execution time: %.3f ms\n", exec_time_ms); // 실행시간 출력
-        double resp_time_ms = (end.tv_sec - next.tv_sec) * 1000.0 + (end.tv_nsec - next.tv_nsec) / 1.0e6;
-        printf("[Planner] Response time: %.3f ms\n", resp_time_ms); // 반응시간 출력
-        printf("[Planner] Sleeping for %d ms\n\n", PERIOD_MS);       // 다음 주기까지 대기 시간 출력
+        rt_perf_mark(RT_SPAN_SEND);
+        rt_trace_ts(&send_time, RT_TR_SEND, release.k, 0, seq);
+        rt_trace_ts(&end, RT_TR_END, release.k, 0, seq);
+        rt_trace_span(&start, &recv_time, RT_SPAN_SETUP, release.k);
+        rt_trace_span(&recv_time, &send_time, RT_SPAN_EXEC, release.k);
+        rt_trace_span(&send_time, &end, RT_SPAN_SEND, release.k);
+        rt_perf_flush(release.k);
 
         // 5.next period cal phase
         //  주기 계산
-        next.tv_nsec += PERIOD_NS;
-        if (next.tv_nsec >= 1000000000)
-        {
-            next.tv_sec += 1;
-            next.tv_nsec -= 1000000000;
-        }
+        rt_trace_sleep(&end, release.k);   // end 이후 기록 구간 + sleep 시작
+        rt_release_next(&release, &next); // epoch + offset + k * period
         clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
     }
     return NULL;
@@ -633,7 +561,7 @@ void bind_process_to_core(int core_id) {
 // ------------------------------
 int main()
 {
-    bind_process_to_core(1);
+    bind_process_to_core(rt_core_from_env(1));
     srand(time(NULL));
     memset(input_buffer_bySFM, 0, INPUT_SIZE_B_bySFM);
     memset(input_buffer_bylane, 0, INPUT_SIZE_B_bylane);
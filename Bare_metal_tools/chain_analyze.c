@@ -0,0 +1,452 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <math.h>
+#include <libgen.h>
+#include <limits.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../Bare_metal_common/chain_bin.h"
+
+// Chain latency analyser (binary chain log용)
+// DASM이 WATERS_LOG_FORMAT=binary|both 로 남긴 log_Chain N_<변형>.bin 을 mmap으로 읽고,
+// block 단위로 여러 thread에 나누어 analysis2.py와 같은 값을 계산한다.
+//  - E2E latency  = l1_end - lL_wake
+//  - Execution    = (lL_send - lL_recv) + Σ(중간 level send - recv) + (l1_end - l1_recv)
+//  - Waiting      = E2E - Execution
+//  - Reaction     = l1_end - prev_wake      (직전 sample 직후의 event가 처음 반영되기까지, 직전 sample이 없으면 제외)
+//  - Data age     = l1_last_end - lL_wake  (sample을 마지막으로 읽은 DASM job까지)
+// 출력 (입력 파일과 같은 디렉터리):
+//  - <파일>,latency_analysis_results.csv       : record별 E2E / Execution / Waiting / Reaction / Data age (us, 제외한 값은 빈 칸)
+//  - <파일>_<항목>_histogram.csv               : bin_start_us,count (기본 10us 간격)
+//  - 표준출력: 평균 / 표준편차(표본) / 최소 / 최대 (analysis2.py와 같은 형식)
+//
+// 사용법: chain_analyze [-t thread 수] [-b bin 간격(us)] [-p 주기(ms)] <log_Chain N_x.bin...>
+
+#define NUM_METRICS 5
+#define DEFAULT_BIN_US 10.0
+#define CSV_ROW_MAX 160
+#define MAX_HIST_BINS (1 << 16) // 범위가 너무 넓으면 (초기화 전 id 0 record 등) bin 간격을 넓힘
+
+static const char *metric_titles[NUM_METRICS] = {"E2E latency", "Execution time", "Waiting time", "Reaction time",
+                                                 "Data age"};
+
+// chain 시작 task의 주기 (ms), 걸린 시간 출력용 (analysis2.py와 동일하게 record 수 * 주기)
+// chain 1: Lidar grabber, chain 2: CAN, chain 3: SFM, chain 4: Lane, chain 5: Detection
+static const int chain_period_ms[6] = {0, 33, 10, 33, 66, 200};
+
+typedef struct
+{
+    const char *base;   // mmap 시작 주소
+    size_t offset;      // block header 위치
+    uint32_t rows;
+    size_t first_row;   // 전체 record 중 이 block의 첫 번째 위치
+} block_index_t;
+
+// thread별 통계 (Welford, 나중에 병합)
+typedef struct
+{
+    size_t n;
+    double mean;
+    double m2;
+    double min;
+    double max;
+} stats_t;
+
+typedef struct
+{
+    // 입력
+    const chain_bin_header_t *h;
+    const block_index_t *blocks;
+    int block_begin;
+    int block_end;
+    double *values[NUM_METRICS]; // 전체 record 수만큼, us 단위
+    // 1단계 결과
+    stats_t stats[NUM_METRICS];
+    // 2단계 입력/결과
+    double bin_us[NUM_METRICS];
+    double hist_start[NUM_METRICS];
+    size_t num_bins[NUM_METRICS];
+    uint64_t *hist[NUM_METRICS];
+    char *csv;
+    size_t csv_len;
+} worker_t;
+
+static double elapsed_s(const struct timespec *a, const struct timespec *b)
+{
+    return (b->tv_sec - a->tv_sec) + (b->tv_nsec - a->tv_nsec) / 1.0e9;
+}
+
+static void stats_add(stats_t *s, double x)
+{
+    s->n++;
+    double d = x - s->mean;
+    s->mean += d / s->n;
+    s->m2 += d * (x - s->mean);
+    if (x < s->min)
+        s->min = x;
+    if (x > s->max)
+        s->max = x;
+}
+
+static void stats_merge(stats_t *a, const stats_t *b)
+{
+    if (b->n == 0)
+        return;
+    if (a->n == 0)
+    {
+        *a = *b;
+        return;
+    }
+    size_t n = a->n + b->n;
+    double d = b->mean - a->mean;
+    a->m2 += b->m2 + d * d * ((double)a->n * b->n / n);
+    a->mean += d * b->n / n;
+    a->n = n;
+    if (b->min < a->min)
+        a->min = b->min;
+    if (b->max > a->max)
+        a->max = b->max;
+}
+
+// 1단계: block의 column을 읽어 record별 값 계산 + thread별 통계
+static void *compute_worker(void *arg)
+{
+    worker_t *w = arg;
+    const chain_bin_header_t *h = w->h;
+    int levels = h->levels;
+    for (int m = 0; m < NUM_METRICS; m++)
+        w->stats[m] = (stats_t){0, 0.0, 0.0, INFINITY, -INFINITY};
+
+    for (int b = w->block_begin; b < w->block_end; b++)
+    {
+        const block_index_t *bi = &w->blocks[b];
+        const int64_t *cols = (const int64_t *)(bi->base + bi->offset + sizeof(chain_bin_block_t));
+#define COL(lvl, kind) (cols + (size_t)chain_bin_col(levels, (lvl), (kind)) * bi->rows)
+        const int64_t *top_wake = COL(levels, CHAIN_BIN_WAKE);
+        const int64_t *top_recv = COL(levels, CHAIN_BIN_RECV);
+        const int64_t *top_send = COL(levels, CHAIN_BIN_SEND);
+        const int64_t *l1_recv = COL(1, CHAIN_BIN_RECV);
+        const int64_t *l1_end = COL(1, CHAIN_BIN_SEND);
+        const int64_t *last_end = cols + (size_t)chain_bin_extra_col(levels, CHAIN_BIN_LAST_END) * bi->rows;
+        const int64_t *prev_wake = cols + (size_t)chain_bin_extra_col(levels, CHAIN_BIN_PREV_WAKE) * bi->rows;
+        for (uint32_t r = 0; r < bi->rows; r++)
+        {
+            int64_t e2e = l1_end[r] - top_wake[r];
+            int64_t exec = (top_send[r] - top_recv[r]) + (l1_end[r] - l1_recv[r]);
+            for (int lvl = levels - 1; lvl >= 2; lvl--)
+                exec += COL(lvl, CHAIN_BIN_SEND)[r] - COL(lvl, CHAIN_BIN_RECV)[r];
+            // 직전 sample이 없으면(첫 sample, clock 보정 전 sample 다음) Reaction을 알 수 없으므로 NAN (통계 / histogram에서 제외)
+            double reaction = prev_wake[r] != 0 ? (l1_end[r] - prev_wake[r]) / 1.0e3 : NAN;
+            int64_t age = last_end[r] - top_wake[r];
+            double v[NUM_METRICS] = {e2e / 1.0e3, exec / 1.0e3, (e2e - exec) / 1.0e3, reaction, age / 1.0e3};
+            size_t idx = bi->first_row + r;
+            for (int m = 0; m < NUM_METRICS; m++)
+            {
+                w->values[m][idx] = v[m];
+                if (!isnan(v[m]))
+                    stats_add(&w->stats[m], v[m]);
+            }
+        }
+#undef COL
+    }
+    return NULL;
+}
+
+// 2단계: thread별 histogram과 결과 CSV 문자열 생성
+static void *output_worker(void *arg)
+{
+    worker_t *w = arg;
+    size_t row_begin = w->blocks[w->block_begin].first_row;
+    size_t row_end = (w->block_end > w->block_begin)
+                         ? w->blocks[w->block_end - 1].first_row + w->blocks[w->block_end - 1].rows
+                         : row_begin;
+
+    for (int m = 0; m < NUM_METRICS; m++)
+    {
+        w->hist[m] = calloc(w->num_bins[m], sizeof(uint64_t));
+        if (w->hist[m] == NULL)
+        {
+            perror("calloc");
+            exit(EXIT_FAILURE);
+        }
+        for (size_t i = row_begin; i < row_end; i++)
+        {
+            if (isnan(w->values[m][i]))
+                continue;
+            size_t bin = (size_t)((w->values[m][i] - w->hist_start[m]) / w->bin_us[m]);
+            if (bin >= w->num_bins[m])
+                bin = w->num_bins[m] - 1;
+            w->hist[m][bin]++;
+        }
+    }
+
+    w->csv = malloc((row_end - row_begin) * CSV_ROW_MAX + 1);
+    if (w->csv == NULL)
+    {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    w->csv_len = 0;
+    for (size_t i = row_begin; i < row_end; i++)
+    {
+        char reaction[32] = "";
+        if (!isnan(w->values[3][i]))
+            snprintf(reaction, sizeof(reaction), "%.3f", w->values[3][i]);
+        w->csv_len += snprintf(w->csv + w->csv_len, CSV_ROW_MAX, "%.3f,%.3f,%.3f,%s,%.3f\n", w->values[0][i],
+                               w->values[1][i], w->values[2][i], reaction, w->values[4][i]);
+    }
+    return NULL;
+}
+
+static int analyze_file(const char *path, int num_threads, double bin_us, int period_override)
+{
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+    {
+        fprintf(stderr, "❌ 오류: '%s' 파일을 찾을 수 없습니다.\n", path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(chain_bin_header_t))
+    {
+        fprintf(stderr, "❌ 오류: '%s' 은(는) binary chain log가 아닙니다.\n", path);
+        close(fd);
+        return -1;
+    }
+    const char *base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        perror("mmap");
+        return -1;
+    }
+    const chain_bin_header_t *h = (const chain_bin_header_t *)base;
+    if (h->magic != CHAIN_BIN_MAGIC || h->version != CHAIN_BIN_VERSION || h->levels < 2 ||
+        h->num_cols != chain_bin_num_cols(h->levels) || h->num_cols > CHAIN_BIN_MAX_COLS)
+    {
+        fprintf(stderr, "❌ 오류: '%s' 은(는) binary chain log가 아닙니다.\n", path);
+        munmap((void *)base, st.st_size);
+        return -1;
+    }
+
+    // block 위치 색인 (block header만 훑음)
+    size_t cap = 1024, num_blocks = 0, total_rows = 0;
+    block_index_t *blocks = malloc(cap * sizeof(block_index_t));
+    size_t off = sizeof(chain_bin_header_t);
+    while (off + sizeof(chain_bin_block_t) <= (size_t)st.st_size)
+    {
+        const chain_bin_block_t *b = (const chain_bin_block_t *)(base + off);
+        size_t bytes = sizeof(chain_bin_block_t) + (size_t)b->rows * h->num_cols * sizeof(int64_t);
+        if (b->magic != CHAIN_BIN_BLOCK_MAGIC || off + bytes > (size_t)st.st_size)
+        {
+            fprintf(stderr, "⚠️ 경고: %s: offset %zu 이후는 불완전한 block이라 무시합니다.\n", path, off);
+            break;
+        }
+        if (num_blocks == cap)
+        {
+            cap *= 2;
+            blocks = realloc(blocks, cap * sizeof(block_index_t));
+        }
+        blocks[num_blocks++] = (block_index_t){base, off, b->rows, total_rows};
+        total_rows += b->rows;
+        off += bytes;
+    }
+    if (total_rows == 0)
+    {
+        printf("분석할 데이터를 찾지 못했습니다. 로그 파일 형식을 확인해주세요.\n");
+        free(blocks);
+        munmap((void *)base, st.st_size);
+        return -1;
+    }
+
+    if (num_threads > (int)num_blocks)
+        num_threads = num_blocks;
+    worker_t *workers = calloc(num_threads, sizeof(worker_t));
+    pthread_t *tids = malloc(num_threads * sizeof(pthread_t));
+    double *values[NUM_METRICS];
+    for (int m = 0; m < NUM_METRICS; m++)
+    {
+        values[m] = malloc(total_rows * sizeof(double));
+        if (values[m] == NULL)
+        {
+            perror("malloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int t = 0; t < num_threads; t++)
+    {
+        workers[t].h = h;
+        workers[t].blocks = blocks;
+        workers[t].block_begin = (int)(num_blocks * t / num_threads);
+        workers[t].block_end = (int)(num_blocks * (t + 1) / num_threads);
+        for (int m = 0; m < NUM_METRICS; m++)
+            workers[t].values[m] = values[m];
+        pthread_create(&tids[t], NULL, compute_worker, &workers[t]);
+    }
+    stats_t stats[NUM_METRICS] = {{0}};
+    for (int t = 0; t < num_threads; t++)
+    {
+        pthread_join(tids[t], NULL);
+        for (int m = 0; m < NUM_METRICS; m++)
+            stats_merge(&stats[m], &workers[t].stats[m]);
+    }
+
+    // 출력 파일 이름: 입력 파일과 같은 디렉터리
+    char path_copy[PATH_MAX], dir_copy[PATH_MAX];
+    snprintf(path_copy, sizeof(path_copy), "%s", path);
+    snprintf(dir_copy, sizeof(dir_copy), "%s", path);
+    const char *file_name = basename(path_copy);
+    const char *dir = dirname(dir_copy);
+
+    // histogram 범위: analysis2.py처럼 int(min) - bin 부터 bin 간격, 최대값이 포함되도록
+    double hist_start[NUM_METRICS], hist_bin_us[NUM_METRICS];
+    size_t num_bins[NUM_METRICS];
+    for (int m = 0; m < NUM_METRICS; m++)
+    {
+        if (stats[m].n == 0)
+        {
+            // 값이 하나도 없음 (예: record 하나뿐인 파일의 Reaction)
+            stats[m].min = stats[m].max = 0.0;
+        }
+        hist_start[m] = floor(stats[m].min) - bin_us;
+        hist_bin_us[m] = bin_us;
+        if ((stats[m].max - hist_start[m]) / bin_us >= MAX_HIST_BINS)
+        {
+            hist_bin_us[m] = ceil((stats[m].max - hist_start[m]) / (MAX_HIST_BINS - 1));
+            fprintf(stderr, "⚠️ 경고: %s %s 범위가 넓어 histogram 간격을 %.0f us로 늘립니다.\n", file_name,
+                    metric_titles[m], hist_bin_us[m]);
+        }
+        num_bins[m] = (size_t)((stats[m].max - hist_start[m]) / hist_bin_us[m]) + 1;
+    }
+    for (int t = 0; t < num_threads; t++)
+    {
+        for (int m = 0; m < NUM_METRICS; m++)
+        {
+            workers[t].bin_us[m] = hist_bin_us[m];
+            workers[t].hist_start[m] = hist_start[m];
+            workers[t].num_bins[m] = num_bins[m];
+        }
+        pthread_create(&tids[t], NULL, output_worker, &workers[t]);
+    }
+    for (int t = 0; t < num_threads; t++)
+        pthread_join(tids[t], NULL);
+
+    char out_path[PATH_MAX * 2];
+    snprintf(out_path, sizeof(out_path), "%s/%s,latency_analysis_results.csv", dir, file_name);
+    FILE *fp = fopen(out_path, "w");
+    if (fp == NULL)
+    {
+        perror("fopen results csv");
+        exit(EXIT_FAILURE);
+    }
+    fprintf(fp, "E2E latency,Execution time,Waiting time,Reaction time,Data age\n");
+    for (int t = 0; t < num_threads; t++)
+    {
+        fwrite(workers[t].csv, 1, workers[t].csv_len, fp);
+        free(workers[t].csv);
+    }
+    fclose(fp);
+
+    int period_ms = period_override > 0 ? period_override
+                                        : (h->chain >= 1 && h->chain <= 5 ? chain_period_ms[h->chain] : 0);
+    printf("results의 길이:  %zu\n", total_rows);
+    printf("걸린 시간(분): %g\n", (total_rows * (double)period_ms) * 1.66667e-5);
+    printf("%s\n", file_name);
+
+    for (int m = 0; m < NUM_METRICS; m++)
+    {
+        double std = stats[m].n > 1 ? sqrt(stats[m].m2 / (stats[m].n - 1)) : 0.0;
+        printf("\n📊 %s 통계\n", metric_titles[m]);
+        printf("  - 평균    : %.2f us\n", stats[m].mean);
+        printf("  - 표준편차 : %.2f us\n", std);
+        printf("  - 최소값   : %.2f us\n", stats[m].min);
+        printf("  - 최대값   : %.2f us\n", stats[m].max);
+        printf("----------------------------------------\n");
+
+        // histogram CSV: thread별 결과 병합
+        char title[32];
+        snprintf(title, sizeof(title), "%s", metric_titles[m]);
+        for (char *c = title; *c; c++)
+            *c = (*c == ' ') ? '_' : (char)((*c >= 'A' && *c <= 'Z') ? *c + 32 : *c);
+        snprintf(out_path, sizeof(out_path), "%s/%s_%s_histogram.csv", dir, file_name, title);
+        fp = fopen(out_path, "w");
+        if (fp == NULL)
+        {
+            perror("fopen histogram csv");
+            exit(EXIT_FAILURE);
+        }
+        fprintf(fp, "bin_start_us,count\n");
+        for (size_t bin = 0; bin < num_bins[m]; bin++)
+        {
+            uint64_t count = 0;
+            for (int t = 0; t < num_threads; t++)
+                count += workers[t].hist[m][bin];
+            fprintf(fp, "%.1f,%llu\n", hist_start[m] + bin * hist_bin_us[m], (unsigned long long)count);
+        }
+        fclose(fp);
+        printf("✅ '%s' 히스토그램이 저장되었습니다.\n", out_path);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    printf("(%zu records, %zu blocks, %d threads, %.3f s)\n", total_rows, num_blocks, num_threads, elapsed_s(&t0, &t1));
+
+    for (int t = 0; t < num_threads; t++)
+        for (int m = 0; m < NUM_METRICS; m++)
+            free(workers[t].hist[m]);
+    for (int m = 0; m < NUM_METRICS; m++)
+        free(values[m]);
+    free(workers);
+    free(tids);
+    free(blocks);
+    munmap((void *)base, st.st_size);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int num_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    double bin_us = DEFAULT_BIN_US;
+    int period_ms = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:b:p:")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            num_threads = atoi(optarg);
+            break;
+        case 'b':
+            bin_us = atof(optarg);
+            break;
+        case 'p':
+            period_ms = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-t threads] [-b bin_us] [-p period_ms] <log_Chain N_x.bin...>\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc || num_threads < 1 || bin_us <= 0)
+    {
+        fprintf(stderr, "usage: %s [-t threads] [-b bin_us] [-p period_ms] <log_Chain N_x.bin...>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    int failed = 0;
+    for (int i = optind; i < argc; i++)
+        failed |= analyze_file(argv[i], num_threads, bin_us, period_ms) != 0;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
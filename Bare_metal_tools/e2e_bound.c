@@ -0,0 +1,257 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <glob.h>
+#include <getopt.h>
+
+#include "../Bare_metal_common/task_model.h"
+#include "../Bare_metal_common/rta.h"
+#include "../Bare_metal_common/chain_bin.h"
+
+// End-to-end latency bound 계산기
+// pipeline 설명 파일과 task source의 #define(task_model.h)으로 chain별 worst-case Reaction time / Data age의
+// 해석적 상한을 구하고, run 디렉터리가 주어지면 DASM chain log의 측정 최댓값과 나란히 출력한다.
+//
+// task i의 주기 T, CPU 실행 C, GPU suspension S(둘 다 UB + overrun = task_model_wcet), semaphore blocking B, 응답 시간 R
+//  - R, B: rta.h (같은 core의 간섭, shm semaphore blocking, TCP copy thread 간섭)
+//  - chain τ_L(시작 task) -> ... -> τ_1(DASM)의 implicit / LET 상한: rta.h의 rta_chain_bounds
+//  측정값 정의는 chain_stats.h와 같음 (Reaction = l1_end - prev_wake, Data age = l1_last_end - lL_wake)
+//  LET 상한은 통신 방식을 바꿨을 때의 값이라 현재 측정값과는 비교용으로만 출력
+//
+// 사용법: e2e_bound [-r run 디렉터리] [-s source 디렉터리] <pipeline.conf>
+//  -s: task 실행 파일이 설명 파일과 다른 곳에 있을 때 source(<이름>.c)를 찾을 디렉터리
+
+#define UNBOUNDED RTA_UNSCHEDULABLE
+
+typedef struct
+{
+    uint64_t count;
+    int64_t reaction_max;
+    int64_t age_max;
+} measured_t;
+
+// chain log 하나 읽기: binary(log_Chain N_*.bin)가 있으면 그것을, 없으면 text log
+static int read_measured_bin(const char *path, measured_t *out)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+        return -1;
+    chain_bin_header_t h;
+    if (fread(&h, sizeof(h), 1, fp) != 1 || h.magic != CHAIN_BIN_MAGIC || h.version != CHAIN_BIN_VERSION)
+    {
+        fprintf(stderr, "[e2e_bound] %s: not a chain log (version %d)\n", path, CHAIN_BIN_VERSION);
+        fclose(fp);
+        return -1;
+    }
+    int levels = h.levels;
+    chain_bin_block_t b;
+    int64_t *cols = NULL;
+    while (fread(&b, sizeof(b), 1, fp) == 1 && b.magic == CHAIN_BIN_BLOCK_MAGIC)
+    {
+        cols = realloc(cols, (size_t)h.num_cols * b.rows * sizeof(int64_t));
+        if (cols == NULL)
+        {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+        if (fread(cols, sizeof(int64_t), (size_t)h.num_cols * b.rows, fp) != (size_t)h.num_cols * b.rows)
+            break;
+        const int64_t *top_wake = cols + (size_t)chain_bin_col(levels, levels, CHAIN_BIN_WAKE) * b.rows;
+        const int64_t *l1_recv = cols + (size_t)chain_bin_col(levels, 1, CHAIN_BIN_RECV) * b.rows;
+        const int64_t *l1_end = cols + (size_t)chain_bin_col(levels, 1, CHAIN_BIN_SEND) * b.rows;
+        const int64_t *last_end = cols + (size_t)chain_bin_extra_col(levels, CHAIN_BIN_LAST_END) * b.rows;
+        const int64_t *prev_wake = cols + (size_t)chain_bin_extra_col(levels, CHAIN_BIN_PREV_WAKE) * b.rows;
+        for (uint32_t r = 0; r < b.rows; r++)
+        {
+            // 초기화 전 data는 제외 (chain_stats_add와 같은 기준), 직전 sample이 없으면 Reaction은 비교하지 않음
+            if (top_wake[r] == 0 || l1_recv[r] == 0)
+                continue;
+            out->count++;
+            if (prev_wake[r] != 0 && l1_end[r] - prev_wake[r] > out->reaction_max)
+                out->reaction_max = l1_end[r] - prev_wake[r];
+            if (last_end[r] - top_wake[r] > out->age_max)
+                out->age_max = last_end[r] - top_wake[r];
+        }
+    }
+    free(cols);
+    fclose(fp);
+    return 0;
+}
+
+static int read_measured_text(const char *path, measured_t *out)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+        return -1;
+    char line[256];
+    double top_wake = 0, l1_recv = 0, l1_end = 0, last_end = 0;
+    int top = 0;
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        long long id;
+        int lvl;
+        char key[48];
+        double v;
+        if (sscanf(line, "ID = %lld, chain_%47s = %lf", &id, key, &v) != 3)
+            continue;
+        if (sscanf(key, "l%d_wake_us", &lvl) == 1 && strstr(key, "_wake_us") != NULL)
+        {
+            top = lvl;
+            top_wake = v;
+        }
+        else if (strcmp(key, "l1_recv_us") == 0)
+            l1_recv = v;
+        else if (strcmp(key, "l1_end_us") == 0)
+            l1_end = v;
+        else if (strcmp(key, "l1_last_end_us") == 0)
+            last_end = v;
+        else if (strcmp(key, "prev_wake_us") == 0 && top > 0)
+        {
+            // record의 마지막 줄
+            if (top_wake != 0 && l1_recv != 0)
+            {
+                out->count++;
+                if (v != 0 && (int64_t)((l1_end - v) * 1.0e3) > out->reaction_max)
+                    out->reaction_max = (int64_t)((l1_end - v) * 1.0e3);
+                if ((int64_t)((last_end - top_wake) * 1.0e3) > out->age_max)
+                    out->age_max = (int64_t)((last_end - top_wake) * 1.0e3);
+            }
+            top = 0;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+static int read_measured(const char *run_dir, int chain, measured_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    static const char *exts[2] = {"bin", "txt"};
+    for (int e = 0; e < 2; e++)
+    {
+        char pattern[PATH_MAX];
+        snprintf(pattern, sizeof(pattern), "%s/log_Chain %d_*.%s", run_dir, chain, exts[e]);
+        glob_t g;
+        if (glob(pattern, 0, NULL, &g) != 0)
+            continue;
+        int ret = (e == 0) ? read_measured_bin(g.gl_pathv[0], out) : read_measured_text(g.gl_pathv[0], out);
+        globfree(&g);
+        if (ret == 0)
+            return 0;
+    }
+    return -1;
+}
+
+static void print_ms(int64_t ns)
+{
+    if (ns == UNBOUNDED)
+        printf(" %14s", "unbounded");
+    else
+        printf(" %14.3f", ns / 1.0e6);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *run_dir = NULL;
+    const char *src_dir = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "r:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            run_dir = optarg;
+            break;
+        case 's':
+            src_dir = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-r run_dir] [-s src_dir] <pipeline.conf>\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc)
+    {
+        fprintf(stderr, "usage: %s [-r run_dir] [-s src_dir] <pipeline.conf>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    static task_model_t model;
+    if (task_model_load(&model, argv[optind], src_dir) != 0)
+        return EXIT_FAILURE;
+    if (model.num_tasks == 0)
+    {
+        fprintf(stderr, "[e2e_bound] %s: no task sources found\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+
+    static rta_model_t rta;
+    rta_mapping_t map;
+    rta_result_t result;
+    rta_cost_t cost = rta_cost_default();
+    rta_build(&rta, &model, &cost);
+    rta_mapping_from_model(&map, &model);
+    rta_analyze(&rta, &map, &result);
+    const int64_t *resp = result.wcrt;
+
+    // C는 data 복사를 포함한 값
+    printf("%-10s %4s %-6s %4s %9s %9s %9s %9s %9s\n", "task", "core", "policy", "prio", "T(ms)", "C(ms)", "S(ms)",
+           "B(ms)", "R(ms)");
+    for (int i = 0; i < model.num_tasks; i++)
+    {
+        const task_model_task_t *t = &model.tasks[i];
+        printf("%-10s %4d %-6s %4d %9.3f %9.3f %9.3f", t->name, t->core, t->policy, t->priority, t->period_ns / 1.0e6,
+               rta.exec[i] / 1.0e6, rta.suspend[i] / 1.0e6);
+        if (result.blocking[i] == UNBOUNDED)
+            printf(" %9s", "> T");
+        else
+            printf(" %9.3f", result.blocking[i] / 1.0e6);
+        if (resp[i] == UNBOUNDED)
+            printf(" %9s\n", "> T");
+        else
+            printf(" %9.3f\n", resp[i] / 1.0e6);
+    }
+
+    for (int c = 1; c <= TASK_MODEL_MAX_CHAINS; c++)
+    {
+        const task_model_chain_t *ch = &model.chains[c];
+        if (ch->len == 0)
+            continue;
+        printf("\nchain %d: ", c);
+        for (int k = 0; k < ch->len; k++)
+            printf("%s%s", model.tasks[ch->task[k]].name, (k + 1 < ch->len) ? " -> " : "\n");
+        int64_t chain_bound[RTA_NUM_BOUNDS];
+        rta_chain_bounds(&rta, ch, resp, chain_bound);
+        int64_t bound[2][2] = {
+            {chain_bound[RTA_BOUND_REACTION], chain_bound[RTA_BOUND_REACTION_LET]},
+            {chain_bound[RTA_BOUND_AGE], chain_bound[RTA_BOUND_AGE_LET]},
+        };
+
+        measured_t meas = {0};
+        int have_meas = run_dir != NULL && read_measured(run_dir, c, &meas) == 0 && meas.count > 0;
+        printf("%-15s %14s %14s %14s %10s\n", "metric", "implicit(ms)", "LET(ms)", "measured(ms)", "bound/meas");
+        for (int k = 0; k < 2; k++)
+        {
+            int64_t measured = (k == 0) ? meas.reaction_max : meas.age_max;
+            printf("%-15s", k == 0 ? "Reaction time" : "Data age");
+            print_ms(bound[k][0]);
+            print_ms(bound[k][1]);
+            if (have_meas && measured > 0)
+            {
+                print_ms(measured);
+                if (bound[k][0] != UNBOUNDED)
+                    printf(" %10.2f", (double)bound[k][0] / measured);
+                // 측정값이 implicit 상한을 넘으면 model(실행 시간 상한, mapping)이 실제와 다름
+                if (bound[k][0] != UNBOUNDED && measured > bound[k][0])
+                    printf("  (exceeds bound)");
+            }
+            printf("\n");
+        }
+        if (have_meas)
+            printf("(measured: %llu samples)\n", (unsigned long long)meas.count);
+    }
+    return EXIT_SUCCESS;
+}
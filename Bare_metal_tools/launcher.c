@@ -0,0 +1,1170 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <glob.h>
+#include <libgen.h>
+#include <limits.h>
+#include <signal.h>
+#include <getopt.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <stdarg.h>
+
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/rt_numa.h"
+#include "../Bare_metal_common/rt_trace.h"
+#include "../Bare_metal_common/chain_stats.h"
+
+// Pipeline launcher
+// pipeline 설명 파일을 읽어서
+//  1. 모든 shared memory channel / semaphore를 미리 생성 (이전 실험의 잔여 객체는 먼저 unlink)
+//  2. task를 지정한 core, scheduling policy로 실행
+//  3. 모든 task의 ready를 기다린 후 공통 epoch을 공지 (start barrier)
+//     각 task의 k번째 release = epoch + offset + k * period
+//  4. 실험 종료 시 task 종료, 로그 수집, 모든 shm/sem unlink
+// node 구성: 설명 파일에 node가 있으면 node마다 network namespace를 만들고 veth로 bridge에 연결 (iproute2의 ip 사용, root 필요)
+//  - task 줄의 node=<이름>으로 task를 node에 배치 (없으면 host namespace)
+//  - 같은 node 안의 channel은 기존 shm, node 사이 channel은 link 줄로 TCP를 지정
+//    -> channel은 node마다 별도 객체(<이름>_<node>)가 되고, 두 node에서 shm_bridge 송신 / 수신 task가 TCP로 이어 줌
+//  - 제어(start barrier), trace ring, DASM 통계 shm은 모든 node가 함께 사용 (node 사이의 별도 관리망 역할)
+//
+// 사용법: launcher [-d 실행시간(s)] [-m 시작 여유(ms)] [-o run 디렉터리] [-n instance 수] [-I 첫 instance]
+//                  [-S core 간격] [-N NUMA policy] [-c] <pipeline.conf>
+//  -d 0 이면 Ctrl+C(SIGINT)까지 실행, -c 는 잔여 shm/sem 정리만 수행
+//  -o 가 없으면 run 디렉터리는 runs/<시각> (상대 경로는 설명 파일 디렉터리 기준)
+//  -n N: 같은 pipeline을 N개 독립적으로 실행 (instance id = -I 값부터 차례로, rt_instance.h)
+//        k번째 instance의 task core = 설명 파일의 core + k * core 간격 (-S, 기본: 설명 파일의 최대 core + 1, 0이면 같은 core 공유)
+//        channel / trace / 통계 shm 이름과 TCP port는 instance마다 다르고, 모든 instance가 같은 epoch에 시작
+//        instance별 task는 run 디렉터리의 i<id>/에서 실행되므로 로그와 epoch.txt는 그 아래에 남음
+//  -N policy: numa=를 지정하지 않은 channel의 NUMA 배치 (none|producer|consumer|interleave|<node>, rt_numa.h)
+//        channel page의 실제 node는 run 디렉터리(instance 모드에서는 i<id>/)의 numa.txt에 기록
+
+#define MAX_CHANNELS 32
+#define MAX_TASKS 32             // 설명 파일 하나의 task 수
+#define MAX_INSTANCES RT_INSTANCE_MAX
+#define MAX_ARGS 16
+#define MAX_LOG_PATTERNS 8
+#define READY_TIMEOUT_MS 10000  // task들의 ready를 기다리는 최대 시간
+#define STOP_TIMEOUT_MS 2000    // SIGTERM 이후 SIGKILL까지 기다리는 시간
+#define DEFAULT_MARGIN_MS 20    // ready 확인 후 공통 epoch까지의 여유
+#define MAX_NODES 8
+#define NODE_PREFIX_LEN 24      // 기본 /24 주소
+#define DEFAULT_BRIDGE_POLL_US 200
+
+typedef struct
+{
+    char shm_name[64];
+    char sem_name[64];
+    size_t size;
+    int numa;          // rt_numa.h policy, -1이면 -N 값
+    int numa_node;     // numa=<node>일 때
+    char producer[32]; // 이름 규칙 /<producer>_<consumer>_shm 에서 얻은 task 이름
+    char consumer[32];
+    int link_port;     // 0: 같은 node의 shm, > 0: node 사이 TCP link의 기존 port (link 줄)
+    long poll_us;      // link 송신 bridge의 polling 주기
+    int nodes[2];      // producer / consumer의 node (-1: host), resolve_links에서 채움
+} channel_t;
+
+typedef struct
+{
+    char name[16];
+    char addr[32];     // veth 주소 (<ip>/<prefix>)
+    char netns[RT_INSTANCE_NAME_MAX];
+} node_t;
+
+typedef struct
+{
+    char name[32];
+    int core;
+    int policy;
+    int priority;
+    long offset_us; // epoch 기준 위상 offset
+    int instance;   // WATERS_INSTANCE
+    int node;       // -1: host namespace
+    long restart_ms; // -1: 종료되면 실험 중단, >= 0: 실험 중 종료되면 이 시간 뒤 다시 실행
+    char *argv[MAX_ARGS + 1];
+    pid_t pid;
+    int64_t respawn_ns; // 다시 실행할 시각 (0: 예정 없음)
+    int restarts;
+} task_t;
+
+static channel_t channels[MAX_CHANNELS];
+static int num_channels = 0;
+static task_t tasks[MAX_TASKS * MAX_INSTANCES];
+static int num_tasks = 0;
+static int first_instance = 0;
+static int num_instances = 1;
+static int instance_mode = 0;   // -n 또는 -I 사용: instance별 작업 디렉터리
+static char ctrl_name[RT_INSTANCE_NAME_MAX];
+static char *log_patterns[MAX_LOG_PATTERNS];
+static int num_log_patterns = 0;
+static node_t nodes[MAX_NODES];
+static int num_nodes = 0;
+static int nodes_created = 0;
+static char bridge_exe[PATH_MAX]; // launcher와 같은 디렉터리의 shm_bridge
+
+static int default_numa = RT_NUMA_NONE;
+static int default_numa_node = -1;
+
+static rt_ctrl_t *ctrl = NULL;
+static volatile sig_atomic_t stop_requested = 0;
+static int stopping = 0; // 종료 단계에서는 task 종료를 오류로 출력하지 않음
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+static int parse_policy(const char *s)
+{
+    if (strcmp(s, "fifo") == 0)
+        return SCHED_FIFO;
+    if (strcmp(s, "rr") == 0)
+        return SCHED_RR;
+    if (strcmp(s, "other") == 0)
+        return SCHED_OTHER;
+    if (strcmp(s, "idle") == 0)
+        return SCHED_IDLE; // trace drainer 등 실시간 task를 방해하면 안 되는 보조 process
+    fprintf(stderr, "[launcher] unknown policy '%s' (other|fifo|rr|idle)\n", s);
+    exit(EXIT_FAILURE);
+}
+
+// channel 이름 /<producer>_<consumer>_shm 에서 양쪽 task 이름을 얻음 (규칙과 다르면 빈 문자열)
+static void channel_endpoints(channel_t *c)
+{
+    c->producer[0] = c->consumer[0] = '\0';
+    sscanf(c->shm_name, "/%31[^_]_%31[^_]_shm", c->producer, c->consumer);
+}
+
+static int find_node(const char *name)
+{
+    for (int i = 0; i < num_nodes; i++)
+        if (strcmp(nodes[i].name, name) == 0)
+            return i;
+    return -1;
+}
+
+static channel_t *find_channel(const char *shm_name)
+{
+    for (int i = 0; i < num_channels; i++)
+        if (strcmp(channels[i].shm_name, shm_name) == 0)
+            return &channels[i];
+    return NULL;
+}
+
+// pipeline 설명 파일 파싱
+// channel <shm 이름> <sem 이름> <크기(bytes)> [numa=none|producer|consumer|interleave|<node>]
+// task <이름> <core> <policy> <priority> [offset_us=<us>] [node=<node 이름>] [restart=<ms>] <실행 명령...>
+// logs <실험 후 run 디렉터리로 옮길 파일 패턴>
+// env <이름>=<값> (모든 task에 넘길 환경변수, 예: env WATERS_PROXY_PORTS=5558)
+// node <이름> <주소>[/<prefix>] (network namespace 하나, 예: node zcu 10.77.0.2/24)
+// link <shm 이름> tcp <port> [poll_us=<us>] (앞에 선언한 channel을 node 사이 TCP로, port는 bridge가 쓰는 기존 port)
+static void parse_description(const char *path)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        perror("[launcher] description open");
+        exit(EXIT_FAILURE);
+    }
+
+    char line[512];
+    int line_num = 0;
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        line_num++;
+        char *hash = strchr(line, '#');
+        if (hash != NULL)
+            *hash = '\0';
+
+        char *tok[MAX_ARGS + 5];
+        int ntok = 0;
+        for (char *t = strtok(line, " \t\r\n"); t != NULL && ntok < MAX_ARGS + 5; t = strtok(NULL, " \t\r\n"))
+            tok[ntok++] = t;
+        if (ntok == 0)
+            continue;
+
+        if (strcmp(tok[0], "channel") == 0 && (ntok == 4 || ntok == 5) && num_channels < MAX_CHANNELS)
+        {
+            channel_t *c = &channels[num_channels++];
+            snprintf(c->shm_name, sizeof(c->shm_name), "%s", tok[1]);
+            snprintf(c->sem_name, sizeof(c->sem_name), "%s", tok[2]);
+            c->size = strtoul(tok[3], NULL, 0);
+            c->numa = -1;
+            if (ntok == 5 && (strncmp(tok[4], "numa=", 5) != 0 || (c->numa = rt_numa_parse(tok[4] + 5, &c->numa_node)) < 0))
+            {
+                fprintf(stderr, "[launcher] %s:%d: invalid numa policy '%s'\n", path, line_num, tok[4]);
+                exit(EXIT_FAILURE);
+            }
+            channel_endpoints(c);
+        }
+        else if (strcmp(tok[0], "task") == 0 && ntok >= 6 && num_tasks < MAX_TASKS)
+        {
+            task_t *t = &tasks[num_tasks++];
+            snprintf(t->name, sizeof(t->name), "%s", tok[1]);
+            t->core = atoi(tok[2]);
+            t->policy = parse_policy(tok[3]);
+            t->priority = atoi(tok[4]);
+            t->offset_us = 0;
+            t->node = -1;
+            t->restart_ms = -1;
+            int first_arg = 5;
+            for (; first_arg < ntok; first_arg++)
+            {
+                if (strncmp(tok[first_arg], "offset_us=", 10) == 0)
+                    t->offset_us = atol(tok[first_arg] + 10);
+                else if (strncmp(tok[first_arg], "restart=", 8) == 0)
+                    t->restart_ms = atol(tok[first_arg] + 8);
+                else if (strncmp(tok[first_arg], "node=", 5) == 0)
+                {
+                    t->node = find_node(tok[first_arg] + 5);
+                    if (t->node < 0)
+                    {
+                        fprintf(stderr, "[launcher] %s:%d: unknown node '%s' (declare it with a node line first)\n", path,
+                                line_num, tok[first_arg] + 5);
+                        exit(EXIT_FAILURE);
+                    }
+                }
+                else
+                    break;
+            }
+            if (first_arg >= ntok)
+            {
+                fprintf(stderr, "[launcher] %s:%d: task '%s' has no command\n", path, line_num, t->name);
+                exit(EXIT_FAILURE);
+            }
+            int nargs = 0;
+            for (int i = first_arg; i < ntok && nargs < MAX_ARGS; i++)
+                t->argv[nargs++] = strdup(tok[i]);
+            t->argv[nargs] = NULL;
+            t->pid = -1;
+        }
+        else if (strcmp(tok[0], "env") == 0 && ntok == 2)
+        {
+            char *eq = strchr(tok[1], '=');
+            if (eq == NULL || eq == tok[1])
+            {
+                fprintf(stderr, "[launcher] %s:%d: env needs <name>=<value>\n", path, line_num);
+                exit(EXIT_FAILURE);
+            }
+            *eq = '\0';
+            if (setenv(tok[1], eq + 1, 1) != 0) // fork한 task가 그대로 물려받음
+            {
+                perror("[launcher] setenv");
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strcmp(tok[0], "node") == 0 && ntok == 3 && num_nodes < MAX_NODES)
+        {
+            node_t *n = &nodes[num_nodes];
+            if (find_node(tok[1]) >= 0 || strlen(tok[1]) >= sizeof(n->name) || strlen(tok[2]) >= sizeof(n->addr) - 4)
+            {
+                fprintf(stderr, "[launcher] %s:%d: duplicate or too long node '%s'\n", path, line_num, tok[1]);
+                exit(EXIT_FAILURE);
+            }
+            snprintf(n->name, sizeof(n->name), "%s", tok[1]);
+            if (strchr(tok[2], '/') != NULL)
+                snprintf(n->addr, sizeof(n->addr), "%s", tok[2]);
+            else
+                snprintf(n->addr, sizeof(n->addr), "%s/%d", tok[2], NODE_PREFIX_LEN);
+            num_nodes++;
+        }
+        else if (strcmp(tok[0], "link") == 0 && (ntok == 4 || ntok == 5) && strcmp(tok[2], "tcp") == 0)
+        {
+            channel_t *c = find_channel(tok[1]);
+            if (c == NULL || atoi(tok[3]) <= 0)
+            {
+                fprintf(stderr, "[launcher] %s:%d: link needs a declared channel and a port\n", path, line_num);
+                exit(EXIT_FAILURE);
+            }
+            c->link_port = atoi(tok[3]);
+            c->poll_us = DEFAULT_BRIDGE_POLL_US;
+            if (ntok == 5 && (strncmp(tok[4], "poll_us=", 8) != 0 || (c->poll_us = atol(tok[4] + 8)) <= 0))
+            {
+                fprintf(stderr, "[launcher] %s:%d: invalid link option '%s'\n", path, line_num, tok[4]);
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (strcmp(tok[0], "logs") == 0 && ntok >= 2)
+        {
+            for (int i = 1; i < ntok && num_log_patterns < MAX_LOG_PATTERNS; i++)
+                log_patterns[num_log_patterns++] = strdup(tok[i]);
+        }
+        else
+        {
+            fprintf(stderr, "[launcher] %s:%d: invalid line\n", path, line_num);
+            exit(EXIT_FAILURE);
+        }
+    }
+    fclose(fp);
+}
+
+static task_t *find_task(const char *name)
+{
+    for (int i = 0; i < num_tasks; i++)
+        if (strcmp(tasks[i].name, name) == 0)
+            return &tasks[i];
+    return NULL;
+}
+
+// node 사이 link 객체 이름에 붙는 node (host namespace는 NULL)
+static const char *channel_node(const channel_t *c, int side)
+{
+    return (c->link_port > 0 && c->nodes[side] >= 0) ? nodes[c->nodes[side]].name : NULL;
+}
+
+static char *format_arg(const char *fmt, ...)
+{
+    char buf[128];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return strdup(buf);
+}
+
+// bridge task 하나 추가: endpoint task와 같은 core / policy / node
+static task_t *add_bridge_task(const channel_t *c, const task_t *endpoint, const char *dir)
+{
+    if (num_tasks == MAX_TASKS)
+    {
+        fprintf(stderr, "[launcher] too many tasks for link %s\n", c->shm_name);
+        exit(EXIT_FAILURE);
+    }
+    task_t *t = &tasks[num_tasks++];
+    *t = *endpoint;
+    if (snprintf(t->name, sizeof(t->name), "%s_%s_%s", c->producer, c->consumer, dir) >= (int)sizeof(t->name))
+    {
+        fprintf(stderr, "[launcher] link %s: task name too long\n", c->shm_name);
+        exit(EXIT_FAILURE);
+    }
+    t->offset_us = 0;
+    t->restart_ms = -1; // bridge가 끝나면 link가 끊긴 것이므로 실험 중단
+    t->pid = -1;
+    return t;
+}
+
+// 각 channel의 양쪽 node 확인, node 사이 link마다 shm_bridge 송신 / 수신 task 추가 (instance 복제 전에 호출)
+static void resolve_links(void)
+{
+    char node_links[512] = "";
+    for (int i = 0; i < num_channels; i++)
+    {
+        channel_t *c = &channels[i];
+        const task_t *producer = find_task(c->producer);
+        const task_t *consumer = find_task(c->consumer);
+        c->nodes[0] = producer != NULL ? producer->node : -1;
+        c->nodes[1] = consumer != NULL ? consumer->node : -1;
+        if (c->link_port == 0)
+        {
+            if (c->nodes[0] != c->nodes[1])
+            {
+                fprintf(stderr, "[launcher] channel %s crosses nodes: add 'link %s tcp <port>'\n", c->shm_name, c->shm_name);
+                exit(EXIT_FAILURE);
+            }
+            continue;
+        }
+        if (producer == NULL || consumer == NULL || c->nodes[0] == c->nodes[1])
+        {
+            fprintf(stderr, "[launcher] link %s: producer and consumer tasks must be on different nodes\n", c->shm_name);
+            exit(EXIT_FAILURE);
+        }
+        // host namespace는 bridge에 주소가 없어 node에서 닿을 수 없음 (반대 방향도 route가 없음)
+        if (c->nodes[0] < 0 || c->nodes[1] < 0)
+        {
+            fprintf(stderr,
+                    "[launcher] link %s: %s runs in the host namespace, which node links cannot reach: "
+                    "put it on a node (node=<name>)\n",
+                    c->shm_name, c->nodes[0] < 0 ? c->producer : c->consumer);
+            exit(EXIT_FAILURE);
+        }
+        if (access(bridge_exe, X_OK) != 0)
+        {
+            fprintf(stderr, "[launcher] link %s: %s not found (build Bare_metal_tools/shm_bridge.c)\n", c->shm_name, bridge_exe);
+            exit(EXIT_FAILURE);
+        }
+
+        // 송신: producer node에서 consumer node의 주소로, 수신: consumer node에서 listen
+        char host[32];
+        snprintf(host, sizeof(host), "%s", nodes[c->nodes[1]].addr);
+        *strchrnul(host, '/') = '\0';
+        task_t *tx = add_bridge_task(c, producer, "tx");
+        char **a = tx->argv;
+        *a++ = bridge_exe;
+        *a++ = "-t";
+        *a++ = format_arg("%s:%d", host, c->link_port);
+        *a++ = "-p";
+        *a++ = format_arg("%ld", c->poll_us);
+        *a++ = c->shm_name;
+        *a++ = c->sem_name;
+        *a++ = format_arg("%zu", c->size);
+        *a = NULL;
+        task_t *rx = add_bridge_task(c, consumer, "rx");
+        a = rx->argv;
+        *a++ = bridge_exe;
+        *a++ = "-l";
+        *a++ = format_arg("%d", c->link_port);
+        *a++ = c->shm_name;
+        *a++ = c->sem_name;
+        *a++ = format_arg("%zu", c->size);
+        *a = NULL;
+
+        size_t used = strlen(node_links);
+        if (snprintf(node_links + used, sizeof(node_links) - used, "%s%s,%s", used ? "," : "", c->shm_name, c->sem_name) >=
+            (int)(sizeof(node_links) - used))
+        {
+            fprintf(stderr, "[launcher] too many links\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (node_links[0] != '\0')
+        setenv("WATERS_NODE_LINKS", node_links, 1); // task가 이 이름들을 자기 node의 객체로 바꿈 (rt_instance.h)
+}
+
+// ip 명령 실행 (iproute2), quiet이면 출력을 버림 (없는 객체를 지우는 정리 단계)
+static int run_ip(int quiet, const char *fmt, ...)
+{
+    char cmd[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(cmd, sizeof(cmd), fmt, ap);
+    va_end(ap);
+    char *argv[MAX_ARGS + 2];
+    int argc = 0;
+    argv[argc++] = "ip";
+    for (char *t = strtok(cmd, " "); t != NULL && argc < MAX_ARGS + 1; t = strtok(NULL, " "))
+        argv[argc++] = t;
+    argv[argc] = NULL;
+
+    pid_t pid = fork();
+    if (pid < 0)
+        return -1;
+    if (pid == 0)
+    {
+        if (quiet)
+        {
+            int null_fd = open("/dev/null", O_WRONLY);
+            dup2(null_fd, STDOUT_FILENO);
+            dup2(null_fd, STDERR_FILENO);
+        }
+        execvp("ip", argv);
+        _exit(127);
+    }
+    int status;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        return -1;
+    return 0;
+}
+
+// node의 namespace, bridge 삭제 (namespace를 지우면 그 안의 veth와 짝도 함께 사라짐)
+static void teardown_nodes(void)
+{
+    for (int i = 0; i < num_nodes; i++)
+        run_ip(1, "netns del %s", nodes[i].netns);
+    if (num_nodes > 0)
+        run_ip(1, "link del wbr%d", first_instance);
+    nodes_created = 0;
+}
+
+static void teardown_nodes_at_exit(void)
+{
+    if (nodes_created)
+        teardown_nodes();
+}
+
+// node마다 network namespace와 veth 한 쌍 (host 쪽 wv<instance>_<i>는 bridge wbr<instance>에, node 쪽은 eth0)
+static void setup_nodes(void)
+{
+    if (num_nodes == 0)
+        return;
+    nodes_created = 1;
+    atexit(teardown_nodes_at_exit);
+    int fail = run_ip(0, "link add wbr%d type bridge", first_instance) || run_ip(0, "link set wbr%d up", first_instance);
+    for (int i = 0; i < num_nodes && !fail; i++)
+    {
+        const node_t *n = &nodes[i];
+        fail = run_ip(0, "netns add %s", n->netns) ||
+               run_ip(0, "link add wv%d_%d type veth peer name eth0 netns %s", first_instance, i, n->netns) ||
+               run_ip(0, "link set wv%d_%d master wbr%d up", first_instance, i, first_instance) ||
+               run_ip(0, "-n %s addr add %s dev eth0", n->netns, n->addr) ||
+               run_ip(0, "-n %s link set eth0 up", n->netns) || run_ip(0, "-n %s link set lo up", n->netns);
+    }
+    if (fail)
+    {
+        fprintf(stderr, "[launcher] node setup failed (needs root and iproute2)\n");
+        exit(EXIT_FAILURE);
+    }
+    printf("[launcher] %d nodes on bridge wbr%d\n", num_nodes, first_instance);
+}
+
+// 설명 파일의 task를 instance 수만큼 복제, k번째 instance는 core를 k * core_stride만큼 옮김
+static void expand_instances(int core_stride)
+{
+    int per_instance = num_tasks;
+    if (core_stride < 0)
+        for (int i = 0; i < per_instance; i++)
+            if (tasks[i].core + 1 > core_stride)
+                core_stride = tasks[i].core + 1;
+    for (int i = 0; i < per_instance; i++)
+        tasks[i].instance = first_instance;
+    for (int k = 1; k < num_instances; k++)
+    {
+        for (int i = 0; i < per_instance; i++)
+        {
+            task_t *t = &tasks[num_tasks++];
+            *t = tasks[i]; // argv는 공유 (읽기만 함)
+            t->core += k * core_stride;
+            t->instance = first_instance + k;
+        }
+    }
+}
+
+// 이전 실험이 비정상 종료되며 남긴 shm/sem 정리 (task별 trace ring, DASM 통계 포함)
+static void unlink_all(void)
+{
+    char name[RT_INSTANCE_NAME_MAX];
+    for (int k = first_instance; k < first_instance + num_instances; k++)
+    {
+        for (int i = 0; i < num_channels; i++)
+        {
+            for (int side = 0; side < (channels[i].link_port > 0 ? 2 : 1); side++)
+            {
+                rt_instance_node_name_for(k, channel_node(&channels[i], side), channels[i].shm_name, name, sizeof(name));
+                rt_mem_shm_unlink(name);
+                rt_instance_node_name_for(k, channel_node(&channels[i], side), channels[i].sem_name, name, sizeof(name));
+                sem_unlink(name);
+            }
+        }
+        rt_instance_name_for(k, CHAIN_STATS_SHM_NAME, name, sizeof(name));
+        shm_unlink(name);
+    }
+    for (int i = 0; i < num_tasks; i++)
+    {
+        rt_trace_shm_name_for(tasks[i].instance, tasks[i].name, name, sizeof(name));
+        shm_unlink(name);
+    }
+    shm_unlink(ctrl_name);
+}
+
+// mkdir -p: 경로의 중간 디렉터리까지 만듦 (-o runs/scale_n4처럼 상위가 없을 수 있음)
+static int mkdir_p(const char *path, mode_t mode)
+{
+    char buf[PATH_MAX];
+    if (snprintf(buf, sizeof(buf), "%s", path) >= (int)sizeof(buf))
+    {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    for (char *p = buf + 1; *p != '\0'; p++)
+    {
+        if (*p != '/')
+            continue;
+        *p = '\0';
+        if (mkdir(buf, mode) != 0 && errno != EEXIST)
+            return -1;
+        *p = '/';
+    }
+    if (mkdir(buf, mode) != 0 && errno != EEXIST)
+        return -1;
+    return 0;
+}
+
+// instance 모드에서 instance별 작업 디렉터리: <run 디렉터리>/i<id>
+static void instance_dir(const char *run_dir, int instance, char *dir, size_t len)
+{
+    if (snprintf(dir, len, "%s/i%d", run_dir, instance) >= (int)len)
+    {
+        fprintf(stderr, "[launcher] run directory name too long\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// instance에서 이름이 name인 task의 core, 없으면 -1
+static int task_core(const char *name, int instance)
+{
+    for (int i = 0; i < num_tasks; i++)
+        if (tasks[i].instance == instance && strcmp(tasks[i].name, name) == 0)
+            return tasks[i].core;
+    return -1;
+}
+
+// numa.txt 한 줄: channel, 크기, policy, node별 page 수, producer / consumer의 core와 node, 원격 접근 여부
+// 원격 접근이 있으면 1
+static int report_numa(FILE *fp, const channel_t *c, const char *shm_name, int policy, void *p, int producer_core,
+                       int consumer_core)
+{
+    int count[RT_NUMA_MAX_NODES], unknown;
+    fprintf(fp, "%-28s %8zu %-10s ", shm_name, c->size, rt_numa_policy_name(policy));
+    if (rt_numa_page_nodes(p, c->size, count, &unknown) != 0)
+    {
+        fprintf(fp, "pages=? (%s)\n", strerror(errno));
+        return 0;
+    }
+    int nodes_used = 0;
+    for (int n = 0; n < RT_NUMA_MAX_NODES; n++)
+    {
+        if (count[n] > 0)
+        {
+            fprintf(fp, "%sn%d:%d", nodes_used ? "," : "pages=", n, count[n]);
+            nodes_used++;
+        }
+    }
+    if (unknown > 0)
+        fprintf(fp, "%s?:%d", nodes_used ? "," : "pages=", unknown);
+    int major = rt_numa_major_node(count);
+    int producer_node = producer_core >= 0 ? rt_numa_node_of_cpu(producer_core) : -1;
+    int consumer_node = consumer_core >= 0 ? rt_numa_node_of_cpu(consumer_core) : -1;
+    fprintf(fp, " %s@%d/n%d %s@%d/n%d", c->producer, producer_core, producer_node, c->consumer, consumer_core,
+            consumer_node);
+    int producer_remote = producer_node >= 0 && producer_node != major;
+    int consumer_remote = consumer_node >= 0 && consumer_node != major;
+    const char *remote = "-";
+    if (nodes_used > 1)
+        remote = "mixed"; // interleave 등 여러 node에 걸친 buffer
+    else if (producer_remote && consumer_remote)
+        remote = "both";
+    else if (producer_remote)
+        remote = "producer";
+    else if (consumer_remote)
+        remote = "consumer";
+    fprintf(fp, " remote=%s\n", remote);
+    return strcmp(remote, "-") != 0;
+}
+
+// channel 생성: 크기 설정(hugetlbfs면 huge page 단위), NUMA policy 적용 후 0으로 초기화(전체 page prefault), semaphore 초기값 1
+// node 사이 link는 node마다 따로 생성 (host_node: 이름 뒤에 붙는 node, 원격 접근이 있으면 1)
+static int create_channel(const channel_t *c, int instance, const char *host_node, FILE *report)
+{
+    char shm_name[RT_INSTANCE_NAME_MAX], sem_name[RT_INSTANCE_NAME_MAX];
+    rt_instance_node_name_for(instance, host_node, c->shm_name, shm_name, sizeof(shm_name));
+    rt_instance_node_name_for(instance, host_node, c->sem_name, sem_name, sizeof(sem_name));
+    int fd = rt_mem_shm_open(shm_name, O_CREAT | O_RDWR, 0666);
+    if (fd == -1)
+    {
+        perror("[launcher] shm_open");
+        exit(EXIT_FAILURE);
+    }
+    if (rt_mem_shm_truncate(fd, c->size) == -1)
+    {
+        perror("[launcher] ftruncate");
+        exit(EXIT_FAILURE);
+    }
+    // MAP_POPULATE 없이 mapping: 첫 page 할당이 mbind 이후에 일어나도록
+    size_t map_size = rt_mem_shm_size(c->size);
+    char *p = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+    {
+        perror("[launcher] mmap");
+        exit(EXIT_FAILURE);
+    }
+    int policy = (c->numa >= 0) ? c->numa : default_numa;
+    int node = (c->numa >= 0) ? c->numa_node : default_numa_node;
+    int producer_core = task_core(c->producer, instance);
+    int consumer_core = task_core(c->consumer, instance);
+    if (policy == RT_NUMA_PRODUCER)
+        node = producer_core >= 0 ? rt_numa_node_of_cpu(producer_core) : -1;
+    else if (policy == RT_NUMA_CONSUMER)
+        node = consumer_core >= 0 ? rt_numa_node_of_cpu(consumer_core) : -1;
+    if (rt_numa_bind(p, map_size, policy, node) != 0)
+        fprintf(stderr, "[launcher] %s: numa=%s not applied (%s)\n", shm_name, rt_numa_policy_name(policy),
+                strerror(errno));
+    memset(p, 0, map_size); // page 할당은 여기서 (policy를 따름)
+    int remote = (report != NULL) ? report_numa(report, c, shm_name, policy, p, producer_core, consumer_core) : 0;
+    munmap(p, map_size);
+    close(fd);
+
+    sem_t *sem = sem_open(sem_name, O_CREAT, 0666, 1);
+    if (sem == SEM_FAILED)
+    {
+        perror("[launcher] sem_open");
+        exit(EXIT_FAILURE);
+    }
+    sem_close(sem);
+    return remote;
+}
+
+static void create_channels(const char *run_dir)
+{
+    int remote = 0;
+    for (int k = first_instance; k < first_instance + num_instances; k++)
+    {
+        char path[PATH_MAX], dir[PATH_MAX];
+        snprintf(dir, sizeof(dir), "%s", run_dir);
+        if (instance_mode)
+            instance_dir(run_dir, k, dir, sizeof(dir));
+        FILE *report = NULL;
+        if (snprintf(path, sizeof(path), "%s/numa.txt", dir) < (int)sizeof(path))
+            report = fopen(path, "w");
+        if (report != NULL)
+            fprintf(report, "# nodes %d\n# channel size_B policy pages(node:count) producer@core/node consumer@core/node remote\n",
+                    rt_numa_num_nodes());
+        for (int i = 0; i < num_channels; i++)
+            for (int side = 0; side < (channels[i].link_port > 0 ? 2 : 1); side++)
+                remote += create_channel(&channels[i], k, channel_node(&channels[i], side), report);
+        if (report != NULL)
+            fclose(report);
+    }
+    if (remote > 0)
+        printf("[launcher] %d channel(s) accessed across NUMA nodes (see numa.txt)\n", remote);
+}
+
+static void create_ctrl(void)
+{
+    int fd = shm_open(ctrl_name, O_CREAT | O_RDWR, 0666);
+    if (fd == -1 || ftruncate(fd, sizeof(rt_ctrl_t)) == -1)
+    {
+        perror("[launcher] ctrl shm");
+        exit(EXIT_FAILURE);
+    }
+    ctrl = mmap(NULL, sizeof(rt_ctrl_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ctrl == MAP_FAILED)
+    {
+        perror("[launcher] ctrl mmap");
+        exit(EXIT_FAILURE);
+    }
+    memset(ctrl, 0, sizeof(rt_ctrl_t));
+    ctrl->expected = num_tasks;
+    ctrl->magic = RT_CTRL_MAGIC;
+}
+
+// task 실행: fork 후 core, scheduling policy를 설정하고 exec
+// stdout/stderr는 run 디렉터리(instance 모드에서는 i<id>/)의 <task 이름>.out 으로 저장
+static void spawn_task(task_t *t, const char *run_dir)
+{
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("[launcher] fork");
+        exit(EXIT_FAILURE);
+    }
+    if (pid > 0)
+    {
+        t->pid = pid;
+        return;
+    }
+
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(t->core, &cpuset);
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) != 0)
+    {
+        perror("[launcher] sched_setaffinity");
+        _exit(EXIT_FAILURE);
+    }
+    if (t->node >= 0)
+    {
+        // node의 network namespace로 (socket은 그 node의 lo / eth0만 봄)
+        char ns_path[PATH_MAX];
+        snprintf(ns_path, sizeof(ns_path), "/var/run/netns/%s", nodes[t->node].netns);
+        int ns_fd = open(ns_path, O_RDONLY);
+        if (ns_fd < 0 || setns(ns_fd, CLONE_NEWNET) != 0)
+        {
+            perror("[launcher] setns");
+            _exit(EXIT_FAILURE);
+        }
+        close(ns_fd);
+        setenv("WATERS_NODE", nodes[t->node].name, 1);
+    }
+    else
+        unsetenv("WATERS_NODE");
+    struct sched_param param = {.sched_priority = (t->policy == SCHED_OTHER || t->policy == SCHED_IDLE) ? 0 : t->priority};
+    if (sched_setscheduler(0, t->policy, &param) != 0)
+    {
+        perror("[launcher] sched_setscheduler");
+        _exit(EXIT_FAILURE);
+    }
+
+    char core_str[16];
+    snprintf(core_str, sizeof(core_str), "%d", t->core);
+    setenv("WATERS_CORE", core_str, 1);
+    setenv("WATERS_CTRL", ctrl_name, 1);
+    setenv("WATERS_TASK", t->name, 1);
+    char offset_str[32];
+    snprintf(offset_str, sizeof(offset_str), "%ld", t->offset_us);
+    setenv("WATERS_OFFSET_US", offset_str, 1);
+    char instance_str[16];
+    snprintf(instance_str, sizeof(instance_str), "%d", t->instance);
+    setenv("WATERS_INSTANCE", instance_str, 1);
+
+    // instance 모드: task가 작업 디렉터리에 쓰는 로그가 섞이지 않도록 i<id>/에서 실행
+    // 실행 파일의 상대 경로는 설명 파일 디렉터리 기준이므로 먼저 절대 경로로 바꿈
+    char out_dir[PATH_MAX];
+    snprintf(out_dir, sizeof(out_dir), "%s", run_dir);
+    if (instance_mode)
+    {
+        static char exe_path[PATH_MAX];
+        if (strchr(t->argv[0], '/') != NULL && realpath(t->argv[0], exe_path) != NULL)
+            t->argv[0] = exe_path;
+        instance_dir(run_dir, t->instance, out_dir, sizeof(out_dir));
+        if (chdir(out_dir) != 0)
+        {
+            perror("[launcher] chdir instance dir");
+            _exit(EXIT_FAILURE);
+        }
+    }
+
+    char out_path[PATH_MAX];
+    int out_fd = -1;
+    if (snprintf(out_path, sizeof(out_path), "%s/%s.out", out_dir, t->name) < (int)sizeof(out_path))
+        out_fd = open(out_path, O_CREAT | O_WRONLY | (t->restarts > 0 ? O_APPEND : O_TRUNC), 0644); // 재시작하면 이어 씀
+    if (out_fd >= 0)
+    {
+        dup2(out_fd, STDOUT_FILENO);
+        dup2(out_fd, STDERR_FILENO);
+        close(out_fd);
+    }
+
+    execvp(t->argv[0], t->argv);
+    perror("[launcher] execvp");
+    _exit(EXIT_FAILURE);
+}
+
+// 종료된 task를 회수, 하나라도 종료됐으면 1
+// 실험 중(epoch 공지 후) restart=가 있는 task는 다시 실행을 예약하고 종료로 세지 않음 (respawn_tasks)
+static int reap_tasks(void)
+{
+    int exited = 0;
+    int running = ctrl != NULL && __atomic_load_n(&ctrl->epoch_ns, __ATOMIC_ACQUIRE) != 0;
+    for (int i = 0; i < num_tasks; i++)
+    {
+        if (tasks[i].pid <= 0)
+            continue;
+        int status;
+        if (waitpid(tasks[i].pid, &status, WNOHANG) == tasks[i].pid)
+        {
+            tasks[i].pid = -1;
+            if (!stopping && running && tasks[i].restart_ms >= 0)
+            {
+                fprintf(stderr, "[launcher] task %s exited (status %d), restarting in %ld ms\n", tasks[i].name, status,
+                        tasks[i].restart_ms);
+                tasks[i].respawn_ns = rt_now_ns() + (int64_t)tasks[i].restart_ms * 1000000;
+                continue;
+            }
+            if (!stopping)
+                fprintf(stderr, "[launcher] task %s exited (status %d)\n", tasks[i].name, status);
+            exited = 1;
+        }
+    }
+    return exited;
+}
+
+// 예약 시각이 지난 task를 다시 실행 (release는 rt_release_init이 공통 epoch 기준 다음 주기부터 맞춤)
+static void respawn_tasks(const char *run_dir)
+{
+    int64_t now = rt_now_ns();
+    for (int i = 0; i < num_tasks; i++)
+    {
+        if (tasks[i].respawn_ns == 0 || now < tasks[i].respawn_ns)
+            continue;
+        tasks[i].respawn_ns = 0;
+        tasks[i].restarts++;
+        spawn_task(&tasks[i], run_dir);
+        printf("[launcher] task %s restarted (%d)\n", tasks[i].name, tasks[i].restarts);
+    }
+}
+
+static void stop_tasks(void)
+{
+    stopping = 1;
+    if (ctrl != NULL)
+        __atomic_store_n(&ctrl->stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < num_tasks; i++)
+        if (tasks[i].pid > 0)
+            kill(tasks[i].pid, SIGTERM);
+
+    int64_t deadline = rt_now_ns() + (int64_t)STOP_TIMEOUT_MS * 1000000;
+    struct timespec poll = {0, 10000000};
+    while (rt_now_ns() < deadline)
+    {
+        reap_tasks();
+        int alive = 0;
+        for (int i = 0; i < num_tasks; i++)
+            alive += (tasks[i].pid > 0);
+        if (alive == 0)
+            return;
+        nanosleep(&poll, NULL);
+    }
+    for (int i = 0; i < num_tasks; i++)
+    {
+        if (tasks[i].pid > 0)
+        {
+            kill(tasks[i].pid, SIGKILL);
+            waitpid(tasks[i].pid, NULL, 0);
+            tasks[i].pid = -1;
+        }
+    }
+}
+
+// task들이 작업 디렉터리에 남긴 로그 파일을 run 디렉터리로 이동
+static void collect_logs(const char *run_dir)
+{
+    for (int i = 0; i < num_log_patterns; i++)
+    {
+        glob_t g;
+        if (glob(log_patterns[i], 0, NULL, &g) != 0)
+            continue;
+        for (size_t j = 0; j < g.gl_pathc; j++)
+        {
+            char dst[PATH_MAX];
+            snprintf(dst, sizeof(dst), "%s/%s", run_dir, g.gl_pathv[j]);
+            if (rename(g.gl_pathv[j], dst) != 0)
+                perror("[launcher] rename log");
+        }
+        globfree(&g);
+    }
+}
+
+// 실험 분석용: 공통 epoch과 task별 core / offset을 run 디렉터리에 기록 (instance 모드에서는 i<id>/마다)
+static void write_epoch_file(const char *dir, int64_t epoch_ns, int instance)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/epoch.txt", dir);
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL)
+    {
+        perror("[launcher] epoch file open");
+        return;
+    }
+    fprintf(fp, "epoch_ns %lld\n", (long long)epoch_ns);
+    for (int i = 0; i < num_tasks; i++)
+        if (!instance_mode || tasks[i].instance == instance)
+            fprintf(fp, "task %s core %d offset_us %ld node %s\n", tasks[i].name, tasks[i].core, tasks[i].offset_us,
+                    tasks[i].node >= 0 ? nodes[tasks[i].node].name : "host");
+    fclose(fp);
+}
+
+int main(int argc, char *argv[])
+{
+    int duration_s = 0;
+    int margin_ms = DEFAULT_MARGIN_MS;
+    int cleanup_only = 0;
+    const char *run_dir_opt = NULL;
+    int core_stride = -1; // -1: 설명 파일의 최대 core + 1
+    int opt;
+    while ((opt = getopt(argc, argv, "d:m:o:n:I:S:N:c")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd':
+            duration_s = atoi(optarg);
+            break;
+        case 'm':
+            margin_ms = atoi(optarg);
+            break;
+        case 'o':
+            run_dir_opt = optarg;
+            break;
+        case 'n':
+            num_instances = atoi(optarg);
+            instance_mode = 1;
+            break;
+        case 'I':
+            first_instance = atoi(optarg);
+            instance_mode = 1;
+            break;
+        case 'S':
+            core_stride = atoi(optarg);
+            break;
+        case 'N':
+            default_numa = rt_numa_parse(optarg, &default_numa_node);
+            if (default_numa < 0)
+            {
+                fprintf(stderr, "[launcher] unknown numa policy '%s' (none|producer|consumer|interleave|<node>)\n", optarg);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'c':
+            cleanup_only = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-d duration_s] [-m margin_ms] [-o run_dir] [-n instances] [-I first_instance] [-S core_stride] [-N numa] [-c] <pipeline.conf>\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (num_instances < 1 || first_instance < 0 || first_instance + num_instances > MAX_INSTANCES)
+    {
+        fprintf(stderr, "[launcher] instances %d ~ %d out of range (0 ~ %d)\n", first_instance,
+                first_instance + num_instances - 1, MAX_INSTANCES - 1);
+        return EXIT_FAILURE;
+    }
+    if (optind >= argc)
+    {
+        fprintf(stderr, "usage: %s [-d duration_s] [-m margin_ms] [-o run_dir] [-n instances] [-I first_instance] [-S core_stride] [-N numa] [-c] <pipeline.conf>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // 설명 파일이 있는 디렉터리(= task 실행 파일과 로그가 있는 곳)에서 실행
+    char desc_path[PATH_MAX];
+    if (realpath(argv[optind], desc_path) == NULL)
+    {
+        perror("[launcher] realpath");
+        return EXIT_FAILURE;
+    }
+    // shm_bridge는 launcher와 같은 디렉터리 (node 사이 link용)
+    char self_path[PATH_MAX];
+    ssize_t self_len = readlink("/proc/self/exe", self_path, sizeof(self_path) - 1);
+    self_path[self_len > 0 ? self_len : 0] = '\0';
+    snprintf(bridge_exe, sizeof(bridge_exe), "%s/shm_bridge", dirname(self_path));
+
+    parse_description(desc_path);
+    for (int i = 0; i < num_nodes; i++) // namespace 이름도 instance 규칙 (다른 -I launcher와 겹치지 않음)
+    {
+        if (first_instance > 0)
+            snprintf(nodes[i].netns, sizeof(nodes[i].netns), "waters_%.15s_i%d", nodes[i].name, first_instance);
+        else
+            snprintf(nodes[i].netns, sizeof(nodes[i].netns), "waters_%.15s", nodes[i].name);
+    }
+    resolve_links();
+    expand_instances(core_stride);
+    // 다른 launcher(다른 -I)와 함께 실행할 수 있도록 제어용 shm도 첫 instance 이름으로
+    rt_instance_name_for(first_instance, RT_CTRL_SHM_NAME, ctrl_name, sizeof(ctrl_name));
+    char desc_dir[PATH_MAX];
+    snprintf(desc_dir, sizeof(desc_dir), "%s", desc_path);
+    if (chdir(dirname(desc_dir)) != 0)
+    {
+        perror("[launcher] chdir");
+        return EXIT_FAILURE;
+    }
+
+    unlink_all();
+    teardown_nodes(); // 비정상 종료한 이전 실험의 namespace
+    if (cleanup_only)
+    {
+        printf("[launcher] removed %d channels x %d instances, %d nodes and control shm\n", num_channels, num_instances,
+               num_nodes);
+        return EXIT_SUCCESS;
+    }
+
+    // run 디렉터리: runs/YYYYmmdd_HHMMSS (또는 -o)
+    char run_dir[256];
+    if (run_dir_opt != NULL)
+    {
+        if (strlen(run_dir_opt) >= sizeof(run_dir))
+        {
+            fprintf(stderr, "[launcher] run directory name too long\n");
+            return EXIT_FAILURE;
+        }
+        snprintf(run_dir, sizeof(run_dir), "%s", run_dir_opt);
+    }
+    else
+    {
+        time_t wall = time(NULL);
+        struct tm tm_now;
+        localtime_r(&wall, &tm_now);
+        strftime(run_dir, sizeof(run_dir), "runs/%Y%m%d_%H%M%S", &tm_now);
+    }
+    if (mkdir_p(run_dir, 0755) != 0)
+    {
+        perror("[launcher] mkdir run_dir");
+        return EXIT_FAILURE;
+    }
+    if (instance_mode)
+    {
+        // task는 instance 디렉터리에서 실행되므로 run 디렉터리를 절대 경로로
+        char abs_dir[PATH_MAX];
+        if (realpath(run_dir, abs_dir) == NULL || strlen(abs_dir) >= sizeof(run_dir))
+        {
+            fprintf(stderr, "[launcher] run directory %s: invalid or too long\n", run_dir);
+            return EXIT_FAILURE;
+        }
+        snprintf(run_dir, sizeof(run_dir), "%s", abs_dir);
+        for (int k = first_instance; k < first_instance + num_instances; k++)
+        {
+            char dir[PATH_MAX];
+            instance_dir(run_dir, k, dir, sizeof(dir));
+            if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+            {
+                perror("[launcher] mkdir instance dir");
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    setup_nodes();
+    int64_t t_begin = rt_now_ns();
+    create_ctrl();
+    create_channels(run_dir);
+    for (int i = 0; i < num_tasks; i++)
+        spawn_task(&tasks[i], run_dir);
+
+    // 모든 task의 ready 대기
+    int64_t ready_deadline = t_begin + (int64_t)READY_TIMEOUT_MS * 1000000;
+    struct timespec poll = {0, RT_CTRL_POLL_NS};
+    int failed = 0;
+    while (__atomic_load_n(&ctrl->ready, __ATOMIC_ACQUIRE) < num_tasks)
+    {
+        if (reap_tasks() || stop_requested || rt_now_ns() > ready_deadline)
+        {
+            fprintf(stderr, "[launcher] only %d/%d tasks became ready\n",
+                    __atomic_load_n(&ctrl->ready, __ATOMIC_ACQUIRE), num_tasks);
+            failed = 1;
+            break;
+        }
+        nanosleep(&poll, NULL);
+    }
+
+    if (!failed)
+    {
+        int64_t epoch_ns = rt_now_ns() + (int64_t)margin_ms * 1000000;
+        if (instance_mode)
+        {
+            for (int k = first_instance; k < first_instance + num_instances; k++)
+            {
+                char dir[PATH_MAX];
+                instance_dir(run_dir, k, dir, sizeof(dir));
+                write_epoch_file(dir, epoch_ns, k);
+            }
+        }
+        else
+            write_epoch_file(run_dir, epoch_ns, 0);
+        __atomic_store_n(&ctrl->epoch_ns, epoch_ns, __ATOMIC_RELEASE);
+        printf("[launcher] %d tasks ready in %.3f ms, epoch at %.3f ms -> %s\n",
+               num_tasks, (epoch_ns - t_begin) / 1.0e6 - margin_ms, epoch_ns / 1.0e6, run_dir);
+
+        // 실행시간 경과, 신호, task 종료 중 하나가 일어날 때까지 대기
+        int64_t end_ns = epoch_ns + (int64_t)duration_s * 1000000000LL;
+        struct timespec tick = {0, 10000000};
+        while (!stop_requested && (duration_s == 0 || rt_now_ns() < end_ns))
+        {
+            if (reap_tasks())
+            {
+                failed = 1;
+                break;
+            }
+            respawn_tasks(run_dir);
+            nanosleep(&tick, NULL);
+        }
+    }
+
+    stop_tasks();
+    for (int i = 0; i < num_tasks; i++)
+        if (tasks[i].restarts > 0)
+            printf("[launcher] task %s restarted %d times\n", tasks[i].name, tasks[i].restarts);
+    if (!instance_mode) // instance 모드의 로그는 이미 i<id>/에 있음
+        collect_logs(run_dir);
+    unlink_all();
+    teardown_nodes_at_exit();
+    munmap(ctrl, sizeof(rt_ctrl_t));
+    printf("[launcher] finished, logs in %s\n", run_dir);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
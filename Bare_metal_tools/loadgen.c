@@ -0,0 +1,475 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "../Bare_metal_common/rt_control.h"
+
+// Interference 생성기 (latency-under-load 실험)
+// pipeline 옆에서 통제된 background 부하를 만든다. core 목록(-c)의 core마다 worker thread 하나를 고정하고,
+// -w 창(기본 10ms)마다 intensity(-i %)만큼만 부하를 돌린 뒤 나머지는 sleep (duty cycle, 100이면 계속)
+// profile (-p):
+//  cpu       : register만 쓰는 loop로 core 점유 (memory 접근 없음)
+//  membw     : worker마다 -s 크기(기본 64MB)를 둘로 나눈 buffer 사이를 1MB씩 memcpy (DRAM 대역폭 소모)
+//  llc       : LLC 크기(sysfs, -s로 변경)의 buffer를 cache line 단위로 무작위 순서로 읽고 씀 (다른 task의 line을 밀어냄)
+//  syscall   : getppid / clock_gettime을 vDSO 없이 syscall로 반복 (kernel 진입, 사용자 cache / TLB 오염)
+//  pagefault : -s 크기(기본 4MB)의 익명 mapping을 만들어 page마다 쓰고 해제 반복 (page fault, mmap lock, TLB flush)
+//  net       : worker마다 loopback TCP 연결 하나로 64KB씩 전송, 같은 core의 수신 thread가 받아 버림 (softirq, loopback)
+//  none      : 부하 없음 (sweep의 기준 run)
+// launcher 설명 파일의 task로 넣으면 start barrier에 참여해 epoch부터 부하를 시작 (policy other 권장)
+// sweep -I로 주면 mapping마다 부하 수준을 차례로 바꿔 실행하고 sweep.csv의 load column에 기록
+// 종료(SIGINT / SIGTERM / -d) 시 worker별 작업량과 실제 duty cycle을 출력
+//
+// 사용법: loadgen [-p profile] [-i intensity(%)] [-c core 목록] [-s 크기(KB)] [-w 창(ms)] [-d 실행시간(s)]
+//  core 목록: 예 2,3 / 4-7 / 0-1,6 (기본: online core 전부)
+
+#define MAX_WORKERS 256
+#define DEFAULT_WINDOW_MS 10
+#define DEFAULT_MEMBW_KB (64 * 1024)
+#define DEFAULT_PAGEFAULT_KB (4 * 1024)
+#define DEFAULT_LLC_KB (8 * 1024) // sysfs에서 LLC 크기를 못 읽을 때
+#define MEMBW_CHUNK (1024 * 1024)
+#define LLC_LINES_PER_STEP 4096
+#define SYSCALLS_PER_STEP 64
+#define CPU_ITERS_PER_STEP 10000
+#define NET_CHUNK (64 * 1024)
+#define LINE_SIZE 64
+
+typedef enum
+{
+    LOAD_NONE,
+    LOAD_CPU,
+    LOAD_MEMBW,
+    LOAD_LLC,
+    LOAD_SYSCALL,
+    LOAD_PAGEFAULT,
+    LOAD_NET,
+    LOAD_MAX
+} load_profile_t;
+
+static const char *profile_names[LOAD_MAX] = {"none", "cpu", "membw", "llc", "syscall", "pagefault", "net"};
+static const char *profile_units[LOAD_MAX] = {"", "Miter", "MB", "Mline", "Mcall", "Mpage", "MB"};
+static const double profile_scale[LOAD_MAX] = {1, 1e6, 1e6, 1e6, 1e6, 1e6, 1e6};
+
+typedef struct
+{
+    int core;
+    pthread_t tid;
+    pthread_t rx_tid;  // net: 수신 thread
+    char *buf;         // membw / llc
+    size_t size;
+    uint32_t *order;   // llc: 무작위 line 순서
+    size_t lines;
+    size_t pos;
+    int tx_sock;       // net
+    int rx_sock;
+    uint64_t ops;      // profile 단위 작업량 (iter / byte / line / call / page)
+    int64_t busy_ns;
+    int64_t run_ns;
+} worker_t;
+
+static worker_t workers[MAX_WORKERS];
+static int num_workers = 0;
+static load_profile_t profile = LOAD_CPU;
+static int intensity = 100;
+static int64_t window_ns = (int64_t)DEFAULT_WINDOW_MS * 1000000;
+static size_t size_bytes = 0;
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+// "0-1,6" 형식의 core 목록
+static void parse_cores(const char *s)
+{
+    const char *p = s;
+    while (*p != '\0')
+    {
+        char *end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (end == p)
+            break;
+        if (*end == '-')
+        {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p)
+                break;
+        }
+        for (long c = first; c <= last && num_workers < MAX_WORKERS; c++)
+            workers[num_workers++].core = (int)c;
+        p = end;
+        if (*p == ',')
+            p++;
+        else if (*p != '\0')
+            break;
+    }
+    if (*p != '\0' || num_workers == 0)
+    {
+        fprintf(stderr, "[loadgen] invalid core list '%s'\n", s);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// core가 쓰는 마지막 level cache 크기 (sysfs의 가장 높은 index), 없으면 0
+static size_t llc_size(int core)
+{
+    size_t best = 0;
+    for (int idx = 0; idx < 8; idx++)
+    {
+        char path[128], val[32];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/size", core, idx);
+        FILE *fp = fopen(path, "r");
+        if (fp == NULL)
+            break;
+        if (fgets(val, sizeof(val), fp) != NULL)
+        {
+            char *end;
+            size_t v = strtoul(val, &end, 10);
+            if (*end == 'K')
+                v *= 1024;
+            else if (*end == 'M')
+                v *= 1024 * 1024;
+            if (v > best)
+                best = v;
+        }
+        fclose(fp);
+    }
+    return best;
+}
+
+static char *alloc_touched(size_t size)
+{
+    char *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+    {
+        perror("[loadgen] mmap");
+        exit(EXIT_FAILURE);
+    }
+    memset(p, 1, size); // 측정 중에는 page fault가 나지 않도록 미리 할당
+    return p;
+}
+
+// loopback 연결 한 쌍 (worker -> 수신 thread)
+static void net_connect(worker_t *w)
+{
+    int ls = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (ls < 0 || bind(ls, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(ls, 1) < 0 ||
+        getsockname(ls, (struct sockaddr *)&addr, &len) < 0)
+    {
+        perror("[loadgen] loopback listen");
+        exit(EXIT_FAILURE);
+    }
+    w->tx_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (w->tx_sock < 0 || connect(w->tx_sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        (w->rx_sock = accept(ls, NULL, NULL)) < 0)
+    {
+        perror("[loadgen] loopback connect");
+        exit(EXIT_FAILURE);
+    }
+    close(ls);
+}
+
+static void worker_init(worker_t *w)
+{
+    switch (profile)
+    {
+    case LOAD_MEMBW:
+        w->size = size_bytes ? size_bytes : (size_t)DEFAULT_MEMBW_KB * 1024;
+        w->size &= ~(size_t)(2 * MEMBW_CHUNK - 1);
+        if (w->size == 0)
+            w->size = 2 * MEMBW_CHUNK;
+        w->buf = alloc_touched(w->size);
+        break;
+    case LOAD_LLC:
+        w->size = size_bytes ? size_bytes : llc_size(w->core);
+        if (w->size == 0)
+            w->size = (size_t)DEFAULT_LLC_KB * 1024;
+        w->buf = alloc_touched(w->size);
+        w->lines = w->size / LINE_SIZE;
+        w->order = malloc(w->lines * sizeof(uint32_t));
+        if (w->order == NULL)
+        {
+            perror("[loadgen] malloc");
+            exit(EXIT_FAILURE);
+        }
+        // 무작위 순서 (hardware prefetcher가 따라오지 못하도록 Fisher-Yates)
+        for (size_t i = 0; i < w->lines; i++)
+            w->order[i] = (uint32_t)i;
+        unsigned int seed = (unsigned int)w->core * 2654435761u;
+        for (size_t i = w->lines - 1; i > 0; i--)
+        {
+            size_t j = (size_t)rand_r(&seed) % (i + 1);
+            uint32_t t = w->order[i];
+            w->order[i] = w->order[j];
+            w->order[j] = t;
+        }
+        break;
+    case LOAD_PAGEFAULT:
+        w->size = size_bytes ? size_bytes : (size_t)DEFAULT_PAGEFAULT_KB * 1024;
+        break;
+    case LOAD_NET:
+        w->buf = alloc_touched(NET_CHUNK);
+        net_connect(w);
+        break;
+    default:
+        break;
+    }
+}
+
+// 부하 한 단계 (수십 us ~ 1ms 정도), 작업량 반환
+static uint64_t worker_step(worker_t *w)
+{
+    switch (profile)
+    {
+    case LOAD_CPU:
+    {
+        uint64_t x = (uint64_t)w->ops | 1;
+        for (int i = 0; i < CPU_ITERS_PER_STEP; i++)
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        __asm__ volatile("" : : "r"(x)); // loop가 사라지지 않도록
+        return CPU_ITERS_PER_STEP;
+    }
+    case LOAD_MEMBW:
+    {
+        size_t half = w->size / 2;
+        memcpy(w->buf + half + w->pos, w->buf + w->pos, MEMBW_CHUNK);
+        w->pos = (w->pos + MEMBW_CHUNK) % half;
+        return 2 * MEMBW_CHUNK; // 읽기 + 쓰기
+    }
+    case LOAD_LLC:
+        for (int i = 0; i < LLC_LINES_PER_STEP; i++)
+        {
+            w->buf[(size_t)w->order[w->pos] * LINE_SIZE]++;
+            if (++w->pos == w->lines)
+                w->pos = 0;
+        }
+        return LLC_LINES_PER_STEP;
+    case LOAD_SYSCALL:
+    {
+        struct timespec ts;
+        for (int i = 0; i < SYSCALLS_PER_STEP; i += 2)
+        {
+            syscall(SYS_getppid);
+            syscall(SYS_clock_gettime, CLOCK_MONOTONIC, &ts);
+        }
+        return SYSCALLS_PER_STEP;
+    }
+    case LOAD_PAGEFAULT:
+    {
+        long page = sysconf(_SC_PAGESIZE);
+        char *p = mmap(NULL, w->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            return 0;
+        for (size_t off = 0; off < w->size; off += (size_t)page)
+            p[off] = 1;
+        munmap(p, w->size);
+        return w->size / (size_t)page;
+    }
+    case LOAD_NET:
+    {
+        ssize_t n = send(w->tx_sock, w->buf, NET_CHUNK, MSG_NOSIGNAL);
+        return n > 0 ? (uint64_t)n : 0;
+    }
+    default:
+        return 0;
+    }
+}
+
+static void *net_rx_thread(void *arg)
+{
+    worker_t *w = arg;
+    char *buf = malloc(NET_CHUNK);
+    while (buf != NULL && recv(w->rx_sock, buf, NET_CHUNK, 0) > 0)
+        ;
+    free(buf);
+    return NULL;
+}
+
+// worker: 창마다 intensity %만큼 부하, 나머지는 sleep
+static void *worker_thread(void *arg)
+{
+    worker_t *w = arg;
+    int64_t busy_len = window_ns * intensity / 100;
+    int64_t start = rt_now_ns();
+    int64_t window_start = start;
+    while (!stop_requested)
+    {
+        int64_t now = rt_now_ns();
+        if (now - window_start >= window_ns)
+            window_start = now; // 선점 등으로 창을 놓침: 밀린 부하를 몰아서 돌리지 않음
+        int64_t begin = now;
+        while (now - window_start < busy_len && !stop_requested)
+        {
+            w->ops += worker_step(w);
+            now = rt_now_ns();
+        }
+        w->busy_ns += now - begin;
+        window_start += window_ns;
+        if (intensity < 100)
+        {
+            struct timespec next;
+            rt_ns_to_timespec(window_start, &next);
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        }
+    }
+    w->run_ns = rt_now_ns() - start;
+    return NULL;
+}
+
+static void start_pinned(pthread_t *tid, int core, void *(*fn)(void *), void *arg)
+{
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+    if (pthread_create(tid, &attr, fn, arg) != 0)
+    {
+        perror("[loadgen] pthread_create");
+        exit(EXIT_FAILURE);
+    }
+    pthread_attr_destroy(&attr);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-p none|cpu|membw|llc|syscall|pagefault|net] [-i intensity_pct] [-c cores] [-s size_kb]\n"
+            "          [-w window_ms] [-d duration_s]\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *cores = NULL;
+    int duration_s = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:i:c:s:w:d:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            profile = LOAD_MAX;
+            for (int i = 0; i < LOAD_MAX; i++)
+                if (strcmp(optarg, profile_names[i]) == 0)
+                    profile = (load_profile_t)i;
+            break;
+        case 'i':
+            intensity = atoi(optarg);
+            break;
+        case 'c':
+            cores = optarg;
+            break;
+        case 's':
+            size_bytes = strtoul(optarg, NULL, 0) * 1024;
+            break;
+        case 'w':
+            window_ns = (int64_t)(atof(optarg) * 1.0e6);
+            break;
+        case 'd':
+            duration_s = atoi(optarg);
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc || profile == LOAD_MAX || intensity < 0 || intensity > 100 || window_ns <= 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (cores != NULL)
+        parse_cores(cores);
+    else
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long c = 0; c < online && num_workers < MAX_WORKERS; c++)
+            workers[num_workers++].core = (int)c;
+    }
+    if (profile == LOAD_NONE || intensity == 0)
+        num_workers = 0;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    for (int i = 0; i < num_workers; i++)
+        worker_init(&workers[i]);
+    if (num_workers == 0)
+        printf("[loadgen] profile %s: no load\n", profile_names[profile]);
+    else
+    {
+        printf("[loadgen] profile %s, intensity %d%% of %.1f ms, %d workers on cores", profile_names[profile], intensity,
+               window_ns / 1.0e6, num_workers);
+        for (int i = 0; i < num_workers; i++)
+            printf("%s%d", i ? "," : " ", workers[i].core);
+        if (workers[0].size > 0)
+            printf(", %zu KB per worker", workers[0].size / 1024);
+        printf("\n");
+    }
+    fflush(stdout);
+
+    rt_ctrl_wait_epoch(); // launcher task로 실행하면 pipeline과 같은 epoch에 시작
+    for (int i = 0; i < num_workers; i++)
+    {
+        if (profile == LOAD_NET)
+            start_pinned(&workers[i].rx_tid, workers[i].core, net_rx_thread, &workers[i]);
+        start_pinned(&workers[i].tid, workers[i].core, worker_thread, &workers[i]);
+    }
+
+    int64_t end_ns = rt_now_ns() + (int64_t)duration_s * 1000000000LL;
+    struct timespec tick = {0, 10000000};
+    while (!stop_requested && (duration_s == 0 || rt_now_ns() < end_ns))
+        nanosleep(&tick, NULL);
+    stop_requested = 1;
+
+    for (int i = 0; i < num_workers; i++)
+    {
+        if (profile == LOAD_NET)
+            shutdown(workers[i].tx_sock, SHUT_RDWR); // 막혀 있는 send / recv를 깨움
+        pthread_join(workers[i].tid, NULL);
+        if (profile == LOAD_NET)
+        {
+            pthread_join(workers[i].rx_tid, NULL);
+            close(workers[i].tx_sock);
+            close(workers[i].rx_sock);
+        }
+    }
+    for (int i = 0; i < num_workers; i++)
+    {
+        const worker_t *w = &workers[i];
+        double run_s = w->run_ns / 1.0e9;
+        printf("[loadgen] core %d: %.1f %s/s, duty %.1f%%\n", w->core,
+               run_s > 0 ? w->ops / profile_scale[profile] / run_s : 0.0, profile_units[profile],
+               w->run_ns > 0 ? 100.0 * w->busy_ns / w->run_ns : 0.0);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,566 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+
+// User-space network emulation proxy (TCP 변형)
+// producer와 consumer(Planner, DASM 등) 사이에서 TCP 연결을 중계하면서 link 하나를 흉내 낸다.
+// multi-node 구성(ZCU 등)에서 shared memory를 쓸 수 없는 link가 chain latency에 주는 영향을 실제 장비 없이 확인하는 용도
+//  - producer는 WATERS_PROXY_PORTS에 적힌 link에서 consumer 대신 proxy(port + RT_INSTANCE_PROXY_OFFSET)에 연결 (rt_instance.h)
+//  - proxy는 consumer(기본 127.0.0.1:<instance port>)에 연결하고, 양방향을 frame 단위로 중계
+//  - frame i의 출발: max(도착, 앞 frame의 출발) + 크기 / 대역폭 (store-and-forward 직렬화)
+//    전달 시각: 출발 + 전파 지연 + jitter(균등 분포 -j ~ +j), TCP처럼 순서는 바뀌지 않음 (앞 frame보다 먼저 나가지 않음)
+//  - 손실: 확률 -l로 frame 손실, TCP 재전송처럼 -r(RTO)만큼 늦게 전달 (뒤 frame도 head-of-line blocking)
+//    -r 0이면 frame을 버림 (sample 손실 실험용, consumer가 frame 크기 단위로 읽으므로 -f 필요)
+//  - -f는 정방향에만 적용, 역방향(consumer의 clock sync ping, rt_clock.h)은 recv 단위로 같은 지연 / 손실을 적용
+//  - frame마다 방향, 번호, 크기와 도착 / 출발 / 전달 예정 / 실제 전달 시각을 log_netem_<이름>.txt에 기록 (epoch 기준 ms)
+//  - 어느 한쪽이 끊기면(launcher restart=로 재시작 등) 양쪽 연결을 닫고 consumer 재연결 + producer 재accept로 다시 중계
+//    (link 상태 link_free_ns / last_due_ns는 새 연결에서 초기화, frame 번호와 통계는 이어서)
+// launcher 설명 파일에서 policy other 또는 실시간 task와 겹치지 않는 core로 실행 (start barrier에 참여)
+//
+// 사용법: netem_proxy [-n 이름] [-f frame 크기(bytes)] [-d 지연(us)] [-j jitter(us)] [-b 대역폭(Mbit/s)]
+//                     [-l 손실 확률] [-r RTO(us)] [-q queue 길이] [-t host:port] [-S seed] <기존 port>
+//  예: netem_proxy -n detection -f 768000 -b 100 -d 200 -j 50 5558   (Detection -> Planner를 100 Mbit/s link로)
+
+#define DEFAULT_QUEUE 16
+#define DEFAULT_RTO_US 200000 // Linux 최소 RTO
+#define CHUNK_SIZE 65536      // -f가 없을 때 recv 한 번을 frame으로 봄
+#define CONNECT_RETRY_US 1000
+#define POLL_MS 50
+
+enum
+{
+    DIR_FWD = 0, // producer -> consumer
+    DIR_REV,     // consumer -> producer
+    NUM_DIRS
+};
+
+typedef struct
+{
+    uint64_t n;
+    size_t len;
+    int64_t in_ns;     // proxy가 frame을 다 받은 시각
+    int64_t depart_ns; // 직렬화가 끝나는 시각
+    int64_t due_ns;    // 전달 예정 시각
+    int lost;
+    char *data;
+} frame_t;
+
+typedef struct
+{
+    const char *name;
+    int in_fd;
+    int out_fd;
+    size_t frame_bytes; // 0: recv 단위 (역방향은 clock sync ping이라 항상 recv 단위, rt_clock.h)
+    frame_t *queue;
+    int q_cap;
+    int q_head;
+    int q_len;
+    int eof;
+    int closing; // 연결 종료 중: reader / writer가 더 기다리지 않음
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    int64_t link_free_ns; // 앞 frame의 직렬화가 끝나는 시각
+    int64_t last_due_ns;
+    uint64_t rng;
+    uint64_t received; // frame 번호 (재연결해도 이어서, reader thread만 갱신)
+    // 통계 (writer thread만 갱신)
+    uint64_t frames;
+    uint64_t bytes;
+    uint64_t lost;
+    uint64_t dropped;
+    int64_t delay_sum_ns; // 실제 전달 - 도착
+    int64_t delay_max_ns;
+    int done;
+} dir_t;
+
+typedef struct
+{
+    size_t frame_bytes; // 0: recv 단위
+    int64_t delay_ns;
+    int64_t jitter_ns;
+    double mbit;        // 0: 대역폭 제한 없음
+    double loss;
+    int64_t rto_ns;
+    int q_cap;
+} netem_t;
+
+static netem_t netem = {0, 0, 0, 0.0, 0.0, (int64_t)DEFAULT_RTO_US * 1000, DEFAULT_QUEUE};
+static dir_t dirs[NUM_DIRS];
+static int64_t epoch_ns;
+static FILE *log_fp;
+static pthread_mutex_t log_lock = PTHREAD_MUTEX_INITIALIZER;
+static volatile sig_atomic_t stop_requested = 0;
+static rt_ctrl_t *ctrl; // epoch 이후 attach, 그 전에는 signal만 확인
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+// xorshift64*, [0, 1)
+static double dir_uniform(dir_t *d)
+{
+    d->rng ^= d->rng >> 12;
+    d->rng ^= d->rng << 25;
+    d->rng ^= d->rng >> 27;
+    return ((d->rng * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// launcher의 종료 요청(SIGTERM 또는 ctrl->stop)
+static int stopping(void)
+{
+    return stop_requested || (ctrl != NULL && __atomic_load_n(&ctrl->stop, __ATOMIC_ACQUIRE));
+}
+
+// frame 하나의 출발 / 전달 시각과 손실 결정
+static void schedule_frame(dir_t *d, frame_t *f)
+{
+    int64_t tx_ns = (netem.mbit > 0) ? (int64_t)(f->len * 8.0 * 1000.0 / netem.mbit) : 0;
+    int64_t begin = (f->in_ns > d->link_free_ns) ? f->in_ns : d->link_free_ns;
+    f->depart_ns = begin + tx_ns;
+    d->link_free_ns = f->depart_ns;
+
+    int64_t due = f->depart_ns + netem.delay_ns;
+    if (netem.jitter_ns > 0)
+        due += (int64_t)((dir_uniform(d) * 2.0 - 1.0) * netem.jitter_ns);
+    if (due < f->depart_ns)
+        due = f->depart_ns;
+    f->lost = (netem.loss > 0 && dir_uniform(d) < netem.loss);
+    if (f->lost)
+        due += netem.rto_ns;
+    if (due < d->last_due_ns)
+        due = d->last_due_ns; // TCP stream은 순서를 유지
+    d->last_due_ns = due;
+    f->due_ns = due;
+}
+
+static ssize_t send_all(int fd, const char *buf, size_t len)
+{
+    size_t off = 0;
+    while (off < len)
+    {
+        ssize_t n = send(fd, buf + off, len - off, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        off += (size_t)n;
+    }
+    return (ssize_t)off;
+}
+
+// 한 방향의 수신: frame을 받아 시각을 정하고 queue에 넣음 (queue가 차면 socket backpressure)
+static void *reader_thread(void *arg)
+{
+    dir_t *d = arg;
+    for (;;)
+    {
+        pthread_mutex_lock(&d->lock);
+        while (d->q_len == d->q_cap && !d->closing)
+            pthread_cond_wait(&d->not_full, &d->lock);
+        if (d->closing)
+        {
+            pthread_mutex_unlock(&d->lock);
+            break;
+        }
+        frame_t *f = &d->queue[(d->q_head + d->q_len) % d->q_cap];
+        pthread_mutex_unlock(&d->lock);
+
+        // queue의 빈 자리는 writer가 건드리지 않으므로 lock 없이 채움
+        ssize_t got = d->frame_bytes ? recv(d->in_fd, f->data, d->frame_bytes, MSG_WAITALL)
+                                     : recv(d->in_fd, f->data, CHUNK_SIZE, 0);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0 || (d->frame_bytes && (size_t)got < d->frame_bytes))
+            break; // 연결 종료 (끝의 불완전한 frame은 버림)
+        f->n = ++d->received;
+        f->len = (size_t)got;
+        f->in_ns = rt_now_ns();
+        schedule_frame(d, f);
+
+        pthread_mutex_lock(&d->lock);
+        d->q_len++;
+        pthread_cond_signal(&d->not_empty);
+        pthread_mutex_unlock(&d->lock);
+    }
+    pthread_mutex_lock(&d->lock);
+    d->eof = 1;
+    pthread_cond_signal(&d->not_empty);
+    pthread_mutex_unlock(&d->lock);
+    return NULL;
+}
+
+// 한 방향의 송신: 전달 예정 시각까지 기다렸다가 반대쪽으로 전송하고 기록
+static void *writer_thread(void *arg)
+{
+    dir_t *d = arg;
+    for (;;)
+    {
+        pthread_mutex_lock(&d->lock);
+        while (d->q_len == 0 && !d->eof)
+            pthread_cond_wait(&d->not_empty, &d->lock);
+        if (d->q_len == 0)
+        {
+            pthread_mutex_unlock(&d->lock);
+            break;
+        }
+        frame_t *f = &d->queue[d->q_head];
+        pthread_mutex_unlock(&d->lock);
+
+        struct timespec due;
+        rt_ns_to_timespec(f->due_ns, &due);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) == EINTR)
+            ;
+        int drop = f->lost && netem.rto_ns == 0 && d->frame_bytes; // recv 단위는 버리면 stream이 깨지므로 바로 전달
+        if (!drop && send_all(d->out_fd, f->data, f->len) < 0)
+        {
+            if (errno != EPIPE && errno != ECONNRESET)
+                perror("[netem_proxy] send");
+            break; // 반대쪽이 끊김: main이 연결을 다시 맺음
+        }
+        int64_t out_ns = rt_now_ns();
+
+        d->frames++;
+        d->bytes += f->len;
+        d->lost += f->lost;
+        d->dropped += drop;
+        if (!drop)
+        {
+            d->delay_sum_ns += out_ns - f->in_ns;
+            if (out_ns - f->in_ns > d->delay_max_ns)
+                d->delay_max_ns = out_ns - f->in_ns;
+        }
+        pthread_mutex_lock(&log_lock);
+        fprintf(log_fp, "%s %llu %zu %.3f %.3f %.3f %.3f %d\n", d->name, (unsigned long long)f->n, f->len,
+                (f->in_ns - epoch_ns) / 1.0e6, (f->depart_ns - epoch_ns) / 1.0e6, (f->due_ns - epoch_ns) / 1.0e6,
+                drop ? -1.0 : (out_ns - epoch_ns) / 1.0e6, f->lost);
+        pthread_mutex_unlock(&log_lock);
+
+        pthread_mutex_lock(&d->lock);
+        d->q_head = (d->q_head + 1) % d->q_cap;
+        d->q_len--;
+        pthread_cond_signal(&d->not_full);
+        pthread_mutex_unlock(&d->lock);
+    }
+    shutdown(d->out_fd, SHUT_WR); // 반대쪽에도 연결 종료를 전달
+    __atomic_store_n(&d->done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void dir_init(dir_t *d, const char *name, size_t frame_bytes, uint64_t seed)
+{
+    size_t slot = frame_bytes ? frame_bytes : CHUNK_SIZE;
+    d->name = name;
+    d->frame_bytes = frame_bytes;
+    d->q_cap = netem.q_cap;
+    d->queue = calloc(d->q_cap, sizeof(frame_t));
+    if (d->queue == NULL)
+    {
+        perror("[netem_proxy] calloc");
+        exit(EXIT_FAILURE);
+    }
+    char *data = rt_mem_alloc(slot * d->q_cap);
+    for (int i = 0; i < d->q_cap; i++)
+        d->queue[i].data = data + slot * i;
+    pthread_mutex_init(&d->lock, NULL);
+    pthread_cond_init(&d->not_empty, NULL);
+    pthread_cond_init(&d->not_full, NULL);
+    d->rng = seed ? seed : 1;
+}
+
+// 새 연결의 중계 시작: queue와 link 상태는 비우고 (이전 연결의 직렬화 / 전달 시각을 이어받지 않음) 통계는 유지
+static void dir_start(dir_t *d, int in_fd, int out_fd, pthread_t *threads)
+{
+    d->in_fd = in_fd;
+    d->out_fd = out_fd;
+    d->q_head = 0;
+    d->q_len = 0;
+    d->eof = 0;
+    d->closing = 0;
+    d->done = 0;
+    d->link_free_ns = 0;
+    d->last_due_ns = 0;
+    if (pthread_create(&threads[0], NULL, reader_thread, d) != 0 ||
+        pthread_create(&threads[1], NULL, writer_thread, d) != 0)
+    {
+        perror("[netem_proxy] pthread_create");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// 연결 종료: socket을 닫아 recv / send에서 깨우고 queue 대기도 풀어서 thread를 모두 끝냄
+static void link_close(pthread_t *threads, int producer_sock, int consumer_sock)
+{
+    for (int i = 0; i < NUM_DIRS; i++)
+    {
+        pthread_mutex_lock(&dirs[i].lock);
+        dirs[i].closing = 1;
+        pthread_cond_broadcast(&dirs[i].not_full);
+        pthread_cond_broadcast(&dirs[i].not_empty);
+        pthread_mutex_unlock(&dirs[i].lock);
+    }
+    shutdown(producer_sock, SHUT_RDWR);
+    shutdown(consumer_sock, SHUT_RDWR);
+    for (int i = 0; i < 2 * NUM_DIRS; i++)
+        pthread_join(threads[i], NULL);
+    close(producer_sock);
+    close(consumer_sock);
+}
+
+// consumer에 연결(listen할 때까지 재시도)하고 producer의 연결을 받음, 종료 요청이면 -1
+static int link_open(int server_sock, const struct sockaddr_in *target_addr, int *producer_sock, int *consumer_sock)
+{
+    int on = 1;
+    *consumer_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (*consumer_sock < 0)
+    {
+        perror("[netem_proxy] socket");
+        exit(EXIT_FAILURE);
+    }
+    while (connect(*consumer_sock, (const struct sockaddr *)target_addr, sizeof(*target_addr)) < 0)
+    {
+        if (stopping())
+        {
+            close(*consumer_sock);
+            return -1;
+        }
+        usleep(CONNECT_RETRY_US);
+    }
+    // accept는 종료 요청을 확인하면서 기다림 (재시작한 producer가 연결할 때까지)
+    struct pollfd pfd = {server_sock, POLLIN, 0};
+    for (;;)
+    {
+        if (stopping())
+        {
+            close(*consumer_sock);
+            return -1;
+        }
+        if (poll(&pfd, 1, POLL_MS) <= 0)
+            continue;
+        *producer_sock = accept(server_sock, NULL, NULL);
+        if (*producer_sock >= 0)
+            break;
+        if (errno != EINTR && errno != ECONNABORTED)
+        {
+            perror("[netem_proxy] accept");
+            exit(EXIT_FAILURE);
+        }
+    }
+    setsockopt(*consumer_sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    setsockopt(*producer_sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return 0;
+}
+
+// "host:port" 또는 "port"
+static void parse_target(const char *s, struct sockaddr_in *addr)
+{
+    char host[64] = "127.0.0.1";
+    const char *colon = strrchr(s, ':');
+    if (colon != NULL)
+        snprintf(host, sizeof(host), "%.*s", (int)(colon - s), s);
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(atoi(colon != NULL ? colon + 1 : s));
+    if (inet_pton(AF_INET, host, &addr->sin_addr) != 1)
+    {
+        fprintf(stderr, "[netem_proxy] invalid target '%s'\n", s);
+        exit(EXIT_FAILURE);
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-n name] [-f frame_bytes] [-d delay_us] [-j jitter_us] [-b mbit] [-l loss] [-r rto_us]\n"
+            "          [-q queue] [-t host:port] [-S seed] <base_port>\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *name = NULL;
+    const char *target = NULL;
+    uint64_t seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:f:d:j:b:l:r:q:t:S:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            name = optarg;
+            break;
+        case 'f':
+            netem.frame_bytes = strtoul(optarg, NULL, 0);
+            break;
+        case 'd':
+            netem.delay_ns = (int64_t)(atof(optarg) * 1000.0);
+            break;
+        case 'j':
+            netem.jitter_ns = (int64_t)(atof(optarg) * 1000.0);
+            break;
+        case 'b':
+            netem.mbit = atof(optarg);
+            break;
+        case 'l':
+            netem.loss = atof(optarg);
+            break;
+        case 'r':
+            netem.rto_ns = (int64_t)(atof(optarg) * 1000.0);
+            break;
+        case 'q':
+            netem.q_cap = atoi(optarg);
+            break;
+        case 't':
+            target = optarg;
+            break;
+        case 'S':
+            seed = strtoull(optarg, NULL, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc || netem.q_cap < 1 || netem.loss < 0 || netem.loss > 1 || netem.delay_ns < 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (netem.loss > 0 && netem.rto_ns == 0 && netem.frame_bytes == 0)
+    {
+        fprintf(stderr, "[netem_proxy] dropping frames (-r 0) needs the frame size (-f)\n");
+        return EXIT_FAILURE;
+    }
+    int base_port = atoi(argv[optind]);
+    char default_name[16];
+    if (name == NULL)
+    {
+        snprintf(default_name, sizeof(default_name), "%d", base_port);
+        name = default_name;
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    // producer 쪽: proxy port에서 대기
+    int listen_port = rt_instance_port(base_port) + RT_INSTANCE_PROXY_OFFSET;
+    int server_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_sock < 0)
+    {
+        perror("[netem_proxy] socket");
+        return EXIT_FAILURE;
+    }
+    int on = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    struct sockaddr_in listen_addr;
+    memset(&listen_addr, 0, sizeof(listen_addr));
+    listen_addr.sin_family = AF_INET;
+    listen_addr.sin_port = htons(listen_port);
+    listen_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(server_sock, (struct sockaddr *)&listen_addr, sizeof(listen_addr)) < 0 || listen(server_sock, 1) < 0)
+    {
+        perror("[netem_proxy] bind/listen");
+        return EXIT_FAILURE;
+    }
+
+    // consumer 쪽: consumer가 listen할 때까지 재시도
+    struct sockaddr_in target_addr;
+    memset(&target_addr, 0, sizeof(target_addr));
+    if (target != NULL)
+        parse_target(target, &target_addr);
+    else
+    {
+        target_addr.sin_family = AF_INET;
+        target_addr.sin_port = htons(rt_instance_port(base_port));
+        inet_pton(AF_INET, "127.0.0.1", &target_addr.sin_addr);
+    }
+    int producer_sock, consumer_sock;
+    printf("[netem_proxy] %s: listening on %d, connecting to %s:%d...\n", name, listen_port,
+           inet_ntoa(target_addr.sin_addr), ntohs(target_addr.sin_port));
+    if (link_open(server_sock, &target_addr, &producer_sock, &consumer_sock) != 0)
+        return EXIT_SUCCESS;
+    printf("[netem_proxy] %s: connected (frame %zu B, delay %.0f us, jitter %.0f us, %.1f Mbit/s, loss %.4f, rto %.0f us)\n",
+           name, netem.frame_bytes, netem.delay_ns / 1e3, netem.jitter_ns / 1e3, netem.mbit, netem.loss,
+           netem.rto_ns / 1e3);
+
+    char log_name[96];
+    snprintf(log_name, sizeof(log_name), "log_netem_%s.txt", name);
+    log_fp = fopen(log_name, "w");
+    if (log_fp == NULL)
+    {
+        perror("[netem_proxy] log open");
+        return EXIT_FAILURE;
+    }
+    dir_init(&dirs[DIR_FWD], "fwd", netem.frame_bytes, seed);
+    dir_init(&dirs[DIR_REV], "rev", 0, seed * 2 + 1);
+
+    // producer / consumer와 같은 start barrier, frame 시각은 epoch 기준으로 기록
+    epoch_ns = rt_ctrl_wait_epoch();
+    fprintf(log_fp, "# link %s: frame %zu B, delay %.0f us, jitter %.0f us, %.1f Mbit/s, loss %.4f, rto %.0f us\n", name,
+            netem.frame_bytes, netem.delay_ns / 1e3, netem.jitter_ns / 1e3, netem.mbit, netem.loss, netem.rto_ns / 1e3);
+    fprintf(log_fp, "# dir frame bytes in_ms depart_ms due_ms out_ms lost\n");
+
+    ctrl = rt_ctrl_attach();
+
+    // launcher의 종료 요청까지 중계, 한쪽이 끊기면 양쪽을 다시 연결
+    pthread_t threads[2 * NUM_DIRS];
+    struct timespec poll_ts = {0, POLL_MS * 1000000L};
+    for (int reconnects = 0;; reconnects++)
+    {
+        dir_start(&dirs[DIR_FWD], producer_sock, consumer_sock, &threads[0]);
+        dir_start(&dirs[DIR_REV], consumer_sock, producer_sock, &threads[2]);
+        while (!stopping() && !__atomic_load_n(&dirs[DIR_FWD].done, __ATOMIC_ACQUIRE) &&
+               !__atomic_load_n(&dirs[DIR_REV].done, __ATOMIC_ACQUIRE))
+            nanosleep(&poll_ts, NULL);
+        link_close(threads, producer_sock, consumer_sock);
+        if (stopping())
+            break;
+
+        int64_t down_ns = rt_now_ns();
+        printf("[netem_proxy] %s: link down, reconnecting...\n", name);
+        if (link_open(server_sock, &target_addr, &producer_sock, &consumer_sock) != 0)
+            break;
+        printf("[netem_proxy] %s: reconnected after %.3f ms\n", name, (rt_now_ns() - down_ns) / 1.0e6);
+        pthread_mutex_lock(&log_lock);
+        fprintf(log_fp, "# reconnect %d: down %.3f ms, up %.3f ms\n", reconnects + 1, (down_ns - epoch_ns) / 1.0e6,
+                (rt_now_ns() - epoch_ns) / 1.0e6);
+        pthread_mutex_unlock(&log_lock);
+    }
+    close(server_sock);
+
+    fflush(log_fp);
+    for (int i = 0; i < NUM_DIRS; i++)
+    {
+        const dir_t *d = &dirs[i];
+        uint64_t delivered = d->frames - d->dropped;
+        printf("[netem_proxy] %s %s: %llu frames, %.1f MB, lost %llu (dropped %llu), proxy delay mean %.3f ms, max %.3f ms\n",
+               name, d->name, (unsigned long long)d->frames, d->bytes / 1.0e6, (unsigned long long)d->lost,
+               (unsigned long long)d->dropped, delivered ? d->delay_sum_ns / 1.0e6 / delivered : 0.0,
+               d->delay_max_ns / 1.0e6);
+    }
+    fclose(log_fp);
+    return EXIT_SUCCESS;
+}
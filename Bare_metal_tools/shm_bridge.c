@@ -0,0 +1,286 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <getopt.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_instance.h"
+#include "../Bare_metal_common/rt_mem.h"
+#include "../Bare_metal_common/chain_msg.h"
+
+// shm channel <-> TCP bridge (node 사이 link)
+// launcher의 node 구성에서 producer와 consumer가 다른 node에 있는 channel은 node마다 별도 객체(<이름>_<node>, rt_instance.h)가 되고,
+// launcher가 이 bridge 두 개를 실행해 두 객체를 TCP로 잇는다. task는 shm 변형 그대로 자기 node의 channel만 본다.
+//  - 송신 (-t): producer node에서 channel을 -p 주기로 polling, chain message(앞 1280bytes)가 바뀌면 channel 전체를 복사해 전송
+//    (consumer task처럼 semaphore를 잡고 읽음, 전송 중에 덮어써진 sample은 다음 polling에서 최신 것만 보냄)
+//  - 수신 (-l): consumer node에서 frame을 받을 때마다 semaphore를 잡고 channel에 씀 (producer task처럼)
+// 종료 시 frame 수와 frame당 bridge 안에서 걸린 시간(송신: 감지 -> 전송 완료, 수신: 수신 완료 -> channel 기록)을 출력
+//
+// 사용법: shm_bridge -t <host:port> [-p polling 주기(us)] <shm 이름> <sem 이름> <크기(bytes)>   (producer node)
+//         shm_bridge -l <port> <shm 이름> <sem 이름> <크기(bytes)>                           (consumer node)
+//  port는 기존 port (instance port 규칙 적용), shm / sem 이름은 설명 파일의 기존 이름
+
+#define DEFAULT_POLL_US 200
+#define CONNECT_RETRY_US 1000
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+typedef struct
+{
+    uint64_t frames;
+    uint64_t bytes;
+    int64_t busy_sum_ns;
+    int64_t busy_max_ns;
+} bridge_stats_t;
+
+static void stats_add(bridge_stats_t *st, size_t len, int64_t busy_ns)
+{
+    st->frames++;
+    st->bytes += len;
+    st->busy_sum_ns += busy_ns;
+    if (busy_ns > st->busy_max_ns)
+        st->busy_max_ns = busy_ns;
+}
+
+static ssize_t send_all(int fd, const char *buf, size_t len)
+{
+    size_t off = 0;
+    while (off < len)
+    {
+        ssize_t n = send(fd, buf + off, len - off, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR && !stop_requested)
+                continue;
+            return -1;
+        }
+        off += (size_t)n;
+    }
+    return (ssize_t)off;
+}
+
+// "host:port" 또는 "port", port는 기존 port
+static void parse_target(const char *s, struct sockaddr_in *addr)
+{
+    char host[64] = "127.0.0.1";
+    const char *colon = strrchr(s, ':');
+    if (colon != NULL)
+        snprintf(host, sizeof(host), "%.*s", (int)(colon - s), s);
+    memset(addr, 0, sizeof(*addr));
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(rt_instance_port(atoi(colon != NULL ? colon + 1 : s)));
+    if (inet_pton(AF_INET, host, &addr->sin_addr) != 1)
+    {
+        fprintf(stderr, "[shm_bridge] invalid target '%s'\n", s);
+        exit(EXIT_FAILURE);
+    }
+}
+
+// producer node: channel이 바뀔 때마다 전송
+static void run_sender(const char *target, int64_t poll_ns, char *shm, sem_t *sem, size_t size, bridge_stats_t *st)
+{
+    struct sockaddr_in addr;
+    parse_target(target, &addr);
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0)
+    {
+        perror("[shm_bridge] socket");
+        exit(EXIT_FAILURE);
+    }
+    printf("[shm_bridge] connecting to %s:%d...\n", inet_ntoa(addr.sin_addr), ntohs(addr.sin_port));
+    while (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        if (stop_requested)
+            return;
+        usleep(CONNECT_RETRY_US);
+    }
+    int on = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    printf("[shm_bridge] connected, polling every %.0f us\n", poll_ns / 1e3);
+
+    char *local = rt_mem_alloc(size);
+    char *last = rt_mem_alloc(CHAIN_MSG_SIZE); // 마지막으로 보낸 chain message (처음은 0 = 아직 쓰지 않은 channel)
+    size_t head = size < CHAIN_MSG_SIZE ? size : CHAIN_MSG_SIZE;
+    rt_ctrl_wait_epoch();
+
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (!stop_requested)
+    {
+        rt_ns_to_timespec(rt_timespec_to_ns(&next) + poll_ns, &next);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        if (stop_requested)
+            break;
+
+        int64_t t0 = rt_now_ns();
+        sem_wait(sem);
+        int changed = memcmp(shm, last, head) != 0;
+        if (changed)
+            memcpy(local, shm, size);
+        sem_post(sem);
+        if (!changed)
+            continue;
+        memcpy(last, local, head);
+        if (send_all(sock, local, size) < 0)
+        {
+            if (!stop_requested)
+                perror("[shm_bridge] send");
+            break;
+        }
+        stats_add(st, size, rt_now_ns() - t0);
+    }
+    close(sock);
+}
+
+// consumer node: 받은 frame을 channel에 기록
+static void run_receiver(int base_port, char *shm, sem_t *sem, size_t size, bridge_stats_t *st)
+{
+    int server_sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (server_sock < 0)
+    {
+        perror("[shm_bridge] socket");
+        exit(EXIT_FAILURE);
+    }
+    int on = 1;
+    setsockopt(server_sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(rt_instance_port(base_port));
+    addr.sin_addr.s_addr = htonl(INADDR_ANY); // 다른 node(network namespace)에서 연결
+    if (bind(server_sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(server_sock, 1) < 0)
+    {
+        perror("[shm_bridge] bind/listen");
+        exit(EXIT_FAILURE);
+    }
+    printf("[shm_bridge] listening on %d...\n", rt_instance_port(base_port));
+    int sock = accept(server_sock, NULL, NULL);
+    if (sock < 0)
+    {
+        if (!stop_requested)
+            perror("[shm_bridge] accept");
+        return;
+    }
+    close(server_sock);
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    printf("[shm_bridge] connected\n");
+
+    char *local = rt_mem_alloc(size);
+    rt_ctrl_wait_epoch();
+    while (!stop_requested)
+    {
+        ssize_t n = recv(sock, local, size, MSG_WAITALL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0 || (size_t)n < size)
+            break; // 연결 종료 (끝의 불완전한 frame은 버림)
+        int64_t t0 = rt_now_ns();
+        sem_wait(sem);
+        memcpy(shm, local, size);
+        sem_post(sem);
+        stats_add(st, size, rt_now_ns() - t0);
+    }
+    close(sock);
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s -t <host:port> [-p poll_us] <shm> <sem> <size>\n"
+            "       %s -l <port> <shm> <sem> <size>\n",
+            prog, prog);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *target = NULL;
+    int listen_port = 0;
+    int64_t poll_ns = (int64_t)DEFAULT_POLL_US * 1000;
+    int opt;
+    while ((opt = getopt(argc, argv, "t:l:p:")) != -1)
+    {
+        switch (opt)
+        {
+        case 't':
+            target = optarg;
+            break;
+        case 'l':
+            listen_port = atoi(optarg);
+            break;
+        case 'p':
+            poll_ns = (int64_t)(atof(optarg) * 1000.0);
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind + 3 != argc || (target == NULL) == (listen_port == 0) || poll_ns <= 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char *shm_name = rt_instance_name(argv[optind]); // WATERS_NODE_LINKS에 있으면 이 node의 객체
+    const char *sem_name = rt_instance_name(argv[optind + 1]);
+    size_t size = strtoul(argv[optind + 2], NULL, 0);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal; // SA_RESTART 없음: 막혀 있는 recv / accept가 EINTR로 돌아옴
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    // channel과 semaphore는 launcher가 미리 생성
+    int fd = rt_mem_shm_open(shm_name, O_RDWR, 0666);
+    if (fd == -1)
+    {
+        perror("[shm_bridge] shm_open");
+        return EXIT_FAILURE;
+    }
+    char *shm = rt_mem_shm_map(fd, size, PROT_READ | PROT_WRITE);
+    close(fd);
+    if (shm == MAP_FAILED)
+    {
+        perror("[shm_bridge] mmap");
+        return EXIT_FAILURE;
+    }
+    sem_t *sem = sem_open(sem_name, 0);
+    if (sem == SEM_FAILED)
+    {
+        perror("[shm_bridge] sem_open");
+        return EXIT_FAILURE;
+    }
+
+    bridge_stats_t st = {0};
+    if (target != NULL)
+        run_sender(target, poll_ns, shm, sem, size, &st);
+    else
+        run_receiver(listen_port, shm, sem, size, &st);
+
+    printf("[shm_bridge] %s %s: %llu frames, %.1f MB, bridge time mean %.3f ms, max %.3f ms\n", shm_name,
+           target != NULL ? "tx" : "rx", (unsigned long long)st.frames, st.bytes / 1.0e6,
+           st.frames ? st.busy_sum_ns / 1.0e6 / st.frames : 0.0, st.busy_max_ns / 1.0e6);
+    sem_close(sem);
+    rt_mem_shm_unmap(shm, size);
+    return EXIT_SUCCESS;
+}
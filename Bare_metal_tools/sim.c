@@ -0,0 +1,822 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "../Bare_metal_common/task_model.h"
+#include "../Bare_metal_common/rta.h"
+#include "../Bare_metal_common/chain_msg.h"
+#include "../Bare_metal_common/chain_log.h"
+
+// 가상 시간 discrete-event simulator
+// pipeline 설명 파일과 task source의 #define(task_model.h)으로 실제 task와 같은 model을 가상 시계 위에서 실행하고,
+// DASM과 같은 형식의 log_Chain N_sim.txt / .bin을 만든다. (analysis2.py, chain_analyze, e2e_bound -r로 그대로 분석)
+// 일주일 분량의 운행도 실제 시간을 기다리지 않고 몇 분 안에 만들 수 있다.
+//  - release: epoch + offset + k * period, 이전 job이 끝나지 않았으면 끝난 직후 (rt_release_next와 같음)
+//  - 실행 시간: task의 rand_range와 같은 분포 (LB ~ AVG, AVG ~ UB, 확률 0.001로 UB 초과)
+//    busy-loop은 실제 구현처럼 CPU 시간이 아니라 경과 시간으로 끝남 (선점되어도 시계는 흐름)
+//    GPU 구간(FUNCTION)은 usleep처럼 CPU를 놓는 구간
+//  - scheduling: core별 fixed-priority 선점 (SCHED_FIFO: 같은 우선순위는 먼저 ready된 순서, 선점된 thread는 맨 앞)
+//    SCHED_OTHER / idle은 우선순위 0 (RR time slice와 CFS의 공정성은 모델링하지 않음)
+//  - data 전달 (비용은 rta.h의 rta_cost_t):
+//    shm: semaphore 안에서 sem + memcpy (consumer는 job 시작에 읽고 producer는 send에서 씀, lock 대기 포함)
+//    TCP: producer send(syscall + kernel 복사) 뒤 consumer core / 우선순위의 copy thread가 recv + 복사해 buffer를 갱신,
+//         consumer는 job 시작에 buffer에서 memcpy
+//  - 보정: -C로 복사 비용과 timer wake-up 지연을 바꿔 가며 실제 run의 chain 통계(dasm.out)와 맞춤
+//
+// 사용법: sim [-d 가상 시간(s)] [-o 출력 디렉터리] [-s source 디렉터리] [-S seed] [-f text|binary|both]
+//             [-C mem=<ns/B>,net=<ns/B>,sem=<ns>,sys=<ns>,wake=<ns>] <pipeline.conf>
+
+#define SIM_EPOCH_NS 1000000000LL // 가상 시계의 epoch (시각 0은 초기화 전 data 표시라 피함)
+#define SIM_OVERRUN_PROBABILITY 0.001
+#define SIM_MAX_THREADS (TASK_MODEL_MAX_TASKS + TASK_MODEL_MAX_EDGES)
+#define SIM_MAX_STEPS (2 * TASK_MODEL_MAX_INPUTS + 8)
+#define SIM_MAX_CORES 256
+#define SIM_INF INT64_MAX
+#define SIM_DEFAULT_DURATION_S 600
+
+// job 안의 단계
+enum
+{
+    SIM_ST_READ_SHM = 0, // semaphore 안에서 입력 channel 복사 (CPU)
+    SIM_ST_READ_TCP,     // copy thread가 채운 buffer에서 복사 (CPU)
+    SIM_ST_RECV,         // 입력 읽기 완료 시각 (recv_time)
+    SIM_ST_BUSY,         // busy-loop: 진입 시각부터 경과 시간 ns가 지나면 끝
+    SIM_ST_SLEEP,        // GPU 구간 (usleep)
+    SIM_ST_SEND,         // send_time, seq 증가, 자기 slot 작성
+    SIM_ST_WRITE_SHM,    // semaphore 안에서 출력 channel에 쓰기 (CPU)
+    SIM_ST_WRITE_TCP,    // socket send (CPU), 끝나면 consumer의 copy thread에 도착
+    SIM_ST_COPY,         // copy thread: recv + buffer 복사 (CPU)
+    SIM_ST_END
+};
+
+enum
+{
+    SIM_SLEEPING = 0,
+    SIM_READY,   // 실행 중이거나 실행 대기
+    SIM_BLOCKED, // semaphore 대기
+};
+
+typedef struct
+{
+    int kind;
+    int edge;
+    int64_t ns;
+} sim_step_t;
+
+typedef struct
+{
+    int task;  // runnable thread의 task, copy thread는 consumer task
+    int edge;  // copy thread의 edge, runnable thread는 -1
+    int core;
+    int prio;
+    int state;
+    int64_t wake_at;   // SIM_SLEEPING일 때 깨어날 시각
+    uint64_t order;    // 같은 우선순위 안에서의 순서 (ready된 순서)
+    int num_steps;
+    int step;
+    int entered;       // 현재 단계를 시작했는지 (단계 시작 동작은 thread가 실행 중일 때만)
+    int64_t remaining; // CPU 단계의 남은 시간
+    int64_t until;     // BUSY 단계가 끝나는 시각
+    sim_step_t steps[SIM_MAX_STEPS];
+} sim_thread_t;
+
+typedef struct
+{
+    int thread;   // runnable thread 번호
+    int has_inputs;
+    int64_t k;    // 현재 job의 release 번호
+    int64_t release_ns;
+    int64_t start_ns;
+    int64_t recv_ns;
+    int64_t send_ns;
+    uint64_t seq;
+    chain_msg_t out; // 입력에서 모은 chain 영역 + 자기 slot
+    // 통계
+    uint64_t jobs;
+    uint64_t late;  // 다음 release 이후에 끝난 job
+    int64_t resp_sum;
+    int64_t resp_max;
+} sim_task_t;
+
+typedef struct
+{
+    int tcp;
+    int64_t cs;        // shm: sem + memcpy (producer / consumer 모두)
+    int64_t send_cost; // TCP: producer의 send
+    int64_t copy_cost; // TCP: copy thread의 recv + buffer 복사
+    int64_t read_cost; // TCP: consumer의 buffer -> local 복사
+    chain_msg_t buf;   // shm channel 또는 TCP consumer의 mutex buffer
+    chain_msg_t local; // consumer의 local copy
+    int holder;        // semaphore를 잡은 thread (-1: 없음)
+    int waiter;        // semaphore를 기다리는 thread (사용자가 producer / consumer 둘뿐이라 하나)
+    int copy_thread;
+    chain_msg_t *queue; // 도착했지만 아직 copy thread가 처리하지 않은 message (socket buffer)
+    int q_head;
+    int q_len;
+    int q_cap;
+} sim_edge_t;
+
+typedef struct
+{
+    const task_model_t *m;
+    rta_cost_t cost;
+    int64_t wake_ns; // timer wake-up 지연 (release, usleep)
+    int64_t now;
+    uint64_t order;
+    int num_threads;
+    sim_thread_t threads[SIM_MAX_THREADS];
+    sim_task_t tasks[TASK_MODEL_MAX_TASKS];
+    sim_edge_t edges[TASK_MODEL_MAX_EDGES];
+    int running[SIM_MAX_CORES];
+    int num_cores;
+    int dasm; // level 1 task (-1: 없음)
+    chain_track_t tracks[CHAIN_MSG_TYPES + 1];
+} sim_t;
+
+static sim_t sim;
+static uint64_t sim_rng = 1;
+
+// xorshift64*, [0, 1)
+static double sim_uniform(void)
+{
+    sim_rng ^= sim_rng >> 12;
+    sim_rng ^= sim_rng << 25;
+    sim_rng ^= sim_rng >> 27;
+    return ((sim_rng * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// task source의 rand_range와 같은 분포
+static int64_t sim_rand_range(const int64_t *bounds)
+{
+    double min = bounds[TASK_MODEL_LB], avg = bounds[TASK_MODEL_AVG], max = bounds[TASK_MODEL_UB];
+    if (max <= min)
+        return (int64_t)avg;
+    double p_avg = (max - avg) / (max - min);
+    double x = sim_uniform();
+    if (x < p_avg)
+        return (int64_t)(min + sim_uniform() * (avg - min));
+    if (x < 1.0 - SIM_OVERRUN_PROBABILITY)
+        return (int64_t)(avg + sim_uniform() * (max - avg));
+    double u = sim_uniform();
+    return (int64_t)(max + (avg * pow(u, 2) / 10.0));
+}
+
+static void sim_ts(int64_t ns, struct timespec *ts)
+{
+    ts->tv_sec = ns / 1000000000LL;
+    ts->tv_nsec = ns % 1000000000LL;
+}
+
+static int64_t sim_release_time(int ti)
+{
+    const task_model_task_t *t = &sim.m->tasks[ti];
+    return SIM_EPOCH_NS + t->offset_ns + sim.tasks[ti].k * t->period_ns;
+}
+
+static void sim_make_ready(sim_thread_t *th)
+{
+    th->state = SIM_READY;
+    th->order = ++sim.order;
+}
+
+static void sim_add_step(sim_thread_t *th, int kind, int edge, int64_t ns)
+{
+    if (th->num_steps == SIM_MAX_STEPS)
+    {
+        fprintf(stderr, "[sim] too many steps in a job\n");
+        exit(EXIT_FAILURE);
+    }
+    th->steps[th->num_steps++] = (sim_step_t){kind, edge, ns};
+}
+
+// 다음 job의 단계 구성 (입력 읽기 -> 실행 -> 출력 -> 종료), 실행 시간은 이때 뽑음
+static void sim_build_job(int ti)
+{
+    const task_model_task_t *t = &sim.m->tasks[ti];
+    sim_task_t *st = &sim.tasks[ti];
+    sim_thread_t *th = &sim.threads[st->thread];
+    th->num_steps = 0;
+    th->step = 0;
+    th->entered = 0;
+    st->start_ns = -1;
+
+    for (int e = 0; e < sim.m->num_edges; e++)
+        if (sim.m->edges[e].consumer == ti)
+        {
+            const sim_edge_t *edge = &sim.edges[e];
+            sim_add_step(th, edge->tcp ? SIM_ST_READ_TCP : SIM_ST_READ_SHM, e, edge->tcp ? edge->read_cost : edge->cs);
+        }
+    if (st->has_inputs)
+        sim_add_step(th, SIM_ST_RECV, -1, 0);
+
+    if (t->suspend_ns[TASK_MODEL_UB] > 0)
+    {
+        int64_t pre[TASK_MODEL_NUM_BOUNDS];
+        for (int b = 0; b < TASK_MODEL_NUM_BOUNDS; b++)
+            pre[b] = t->exec_ns[b] - t->post_ns[b];
+        sim_add_step(th, SIM_ST_BUSY, -1, sim_rand_range(pre));
+        sim_add_step(th, SIM_ST_SLEEP, -1, sim_rand_range(t->suspend_ns));
+        sim_add_step(th, SIM_ST_BUSY, -1, sim_rand_range(t->post_ns));
+    }
+    else
+        sim_add_step(th, SIM_ST_BUSY, -1, sim_rand_range(t->exec_ns));
+
+    if (t->level >= CHAIN_MSG_FIRST_LEVEL)
+        sim_add_step(th, SIM_ST_SEND, -1, 0);
+    for (int e = 0; e < sim.m->num_edges; e++)
+        if (sim.m->edges[e].producer == ti)
+        {
+            const sim_edge_t *edge = &sim.edges[e];
+            sim_add_step(th, edge->tcp ? SIM_ST_WRITE_TCP : SIM_ST_WRITE_SHM, e, edge->tcp ? edge->send_cost : edge->cs);
+        }
+    sim_add_step(th, SIM_ST_END, -1, 0);
+}
+
+// 입력 읽기 완료: chain마다 바로 앞 level task에게서 받은 chain 영역을 out에 모음
+static void sim_collect_inputs(int ti)
+{
+    const task_model_task_t *t = &sim.m->tasks[ti];
+    for (int c = 1; c <= CHAIN_MSG_TYPES; c++)
+    {
+        const task_model_chain_t *ch = &sim.m->chains[c];
+        if (!(t->chain_mask & (1u << c)) || ch->len == 0 || t->level >= ch->len)
+            continue;
+        int upstream = ch->task[ch->len - t->level - 1];
+        for (int e = 0; e < sim.m->num_edges; e++)
+            if (sim.m->edges[e].producer == upstream && sim.m->edges[e].consumer == ti)
+                sim.tasks[ti].out.chain[c - 1] = sim.edges[e].local.chain[c - 1];
+    }
+}
+
+// send: seq 증가, chain마다 자기 level의 slot 작성 (시작 task의 recv는 start)
+static void sim_write_slots(int ti)
+{
+    const task_model_task_t *t = &sim.m->tasks[ti];
+    sim_task_t *st = &sim.tasks[ti];
+    struct timespec wake, recv, send;
+    sim_ts(st->release_ns, &wake);
+    sim_ts(st->has_inputs ? st->recv_ns : st->start_ns, &recv);
+    sim_ts(st->send_ns, &send);
+    st->seq++;
+    for (int c = 1; c <= CHAIN_MSG_TYPES; c++)
+        if (t->chain_mask & (1u << c))
+            chain_slot_set(&st->out.chain[c - 1].slot[t->level - CHAIN_MSG_FIRST_LEVEL], st->seq, &wake, &recv, &send);
+}
+
+// DASM job 종료: dasm의 print_log_if_new와 같은 record를 chain log queue에 넣음
+static void sim_log_chains(int ti)
+{
+    sim_task_t *st = &sim.tasks[ti];
+    struct timespec end;
+    sim_ts(sim.now, &end);
+    for (int c = 1; c <= CHAIN_MSG_TYPES; c++)
+    {
+        int levels = sim.m->chains[c].len;
+        if (levels == 0)
+            continue;
+        const chain_msg_chain_t *chain = &st->out.chain[c - 1];
+        uint64_t seq = chain_msg_level(chain, levels)->seq;
+        if (!chain_track_read(&sim.tracks[c], seq, &end))
+            continue;
+        chain_log_rec_t rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.chain = c;
+        rec.seq = (int64_t)seq;
+        rec.levels = levels;
+        for (int level = levels; level >= CHAIN_MSG_FIRST_LEVEL; level--)
+        {
+            const chain_slot_t *slot = chain_msg_level(chain, level);
+            rec.wake_ns[level] = chain_log_ns(slot->wake_sec, slot->wake_nsec);
+            rec.recv_ns[level] = chain_log_ns(slot->recv_sec, slot->recv_nsec);
+            rec.send_ns[level] = chain_log_ns(slot->send_sec, slot->send_nsec);
+        }
+        rec.wake_ns[1] = st->release_ns;
+        rec.recv_ns[1] = st->recv_ns;
+        rec.send_ns[1] = sim.now;
+        chain_track_begin(&sim.tracks[c], &rec);
+    }
+    // logging thread 대신 queue가 반쯤 차면 직접 비움
+    if (chain_log.head - chain_log.tail >= CHAIN_LOG_CAPACITY / 2)
+        chain_log_drain();
+}
+
+// job 종료: 통계, 다음 release (이미 지났으면 쉬지 않고 바로 다음 job)
+static void sim_end_job(int ti)
+{
+    sim_task_t *st = &sim.tasks[ti];
+    sim_thread_t *th = &sim.threads[st->thread];
+    int64_t resp = sim.now - st->release_ns;
+    st->jobs++;
+    st->resp_sum += resp;
+    if (resp > st->resp_max)
+        st->resp_max = resp;
+    if (ti == sim.dasm)
+        sim_log_chains(ti);
+
+    st->k++;
+    st->release_ns = sim_release_time(ti);
+    if (sim.now > st->release_ns)
+        st->late++;
+    sim_build_job(ti);
+    if (st->release_ns > sim.now)
+    {
+        th->state = SIM_SLEEPING;
+        th->wake_at = st->release_ns + sim.wake_ns;
+    }
+}
+
+static void sim_unlock(sim_edge_t *edge)
+{
+    edge->holder = -1;
+    if (edge->waiter >= 0)
+    {
+        edge->holder = edge->waiter;
+        edge->waiter = -1;
+        sim_make_ready(&sim.threads[edge->holder]);
+    }
+}
+
+// TCP send 완료: consumer의 socket buffer에 도착, copy thread가 쉬고 있으면 깨움
+static void sim_deliver(int e, const chain_msg_t *msg)
+{
+    sim_edge_t *edge = &sim.edges[e];
+    if (edge->q_len == edge->q_cap)
+    {
+        int cap = edge->q_cap ? edge->q_cap * 2 : 8;
+        chain_msg_t *q = malloc(sizeof(chain_msg_t) * cap);
+        if (q == NULL)
+        {
+            perror("[sim] malloc");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < edge->q_len; i++)
+            q[i] = edge->queue[(edge->q_head + i) % edge->q_cap];
+        free(edge->queue);
+        edge->queue = q;
+        edge->q_head = 0;
+        edge->q_cap = cap;
+    }
+    edge->queue[(edge->q_head + edge->q_len++) % edge->q_cap] = *msg;
+    sim_thread_t *copy = &sim.threads[edge->copy_thread];
+    if (copy->state == SIM_SLEEPING)
+    {
+        copy->step = 0;
+        copy->entered = 0;
+        sim_make_ready(copy);
+    }
+}
+
+// 실행 중인 thread가 현재 단계를 시작 (즉시 끝나는 단계는 바로 처리)
+static void sim_enter(int tid)
+{
+    sim_thread_t *th = &sim.threads[tid];
+    for (;;)
+    {
+        sim_step_t *s = &th->steps[th->step];
+        sim_task_t *st = &sim.tasks[th->task];
+        th->entered = 1;
+        if (th->edge < 0 && st->start_ns < 0)
+            st->start_ns = sim.now;
+        switch (s->kind)
+        {
+        case SIM_ST_RECV:
+            st->recv_ns = sim.now;
+            sim_collect_inputs(th->task);
+            th->step++;
+            continue;
+        case SIM_ST_SEND:
+            st->send_ns = sim.now;
+            sim_write_slots(th->task);
+            th->step++;
+            continue;
+        case SIM_ST_END:
+            sim_end_job(th->task);
+            return;
+        case SIM_ST_BUSY:
+            th->until = sim.now + s->ns;
+            return;
+        case SIM_ST_SLEEP:
+            th->state = SIM_SLEEPING;
+            th->wake_at = sim.now + s->ns + sim.wake_ns;
+            return;
+        case SIM_ST_READ_SHM:
+        case SIM_ST_WRITE_SHM:
+        {
+            sim_edge_t *edge = &sim.edges[s->edge];
+            th->remaining = s->ns;
+            if (edge->holder < 0)
+                edge->holder = tid;
+            else
+            {
+                edge->waiter = tid;
+                th->state = SIM_BLOCKED;
+            }
+            return;
+        }
+        default: // READ_TCP, WRITE_TCP, COPY
+            th->remaining = s->ns;
+            return;
+        }
+    }
+}
+
+// 실행 중이던 thread의 CPU / BUSY 단계 종료
+static void sim_complete(int tid)
+{
+    sim_thread_t *th = &sim.threads[tid];
+    sim_step_t *s = &th->steps[th->step];
+    switch (s->kind)
+    {
+    case SIM_ST_READ_SHM:
+        sim.edges[s->edge].local = sim.edges[s->edge].buf;
+        sim_unlock(&sim.edges[s->edge]);
+        break;
+    case SIM_ST_READ_TCP:
+        sim.edges[s->edge].local = sim.edges[s->edge].buf;
+        break;
+    case SIM_ST_WRITE_SHM:
+        sim.edges[s->edge].buf = sim.tasks[th->task].out;
+        sim_unlock(&sim.edges[s->edge]);
+        break;
+    case SIM_ST_WRITE_TCP:
+        sim_deliver(s->edge, &sim.tasks[th->task].out);
+        break;
+    case SIM_ST_COPY:
+    {
+        sim_edge_t *edge = &sim.edges[th->edge];
+        edge->buf = edge->queue[edge->q_head];
+        edge->q_head = (edge->q_head + 1) % edge->q_cap;
+        edge->q_len--;
+        th->entered = 0;
+        if (edge->q_len == 0)
+        {
+            th->state = SIM_SLEEPING;
+            th->wake_at = SIM_INF;
+        }
+        return; // 다음 message가 있으면 같은 단계를 다시 시작
+    }
+    }
+    th->step++;
+    th->entered = 0;
+}
+
+static int sim_step_done(const sim_thread_t *th)
+{
+    const sim_step_t *s = &th->steps[th->step];
+    if (s->kind == SIM_ST_BUSY)
+        return th->until <= sim.now;
+    return th->remaining <= 0;
+}
+
+// core의 실행 thread: ready 중 우선순위가 가장 높고, 같으면 먼저 ready된 thread
+static int sim_pick(int core)
+{
+    int best = -1;
+    for (int i = 0; i < sim.num_threads; i++)
+    {
+        const sim_thread_t *th = &sim.threads[i];
+        if (th->core != core || th->state != SIM_READY)
+            continue;
+        if (best < 0 || th->prio > sim.threads[best].prio ||
+            (th->prio == sim.threads[best].prio && th->order < sim.threads[best].order))
+            best = i;
+    }
+    return best;
+}
+
+// 현재 시각에서 모든 core의 실행 thread를 정함 (단계 시작 / 즉시 끝나는 단계가 다른 core를 깨울 수 있어 반복)
+static void sim_schedule(void)
+{
+    int changed;
+    do
+    {
+        changed = 0;
+        for (int core = 0; core < sim.num_cores; core++)
+        {
+            int tid;
+            while ((tid = sim_pick(core)) >= 0)
+            {
+                sim_thread_t *th = &sim.threads[tid];
+                if (!th->entered)
+                    sim_enter(tid);
+                else if (sim_step_done(th))
+                    sim_complete(tid);
+                else
+                    break;
+                changed = 1;
+            }
+            sim.running[core] = tid;
+        }
+    } while (changed);
+}
+
+static void sim_run(int64_t end_ns)
+{
+    sim.now = SIM_EPOCH_NS;
+    sim_schedule();
+    for (;;)
+    {
+        // 다음 사건: 잠든 thread의 기상, 실행 중인 thread의 단계 종료
+        int64_t next = SIM_INF;
+        for (int i = 0; i < sim.num_threads; i++)
+            if (sim.threads[i].state == SIM_SLEEPING && sim.threads[i].wake_at < next)
+                next = sim.threads[i].wake_at;
+        for (int core = 0; core < sim.num_cores; core++)
+        {
+            int tid = sim.running[core];
+            if (tid < 0)
+                continue;
+            const sim_thread_t *th = &sim.threads[tid];
+            int64_t t = (th->steps[th->step].kind == SIM_ST_BUSY) ? th->until : sim.now + th->remaining;
+            if (t < next)
+                next = t;
+        }
+        if (next == SIM_INF || next > end_ns)
+            break;
+
+        int64_t elapsed = next - sim.now;
+        for (int core = 0; core < sim.num_cores; core++)
+            if (sim.running[core] >= 0 && sim.threads[sim.running[core]].steps[sim.threads[sim.running[core]].step].kind != SIM_ST_BUSY)
+                sim.threads[sim.running[core]].remaining -= elapsed;
+        sim.now = next;
+
+        // 끝난 단계를 먼저 처리 (그 시각에 깨어난 더 높은 우선순위 thread가 있어도 이미 끝난 일)
+        for (int core = 0; core < sim.num_cores; core++)
+        {
+            int tid = sim.running[core];
+            if (tid >= 0 && sim_step_done(&sim.threads[tid]))
+                sim_complete(tid);
+        }
+        for (int i = 0; i < sim.num_threads; i++)
+        {
+            sim_thread_t *th = &sim.threads[i];
+            if (th->state != SIM_SLEEPING || th->wake_at > sim.now)
+                continue;
+            if (th->step < th->num_steps && th->steps[th->step].kind == SIM_ST_SLEEP)
+            {
+                th->step++; // GPU 구간 끝
+                th->entered = 0;
+            }
+            else
+                sim.tasks[th->task].release_ns = sim_release_time(th->task); // 다음 job release
+            sim_make_ready(th);
+        }
+        sim_schedule();
+    }
+    sim.now = end_ns;
+}
+
+// -C key=value,... : rta_cost_t와 timer wake-up 지연
+static int sim_parse_cost(char *spec)
+{
+    for (char *kv = strtok(spec, ","); kv != NULL; kv = strtok(NULL, ","))
+    {
+        char *eq = strchr(kv, '=');
+        if (eq == NULL)
+            return -1;
+        *eq = '\0';
+        double v = atof(eq + 1);
+        if (strcmp(kv, "mem") == 0)
+            sim.cost.memcpy_ns_per_byte = v;
+        else if (strcmp(kv, "net") == 0)
+            sim.cost.net_ns_per_byte = v;
+        else if (strcmp(kv, "sem") == 0)
+            sim.cost.sem_ns = (int64_t)v;
+        else if (strcmp(kv, "sys") == 0)
+            sim.cost.syscall_ns = (int64_t)v;
+        else if (strcmp(kv, "wake") == 0)
+            sim.wake_ns = (int64_t)v;
+        else
+            return -1;
+    }
+    return 0;
+}
+
+static void sim_init(const task_model_t *m)
+{
+    sim.m = m;
+    sim.dasm = -1;
+    sim.num_cores = 0;
+    rta_mapping_t map;
+    rta_mapping_from_model(&map, m);
+
+    for (int c = 1; c <= CHAIN_MSG_TYPES; c++)
+    {
+        if (m->chains[c].len > CHAIN_MSG_LAST_LEVEL)
+        {
+            fprintf(stderr, "[sim] chain %d: %d levels (chain message has up to %d)\n", c, m->chains[c].len,
+                    CHAIN_MSG_LAST_LEVEL);
+            exit(EXIT_FAILURE);
+        }
+        chain_track_init(&sim.tracks[c]);
+    }
+
+    for (int i = 0; i < m->num_tasks; i++)
+    {
+        if (map.core[i] < 0 || map.core[i] >= SIM_MAX_CORES)
+        {
+            fprintf(stderr, "[sim] %s: core %d out of range\n", m->tasks[i].name, map.core[i]);
+            exit(EXIT_FAILURE);
+        }
+        sim_thread_t *th = &sim.threads[sim.num_threads];
+        th->task = i;
+        th->edge = -1;
+        th->core = map.core[i];
+        th->prio = map.prio[i];
+        sim.tasks[i].thread = sim.num_threads++;
+        if (th->core + 1 > sim.num_cores)
+            sim.num_cores = th->core + 1;
+        if (m->tasks[i].level == 1)
+            sim.dasm = i;
+    }
+
+    for (int e = 0; e < m->num_edges; e++)
+    {
+        const task_model_edge_t *me = &m->edges[e];
+        sim_edge_t *edge = &sim.edges[e];
+        int64_t copy = (int64_t)(me->bytes * sim.cost.memcpy_ns_per_byte);
+        int64_t net = sim.cost.syscall_ns + (int64_t)(me->bytes * sim.cost.net_ns_per_byte);
+        edge->tcp = me->tcp;
+        edge->cs = sim.cost.sem_ns + copy;
+        edge->send_cost = net;
+        edge->copy_cost = net + copy;
+        edge->read_cost = copy;
+        edge->holder = -1;
+        edge->waiter = -1;
+        edge->copy_thread = -1;
+        sim.tasks[me->consumer].has_inputs = 1;
+        if (me->tcp)
+        {
+            // copy thread: consumer process의 thread (같은 core, 같은 우선순위)
+            sim_thread_t *th = &sim.threads[sim.num_threads];
+            const sim_thread_t *owner = &sim.threads[sim.tasks[me->consumer].thread];
+            th->task = me->consumer;
+            th->edge = e;
+            th->core = owner->core;
+            th->prio = owner->prio;
+            th->state = SIM_SLEEPING;
+            th->wake_at = SIM_INF;
+            th->num_steps = 1;
+            th->steps[0] = (sim_step_t){SIM_ST_COPY, e, edge->copy_cost};
+            edge->copy_thread = sim.num_threads++;
+        }
+    }
+
+    // 첫 release까지 대기
+    for (int i = 0; i < m->num_tasks; i++)
+    {
+        sim_task_t *st = &sim.tasks[i];
+        sim_thread_t *th = &sim.threads[st->thread];
+        st->k = 0;
+        st->release_ns = sim_release_time(i);
+        sim_build_job(i);
+        th->state = SIM_SLEEPING;
+        th->wake_at = st->release_ns + sim.wake_ns;
+    }
+}
+
+// DASM의 logging thread 없이 chain_log.h의 queue / 파일 기록과 통계를 그대로 사용
+static void sim_log_open(const char *format)
+{
+    memset(&chain_log, 0, sizeof(chain_log));
+    snprintf(chain_log.suffix, sizeof(chain_log.suffix), "sim");
+    chain_log.log_core = -1;
+    chain_log.fsync_policy = CHAIN_LOG_FSYNC_NONE;
+    if (strcmp(format, "text") == 0)
+        chain_log.format = CHAIN_LOG_TEXT;
+    else if (strcmp(format, "binary") == 0)
+        chain_log.format = CHAIN_LOG_BINARY;
+    else if (strcmp(format, "both") == 0)
+        chain_log.format = CHAIN_LOG_TEXT | CHAIN_LOG_BINARY;
+    else
+    {
+        fprintf(stderr, "[sim] unknown format '%s' (text|binary|both)\n", format);
+        exit(EXIT_FAILURE);
+    }
+    chain_stats = calloc(1, sizeof(chain_stats_t));
+    if (chain_stats == NULL)
+    {
+        perror("[sim] calloc");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c <= CHAIN_STATS_NUM_CHAINS; c++)
+        for (int m = 0; m < CHAIN_STATS_NUM_METRICS; m++)
+            rt_hist_reset(&chain_stats->chains[c].hist[m]);
+    chain_stats->magic = CHAIN_STATS_MAGIC;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-d seconds] [-o out_dir] [-s src_dir] [-S seed] [-f text|binary|both]\n"
+            "          [-C mem=<ns/B>,net=<ns/B>,sem=<ns>,sys=<ns>,wake=<ns>] <pipeline.conf>\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    double duration_s = SIM_DEFAULT_DURATION_S;
+    const char *out_dir = ".";
+    const char *src_dir = NULL;
+    const char *format = "text";
+    unsigned long long seed = 1;
+    sim.cost = rta_cost_default();
+    int opt;
+    while ((opt = getopt(argc, argv, "d:o:s:S:f:C:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd':
+            duration_s = atof(optarg);
+            break;
+        case 'o':
+            out_dir = optarg;
+            break;
+        case 's':
+            src_dir = optarg;
+            break;
+        case 'S':
+            seed = strtoull(optarg, NULL, 0);
+            break;
+        case 'f':
+            format = optarg;
+            break;
+        case 'C':
+            if (sim_parse_cost(optarg) != 0)
+            {
+                fprintf(stderr, "[sim] bad -C value\n");
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc || duration_s <= 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    sim_rng = seed ? seed : 1; // xorshift는 0에서 멈춤
+
+    static task_model_t model;
+    if (task_model_load(&model, argv[optind], src_dir) != 0)
+        return EXIT_FAILURE;
+    if (model.num_tasks == 0)
+    {
+        fprintf(stderr, "[sim] %s: no task sources found\n", argv[optind]);
+        return EXIT_FAILURE;
+    }
+    sim_init(&model);
+    if (sim.dasm < 0)
+        fprintf(stderr, "[sim] no level 1 task (DASM): chain logs will be empty\n");
+
+    if (mkdir(out_dir, 0755) != 0 && errno != EEXIST)
+    {
+        perror("[sim] mkdir");
+        return EXIT_FAILURE;
+    }
+    if (chdir(out_dir) != 0)
+    {
+        perror("[sim] chdir");
+        return EXIT_FAILURE;
+    }
+    sim_log_open(format);
+
+    printf("[sim] %d tasks, %d threads, %d cores, %.0f s virtual, seed %llu\n", model.num_tasks, sim.num_threads,
+           sim.num_cores, duration_s, seed);
+    printf("[sim] cost: mem %.3f ns/B, net %.3f ns/B, sem %lld ns, syscall %lld ns, wake %lld ns\n",
+           sim.cost.memcpy_ns_per_byte, sim.cost.net_ns_per_byte, (long long)sim.cost.sem_ns,
+           (long long)sim.cost.syscall_ns, (long long)sim.wake_ns);
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    sim_run(SIM_EPOCH_NS + (int64_t)(duration_s * 1.0e9));
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double wall_s = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1.0e9;
+
+    printf("%-10s %4s %4s %10s %10s %10s %8s\n", "task", "core", "prio", "jobs", "R mean(ms)", "R max(ms)", "late");
+    for (int i = 0; i < model.num_tasks; i++)
+    {
+        const sim_task_t *st = &sim.tasks[i];
+        const sim_thread_t *th = &sim.threads[st->thread];
+        printf("%-10s %4d %4d %10llu %10.3f %10.3f %8llu\n", model.tasks[i].name, th->core, th->prio,
+               (unsigned long long)st->jobs, st->jobs ? st->resp_sum / 1.0e6 / st->jobs : 0.0, st->resp_max / 1.0e6,
+               (unsigned long long)st->late);
+    }
+    chain_log_close();
+    printf("[sim] %.0f s simulated in %.2f s (x%.0f), logs in %s\n", duration_s, wall_s,
+           wall_s > 0 ? duration_s / wall_s : 0.0, out_dir);
+    return EXIT_SUCCESS;
+}
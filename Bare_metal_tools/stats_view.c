@@ -0,0 +1,101 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <signal.h>
+#include <getopt.h>
+
+#include "../Bare_metal_common/chain_stats.h"
+
+// DASM 실시간 latency 통계 보기
+// DASM이 갱신하는 /waters_dasm_stats를 read-only로 읽어 chain별 p50/p99/p99.9/max를 주기적으로 출력한다.
+// 실행 중인 pipeline에는 아무것도 쓰지 않음 (seqlock snapshot 복사만)
+//
+// 사용법: stats_view [-i 간격(ms)] [-I instance] [-1]
+//   -1: 한 번만 출력하고 종료 (화면 지우기 없음)
+//   -I: launcher -n으로 여러 pipeline을 실행했을 때 볼 instance (기본: WATERS_INSTANCE 또는 0)
+
+#define DEFAULT_INTERVAL_MS 1000
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+static void show(const chain_stats_t *snap, int clear)
+{
+    if (clear)
+        printf("\033[H\033[2J");
+    double elapsed = (snap->updated_ns - snap->start_ns) / 1.0e9;
+    double age = (chain_stats_now_ns() - snap->updated_ns) / 1.0e9;
+    printf("[DASM pid %d] %.1f s 동안 기록, 마지막 갱신 %.1f s 전, dropped %llu\n", snap->pid, elapsed, age,
+           (unsigned long long)snap->dropped);
+    printf("(단위 us, percentile은 histogram bucket 기준 약 3%% 오차)\n\n");
+    chain_stats_print(stdout, snap);
+    for (int c = 1; c <= CHAIN_STATS_NUM_CHAINS; c++)
+        if (snap->chains[c].invalid > 0)
+            printf("chain %d: 초기화 전 record %llu개 제외\n", c, (unsigned long long)snap->chains[c].invalid);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    int interval_ms = DEFAULT_INTERVAL_MS;
+    int once = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "i:I:1")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i':
+            interval_ms = atoi(optarg);
+            break;
+        case 'I':
+            setenv("WATERS_INSTANCE", optarg, 1); // rt_instance.h가 이름을 만들 때 사용
+            break;
+        case '1':
+            once = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-i interval_ms] [-I instance] [-1]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const chain_stats_t *stats = chain_stats_attach();
+    if (stats == NULL)
+    {
+        fprintf(stderr, "[stats_view] %s 없음 (DASM이 실행 중인지 확인)\n", rt_instance_name(CHAIN_STATS_SHM_NAME));
+        return EXIT_FAILURE;
+    }
+
+    chain_stats_t *snap = malloc(sizeof(chain_stats_t));
+    if (snap == NULL)
+    {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    struct timespec interval = {interval_ms / 1000, (interval_ms % 1000) * 1000000L};
+    do
+    {
+        chain_stats_snapshot(stats, snap);
+        show(snap, !once);
+        if (once)
+            break;
+        nanosleep(&interval, NULL);
+    } while (!stop_requested);
+
+    free(snap);
+    return EXIT_SUCCESS;
+}
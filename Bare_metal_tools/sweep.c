@@ -0,0 +1,703 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <libgen.h>
+#include <limits.h>
+#include <signal.h>
+#include <getopt.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "../Bare_metal_common/task_model.h"
+#include "../Bare_metal_common/rta.h"
+#include "../Bare_metal_common/chain_bin.h"
+
+// Core mapping 탐색 (design-space sweep)
+// pipeline 설명 파일의 task를 core k개(1 ~ 최대)에 나누어 놓는 모든 mapping(여러 task를 한 core에 모으는 것 포함)을 만들고
+//  1. rta.h로 분석해 R > T인 task가 있는 mapping은 버림
+//  2. core 수(budget)마다 해석적 E2E 상한이 작은 순서로 n개를 launcher로 hyperperiod H개 동안 실행
+//     (설명 파일에서 core 값만 바꾼 사본을 만들어 실행, chain log는 binary)
+//  3. chain별 E2E latency의 p50 / p<q> / max를 deadline과 비교해 순위를 매기고
+//     모든 chain이 deadline을 지키는 mapping이 나온 가장 작은 budget에서 멈춤 (-a: 모든 budget 실행)
+//  -I로 background 부하 수준을 주면 mapping마다 수준별로 한 번씩 실행 (실행 중에 loadgen을 띄움)
+//     sweep.csv의 load column에 수준을 남기고, 모든 수준에서 deadline을 지켜야 통과
+// task 우선순위와 policy는 설명 파일 값을 그대로 쓰고, core 번호는 -b부터 차례로 사용.
+// 결과: <설명 파일 디렉터리>/runs/sweep_<시각>/ 아래 mapping별 run 디렉터리와 sweep.csv
+//
+// 사용법: sweep [-k 최대 core 수] [-b 첫 core] [-n budget별 실행 수] [-H hyperperiod 수] [-q percentile]
+//               [-D chain=deadline_ms]... [-I 부하]... [-L launcher] [-s source 디렉터리] [-x] [-a] <pipeline.conf>
+//  -I: <profile>[:<intensity %>][@<core 목록>] (loadgen, 예: none, membw:50@2-3, llc@0-7), launcher와 같은 디렉터리의 loadgen 사용
+//  -s: task source(<이름>.c)를 찾을 디렉터리 (e2e_bound와 같음)
+//  -x: 실행 없이 분석 결과(budget별 후보)만 출력
+//  deadline이 없는 chain은 해석적 순위에서 모든 task가 각자 core를 가질 때의 상한을 기준으로 비교하고 측정값은 검사하지 않음
+
+#define DEFAULT_RUNS_PER_BUDGET 3
+#define DEFAULT_HYPERPERIODS 1
+#define DEFAULT_PERCENTILE 99.0
+#define MAPPING_STR_MAX 512
+#define MAX_LOADS 16
+#define LOAD_STR_MAX 64
+
+typedef struct
+{
+    uint8_t block[RTA_MAX_TASKS]; // task -> 0 ~ cores-1 (실제 core = base_core + block)
+    int cores;
+    int analytic_ok;              // 해석적 E2E 상한이 모든 deadline 이내
+    double score;                 // max_c (상한 / 기준), 작을수록 좋음
+    int64_t bound[TASK_MODEL_MAX_CHAINS + 1];
+} candidate_t;
+
+typedef struct
+{
+    uint64_t count;
+    double p50_ms;
+    double pq_ms;
+    double max_ms;
+} chain_meas_t;
+
+static task_model_t model;
+static rta_model_t rta;
+static rta_mapping_t base_map;
+static int base_core = 0;
+static int max_cores = 0;
+static int64_t deadline_ns[TASK_MODEL_MAX_CHAINS + 1];   // 0: 없음
+static int64_t reference_ns[TASK_MODEL_MAX_CHAINS + 1];  // deadline 또는 전용 core 기준 상한
+
+static candidate_t *cands = NULL;
+static size_t num_cands = 0, cap_cands = 0;
+static uint64_t num_rejected = 0;
+static uint8_t cur_block[RTA_MAX_TASKS];
+static char loads[MAX_LOADS][LOAD_STR_MAX]; // -I 부하 수준 (없으면 "none" 하나)
+static int num_loads = 0;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+static int64_t gcd64(int64_t a, int64_t b)
+{
+    while (b != 0)
+    {
+        int64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static void chain_bounds_for(const rta_mapping_t *map, int64_t *bound, int *schedulable)
+{
+    rta_result_t res;
+    *schedulable = rta_analyze(&rta, map, &res);
+    for (int c = 1; c <= TASK_MODEL_MAX_CHAINS; c++)
+    {
+        bound[c] = 0;
+        if (model.chains[c].len == 0)
+            continue;
+        int64_t b[RTA_NUM_BOUNDS];
+        rta_chain_bounds(&rta, &model.chains[c], res.wcrt, b);
+        bound[c] = b[RTA_BOUND_E2E];
+    }
+}
+
+static void evaluate(int cores)
+{
+    rta_mapping_t map = base_map;
+    for (int i = 0; i < model.num_tasks; i++)
+        map.core[i] = base_core + cur_block[i];
+    candidate_t cand;
+    int schedulable;
+    chain_bounds_for(&map, cand.bound, &schedulable);
+    if (!schedulable)
+    {
+        num_rejected++;
+        return;
+    }
+    memcpy(cand.block, cur_block, sizeof(cand.block));
+    cand.cores = cores;
+    cand.analytic_ok = 1;
+    cand.score = 0.0;
+    for (int c = 1; c <= TASK_MODEL_MAX_CHAINS; c++)
+    {
+        if (model.chains[c].len == 0)
+            continue;
+        if (deadline_ns[c] > 0 && cand.bound[c] > deadline_ns[c])
+            cand.analytic_ok = 0;
+        double s = (double)cand.bound[c] / reference_ns[c];
+        if (s > cand.score)
+            cand.score = s;
+    }
+    if (num_cands == cap_cands)
+    {
+        cap_cands = cap_cands ? cap_cands * 2 : 1024;
+        cands = realloc(cands, cap_cands * sizeof(candidate_t));
+        if (cands == NULL)
+        {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+    }
+    cands[num_cands++] = cand;
+}
+
+// task를 core에 나누는 모든 방법 (restricted growth string: core 번호만 다른 같은 분할은 한 번만)
+static void enumerate(int i, int used)
+{
+    if (i == model.num_tasks)
+    {
+        evaluate(used);
+        return;
+    }
+    for (int b = 0; b < used; b++)
+    {
+        cur_block[i] = (uint8_t)b;
+        enumerate(i + 1, used);
+    }
+    if (used < max_cores)
+    {
+        cur_block[i] = (uint8_t)used;
+        enumerate(i + 1, used + 1);
+    }
+}
+
+static int cmp_candidate(const void *a, const void *b)
+{
+    const candidate_t *x = a, *y = b;
+    if (x->cores != y->cores)
+        return x->cores - y->cores;
+    if (x->analytic_ok != y->analytic_ok)
+        return y->analytic_ok - x->analytic_ok;
+    return (x->score > y->score) - (x->score < y->score);
+}
+
+static void mapping_str(const candidate_t *cand, char *buf, size_t len)
+{
+    size_t off = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < model.num_tasks && off < len; i++)
+        off += snprintf(buf + off, len - off, "%s%s@%d", i ? " " : "", model.tasks[i].name,
+                        base_core + cand->block[i]);
+}
+
+// 설명 파일 사본: model에 있는 task 줄의 core 값만 바꿈
+static int write_conf(const char *src, const char *dst, const candidate_t *cand)
+{
+    FILE *in = fopen(src, "r");
+    if (in == NULL)
+    {
+        perror("[sweep] description open");
+        return -1;
+    }
+    FILE *out = fopen(dst, "w");
+    if (out == NULL)
+    {
+        perror("[sweep] conf write");
+        fclose(in);
+        return -1;
+    }
+    char line[512];
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        char name[32];
+        int core_begin = 0, core_end = 0;
+        if (sscanf(line, " task %31s %n%*d%n", name, &core_begin, &core_end) == 1 && core_end > core_begin)
+        {
+            int i = task_model_find(&model, name);
+            if (i >= 0)
+            {
+                fprintf(out, "%.*s%d%s", core_begin, line, base_core + cand->block[i], line + core_end);
+                continue;
+            }
+        }
+        fputs(line, out);
+    }
+    fclose(in);
+    fclose(out);
+    return 0;
+}
+
+static int cmp_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_ms(const int64_t *v, size_t n, double q)
+{
+    size_t idx = (size_t)(q / 100.0 * (n - 1) + 0.5);
+    return v[idx < n ? idx : n - 1] / 1.0e6;
+}
+
+// run 디렉터리의 log_Chain N_*.bin에서 E2E latency(l1_end - lL_wake) 분포
+static void measure_chain(const char *run_dir, int chain, double q, chain_meas_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    char pattern[PATH_MAX];
+    if (snprintf(pattern, sizeof(pattern), "%s/log_Chain %d_*.bin", run_dir, chain) >= (int)sizeof(pattern))
+        return;
+    glob_t g;
+    if (glob(pattern, 0, NULL, &g) != 0)
+        return;
+    FILE *fp = fopen(g.gl_pathv[0], "rb");
+    globfree(&g);
+    if (fp == NULL)
+        return;
+
+    chain_bin_header_t h;
+    int64_t *vals = NULL, *cols = NULL;
+    size_t n = 0, cap = 0;
+    if (fread(&h, sizeof(h), 1, fp) == 1 && h.magic == CHAIN_BIN_MAGIC && h.version == CHAIN_BIN_VERSION)
+    {
+        chain_bin_block_t b;
+        while (fread(&b, sizeof(b), 1, fp) == 1 && b.magic == CHAIN_BIN_BLOCK_MAGIC)
+        {
+            size_t cells = (size_t)h.num_cols * b.rows;
+            cols = realloc(cols, cells * sizeof(int64_t));
+            if (cols == NULL || (n + b.rows > cap && (vals = realloc(vals, (cap = (n + b.rows) * 2) * sizeof(int64_t))) == NULL))
+            {
+                perror("realloc");
+                exit(EXIT_FAILURE);
+            }
+            if (fread(cols, sizeof(int64_t), cells, fp) != cells)
+                break;
+            const int64_t *top_wake = cols + (size_t)chain_bin_col(h.levels, h.levels, CHAIN_BIN_WAKE) * b.rows;
+            const int64_t *l1_recv = cols + (size_t)chain_bin_col(h.levels, 1, CHAIN_BIN_RECV) * b.rows;
+            const int64_t *l1_end = cols + (size_t)chain_bin_col(h.levels, 1, CHAIN_BIN_SEND) * b.rows;
+            for (uint32_t r = 0; r < b.rows; r++)
+                if (top_wake[r] != 0 && l1_recv[r] != 0) // 초기화 전 data 제외
+                    vals[n++] = l1_end[r] - top_wake[r];
+        }
+    }
+    fclose(fp);
+    if (n > 0)
+    {
+        qsort(vals, n, sizeof(int64_t), cmp_i64);
+        out->count = n;
+        out->p50_ms = percentile_ms(vals, n, 50.0);
+        out->pq_ms = percentile_ms(vals, n, q);
+        out->max_ms = vals[n - 1] / 1.0e6;
+    }
+    free(cols);
+    free(vals);
+}
+
+static int run_launcher(const char *launcher, const char *conf, const char *run_dir, int duration_s)
+{
+    char out_path[PATH_MAX], dur[16];
+    if (snprintf(out_path, sizeof(out_path), "%s/launcher.out", run_dir) >= (int)sizeof(out_path))
+        return -1;
+    snprintf(dur, sizeof(dur), "%d", duration_s);
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("[sweep] fork");
+        return -1;
+    }
+    if (pid == 0)
+    {
+        int fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        setenv("WATERS_LOG_FORMAT", "binary", 1);
+        execl(launcher, launcher, "-d", dur, "-o", run_dir, conf, (char *)NULL);
+        perror("[sweep] exec launcher");
+        _exit(127);
+    }
+    int status;
+    while (waitpid(pid, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+        {
+            perror("[sweep] waitpid");
+            return -1;
+        }
+    }
+    return (WIFEXITED(status) && WEXITSTATUS(status) == 0) ? 0 : -1;
+}
+
+// 부하 수준 하나를 background로 실행 ("none"이면 실행하지 않고 0), 출력은 run 디렉터리의 loadgen.out
+static pid_t start_loadgen(const char *loadgen, const char *spec, const char *run_dir)
+{
+    char profile[LOAD_STR_MAX], intensity[16] = "100", cores[LOAD_STR_MAX] = "";
+    snprintf(profile, sizeof(profile), "%.*s", LOAD_STR_MAX - 1, spec);
+    char *at = strchr(profile, '@');
+    if (at != NULL)
+    {
+        snprintf(cores, sizeof(cores), "%s", at + 1);
+        *at = '\0';
+    }
+    char *colon = strchr(profile, ':');
+    if (colon != NULL)
+    {
+        snprintf(intensity, sizeof(intensity), "%s", colon + 1);
+        *colon = '\0';
+    }
+    if (strcmp(profile, "none") == 0)
+        return 0;
+
+    char out_path[PATH_MAX];
+    if (snprintf(out_path, sizeof(out_path), "%s/loadgen.out", run_dir) >= (int)sizeof(out_path))
+        return -1;
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("[sweep] fork");
+        return -1;
+    }
+    if (pid == 0)
+    {
+        int fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0)
+        {
+            dup2(fd, STDOUT_FILENO);
+            dup2(fd, STDERR_FILENO);
+            close(fd);
+        }
+        if (cores[0] != '\0')
+            execl(loadgen, loadgen, "-p", profile, "-i", intensity, "-c", cores, (char *)NULL);
+        else
+            execl(loadgen, loadgen, "-p", profile, "-i", intensity, (char *)NULL);
+        perror("[sweep] exec loadgen");
+        _exit(127);
+    }
+    return pid;
+}
+
+static void stop_loadgen(pid_t pid)
+{
+    if (pid <= 0)
+        return;
+    kill(pid, SIGTERM);
+    while (waitpid(pid, NULL, 0) < 0 && errno == EINTR)
+        ;
+}
+
+// 부하 수준을 run 디렉터리 이름에 쓸 수 있게 (membw:50@2-3 -> membw50_2-3)
+static void load_label(const char *spec, char *buf, size_t len)
+{
+    size_t off = 0;
+    for (const char *p = spec; *p != '\0' && off + 1 < len; p++)
+    {
+        if (*p == ':')
+            continue;
+        buf[off++] = (*p == '@' || *p == ',') ? '_' : *p;
+    }
+    buf[off] = '\0';
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-k max_cores] [-b first_core] [-n runs_per_budget] [-H hyperperiods] [-q percentile]\n"
+            "          [-D chain=deadline_ms]... [-I profile[:intensity][@cores]]... [-L launcher] [-s src_dir] [-x] [-a]\n"
+            "          <pipeline.conf>\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    int runs_per_budget = DEFAULT_RUNS_PER_BUDGET;
+    int hyperperiods = DEFAULT_HYPERPERIODS;
+    double q = DEFAULT_PERCENTILE;
+    int dry_run = 0, all_budgets = 0;
+    char launcher[PATH_MAX] = "";
+    const char *src_dir = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "k:b:n:H:q:D:I:L:s:xa")) != -1)
+    {
+        switch (opt)
+        {
+        case 'k':
+            max_cores = atoi(optarg);
+            break;
+        case 'b':
+            base_core = atoi(optarg);
+            break;
+        case 'n':
+            runs_per_budget = atoi(optarg);
+            break;
+        case 'H':
+            hyperperiods = atoi(optarg);
+            break;
+        case 'q':
+            q = atof(optarg);
+            break;
+        case 'D':
+        {
+            int c;
+            double ms;
+            if (sscanf(optarg, "%d=%lf", &c, &ms) != 2 || c < 1 || c > TASK_MODEL_MAX_CHAINS || ms <= 0)
+            {
+                fprintf(stderr, "[sweep] invalid deadline '%s' (chain=ms)\n", optarg);
+                return EXIT_FAILURE;
+            }
+            deadline_ns[c] = (int64_t)(ms * 1.0e6);
+            break;
+        }
+        case 'I':
+            if (num_loads == MAX_LOADS)
+            {
+                fprintf(stderr, "[sweep] at most %d load levels\n", MAX_LOADS);
+                return EXIT_FAILURE;
+            }
+            snprintf(loads[num_loads++], LOAD_STR_MAX, "%s", optarg);
+            break;
+        case 'L':
+            snprintf(launcher, sizeof(launcher), "%s", optarg);
+            break;
+        case 's':
+            src_dir = optarg;
+            break;
+        case 'x':
+            dry_run = 1;
+            break;
+        case 'a':
+            all_budgets = 1;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc || runs_per_budget < 1 || hyperperiods < 1 || q <= 0 || q > 100)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    char conf_path[PATH_MAX];
+    if (realpath(argv[optind], conf_path) == NULL)
+    {
+        perror("[sweep] realpath");
+        return EXIT_FAILURE;
+    }
+    if (task_model_load(&model, conf_path, src_dir) != 0 || model.num_tasks == 0)
+    {
+        fprintf(stderr, "[sweep] %s: no task sources found\n", conf_path);
+        return EXIT_FAILURE;
+    }
+    if (max_cores <= 0 || max_cores > model.num_tasks)
+        max_cores = model.num_tasks;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (!dry_run && base_core + max_cores > online)
+    {
+        max_cores = (int)(online - base_core);
+        fprintf(stderr, "[sweep] only %ld cores online, budget limited to %d\n", online, max_cores);
+        if (max_cores < 1)
+            return EXIT_FAILURE;
+    }
+    if (launcher[0] == '\0')
+    {
+        // 기본: sweep 실행 파일과 같은 디렉터리의 launcher
+        char self[PATH_MAX];
+        ssize_t len = readlink("/proc/self/exe", self, sizeof(self) - 1);
+        if (len < 0)
+        {
+            perror("[sweep] readlink");
+            return EXIT_FAILURE;
+        }
+        self[len] = '\0';
+        snprintf(launcher, sizeof(launcher), "%s/launcher", dirname(self));
+    }
+    char loadgen[PATH_MAX];
+    {
+        char dir[PATH_MAX];
+        snprintf(dir, sizeof(dir), "%s", launcher);
+        if (snprintf(loadgen, sizeof(loadgen), "%s/loadgen", dirname(dir)) >= (int)sizeof(loadgen))
+        {
+            fprintf(stderr, "[sweep] %s: path too long\n", launcher);
+            return EXIT_FAILURE;
+        }
+    }
+    if (num_loads == 0)
+        snprintf(loads[num_loads++], LOAD_STR_MAX, "none");
+
+    rta_cost_t cost = rta_cost_default();
+    rta_build(&rta, &model, &cost);
+    rta_mapping_from_model(&base_map, &model);
+
+    // deadline이 없는 chain의 비교 기준: 모든 task가 각자 core를 가질 때의 상한
+    rta_mapping_t dedicated = base_map;
+    for (int i = 0; i < model.num_tasks; i++)
+        dedicated.core[i] = i;
+    int dedicated_ok;
+    int64_t dedicated_bound[TASK_MODEL_MAX_CHAINS + 1];
+    chain_bounds_for(&dedicated, dedicated_bound, &dedicated_ok);
+    int64_t hyperperiod_ms = 1;
+    for (int i = 0; i < model.num_tasks; i++)
+    {
+        int64_t t_ms = model.tasks[i].period_ns / 1000000;
+        hyperperiod_ms = hyperperiod_ms / gcd64(hyperperiod_ms, t_ms) * t_ms;
+    }
+    for (int c = 1; c <= TASK_MODEL_MAX_CHAINS; c++)
+    {
+        reference_ns[c] = deadline_ns[c];
+        if (reference_ns[c] == 0)
+            reference_ns[c] = (dedicated_ok && dedicated_bound[c] > 0) ? dedicated_bound[c] : 1000000000LL;
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    enumerate(0, 0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double analysis_s = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1.0e9;
+    printf("[sweep] %d tasks, up to %d cores: %zu schedulable / %llu mappings analysed in %.3f s\n", model.num_tasks,
+           max_cores, num_cands, (unsigned long long)(num_cands + num_rejected), analysis_s);
+    qsort(cands, num_cands, sizeof(candidate_t), cmp_candidate);
+
+    int duration_s = (int)((hyperperiods * hyperperiod_ms + 999) / 1000);
+    char sweep_dir[PATH_MAX] = "", csv_path[PATH_MAX], tmp_conf[PATH_MAX];
+    FILE *csv = NULL;
+    if (!dry_run)
+    {
+        char conf_dir[PATH_MAX];
+        snprintf(conf_dir, sizeof(conf_dir), "%s", conf_path);
+        dirname(conf_dir);
+        char stamp[32];
+        time_t wall = time(NULL);
+        struct tm tm_now;
+        localtime_r(&wall, &tm_now);
+        strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm_now);
+        char runs_dir[PATH_MAX];
+        // launcher는 설명 파일 디렉터리 기준으로 task를 실행하므로 사본도 같은 디렉터리에
+        if (snprintf(runs_dir, sizeof(runs_dir), "%s/runs", conf_dir) >= (int)sizeof(runs_dir) ||
+            snprintf(sweep_dir, sizeof(sweep_dir), "%s/sweep_%s", runs_dir, stamp) >= (int)sizeof(sweep_dir) ||
+            snprintf(tmp_conf, sizeof(tmp_conf), "%s/.sweep_%d.conf", conf_dir, (int)getpid()) >= (int)sizeof(tmp_conf) ||
+            snprintf(csv_path, sizeof(csv_path), "%s/sweep.csv", sweep_dir) >= (int)sizeof(csv_path))
+        {
+            fprintf(stderr, "[sweep] %s: path too long\n", conf_dir);
+            return EXIT_FAILURE;
+        }
+        mkdir(runs_dir, 0755);
+        if (mkdir(sweep_dir, 0755) != 0 && errno != EEXIST)
+        {
+            perror("[sweep] mkdir");
+            return EXIT_FAILURE;
+        }
+        csv = fopen(csv_path, "w");
+        if (csv == NULL)
+        {
+            perror("[sweep] csv open");
+            return EXIT_FAILURE;
+        }
+        fprintf(csv, "run,cores,mapping,load,chain,bound_ms,deadline_ms,count,p50_ms,p%g_ms,max_ms,meets\n", q);
+        printf("[sweep] %d hyperperiod(s) = %d s per run, %d load level(s) per mapping, results in %s\n", hyperperiods,
+               duration_s, num_loads, sweep_dir);
+
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = on_signal;
+        sigaction(SIGINT, &sa, NULL);
+        sigaction(SIGTERM, &sa, NULL);
+    }
+
+    int best_run = -1, run_id = 0;
+    char best_mapping[MAPPING_STR_MAX] = "";
+    size_t ci = 0;
+    for (int k = 1; k <= max_cores && !stop_requested; k++)
+    {
+        size_t first = ci;
+        while (ci < num_cands && cands[ci].cores == k)
+            ci++;
+        if (ci == first)
+        {
+            printf("\n[budget %d cores] no schedulable mapping\n", k);
+            continue;
+        }
+        printf("\n[budget %d cores] %zu schedulable mappings, trying %d\n", k, ci - first,
+               (int)(ci - first < (size_t)runs_per_budget ? ci - first : (size_t)runs_per_budget));
+        int budget_met = 0;
+        for (size_t j = first; j < ci && j < first + (size_t)runs_per_budget && !stop_requested; j++)
+        {
+            const candidate_t *cand = &cands[j];
+            char mstr[MAPPING_STR_MAX];
+            mapping_str(cand, mstr, sizeof(mstr));
+            printf("  %s\n    bound(ms):", mstr);
+            for (int c = 1; c <= TASK_MODEL_MAX_CHAINS; c++)
+                if (model.chains[c].len > 0)
+                    printf(" c%d=%.1f%s", c, cand->bound[c] / 1.0e6,
+                           (deadline_ns[c] > 0 && cand->bound[c] > deadline_ns[c]) ? "!" : "");
+            printf("\n");
+            if (dry_run)
+                continue;
+
+            if (write_conf(conf_path, tmp_conf, cand) != 0)
+                return EXIT_FAILURE;
+            int meets = 1;
+            for (int l = 0; l < num_loads && !stop_requested; l++)
+            {
+                char run_dir[PATH_MAX], label[LOAD_STR_MAX];
+                load_label(loads[l], label, sizeof(label));
+                if (num_loads > 1 || strcmp(loads[l], "none") != 0)
+                    snprintf(run_dir, sizeof(run_dir), "%s/run%02d_c%d_%s", sweep_dir, run_id, k, label);
+                else
+                    snprintf(run_dir, sizeof(run_dir), "%s/run%02d_c%d", sweep_dir, run_id, k);
+                mkdir(run_dir, 0755);
+                pid_t load_pid = start_loadgen(loadgen, loads[l], run_dir);
+                int ret = (load_pid < 0) ? -1 : run_launcher(launcher, tmp_conf, run_dir, duration_s);
+                stop_loadgen(load_pid);
+                if (ret != 0)
+                    printf("    launcher failed (see %s/launcher.out)\n", run_dir);
+
+                int load_meets = (ret == 0);
+                printf("    [%s] E2E(ms) p50/p%g/max:", loads[l], q);
+                for (int c = 1; c <= TASK_MODEL_MAX_CHAINS; c++)
+                {
+                    if (model.chains[c].len == 0)
+                        continue;
+                    chain_meas_t m;
+                    measure_chain(run_dir, c, q, &m);
+                    int chain_ok = m.count > 0 && (deadline_ns[c] == 0 || m.pq_ms * 1.0e6 <= deadline_ns[c]);
+                    load_meets &= chain_ok;
+                    printf(" c%d=%.1f/%.1f/%.1f%s", c, m.p50_ms, m.pq_ms, m.max_ms, chain_ok ? "" : "!");
+                    fprintf(csv, "%d,%d,%s,%s,%d,%.3f,%.3f,%llu,%.3f,%.3f,%.3f,%d\n", run_id, k, mstr, loads[l], c,
+                            cand->bound[c] / 1.0e6, deadline_ns[c] / 1.0e6, (unsigned long long)m.count, m.p50_ms,
+                            m.pq_ms, m.max_ms, chain_ok);
+                }
+                fflush(csv);
+                printf("\n");
+                meets &= load_meets;
+            }
+            unlink(tmp_conf);
+            printf("    -> %s\n", meets ? "meets deadlines" : "misses");
+            if (meets && !budget_met)
+            {
+                budget_met = 1;
+                if (best_run < 0)
+                {
+                    best_run = run_id;
+                    snprintf(best_mapping, sizeof(best_mapping), "%s", mstr);
+                }
+            }
+            run_id++;
+        }
+        if (budget_met && !all_budgets)
+            break;
+    }
+
+    if (csv != NULL)
+        fclose(csv);
+    if (dry_run)
+        return EXIT_SUCCESS;
+    if (best_run >= 0)
+        printf("\n[sweep] cheapest budget: run%02d (%s)\n", best_run, best_mapping);
+    else
+        printf("\n[sweep] no mapping met the deadlines within %d cores\n", max_cores);
+    return EXIT_SUCCESS;
+}
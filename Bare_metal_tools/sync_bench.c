@@ -0,0 +1,633 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <getopt.h>
+#include <sched.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_hist.h"
+
+// shm channel 동기화 기법 비교 (benchmark)
+// 실제 channel 접근 형태를 그대로 재현한다: writer 하나가 주기마다 sample(24KB SFM 33ms / 32KB Lane 66ms / 750KB Detection 200ms)을 쓰고,
+// Planner(15ms)와 DASM(5ms) 주기의 reader 둘이 같은 channel을 읽는다. 세 역할은 fork한 process로 각자 core에 고정되고,
+// task와 같은 방식으로 공통 epoch + k * 주기에 release된다.
+// 기법 (-p):
+//  sem     : POSIX named semaphore (현재 task의 방식, sem_wait -> memcpy -> sem_post)
+//  mutex   : process-shared pthread mutex
+//  spin    : process-shared pthread spinlock (holder가 선점되면 기다리는 쪽은 계속 돎)
+//  rwlock  : process-shared pthread rwlock (reader끼리는 동시에, glibc 기본은 reader 우선이라 writer가 밀릴 수 있음)
+//  seqlock : writer는 기다리지 않고, reader가 copy 도중 sample이 바뀌면 다시 읽음
+//  rcu     : buffer 3개 + 현재 buffer 번호 교체 (reader는 번호를 잡고 읽음, writer는 아무도 읽지 않는 buffer가 생길 때까지 대기)
+//  ring    : slot 4개의 lock-free ring (slot마다 seq, reader는 가장 최근 완성된 slot을 읽고 덮어써졌으면 다시 읽음)
+// 측정 (task의 phase 구간과 같음):
+//  - reader 읽기 latency = start -> 입력 읽기 완료 (SETUP 구간), writer 쓰기 latency = send -> end (SEND 구간)
+//  - blocking = lock 획득까지 기다린 시간 (seqlock / ring은 마지막 시도 전까지 다시 읽은 시간, rcu writer는 빈 buffer 대기)
+//  - writer starvation: blocking이 -S(기본 1ms)를 넘은 쓰기 수
+//  - sample 앞뒤에 seq를 써서 찢어진 copy(torn)를 검사, reader가 같은 sample을 다시 읽은 수(stale)도 셈
+// 결과는 기법 / 역할별 표 (us), -o로 CSV
+//
+// 사용법: sync_bench [-p 기법 목록] [-s 크기 목록(KB)] [-d 기법당 실행시간(s)] [-w writer 주기(ms)] [-t 시간 배율]
+//                    [-c writer,planner,dasm core] [-f] [-S starvation 기준(us)] [-o csv 파일]
+//  -p: 쉼표로 구분 (기본: 모두), -s: 기본 24,32,750 (writer 주기는 크기에 맞는 task 주기, -w로 모두 변경)
+//  -t N: 모든 주기를 1/N로 줄여 충돌을 자주 만듦, -f: SCHED_FIFO (pipeline.conf와 같은 우선순위: DASM 90, Planner 85, writer 70~80)
+//  spin과 -f를 같은 core에서 함께 쓰면 holder가 실행되지 못해 멈출 수 있음
+
+#define MAX_PRIMS 8
+#define MAX_SIZES 8
+#define RCU_BUFS 3
+#define RING_SLOTS 4
+#define DEFAULT_DURATION_S 10
+#define DEFAULT_STARVE_US 1000
+#define PLANNER_PERIOD_MS 15
+#define DASM_PERIOD_MS 5
+
+typedef enum
+{
+    PRIM_SEM,
+    PRIM_MUTEX,
+    PRIM_SPIN,
+    PRIM_RWLOCK,
+    PRIM_SEQLOCK,
+    PRIM_RCU,
+    PRIM_RING,
+    PRIM_MAX
+} prim_t;
+
+static const char *prim_names[PRIM_MAX] = {"sem", "mutex", "spin", "rwlock", "seqlock", "rcu", "ring"};
+
+enum
+{
+    ROLE_WRITER,
+    ROLE_PLANNER,
+    ROLE_DASM,
+    ROLE_MAX
+};
+
+static const char *role_names[ROLE_MAX] = {"writer", "planner", "dasm"};
+
+typedef struct
+{
+    rt_hist_t latency; // reader: start -> 읽기 완료, writer: send -> end
+    rt_hist_t blocked;
+    uint64_t jobs;
+    uint64_t retries;
+    uint64_t torn;
+    uint64_t stale;
+    uint64_t starved;
+} role_stats_t;
+
+// fork한 process가 함께 쓰는 영역 (MAP_SHARED)
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_spinlock_t spin;
+    pthread_rwlock_t rwlock;
+    uint64_t seq;                     // seqlock: 홀수면 쓰는 중
+    uint32_t rcu_cur;                 // rcu: 현재 buffer
+    uint32_t rcu_readers[RCU_BUFS];   // rcu: buffer별 읽는 중인 reader 수
+    uint64_t ring_head;               // ring: 마지막으로 완성된 쓰기 번호 (1부터)
+    uint64_t ring_seq[RING_SLOTS];    // ring: slot의 쓰기 번호 * 2 (홀수면 쓰는 중)
+    int64_t epoch_ns;
+    int64_t stop_ns;
+    role_stats_t stats[ROLE_MAX];
+} bench_shm_t;
+
+typedef struct
+{
+    prim_t prim;
+    size_t size;
+    bench_shm_t *shm;
+    char *bufs;                       // RING_SLOTS개의 sample buffer (잠금 방식은 0번만)
+    sem_t *sem;
+} bench_t;
+
+static void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ volatile("yield");
+#endif
+}
+
+static char *buf_at(const bench_t *b, unsigned idx)
+{
+    return b->bufs + (size_t)idx * b->size;
+}
+
+// sample 앞뒤의 seq (찢어진 copy 검사)
+static void stamp(char *p, size_t size, uint64_t seq)
+{
+    memcpy(p, &seq, sizeof(seq));
+    memcpy(p + size - sizeof(seq), &seq, sizeof(seq));
+}
+
+static int check(const char *p, size_t size, uint64_t *seq)
+{
+    uint64_t head, tail;
+    memcpy(&head, p, sizeof(head));
+    memcpy(&tail, p + size - sizeof(tail), sizeof(tail));
+    *seq = head;
+    return head == tail;
+}
+
+// writer: local(준비된 sample)을 channel에 씀, blocking 시간 반환
+static int64_t bench_write(bench_t *b, const char *local)
+{
+    bench_shm_t *s = b->shm;
+    int64_t t0 = rt_now_ns(), t1 = t0;
+    switch (b->prim)
+    {
+    case PRIM_SEM:
+        sem_wait(b->sem);
+        t1 = rt_now_ns();
+        memcpy(buf_at(b, 0), local, b->size);
+        sem_post(b->sem);
+        break;
+    case PRIM_MUTEX:
+        pthread_mutex_lock(&s->mutex);
+        t1 = rt_now_ns();
+        memcpy(buf_at(b, 0), local, b->size);
+        pthread_mutex_unlock(&s->mutex);
+        break;
+    case PRIM_SPIN:
+        pthread_spin_lock(&s->spin);
+        t1 = rt_now_ns();
+        memcpy(buf_at(b, 0), local, b->size);
+        pthread_spin_unlock(&s->spin);
+        break;
+    case PRIM_RWLOCK:
+        pthread_rwlock_wrlock(&s->rwlock);
+        t1 = rt_now_ns();
+        memcpy(buf_at(b, 0), local, b->size);
+        pthread_rwlock_unlock(&s->rwlock);
+        break;
+    case PRIM_SEQLOCK:
+    {
+        uint64_t seq = __atomic_load_n(&s->seq, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->seq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy(buf_at(b, 0), local, b->size);
+        __atomic_store_n(&s->seq, seq + 2, __ATOMIC_RELEASE);
+        break;
+    }
+    case PRIM_RCU:
+    {
+        // 현재 buffer가 아니고 읽는 reader가 없는 buffer (grace period가 끝난 buffer)
+        uint32_t cur = __atomic_load_n(&s->rcu_cur, __ATOMIC_SEQ_CST);
+        uint32_t next;
+        for (;;)
+        {
+            for (next = 0; next < RCU_BUFS; next++)
+                if (next != cur && __atomic_load_n(&s->rcu_readers[next], __ATOMIC_SEQ_CST) == 0)
+                    break;
+            if (next < RCU_BUFS)
+                break;
+            cpu_relax();
+        }
+        t1 = rt_now_ns();
+        memcpy(buf_at(b, next), local, b->size);
+        __atomic_store_n(&s->rcu_cur, next, __ATOMIC_SEQ_CST);
+        break;
+    }
+    case PRIM_RING:
+    {
+        uint64_t w = __atomic_load_n(&s->ring_head, __ATOMIC_RELAXED) + 1;
+        unsigned slot = (unsigned)(w % RING_SLOTS);
+        __atomic_store_n(&s->ring_seq[slot], w * 2 - 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy(buf_at(b, slot), local, b->size);
+        __atomic_store_n(&s->ring_seq[slot], w * 2, __ATOMIC_RELEASE);
+        __atomic_store_n(&s->ring_head, w, __ATOMIC_RELEASE);
+        break;
+    }
+    default:
+        break;
+    }
+    return t1 - t0;
+}
+
+// reader: channel의 최신 sample을 local로 읽음, blocking 시간 반환 (retries에 다시 읽은 횟수)
+static int64_t bench_read(bench_t *b, char *local, uint64_t *retries)
+{
+    bench_shm_t *s = b->shm;
+    int64_t t0 = rt_now_ns(), t1 = t0;
+    switch (b->prim)
+    {
+    case PRIM_SEM:
+        sem_wait(b->sem);
+        t1 = rt_now_ns();
+        memcpy(local, buf_at(b, 0), b->size);
+        sem_post(b->sem);
+        break;
+    case PRIM_MUTEX:
+        pthread_mutex_lock(&s->mutex);
+        t1 = rt_now_ns();
+        memcpy(local, buf_at(b, 0), b->size);
+        pthread_mutex_unlock(&s->mutex);
+        break;
+    case PRIM_SPIN:
+        pthread_spin_lock(&s->spin);
+        t1 = rt_now_ns();
+        memcpy(local, buf_at(b, 0), b->size);
+        pthread_spin_unlock(&s->spin);
+        break;
+    case PRIM_RWLOCK:
+        pthread_rwlock_rdlock(&s->rwlock);
+        t1 = rt_now_ns();
+        memcpy(local, buf_at(b, 0), b->size);
+        pthread_rwlock_unlock(&s->rwlock);
+        break;
+    case PRIM_SEQLOCK:
+        for (;;)
+        {
+            t1 = rt_now_ns();
+            uint64_t s1 = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+            if (s1 & 1)
+            {
+                (*retries)++;
+                cpu_relax();
+                continue;
+            }
+            memcpy(local, buf_at(b, 0), b->size);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&s->seq, __ATOMIC_RELAXED) == s1)
+                break;
+            (*retries)++;
+        }
+        break;
+    case PRIM_RCU:
+    {
+        uint32_t cur;
+        for (;;)
+        {
+            cur = __atomic_load_n(&s->rcu_cur, __ATOMIC_SEQ_CST);
+            __atomic_add_fetch(&s->rcu_readers[cur], 1, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&s->rcu_cur, __ATOMIC_SEQ_CST) == cur)
+                break;
+            __atomic_sub_fetch(&s->rcu_readers[cur], 1, __ATOMIC_SEQ_CST); // 그 사이에 교체됨
+            (*retries)++;
+        }
+        t1 = rt_now_ns();
+        memcpy(local, buf_at(b, cur), b->size);
+        __atomic_sub_fetch(&s->rcu_readers[cur], 1, __ATOMIC_SEQ_CST);
+        break;
+    }
+    case PRIM_RING:
+        for (;;)
+        {
+            t1 = rt_now_ns();
+            uint64_t h = __atomic_load_n(&s->ring_head, __ATOMIC_ACQUIRE);
+            unsigned slot = (unsigned)(h % RING_SLOTS);
+            uint64_t s1 = __atomic_load_n(&s->ring_seq[slot], __ATOMIC_ACQUIRE);
+            if (s1 == h * 2)
+            {
+                memcpy(local, buf_at(b, slot), b->size);
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                if (__atomic_load_n(&s->ring_seq[slot], __ATOMIC_RELAXED) == s1)
+                    break;
+            }
+            (*retries)++; // writer가 한 바퀴 돌아 slot을 덮어씀
+        }
+        break;
+    default:
+        break;
+    }
+    return t1 - t0;
+}
+
+static void set_affinity_sched(int core, int fifo, int priority)
+{
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    if (sched_setaffinity(0, sizeof(cpuset), &cpuset) != 0)
+    {
+        perror("[sync_bench] sched_setaffinity");
+        _exit(EXIT_FAILURE);
+    }
+    if (fifo)
+    {
+        struct sched_param param = {.sched_priority = priority};
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0)
+        {
+            perror("[sync_bench] sched_setscheduler");
+            _exit(EXIT_FAILURE);
+        }
+    }
+}
+
+// 역할 하나의 주기 loop (fork한 process에서 실행)
+static void run_role(bench_t *b, int role, int64_t period_ns, int64_t starve_ns)
+{
+    bench_shm_t *s = b->shm;
+    role_stats_t *st = &s->stats[role];
+    char *local = mmap(NULL, b->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (local == MAP_FAILED)
+    {
+        perror("[sync_bench] mmap");
+        _exit(EXIT_FAILURE);
+    }
+    memset(local, 0, b->size); // 측정 중 page fault 방지
+    uint64_t last_seq = 0, seq = 0;
+
+    for (int64_t k = 0;; k++)
+    {
+        struct timespec next, start, phase, end;
+        int64_t release = s->epoch_ns + k * period_ns;
+        if (release >= s->stop_ns || rt_now_ns() >= s->stop_ns) // 주기를 넘기는 역할도 실행시간에 끝냄
+            break;
+        rt_ns_to_timespec(release, &next);
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        if (role == ROLE_WRITER)
+        {
+            stamp(local, b->size, ++seq); // execution 결과
+            clock_gettime(CLOCK_MONOTONIC, &phase); // send
+            int64_t blocked = bench_write(b, local);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            rt_hist_record(&st->latency, rt_timespec_to_ns(&end) - rt_timespec_to_ns(&phase));
+            rt_hist_record(&st->blocked, blocked);
+            if (blocked > starve_ns)
+                st->starved++;
+        }
+        else
+        {
+            uint64_t retries = 0;
+            int64_t blocked = bench_read(b, local, &retries);
+            clock_gettime(CLOCK_MONOTONIC, &phase); // recv_time
+            rt_hist_record(&st->latency, rt_timespec_to_ns(&phase) - rt_timespec_to_ns(&start));
+            rt_hist_record(&st->blocked, blocked);
+            st->retries += retries;
+            if (!check(local, b->size, &seq))
+                st->torn++;
+            else if (seq == last_seq)
+                st->stale++;
+            last_seq = seq;
+        }
+        st->jobs++;
+    }
+    munmap(local, b->size);
+}
+
+static void print_row(FILE *csv, size_t size_kb, prim_t prim, int role, const role_stats_t *st)
+{
+    printf("%-8s %-8s %7llu %9.1f %9.1f %9.1f %9.1f %9.1f %9.1f %8llu %5llu %7llu %7llu\n", prim_names[prim],
+           role_names[role], (unsigned long long)st->jobs, rt_hist_percentile(&st->latency, 50) / 1e3,
+           rt_hist_percentile(&st->latency, 99) / 1e3, st->latency.count ? st->latency.max / 1e3 : 0.0,
+           rt_hist_mean(&st->blocked) / 1e3, rt_hist_percentile(&st->blocked, 99) / 1e3,
+           st->blocked.count ? st->blocked.max / 1e3 : 0.0, (unsigned long long)st->retries,
+           (unsigned long long)st->torn, (unsigned long long)st->stale, (unsigned long long)st->starved);
+    if (csv != NULL)
+        fprintf(csv, "%zu,%s,%s,%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%llu,%llu,%llu,%llu\n", size_kb, prim_names[prim],
+                role_names[role], (unsigned long long)st->jobs, rt_hist_percentile(&st->latency, 50) / 1e3,
+                rt_hist_percentile(&st->latency, 99) / 1e3, st->latency.count ? st->latency.max / 1e3 : 0.0,
+                rt_hist_mean(&st->blocked) / 1e3, rt_hist_percentile(&st->blocked, 99) / 1e3,
+                st->blocked.count ? st->blocked.max / 1e3 : 0.0, (unsigned long long)st->retries,
+                (unsigned long long)st->torn, (unsigned long long)st->stale, (unsigned long long)st->starved);
+}
+
+// 크기에 맞는 writer task의 주기 (SFM / Lane / Detection)
+static int writer_period_ms(size_t size_kb)
+{
+    if (size_kb <= 24)
+        return 33;
+    if (size_kb <= 32)
+        return 66;
+    return 200;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [-p sem,mutex,spin,rwlock,seqlock,rcu,ring] [-s size_kb,...] [-d duration_s] [-w writer_ms]\n"
+            "          [-t time_scale] [-c writer,planner,dasm] [-f] [-S starve_us] [-o out.csv]\n",
+            prog);
+}
+
+int main(int argc, char *argv[])
+{
+    prim_t prims[MAX_PRIMS];
+    int num_prims = 0;
+    size_t sizes_kb[MAX_SIZES] = {24, 32, 750};
+    int num_sizes = 3;
+    int duration_s = DEFAULT_DURATION_S;
+    int writer_ms = 0;
+    double scale = 1.0;
+    int cores[ROLE_MAX] = {5, 1, 0}; // pipeline.conf: Detection 5, Planner 1, DASM 0
+    int fifo = 0;
+    int64_t starve_ns = (int64_t)DEFAULT_STARVE_US * 1000;
+    const char *csv_path = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "p:s:d:w:t:c:fS:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'p':
+            for (char *tok = strtok(optarg, ","); tok != NULL; tok = strtok(NULL, ","))
+            {
+                int p = 0;
+                while (p < PRIM_MAX && strcmp(tok, prim_names[p]) != 0)
+                    p++;
+                if (p == PRIM_MAX || num_prims == MAX_PRIMS)
+                {
+                    fprintf(stderr, "[sync_bench] unknown primitive '%s'\n", tok);
+                    return EXIT_FAILURE;
+                }
+                prims[num_prims++] = (prim_t)p;
+            }
+            break;
+        case 's':
+            num_sizes = 0;
+            for (char *tok = strtok(optarg, ","); tok != NULL && num_sizes < MAX_SIZES; tok = strtok(NULL, ","))
+                sizes_kb[num_sizes++] = strtoul(tok, NULL, 10);
+            break;
+        case 'd':
+            duration_s = atoi(optarg);
+            break;
+        case 'w':
+            writer_ms = atoi(optarg);
+            break;
+        case 't':
+            scale = atof(optarg);
+            break;
+        case 'c':
+            if (sscanf(optarg, "%d,%d,%d", &cores[0], &cores[1], &cores[2]) != 3)
+            {
+                usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'f':
+            fifo = 1;
+            break;
+        case 'S':
+            starve_ns = (int64_t)(atof(optarg) * 1000.0);
+            break;
+        case 'o':
+            csv_path = optarg;
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc || duration_s <= 0 || scale <= 0 || num_sizes == 0)
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < num_sizes; i++)
+    {
+        if (sizes_kb[i] == 0)
+        {
+            fprintf(stderr, "[sync_bench] invalid size\n");
+            return EXIT_FAILURE;
+        }
+    }
+    if (num_prims == 0)
+        for (int p = 0; p < PRIM_MAX; p++)
+            prims[num_prims++] = (prim_t)p;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int r = 0; r < ROLE_MAX; r++)
+        cores[r] %= (int)online; // core가 적은 machine에서는 겹쳐서 실행
+
+    FILE *csv = NULL;
+    if (csv_path != NULL)
+    {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL)
+        {
+            perror("[sync_bench] csv open");
+            return EXIT_FAILURE;
+        }
+        fprintf(csv, "size_kb,primitive,role,jobs,lat_p50_us,lat_p99_us,lat_max_us,blk_mean_us,blk_p99_us,blk_max_us,"
+                     "retries,torn,stale,starved\n");
+    }
+
+    bench_shm_t *shm = mmap(NULL, sizeof(bench_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shm == MAP_FAILED)
+    {
+        perror("[sync_bench] mmap");
+        return EXIT_FAILURE;
+    }
+    char sem_name[64];
+    snprintf(sem_name, sizeof(sem_name), "/sync_bench_%d_sem", (int)getpid());
+    sem_unlink(sem_name);
+    sem_t *sem = sem_open(sem_name, O_CREAT | O_EXCL, 0666, 1);
+    if (sem == SEM_FAILED)
+    {
+        perror("[sync_bench] sem_open");
+        return EXIT_FAILURE;
+    }
+    sem_unlink(sem_name); // fork한 process는 이미 열린 semaphore를 그대로 씀
+
+    for (int si = 0; si < num_sizes; si++)
+    {
+        size_t size = sizes_kb[si] * 1024;
+        int w_ms = writer_ms > 0 ? writer_ms : writer_period_ms(sizes_kb[si]);
+        int64_t periods[ROLE_MAX] = {(int64_t)(w_ms * 1.0e6 / scale), (int64_t)(PLANNER_PERIOD_MS * 1.0e6 / scale),
+                                     (int64_t)(DASM_PERIOD_MS * 1.0e6 / scale)};
+        const int priorities[ROLE_MAX] = {sizes_kb[si] <= 24 ? 80 : (sizes_kb[si] <= 32 ? 75 : 70), 85, 90};
+        char *bufs = mmap(NULL, size * RING_SLOTS, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (bufs == MAP_FAILED)
+        {
+            perror("[sync_bench] mmap");
+            return EXIT_FAILURE;
+        }
+        printf("\n[sync_bench] %zu KB sample, writer %.3f ms, planner %.3f ms, dasm %.3f ms, %d s each, cores %d/%d/%d%s\n",
+               sizes_kb[si], periods[0] / 1e6, periods[1] / 1e6, periods[2] / 1e6, duration_s, cores[0], cores[1],
+               cores[2], fifo ? ", SCHED_FIFO" : "");
+        printf("%-8s %-8s %7s %9s %9s %9s %9s %9s %9s %8s %5s %7s %7s\n", "prim", "role", "jobs", "lat p50", "lat p99",
+               "lat max", "blk mean", "blk p99", "blk max", "retries", "torn", "stale", "starved");
+
+        for (int pi = 0; pi < num_prims; pi++)
+        {
+            memset(shm, 0, sizeof(*shm));
+            pthread_mutexattr_t ma;
+            pthread_mutexattr_init(&ma);
+            pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED);
+            pthread_mutex_init(&shm->mutex, &ma);
+            pthread_mutexattr_destroy(&ma);
+            pthread_spin_init(&shm->spin, PTHREAD_PROCESS_SHARED);
+            pthread_rwlockattr_t ra;
+            pthread_rwlockattr_init(&ra);
+            pthread_rwlockattr_setpshared(&ra, PTHREAD_PROCESS_SHARED);
+            pthread_rwlock_init(&shm->rwlock, &ra);
+            pthread_rwlockattr_destroy(&ra);
+            for (int r = 0; r < ROLE_MAX; r++)
+            {
+                rt_hist_reset(&shm->stats[r].latency);
+                rt_hist_reset(&shm->stats[r].blocked);
+            }
+            memset(bufs, 0, size * RING_SLOTS); // page를 미리 할당, seq 0 = 아직 쓰지 않은 channel
+
+            bench_t b = {prims[pi], size, shm, bufs, sem};
+            {
+                // 초기 sample (seq 0): ring / rcu도 읽을 수 있는 상태로 시작
+                char *init = calloc(1, size);
+                if (init == NULL)
+                {
+                    perror("[sync_bench] calloc");
+                    return EXIT_FAILURE;
+                }
+                bench_write(&b, init);
+                free(init);
+            }
+            shm->epoch_ns = rt_now_ns() + 100000000LL; // 세 process가 준비될 여유 (100ms)
+            shm->stop_ns = shm->epoch_ns + (int64_t)duration_s * 1000000000LL;
+
+            pid_t pids[ROLE_MAX];
+            for (int r = 0; r < ROLE_MAX; r++)
+            {
+                pids[r] = fork();
+                if (pids[r] < 0)
+                {
+                    perror("[sync_bench] fork");
+                    return EXIT_FAILURE;
+                }
+                if (pids[r] == 0)
+                {
+                    set_affinity_sched(cores[r], fifo, priorities[r]);
+                    run_role(&b, r, periods[r], starve_ns);
+                    _exit(EXIT_SUCCESS);
+                }
+            }
+            int failed = 0;
+            for (int r = 0; r < ROLE_MAX; r++)
+            {
+                int status;
+                while (waitpid(pids[r], &status, 0) < 0 && errno == EINTR)
+                    ;
+                failed |= !(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+            }
+            if (failed)
+                fprintf(stderr, "[sync_bench] %s: a role process failed\n", prim_names[prims[pi]]);
+            for (int r = 0; r < ROLE_MAX; r++)
+                print_row(csv, sizes_kb[si], prims[pi], r, &shm->stats[r]);
+            fflush(stdout);
+            pthread_mutex_destroy(&shm->mutex);
+            pthread_spin_destroy(&shm->spin);
+            pthread_rwlock_destroy(&shm->rwlock);
+        }
+        munmap(bufs, size * RING_SLOTS);
+    }
+    printf("\n(latency / blocking in us, writer latency = send phase, reader latency = setup phase)\n");
+    if (csv != NULL)
+        fclose(csv);
+    sem_close(sem);
+    munmap(shm, sizeof(bench_shm_t));
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,255 @@
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <time.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <getopt.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../Bare_metal_common/rt_control.h"
+#include "../Bare_metal_common/rt_trace.h"
+
+// Trace drainer
+// 각 task의 trace ring(/waters_trace_<task>)을 주기적으로 비워 trace_<task>.bin 파일로 저장한다.
+// 실시간 task를 방해하지 않도록 SCHED_IDLE로 동작 (launcher 설명 파일에서 policy idle로 실행)
+// ring이 다시 만들어지면(task 재시작) 새 ring에 다시 연결한다.
+//
+// 사용법: trace_drain [-i 간격(ms)] [-o 출력 디렉터리] <task 이름...>
+//         trace_drain -x <trace_<task>.bin>   binary trace를 text로 출력
+
+#define MAX_RINGS 32
+#define DEFAULT_INTERVAL_MS 50
+#define TRACE_FILE_MAGIC 0x57544246 // "WTBF"
+#define TRACE_FILE_VERSION 1
+
+// trace 파일 header, 뒤에 rt_trace_rec_t가 이어짐
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t rec_size;
+    uint32_t reserved;
+    int64_t epoch_ns;  // launcher가 공지한 공통 epoch (단독 실행 시 drainer 시작 시각)
+    uint64_t dropped;  // ring이 가득 차서 task가 버린 record 수 (종료 시 갱신)
+    char task[32];
+} trace_file_header_t;
+
+typedef struct
+{
+    char task[32];
+    char shm_name[64];
+    rt_trace_ring_t *ring;
+    size_t ring_size;
+    ino_t ino;
+    uint64_t dropped_prev; // 이전 ring(재시작 전)에서 버려진 record 수
+    uint64_t written;
+    FILE *fp;
+} ring_state_t;
+
+static ring_state_t rings[MAX_RINGS];
+static int num_rings = 0;
+static volatile sig_atomic_t stop_requested = 0;
+
+static const char *phase_names[RT_TR_PHASE_MAX] = {
+    "?", "wake", "start", "read", "send", "end", "pre", "func", "post", "begin", "finish", "perf", "skip", "repeat"};
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+// ring에 쌓인 record를 파일로 옮김 (reader는 tail만 갱신)
+static void drain(ring_state_t *rs)
+{
+    rt_trace_ring_t *ring = rs->ring;
+    if (ring == NULL)
+        return;
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = ring->tail;
+    uint32_t mask = ring->capacity - 1;
+    while (tail < head)
+    {
+        // wrap-around 전까지 연속된 구간을 한 번에 기록
+        uint64_t idx = tail & mask;
+        uint64_t n = head - tail;
+        if (n > ring->capacity - idx)
+            n = ring->capacity - idx;
+        fwrite(&ring->recs[idx], sizeof(rt_trace_rec_t), n, rs->fp);
+        tail += n;
+        rs->written += n;
+    }
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+}
+
+// ring 연결 (처음 생성되었거나 task 재시작으로 다시 만들어진 경우)
+static void attach(ring_state_t *rs)
+{
+    int fd = shm_open(rs->shm_name, O_RDWR, 0666);
+    if (fd == -1)
+        return; // 아직 task가 ring을 만들지 않음
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (rs->ring != NULL && st.st_ino == rs->ino) ||
+        (size_t)st.st_size < sizeof(rt_trace_ring_t))
+    {
+        close(fd);
+        return;
+    }
+    rt_trace_ring_t *ring = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (ring == MAP_FAILED)
+    {
+        perror("[trace_drain] mmap");
+        return;
+    }
+    if (__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != RT_TRACE_MAGIC)
+    {
+        munmap(ring, st.st_size); // 초기화 중, 다음 주기에 다시 시도
+        return;
+    }
+
+    if (rs->ring != NULL)
+    {
+        // 이전 ring의 나머지를 비우고 교체
+        drain(rs);
+        rs->dropped_prev += rs->ring->dropped;
+        munmap(rs->ring, rs->ring_size);
+    }
+    rs->ring = ring;
+    rs->ring_size = st.st_size;
+    rs->ino = st.st_ino;
+}
+
+static void write_header(ring_state_t *rs, int64_t epoch_ns)
+{
+    trace_file_header_t h;
+    memset(&h, 0, sizeof(h));
+    h.magic = TRACE_FILE_MAGIC;
+    h.version = TRACE_FILE_VERSION;
+    h.rec_size = sizeof(rt_trace_rec_t);
+    h.epoch_ns = epoch_ns;
+    h.dropped = rs->dropped_prev + (rs->ring != NULL ? rs->ring->dropped : 0);
+    snprintf(h.task, sizeof(h.task), "%s", rs->task);
+    fseek(rs->fp, 0, SEEK_SET);
+    fwrite(&h, sizeof(h), 1, rs->fp);
+    fseek(rs->fp, 0, SEEK_END);
+}
+
+// binary trace 파일을 text로 출력
+// 형식: job, epoch 기준 시각(ms), phase, cpu, flags, arg
+static int decode(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        perror("[trace_drain] open");
+        return EXIT_FAILURE;
+    }
+    trace_file_header_t h;
+    if (fread(&h, sizeof(h), 1, fp) != 1 || h.magic != TRACE_FILE_MAGIC || h.rec_size != sizeof(rt_trace_rec_t))
+    {
+        fprintf(stderr, "[trace_drain] %s: not a trace file\n", path);
+        fclose(fp);
+        return EXIT_FAILURE;
+    }
+    printf("# task %s, epoch %lld ns, dropped %llu\n", h.task, (long long)h.epoch_ns, (unsigned long long)h.dropped);
+    printf("# job time_ms phase cpu flags arg\n");
+    rt_trace_rec_t r;
+    while (fread(&r, sizeof(r), 1, fp) == 1)
+    {
+        const char *name = (r.phase < RT_TR_PHASE_MAX) ? phase_names[r.phase] : "?";
+        printf("%u %.6f %s %d %u %lld\n", r.job, (r.ts_ns - h.epoch_ns) / 1.0e6, name, r.cpu, r.flags, (long long)r.arg);
+    }
+    fclose(fp);
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    int interval_ms = DEFAULT_INTERVAL_MS;
+    const char *out_dir = ".";
+    int opt;
+    while ((opt = getopt(argc, argv, "i:o:x:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i':
+            interval_ms = atoi(optarg);
+            break;
+        case 'o':
+            out_dir = optarg;
+            break;
+        case 'x':
+            return decode(optarg);
+        default:
+            fprintf(stderr, "usage: %s [-i interval_ms] [-o out_dir] <task...>\n       %s -x <trace.bin>\n", argv[0], argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc)
+    {
+        fprintf(stderr, "usage: %s [-i interval_ms] [-o out_dir] <task...>\n       %s -x <trace.bin>\n", argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // 실시간 task가 모두 쉬고 있을 때만 실행되도록
+    struct sched_param param = {.sched_priority = 0};
+    if (sched_setscheduler(0, SCHED_IDLE, &param) != 0)
+        perror("[trace_drain] sched_setscheduler(SCHED_IDLE)");
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    for (int i = optind; i < argc && num_rings < MAX_RINGS; i++)
+    {
+        ring_state_t *rs = &rings[num_rings++];
+        snprintf(rs->task, sizeof(rs->task), "%s", argv[i]);
+        rt_trace_shm_name(argv[i], rs->shm_name, sizeof(rs->shm_name));
+        char path[256];
+        snprintf(path, sizeof(path), "%s/trace_%s.bin", out_dir, rs->task);
+        rs->fp = fopen(path, "wb");
+        if (rs->fp == NULL)
+        {
+            perror("[trace_drain] fopen");
+            exit(EXIT_FAILURE);
+        }
+        write_header(rs, 0);
+    }
+
+    // launcher 실행 시 다른 task와 같은 start barrier를 통과 (epoch을 파일 header에 기록)
+    int64_t epoch_ns = rt_ctrl_wait_epoch();
+    for (int i = 0; i < num_rings; i++)
+        write_header(&rings[i], epoch_ns);
+
+    struct timespec interval = {interval_ms / 1000, (interval_ms % 1000) * 1000000L};
+    while (!stop_requested)
+    {
+        for (int i = 0; i < num_rings; i++)
+        {
+            attach(&rings[i]);
+            drain(&rings[i]);
+        }
+        nanosleep(&interval, NULL);
+    }
+
+    // 종료: 남은 record를 모두 비우고 header의 dropped 갱신
+    for (int i = 0; i < num_rings; i++)
+    {
+        ring_state_t *rs = &rings[i];
+        attach(rs);
+        drain(rs);
+        write_header(rs, epoch_ns);
+        fclose(rs->fp);
+        printf("[trace_drain] %s: %llu records, %llu dropped\n", rs->task, (unsigned long long)rs->written,
+               (unsigned long long)(rs->dropped_prev + (rs->ring != NULL ? rs->ring->dropped : 0)));
+    }
+    return EXIT_SUCCESS;
+}
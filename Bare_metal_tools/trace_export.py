@@ -0,0 +1,200 @@
+import bisect
+import glob
+import json
+import os
+import struct
+import sys
+
+# trace_drain이 남긴 trace_<task>.bin 파일들을 하나의 Chrome trace-event JSON으로 변환
+# chrome://tracing 또는 https://ui.perfetto.dev 에서 열 수 있음
+#  - task마다 process 하나, 그 안에서 core마다 track 하나 (pid = task, tid = core)
+#  - job 구간과 phase 구간(setup / exec(pre, func, post) / send / log / sleep)
+#  - release 지연(WAKE ~ START)은 "ready" 구간
+#  - WATERS_PERF=1로 실행했다면 phase 구간의 args에 performance counter 증가량
+#  - chain 흐름 화살표: 시작 task send(seq) -> 경유 task read -> 경유 task send -> ... -> DASM read
+#    (chain 1,2: Lidar_grabber/CAN -> Loc -> EKF -> Planner -> DASM, chain 3~5: producer -> Planner -> DASM)
+#    (경유 task는 같은 seq를 처음 읽은 job에만 연결)
+#  - Planner / DASM의 입력 link별 undersampling(덮어써진 sample) / oversampling(다시 읽은 job) 합계 출력 (rt_sample.h)
+#
+# 사용법: python3 trace_export.py [run 디렉터리] [출력 파일]   (기본: 현재 디렉터리, <run 디렉터리>/trace.json)
+
+HEADER = struct.Struct('<IIIIqQ32s')
+RECORD = struct.Struct('<qqIHHiI')
+TRACE_FILE_MAGIC = 0x57544246
+
+# rt_trace.h의 RT_TR_* / RT_SPAN_*
+WAKE, START, READ, SEND, END, PRE, FUNC, POST, BEGIN, FINISH, PERF, SKIP, REPEAT = range(1, 14)
+SPAN_NAMES = {1: 'setup', 2: 'exec', 3: 'pre', 4: 'func', 5: 'post', 6: 'send', 7: 'log', 8: 'sleep'}
+SPAN_SLEEP = 8
+# rt_perf.h의 RT_PERF_* (WATERS_PERF=1로 실행한 경우 phase 구간 args에 추가)
+PERF_NAMES = ['cycles', 'instructions', 'LLC-misses', 'context-switches', 'page-faults',
+              'dTLB-load-misses']
+
+# chain별 시작(producer) task와 경유 task
+CHAIN_SOURCES = {1: 'lidar', 2: 'can', 3: 'sfm', 4: 'lane', 5: 'detection'}
+CHAIN_PATHS = {1: ['loc', 'ekf', 'planner', 'dasm'], 2: ['loc', 'ekf', 'planner', 'dasm'],
+               3: ['planner', 'dasm'], 4: ['planner', 'dasm'], 5: ['planner', 'dasm']}
+
+# RT_TR_SKIP / RT_TR_REPEAT의 flags(link 번호) -> 입력 buffer를 쓰는 task
+SAMPLE_LINKS = {'planner': ['ekf', 'sfm', 'lane', 'detection'], 'dasm': ['planner']}
+
+# 출력 순서 (위에서 아래로 chain 방향)
+TASK_ORDER = ['lidar', 'can', 'loc', 'ekf', 'sfm', 'lane', 'detection', 'planner', 'dasm']
+
+
+def read_trace(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    magic, version, rec_size, _, epoch_ns, dropped, task = HEADER.unpack_from(data, 0)
+    if magic != TRACE_FILE_MAGIC or rec_size != RECORD.size:
+        print(f"❌ 오류: '{path}' 은(는) trace 파일이 아닙니다.")
+        return None
+    task = task.split(b'\0', 1)[0].decode()
+    recs = [RECORD.unpack_from(data, off)
+            for off in range(HEADER.size, len(data) - RECORD.size + 1, RECORD.size)]
+    recs.sort(key=lambda r: r[0])
+    return task, epoch_ns, dropped, recs
+
+
+def us(ts_ns, epoch_ns):
+    return (ts_ns - epoch_ns) / 1000.0
+
+
+def print_sampling(traces):
+    """입력 link별 undersampling / oversampling 합계 (job 수는 END record 기준)"""
+    for task, links in SAMPLE_LINKS.items():
+        if task not in traces:
+            continue
+        recs = traces[task][3]
+        jobs = sum(1 for r in recs if r[3] == END)
+        for i, source in enumerate(links):
+            skipped = sum(r[1] for r in recs if r[3] == SKIP and r[4] == i)
+            repeated = sum(1 for r in recs if r[3] == REPEAT and r[4] == i)
+            print(f'📊 {source} -> {task}: job {jobs}개, 덮어써진 sample {skipped}개 (undersampling), '
+                  f'같은 sample을 다시 읽은 job {repeated}개 (oversampling)')
+
+
+def export(run_dir, out_path):
+    traces = {}
+    for path in sorted(glob.glob(os.path.join(run_dir, 'trace_*.bin'))):
+        t = read_trace(path)
+        if t is not None:
+            traces[t[0]] = t
+    if not traces:
+        print(f"❌ 오류: '{run_dir}'에 trace_*.bin 파일이 없습니다.")
+        return 1
+
+    epoch_ns = min(t[1] for t in traces.values())
+    tasks = sorted(traces, key=lambda n: (TASK_ORDER.index(n) if n in TASK_ORDER else len(TASK_ORDER), n))
+    events = []
+
+    for pid, task in enumerate(tasks, start=1):
+        _, _, dropped, recs = traces[task]
+        events.append({'ph': 'M', 'name': 'process_name', 'pid': pid, 'args': {'name': task}})
+        events.append({'ph': 'M', 'name': 'process_sort_index', 'pid': pid, 'args': {'sort_index': pid}})
+        if dropped:
+            print(f'⚠️ 경고: {task}: ring에서 버려진 record {dropped}개')
+        cores = sorted({r[5] for r in recs})
+        for cpu in cores:
+            events.append({'ph': 'M', 'name': 'thread_name', 'pid': pid, 'tid': cpu, 'args': {'name': f'core {cpu}'}})
+
+        open_spans = {}   # span 종류 -> (시작 ns, core, job)
+        job_start = {}    # job -> (START ns, core)
+        span_events = {}  # (job, span 종류) -> phase 구간 event (perf counter 추가용)
+        for ts, arg, job, phase, flags, cpu, _ in recs:
+            if phase == WAKE:
+                # 이전 job의 sleep 구간 종료
+                if SPAN_SLEEP in open_spans:
+                    b_ts, b_cpu, b_job = open_spans.pop(SPAN_SLEEP)
+                    if ts > b_ts:
+                        events.append({'ph': 'X', 'name': 'sleep', 'cat': 'phase', 'pid': pid, 'tid': b_cpu,
+                                       'ts': us(b_ts, epoch_ns), 'dur': (ts - b_ts) / 1000.0, 'args': {'job': b_job}})
+                open_spans['ready'] = (ts, cpu, job)
+            elif phase == START:
+                if 'ready' in open_spans:
+                    w_ts, _, w_job = open_spans.pop('ready')
+                    if ts > w_ts:
+                        events.append({'ph': 'X', 'name': 'ready', 'cat': 'release', 'pid': pid, 'tid': cpu,
+                                       'ts': us(w_ts, epoch_ns), 'dur': (ts - w_ts) / 1000.0, 'args': {'job': w_job}})
+                job_start[job] = (ts, cpu)
+            elif phase == BEGIN:
+                if flags == SPAN_SLEEP and job in job_start:
+                    # job 구간: START ~ sleep 시작
+                    s_ts, s_cpu = job_start.pop(job)
+                    events.append({'ph': 'X', 'name': f'{task} job', 'cat': 'job', 'pid': pid, 'tid': s_cpu,
+                                   'ts': us(s_ts, epoch_ns), 'dur': (ts - s_ts) / 1000.0, 'args': {'job': job}})
+                open_spans[flags] = (ts, cpu, job)
+            elif phase == FINISH:
+                if flags in open_spans:
+                    b_ts, b_cpu, b_job = open_spans.pop(flags)
+                    ev = {'ph': 'X', 'name': SPAN_NAMES.get(flags, str(flags)), 'cat': 'phase', 'pid': pid,
+                          'tid': b_cpu, 'ts': us(b_ts, epoch_ns), 'dur': (ts - b_ts) / 1000.0, 'args': {'job': job}}
+                    events.append(ev)
+                    span_events[(job, flags)] = ev
+            elif phase == PERF:
+                ev = span_events.get((job, flags & 0xff))
+                counter = flags >> 8
+                if ev is not None and counter < len(PERF_NAMES):
+                    ev['args'][PERF_NAMES[counter]] = arg
+
+    # chain 흐름 화살표
+    pid_of = {task: pid for pid, task in enumerate(tasks, start=1)}
+    flow_id = 0
+    num_flows = 0
+    for chain, source in CHAIN_SOURCES.items():
+        if source not in traces or any(t not in traces for t in CHAIN_PATHS[chain]):
+            continue
+        # producer가 보낸 seq -> (시각, 흐름 번호) 목록 (seq는 wrap되지 않으므로 보통 하나)
+        sends = {}
+        steps = {}
+        for ts, arg, job, phase, flags, cpu, _ in traces[source][3]:
+            if phase == SEND:
+                flow_id += 1
+                sends.setdefault(arg, ([], []))
+                sends[arg][0].append(ts)
+                sends[arg][1].append(flow_id)
+                steps[flow_id] = [(ts, source, cpu)]
+        # 경유 task: 새 seq(chain 시작 task의 seq)를 처음 읽은 READ(flags = chain)를 그 시각 이전의 마지막 send와 연결
+        # 중간 task는 같은 job의 SEND까지 이어서 다음 task로 넘어가는 화살표를 만듦
+        for task in CHAIN_PATHS[chain]:
+            last_seq = None
+            read_jobs = {}
+            for ts, arg, job, phase, flags, cpu, _ in traces[task][3]:
+                if phase == READ and flags == chain and arg != last_seq:
+                    last_seq = arg
+                    if arg not in sends:
+                        continue
+                    i = bisect.bisect_right(sends[arg][0], ts) - 1
+                    if i < 0:
+                        continue
+                    fid = sends[arg][1][i]
+                    steps[fid].append((ts, task, cpu))
+                    read_jobs[job] = fid
+                elif phase == SEND and job in read_jobs:
+                    steps[read_jobs.pop(job)].append((ts, task, cpu))
+        # 소비된 흐름만 출력: 시작 's', 중간 't', 마지막 'f'
+        for fid, path in steps.items():
+            if len(path) < 2:
+                continue
+            path.sort()
+            num_flows += 1
+            for i, (ts, task, cpu) in enumerate(path):
+                ph = 's' if i == 0 else ('f' if i == len(path) - 1 else 't')
+                ev = {'ph': ph, 'name': f'Chain {chain}', 'cat': 'chain', 'id': fid, 'pid': pid_of[task],
+                      'tid': cpu, 'ts': us(ts, epoch_ns)}
+                if ph == 'f':
+                    ev['bp'] = 'e'
+                events.append(ev)
+
+    print_sampling(traces)
+
+    with open(out_path, 'w') as f:
+        json.dump({'traceEvents': events, 'displayTimeUnit': 'ms'}, f)
+    print(f"✅ '{out_path}' 저장 완료 (task {len(tasks)}개, event {len(events)}개, chain 흐름 {num_flows}개)")
+    return 0
+
+
+if __name__ == '__main__':
+    run_dir = sys.argv[1] if len(sys.argv) > 1 else '.'
+    out_path = sys.argv[2] if len(sys.argv) > 2 else os.path.join(run_dir, 'trace.json')
+    sys.exit(export(run_dir, out_path))